@@ -34,6 +34,24 @@
 #define DEFAULT_GAS_PRICE 20000000000ULL  // 20 Gwei
 #define DEFAULT_GAS_LIMIT 100000
 
+// Signer Pool: {private key, address} pairs, each with its own nonce lane.
+// Add more pairs to send transactions in parallel; fund every address.
+// main.cpp builds its SIGNER_KEYS table from this list.
+#define SIGNER_KEY_PAIRS { PRIVATE_KEY, MY_ADDRESS }
+
+// Sensor Pipeline: one store() of min/max/mean/count per window, not per sample
+#define SENSOR_PIN 34
+#define SENSOR_SAMPLE_HZ 50
+#define SENSOR_WINDOW_MS 300000
+#define SENSOR_ALERT_MV 0  // Millivolts that close a window early, 0 = off
+
+// Vouchers: EIP-712 domain of the VoucherEscrow contract that settles them
+#define VOUCHER_CONTRACT "0x0000000000000000000000000000000000000000"
+
+// Meta-transactions: writes signed as ERC-2771 requests and batched by a relayer
+#define RELAYER_URL ""  // e.g. "http://192.168.1.10:8088", empty = off
+#define FORWARDER_ADDRESS "0x0000000000000000000000000000000000000000"
+
 // Server Configuration (for web interface)
 #define SERVER_PORT 80
 
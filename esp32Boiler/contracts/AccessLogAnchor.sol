@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MIT
+pragma solidity ^0.8.0;
+
+/// @title Access log anchor for the security door example
+/// @notice Each door closes its access log once per period, builds a Merkle
+/// tree over the entries and anchors only the root here, so on-chain cost is
+/// one transaction per period however many times the door opened. Any entry
+/// can later be checked against the anchored root with the inclusion proof
+/// the door serves at /api/proof.
+///
+/// Leaves are keccak256(abi.encodePacked(period, index, time, granted, user))
+/// (37 bytes, so never confused with a 64-byte inner node); inner nodes hash
+/// the sorted pair, and an odd node at the end of a level is carried up as is.
+contract AccessLogAnchor {
+    mapping(address => mapping(uint64 => bytes32)) public roots;
+    mapping(address => mapping(uint64 => uint32)) public entryCounts;
+
+    event Anchored(address indexed device, uint64 indexed period, bytes32 root, uint32 entries);
+
+    /// @notice Anchor the root of one closed period; the sender is the door
+    function anchor(uint64 period, bytes32 root, uint32 entries) external {
+        require(root != bytes32(0), "empty root");
+        require(roots[msg.sender][period] == bytes32(0), "period already anchored");
+        roots[msg.sender][period] = root;
+        entryCounts[msg.sender][period] = entries;
+        emit Anchored(msg.sender, period, root, entries);
+    }
+
+    function leaf(uint64 period, uint32 index, uint32 time, bool granted, address user)
+        public pure returns (bytes32)
+    {
+        return keccak256(abi.encodePacked(period, index, time, granted, user));
+    }
+
+    /// @notice True if the entry is part of the period the device anchored
+    function verify(
+        address device,
+        uint64 period,
+        uint32 index,
+        uint32 time,
+        bool granted,
+        address user,
+        bytes32[] calldata proof
+    ) external view returns (bool) {
+        bytes32 node = leaf(period, index, time, granted, user);
+        for (uint256 i = 0; i < proof.length; i++) {
+            bytes32 sibling = proof[i];
+            node = node < sibling
+                ? keccak256(abi.encodePacked(node, sibling))
+                : keccak256(abi.encodePacked(sibling, node));
+        }
+        bytes32 root = roots[device][period];
+        return root != bytes32(0) && node == root;
+    }
+}
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+pragma solidity ^0.8.5;     // Calldata slice to bytes32 conversion
+
+/// @title ERC-2771 forwarder that executes many signed requests per transaction
+/// @notice Devices sign EIP-712 ForwardRequests and hand them to a relayer
+/// (tools/relayer); the relayer pays gas and submits them in batches here.
+/// Each call is forwarded with the signer appended to the calldata, so a
+/// target that trusts this forwarder (ERC2771Context) sees the device as
+/// _msgSender(). An invalid request, or one the batch has too little gas
+/// left for, is skipped and reported, not reverted, so one bad device or a
+/// short gas limit cannot sink a batch.
+contract BatchForwarder {
+    struct ForwardRequestData {
+        address from;
+        address to;
+        uint256 value;
+        uint256 gas;
+        uint256 nonce;
+        uint48 deadline;          // Unix seconds; 0 = no deadline (devices without a clock)
+        bytes data;
+        bytes signature;          // r || s || v
+    }
+
+    bytes32 private constant DOMAIN_TYPEHASH =
+        keccak256("EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)");
+    bytes32 private constant FORWARD_REQUEST_TYPEHASH = keccak256(
+        "ForwardRequest(address from,address to,uint256 value,uint256 gas,uint256 nonce,uint48 deadline,bytes data)");
+    uint256 private constant HALF_ORDER = 0x7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5D576E7357A4501DDFE92F46681B20A0;
+
+    mapping(address => uint256) public nonces;
+
+    event ExecutedForwardRequest(address indexed signer, uint256 nonce, bool success);
+    event RejectedForwardRequest(address indexed signer, uint256 nonce, string reason);
+
+    function domainSeparator() public view returns (bytes32) {
+        return keccak256(abi.encode(
+            DOMAIN_TYPEHASH, keccak256("PolkaESP Forwarder"), keccak256("1"), block.chainid, address(this)));
+    }
+
+    function digest(ForwardRequestData calldata req) public view returns (bytes32) {
+        bytes32 structHash = keccak256(abi.encode(
+            FORWARD_REQUEST_TYPEHASH, req.from, req.to, req.value, req.gas, req.nonce, req.deadline,
+            keccak256(req.data)));
+        return keccak256(abi.encodePacked("\x19\x01", domainSeparator(), structHash));
+    }
+
+    /// @notice Empty string if the request would execute now
+    function check(ForwardRequestData calldata req) public view returns (string memory) {
+        if (req.deadline != 0 && block.timestamp > req.deadline) return "expired";
+        if (req.nonce != nonces[req.from]) return "bad nonce";
+        if (req.signature.length != 65) return "bad signature";
+        bytes32 r = bytes32(req.signature[0:32]);
+        bytes32 s = bytes32(req.signature[32:64]);
+        uint8 v = uint8(req.signature[64]);
+        if (uint256(s) > HALF_ORDER) return "bad signature";
+        address signer = ecrecover(digest(req), v, r, s);
+        if (signer == address(0) || signer != req.from) return "bad signature";
+        return "";
+    }
+
+    function execute(ForwardRequestData calldata req) external payable returns (bool) {
+        require(msg.value == req.value, "value mismatch");
+        string memory reason = check(req);
+        require(bytes(reason).length == 0, reason);
+        require(enoughGas(req), "insufficient gas for request");
+        return forward(req);
+    }
+
+    /// @notice Executes every valid request in order; msg.value must cover the
+    /// value of all of them. Returns per-request success.
+    function executeBatch(ForwardRequestData[] calldata requests) external payable returns (bool[] memory ok) {
+        uint256 total;
+        for (uint256 i = 0; i < requests.length; i++) {
+            total += requests[i].value;
+        }
+        require(msg.value == total, "value mismatch");
+
+        ok = new bool[](requests.length);
+        uint256 refund;
+        for (uint256 i = 0; i < requests.length; i++) {
+            string memory reason = check(requests[i]);
+            if (bytes(reason).length == 0 && !enoughGas(requests[i])) {
+                reason = "insufficient gas";    // Nonce left unused, so the device can resubmit it
+            }
+            if (bytes(reason).length != 0) {
+                emit RejectedForwardRequest(requests[i].from, requests[i].nonce, reason);
+                refund += requests[i].value;
+                continue;
+            }
+            ok[i] = forward(requests[i]);
+        }
+        if (refund > 0) {
+            payable(msg.sender).transfer(refund);
+        }
+    }
+
+    /// @dev Whether the relayer left the gas the signer asked for (EIP-150 keeps 1/64 back)
+    function enoughGas(ForwardRequestData calldata req) private view returns (bool) {
+        return gasleft() > req.gas + req.gas / 63 + 10000;
+    }
+
+    function forward(ForwardRequestData calldata req) private returns (bool success) {
+        nonces[req.from] = req.nonce + 1;
+        (success, ) = req.to.call{gas: req.gas, value: req.value}(abi.encodePacked(req.data, req.from));
+        emit ExecutedForwardRequest(req.from, req.nonce, success);
+    }
+}
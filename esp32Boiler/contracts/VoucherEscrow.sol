@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MIT
+pragma solidity ^0.8.0;
+
+/// @title Escrow for off-chain pay-per-use vouchers (src/voucher.h)
+/// @notice Payers deposit once and then sign EIP-712 vouchers for the running
+/// total they owe a device. The device redeems only the newest voucher, as
+/// rarely as it likes; each redemption pays the difference to what was
+/// already paid out to it.
+contract VoucherEscrow {
+    struct Voucher {
+        address device;
+        address payer;
+        uint256 amount;
+        uint64 nonce;
+        uint64 expiry;
+    }
+
+    bytes32 private constant DOMAIN_TYPEHASH =
+        keccak256("EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)");
+    bytes32 private constant VOUCHER_TYPEHASH =
+        keccak256("Voucher(address device,address payer,uint256 amount,uint64 nonce,uint64 expiry)");
+    uint256 private constant HALF_ORDER = 0x7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5D576E7357A4501DDFE92F46681B20A0;
+
+    mapping(address => uint256) public deposits;
+    mapping(address => mapping(address => uint256)) public paid;   // payer => device => total paid
+
+    event Deposited(address indexed payer, uint256 amount);
+    event Redeemed(address indexed payer, address indexed device, uint256 total, uint256 payout);
+
+    function deposit() external payable {
+        deposits[msg.sender] += msg.value;
+        emit Deposited(msg.sender, msg.value);
+    }
+
+    function domainSeparator() public view returns (bytes32) {
+        return keccak256(abi.encode(
+            DOMAIN_TYPEHASH, keccak256("PolkaESP Voucher"), keccak256("1"), block.chainid, address(this)));
+    }
+
+    function digest(Voucher calldata v) public view returns (bytes32) {
+        bytes32 structHash = keccak256(abi.encode(VOUCHER_TYPEHASH, v.device, v.payer, v.amount, v.nonce, v.expiry));
+        return keccak256(abi.encodePacked("\x19\x01", domainSeparator(), structHash));
+    }
+
+    /// @notice Called by the device with the newest voucher it holds
+    function redeem(Voucher calldata v, uint8 sigV, bytes32 r, bytes32 s) external {
+        require(msg.sender == v.device, "not the device");
+        require(v.expiry == 0 || block.timestamp <= v.expiry, "voucher expired");
+        require(uint256(s) <= HALF_ORDER, "high s");
+        require(ecrecover(digest(v), sigV, r, s) == v.payer && v.payer != address(0), "bad signature");
+
+        uint256 already = paid[v.payer][v.device];
+        require(v.amount > already, "nothing to redeem");
+        uint256 payout = v.amount - already;
+        require(deposits[v.payer] >= payout, "deposit too low");
+
+        deposits[v.payer] -= payout;
+        paid[v.payer][v.device] = v.amount;
+        emit Redeemed(v.payer, v.device, v.amount, payout);
+        payable(v.device).transfer(payout);
+    }
+}
@@ -12,6 +12,8 @@
 #include <Web3.h>
 #include <Util.h>
 
+#include "../../src/amount.h"
+
 // Configuration
 const char* WIFI_SSID = "YOUR_WIFI_SSID";
 const char* WIFI_PASSWORD = "YOUR_WIFI_PASSWORD";
@@ -55,9 +57,10 @@ void testBasicOperations() {
         // Test 1: Get account balance
         Serial.println("1. Getting account balance...");
         uint256_t balance = web3->EthGetBalance(&myAddress);
-        string balanceStr = Util::ConvertWeiToEthString(&balance, 18);
+        char balanceStr[AMOUNT_MAX_CHARS];
+        Amount::format(balance, 18, balanceStr, sizeof(balanceStr));
         Serial.print("   Balance: ");
-        Serial.print(balanceStr.c_str());
+        Serial.print(balanceStr);
         Serial.println(" ETH");
         
         // Test 2: Get transaction count
@@ -86,12 +89,13 @@ void queryAccountBalance() {
     
     try {
         uint256_t balance = web3->EthGetBalance(&myAddress);
-        string balanceStr = Util::ConvertWeiToEthString(&balance, 18);
+        char balanceStr[AMOUNT_MAX_CHARS];
+        Amount::format(balance, 18, balanceStr, sizeof(balanceStr));
         
         Serial.print("[");
         Serial.print(millis());
         Serial.print("] Current balance: ");
-        Serial.print(balanceStr.c_str());
+        Serial.print(balanceStr);
         Serial.println(" ETH");
         
     } catch (const std::exception& e) {
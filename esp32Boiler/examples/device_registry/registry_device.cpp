@@ -0,0 +1,135 @@
+/*
+ * Device Registry Example
+ *
+ * Registers this board in PolkaESPRegistry (contracts/PolkaESPRegistry.sol)
+ * with add(name), then heartbeats with ping(0) and reads its entry back
+ * with get(address). Failures back off with jitter.
+ *
+ * The decision logic is src/registry_agent.h, the same code the host fleet
+ * simulator (tools/fleet_sim) runs for thousands of virtual devices; this
+ * file only performs the calls it asks for. Reads use src/rpc_client.cpp,
+ * src/tls_resume.cpp and src/gzip_inflate.cpp, which must be built
+ * alongside.
+ */
+
+#include <WiFi.h>
+#include <Web3.h>
+#include <Contract.h>
+
+#include "../../src/abi/polka32.h"
+#include "../../src/registry_agent.h"
+#include "../../src/rpc_client.h"
+#include "../../src/uint256.h"
+
+// Configuration
+const char* WIFI_SSID = "YOUR_WIFI_SSID";
+const char* WIFI_PASSWORD = "YOUR_WIFI_PASSWORD";
+#define MY_ADDRESS "0x0000000000000000000000000000000000000000"
+#define PRIVATE_KEY "0000000000000000000000000000000000000000000000000000000000000000"
+#define REGISTRY_CONTRACT "0x0000000000000000000000000000000000000000"
+#define DEVICE_NAME "esp32-registry-01"
+#define RPC_URL "https://ethereum-sepolia-rpc.publicnode.com"
+
+Web3* web3;
+RpcClient rpc;
+RegistryAgent* agent;
+
+RegistryStatus performCall(const RegistryCall& call, uint64_t* value);
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("Device Registry Example Starting...");
+
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    while (WiFi.status() != WL_CONNECTED) {
+        delay(500);
+        Serial.print(".");
+    }
+    Serial.println("\nWiFi connected!");
+
+    web3 = new Web3(SEPOLIA_ID);
+    rpc.addEndpoint(RPC_URL);
+
+    // Seed jitter from the chip so boards booting together spread out
+    agent = new RegistryAgent(DEVICE_NAME, MY_ADDRESS, (uint32_t)ESP.getEfuseMac());
+}
+
+void loop() {
+    RegistryCall call;
+    if (agent->next(millis(), &call)) {
+        uint64_t value = 0;
+        RegistryStatus status = performCall(call, &value);
+        agent->complete(millis(), status, value);
+
+        if (call.type == REGISTRY_RECEIPT && status == REGISTRY_OK) {
+            Serial.println("Registered in the device registry");
+        } else if (call.type == REGISTRY_GET && status == REGISTRY_OK) {
+            Serial.printf("Registry lists %lu device(s) for this address\n", (unsigned long)value);
+        } else if (status == REGISTRY_RATE_LIMITED || status == REGISTRY_FAILED) {
+            Serial.printf("Registry call failed, backing off (%lu so far)\n", (unsigned long)agent->backoffs());
+        }
+    }
+
+    delay(50);
+}
+
+// Perform the call and let the agent interpret the raw JSON-RPC reply
+RegistryStatus performCall(const RegistryCall& call, uint64_t* value) {
+    std::string response;
+    switch (call.type) {
+        case REGISTRY_NONCE:
+        case REGISTRY_RECEIPT: {
+            char params[72];
+            snprintf(params, sizeof(params), "[\"%s\",\"%s\"]", MY_ADDRESS,
+                     call.type == REGISTRY_NONCE ? "pending" : "latest");
+            if (!rpc.call("eth_getTransactionCount", params, &response)) {
+                return REGISTRY_FAILED;
+            }
+            return RegistryAgent::interpret(call, response, value);
+        }
+
+        case REGISTRY_GET: {
+            char params[REGISTRY_CALLDATA_LEN + 80];
+            snprintf(params, sizeof(params), "[{\"to\":\"%s\",\"data\":\"%s\"},\"latest\"]",
+                     REGISTRY_CONTRACT, call.data);
+            if (!rpc.read("eth_call", params, &response)) {
+                return REGISTRY_FAILED;
+            }
+            RegistryStatus status = RegistryAgent::interpret(call, response, value);
+            if (status == REGISTRY_OK) {
+                // Device[] is walked in place, one entry at a time
+                for (AbiReader device : Polka32Abi::decodeGet(response)) {
+                    char name[REGISTRY_NAME_MAX + 1];
+                    UInt256 time;
+                    if (Polka32Abi::decodeDevice(device, name, sizeof(name), &time)) {
+                        Serial.printf("  %s (last seen %llu)\n", name, (unsigned long long)time.low64());
+                    }
+                }
+            }
+            return status;
+        }
+
+        case REGISTRY_ADD:
+        case REGISTRY_PING: {
+            try {
+                Contract contract(web3, REGISTRY_CONTRACT);
+                contract.SetPrivateKey(PRIVATE_KEY);
+                string to = REGISTRY_CONTRACT;
+                string data = call.data;
+                uint256_t callValue = 0;
+                unsigned long long gasPriceVal = 20000000000ULL; // 20 Gwei
+                uint32_t gasLimitVal = call.type == REGISTRY_ADD ? 150000 : 60000;
+
+                response = contract.SendTransaction(call.nonce, gasPriceVal, gasLimitVal, &to, &callValue, &data);
+                return RegistryAgent::interpret(call, response, value);
+            } catch (const std::exception& e) {
+                Serial.print("Error sending registry transaction: ");
+                Serial.println(e.what());
+                return REGISTRY_FAILED;
+            }
+        }
+    }
+    return REGISTRY_FAILED;
+}
@@ -0,0 +1,329 @@
+/*
+ * Access Log implementation
+ */
+
+#include "access_log.h"
+
+#include <Crypto.h>
+
+#include "../../src/hex.h"
+
+static void hashPair(const uint8_t a[32], const uint8_t b[32], uint8_t out[32]) {
+    uint8_t buf[64];
+    bool swap = memcmp(a, b, 32) > 0;
+    memcpy(buf, swap ? b : a, 32);
+    memcpy(buf + 32, swap ? a : b, 32);
+    Crypto::Keccak256(buf, sizeof(buf), out);
+}
+
+static void putBE32(uint8_t* p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+// Record: time (LE), granted, 3 bytes padding, user[20]
+static void decodeRecord(const uint8_t* r, AccessEntry* e) {
+    e->time = (uint32_t)r[0] | (uint32_t)r[1] << 8 | (uint32_t)r[2] << 16 | (uint32_t)r[3] << 24;
+    e->granted = r[4] != 0;
+    memcpy(e->user, r + 8, 20);
+}
+
+// Malformed addresses (failed logins can carry anything) log as zero
+static void parseAddress(const char* text, uint8_t out[20]) {
+    if (!Hex::parseAddress(text, out)) {
+        memset(out, 0, 20);
+    }
+}
+
+AccessLog::AccessLog(fs::FS& fs, uint32_t periodMs)
+    : fs(fs), periodMs(periodMs), openId(0), openCount(0), openedAt(0), oldestId(0),
+      anchorCursor(0), pending(0) {}
+
+void AccessLog::path(char* out, size_t len, uint32_t period, const char* ext) {
+    snprintf(out, len, ACCESS_LOG_DIR "/%08lu.%s", (unsigned long)period, ext);
+}
+
+void AccessLog::leafHash(uint32_t period, uint32_t index, const AccessEntry& entry, uint8_t out[32]) {
+    uint8_t packed[37];
+    putBE32(packed, 0);             // period is uint64 on chain
+    putBE32(packed + 4, period);
+    putBE32(packed + 8, index);
+    putBE32(packed + 12, entry.time);
+    packed[16] = entry.granted ? 1 : 0;
+    memcpy(packed + 17, entry.user, 20);
+    Crypto::Keccak256(packed, sizeof(packed), out);
+}
+
+// ===== PERIODS =====
+bool AccessLog::begin(uint32_t now) {
+    if (!fs.exists(ACCESS_LOG_DIR) && !fs.mkdir(ACCESS_LOG_DIR)) {
+        return false;
+    }
+    File dir = fs.open(ACCESS_LOG_DIR);
+    if (!dir || !dir.isDirectory()) {
+        return false;
+    }
+
+    bool found = false;
+    uint32_t lowest = UINT32_MAX, highest = 0;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        const char* name = f.name();
+        const char* slash = strrchr(name, '/');
+        name = slash ? slash + 1 : name;
+        char* end;
+        uint32_t id = strtoul(name, &end, 10);
+        if (end != name && strcmp(end, ".log") == 0) {
+            found = true;
+            lowest = id < lowest ? id : lowest;
+            highest = id > highest ? id : highest;
+        }
+    }
+
+    openedAt = now;
+    if (!found) {
+        openId = oldestId = anchorCursor = 0;
+        openCount = 0;
+        pending = 0;
+        return true;
+    }
+
+    // LittleFS commits each append on close, so records are never torn
+    char p[32];
+    path(p, sizeof(p), highest, "root");
+    openId = fs.exists(p) ? highest + 1 : highest;
+    path(p, sizeof(p), openId, "log");
+    File open = fs.open(p, FILE_READ);
+    openCount = open ? open.size() / ACCESS_LOG_RECORD_SIZE : 0;
+    oldestId = lowest;
+
+    pending = 0;
+    anchorCursor = openId;
+    for (uint32_t id = lowest; id < openId; id++) {
+        uint8_t root[32];
+        uint32_t count;
+        char txHash[67];
+        if (!readRoot(id, root, &count, txHash)) {
+            continue;
+        }
+        if (txHash[0] == '\0') {
+            pending++;
+            anchorCursor = id < anchorCursor ? id : anchorCursor;
+        }
+    }
+    return true;
+}
+
+bool AccessLog::append(uint32_t now, uint32_t time, bool granted, const char* user) {
+    if (openCount >= ACCESS_LOG_MAX_ENTRIES && !close(now)) {
+        return false;
+    }
+
+    uint8_t record[ACCESS_LOG_RECORD_SIZE] = {0};
+    record[0] = time;
+    record[1] = time >> 8;
+    record[2] = time >> 16;
+    record[3] = time >> 24;
+    record[4] = granted ? 1 : 0;
+    parseAddress(user, record + 8);
+
+    char p[32];
+    path(p, sizeof(p), openId, "log");
+    File f = fs.open(p, FILE_APPEND);
+    if (!f) {
+        return false;
+    }
+    bool ok = f.write(record, sizeof(record)) == sizeof(record);
+    f.close();
+    if (ok) {
+        openCount++;
+    }
+    return ok;
+}
+
+bool AccessLog::roll(uint32_t now) {
+    if (now - openedAt < periodMs) {
+        return false;
+    }
+    if (openCount == 0) {
+        openedAt = now;    // Nothing to anchor; start the next period
+        return false;
+    }
+    return close(now);
+}
+
+bool AccessLog::close(uint32_t now) {
+    char p[32];
+    path(p, sizeof(p), openId, "log");
+    File log = fs.open(p, FILE_READ);
+    uint8_t root[32];
+    if (!log || !subtreeRoot(log, openId, 0, openCount, root)) {
+        return false;
+    }
+    log.close();
+
+    uint8_t count[4] = {(uint8_t)openCount, (uint8_t)(openCount >> 8), (uint8_t)(openCount >> 16),
+                        (uint8_t)(openCount >> 24)};
+    path(p, sizeof(p), openId, "root");
+    File f = fs.open(p, FILE_WRITE);
+    if (!f || f.write(root, 32) != 32 || f.write(count, 4) != 4) {
+        return false;
+    }
+    f.close();
+
+    openId++;
+    openCount = 0;
+    openedAt = now;
+    pending++;
+    prune();
+    return true;
+}
+
+bool AccessLog::readRoot(uint32_t period, uint8_t root[32], uint32_t* count, char* txHash) {
+    char p[32];
+    path(p, sizeof(p), period, "root");
+    File f = fs.open(p, FILE_READ);
+    uint8_t n[4];
+    if (!f || f.read(root, 32) != 32 || f.read(n, 4) != 4) {
+        return false;
+    }
+    *count = (uint32_t)n[0] | (uint32_t)n[1] << 8 | (uint32_t)n[2] << 16 | (uint32_t)n[3] << 24;
+    size_t len = f.read((uint8_t*)txHash, 66);
+    txHash[len == 66 ? 66 : 0] = '\0';
+    return true;
+}
+
+// Drop the oldest anchored periods beyond ACCESS_LOG_KEEP_PERIODS
+void AccessLog::prune() {
+    while (openId - oldestId > ACCESS_LOG_KEEP_PERIODS) {
+        uint8_t root[32];
+        uint32_t count;
+        char txHash[67];
+        char p[32];
+        if (readRoot(oldestId, root, &count, txHash) && txHash[0] == '\0') {
+            return;    // Not anchored yet; keep it and everything after it
+        }
+        path(p, sizeof(p), oldestId, "log");
+        fs.remove(p);
+        path(p, sizeof(p), oldestId, "root");
+        fs.remove(p);
+        oldestId++;
+    }
+}
+
+// ===== ANCHORING =====
+bool AccessLog::pendingAnchor(uint32_t* period, uint8_t root[32], uint32_t* count) {
+    for (uint32_t id = anchorCursor; id < openId && pending > 0; id++) {
+        char txHash[67];
+        if (!readRoot(id, root, count, txHash)) {
+            continue;
+        }
+        anchorCursor = id;
+        if (txHash[0] == '\0') {
+            *period = id;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AccessLog::markAnchored(uint32_t period, const char* txHash) {
+    if (strlen(txHash) != 66) {
+        return false;
+    }
+    char p[32];
+    path(p, sizeof(p), period, "root");
+    File f = fs.open(p, FILE_APPEND);
+    if (!f || f.size() != 36 || f.write((const uint8_t*)txHash, 66) != 66) {
+        return false;
+    }
+    f.close();
+    pending--;
+    return true;
+}
+
+// ===== MERKLE TREE =====
+// Root over records [from, to) of one period. Keeps one pending left node
+// per level: a new node merges upward while the level above is occupied.
+// At the end the leftover nodes fold together from the lowest level, which
+// is the same as carrying an odd last node up unpaired.
+bool AccessLog::subtreeRoot(File& file, uint32_t period, uint32_t from, uint32_t to, uint8_t out[32]) {
+    uint8_t frontier[ACCESS_LOG_MAX_DEPTH + 1][32];
+    uint32_t filled = 0;
+    uint8_t chunk[ACCESS_LOG_RECORD_SIZE * 8];
+
+    if (from >= to || to - from > ACCESS_LOG_MAX_ENTRIES || !file.seek(from * ACCESS_LOG_RECORD_SIZE)) {
+        return false;
+    }
+    for (uint32_t i = from; i < to;) {
+        uint32_t n = to - i < 8 ? to - i : 8;
+        if (file.read(chunk, n * ACCESS_LOG_RECORD_SIZE) != n * ACCESS_LOG_RECORD_SIZE) {
+            return false;
+        }
+        for (uint32_t k = 0; k < n; k++, i++) {
+            AccessEntry entry;
+            uint8_t node[32];
+            decodeRecord(chunk + k * ACCESS_LOG_RECORD_SIZE, &entry);
+            leafHash(period, i, entry, node);
+
+            int level = 0;
+            while (filled & (1UL << level)) {
+                hashPair(frontier[level], node, node);
+                filled &= ~(1UL << level);
+                level++;
+            }
+            memcpy(frontier[level], node, 32);
+            filled |= 1UL << level;
+        }
+    }
+
+    bool carrying = false;
+    for (int level = 0; level <= ACCESS_LOG_MAX_DEPTH; level++) {
+        if (!(filled & (1UL << level))) {
+            continue;
+        }
+        if (carrying) {
+            hashPair(frontier[level], out, out);
+        } else {
+            memcpy(out, frontier[level], 32);
+            carrying = true;
+        }
+    }
+    return carrying;
+}
+
+// Siblings from the leaf up. At each level the sibling of node j is j ^ 1,
+// covering records [sibling << level, +2^level); a level where that range
+// starts past the end has no sibling (the node was carried up unpaired).
+bool AccessLog::proof(uint32_t period, uint32_t index, AccessProof* out) {
+    if (period >= openId || !readRoot(period, out->root, &out->count, out->txHash) || index >= out->count) {
+        return false;
+    }
+
+    char p[32];
+    path(p, sizeof(p), period, "log");
+    File f = fs.open(p, FILE_READ);
+    uint8_t record[ACCESS_LOG_RECORD_SIZE];
+    if (!f || !f.seek(index * ACCESS_LOG_RECORD_SIZE) || f.read(record, sizeof(record)) != sizeof(record)) {
+        return false;
+    }
+    decodeRecord(record, &out->entry);
+    out->period = period;
+    out->index = index;
+    out->depth = 0;
+    leafHash(period, index, out->entry, out->leaf);
+
+    for (uint32_t level = 0; (1UL << level) < out->count; level++) {
+        uint32_t from = ((index >> level) ^ 1) << level;
+        if (from >= out->count) {
+            continue;
+        }
+        uint32_t to = from + (1UL << level) < out->count ? from + (1UL << level) : out->count;
+        if (out->depth == ACCESS_LOG_MAX_DEPTH || !subtreeRoot(f, period, from, to, out->siblings[out->depth])) {
+            return false;
+        }
+        out->depth++;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+/*
+ * Access Log
+ *
+ * Append-only, tamper-evident log of door decisions in flash. Entries are
+ * grouped into periods; when a period closes, a Keccak Merkle tree is
+ * built over its entries and only the root goes on chain
+ * (contracts/AccessLogAnchor.sol), one transaction per period however busy
+ * the door was. Any single entry can later be proven against that root
+ * with proof(), which the door serves at /api/proof.
+ *
+ * - One file per period (/alog/<period>.log, fixed 28-byte records) and a
+ *   sidecar (/alog/<period>.root) written when it closes: root, entry count
+ *   and, once anchored, the transaction hash
+ * - Leaf = keccak256(period u64 | index u32 | time u32 | granted u8 |
+ *   user[20]), big-endian like abi.encodePacked; inner node = keccak256 of
+ *   the sorted pair; an odd node at the end of a level is carried up as is
+ * - Roots and proofs are computed by streaming the records, with one
+ *   pending node per tree level in RAM, never the whole tree
+ * - Anchored periods beyond ACCESS_LOG_KEEP_PERIODS are deleted; periods
+ *   not yet anchored are always kept
+ */
+
+#ifndef ACCESS_LOG_H
+#define ACCESS_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define ACCESS_LOG_DIR "/alog"
+#define ACCESS_LOG_PERIOD_MS 86400000UL   // One anchor per day
+// 1024 entries per period keeps a proof (10 siblings) inside one HTTP_TX_BUFFER
+#define ACCESS_LOG_MAX_DEPTH 10
+#define ACCESS_LOG_MAX_ENTRIES (1UL << ACCESS_LOG_MAX_DEPTH)  // A full period closes early
+#define ACCESS_LOG_KEEP_PERIODS 60
+#define ACCESS_LOG_RECORD_SIZE 28
+
+struct AccessEntry {
+    uint32_t time;                  // Unix seconds, 0 before NTP sync
+    bool granted;
+    uint8_t user[20];
+};
+
+struct AccessProof {
+    uint32_t period;
+    uint32_t index;
+    uint32_t count;                 // Entries in the period
+    AccessEntry entry;
+    uint8_t leaf[32];
+    uint8_t root[32];
+    uint8_t siblings[ACCESS_LOG_MAX_DEPTH][32];   // Leaf to root
+    uint8_t depth;
+    char txHash[67];                // Empty until anchored
+};
+
+class AccessLog {
+public:
+    AccessLog(fs::FS& fs, uint32_t periodMs = ACCESS_LOG_PERIOD_MS);
+
+    // Find existing periods and resume the open one. Call once the
+    // filesystem is mounted.
+    bool begin(uint32_t now);
+
+    // Append to the open period; user is a 0x address
+    bool append(uint32_t now, uint32_t time, bool granted, const char* user);
+
+    // Close the open period once it is due; call from loop()
+    bool roll(uint32_t now);
+
+    // Oldest closed period without an anchor transaction yet
+    bool pendingAnchor(uint32_t* period, uint8_t root[32], uint32_t* count);
+    bool markAnchored(uint32_t period, const char* txHash);
+
+    // Inclusion proof for one entry of a closed period
+    bool proof(uint32_t period, uint32_t index, AccessProof* out);
+
+    uint32_t openPeriod() const { return openId; }
+    uint32_t openEntries() const { return openCount; }
+    uint32_t unanchored() const { return pending; }
+
+    static void leafHash(uint32_t period, uint32_t index, const AccessEntry& entry, uint8_t out[32]);
+
+private:
+    fs::FS& fs;
+    uint32_t periodMs;
+    uint32_t openId;
+    uint32_t openCount;
+    uint32_t openedAt;
+    uint32_t oldestId;
+    uint32_t anchorCursor;           // No unanchored period below this
+    uint32_t pending;
+
+    bool close(uint32_t now);
+    bool subtreeRoot(File& file, uint32_t period, uint32_t from, uint32_t to, uint8_t out[32]);
+    bool readRoot(uint32_t period, uint8_t root[32], uint32_t* count, char* txHash);
+    void prune();
+    static void path(char* out, size_t len, uint32_t period, const char* ext);
+};
+
+#endif // ACCESS_LOG_H
@@ -0,0 +1,621 @@
+/*
+ * Async HTTP Server implementation
+ *
+ * Connection state is touched from two tasks: AsyncTCP callbacks and the
+ * loop() task running deferred handlers. Both hold the server mutex while
+ * they change it; deferred handlers themselves run unlocked. The mutex is
+ * recursive so inline handlers may call broadcast().
+ */
+
+#include "async_http_server.h"
+
+#include <string.h>
+#include <strings.h>
+
+#include "../../src/hex.h"
+
+enum ConnState : uint8_t {
+    CONN_FREE = 0,
+    CONN_READING,   // Waiting for a complete request head
+    CONN_HANDLING,  // Deferred handler queued or running
+    CONN_SENDING,   // Response queued to the socket
+    CONN_STREAMING, // Server-sent events subscriber
+    CONN_CLOSING    // Last response out, waiting for the disconnect
+};
+
+struct HttpConnection {
+    AsyncHttpServer* server;
+    AsyncClient* client;
+    ConnState state;
+    bool keepAlive;
+    bool closing;       // Client went away while a deferred handler ran
+    bool responded;
+    uint16_t requests;
+    uint32_t lastActivity;
+    uint32_t requestStart;
+
+    // Request head, parsed in place
+    char rx[HTTP_RX_BUFFER];
+    size_t rxLen;
+    size_t consumed;
+    HttpRequest request;
+    HttpHandler handler;
+
+    // Response: head and small bodies in tx, large bodies from static memory
+    char extra[HTTP_EXTRA_HEADERS];
+    size_t extraLen;
+    char tx[HTTP_TX_BUFFER];
+    size_t txLen;
+    const uint8_t* staticBody;
+    size_t staticLen;
+    size_t sentLen;
+};
+
+static HttpConnection connections[HTTP_MAX_CONNECTIONS];
+
+static const char BUSY_RESPONSE[] =
+    "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\nRetry-After: 1\r\n\r\n";
+
+static const char EVENTS_RESPONSE[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n\r\nretry: 3000\n\n";
+
+static const char EVENTS_PING[] = ": ping\n\n";
+
+class ServerLock {
+public:
+    explicit ServerLock(SemaphoreHandle_t lock) : lock(lock) { xSemaphoreTakeRecursive(lock, portMAX_DELAY); }
+    ~ServerLock() { xSemaphoreGiveRecursive(lock); }
+private:
+    SemaphoreHandle_t lock;
+};
+
+static const char* reasonPhrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 431: return "Request Header Fields Too Large";
+        case 503: return "Service Unavailable";
+        default:  return code < 500 ? "Error" : "Internal Server Error";
+    }
+}
+
+// ===== REQUEST =====
+bool HttpRequest::arg(const char* name, char* out, size_t outLen) const {
+    if (reqQuery == nullptr || outLen == 0) {
+        return false;
+    }
+
+    size_t nameLen = strlen(name);
+    const char* p = reqQuery;
+    while (*p) {
+        const char* end = strchr(p, '&');
+        if (end == nullptr) {
+            end = p + strlen(p);
+        }
+
+        if (strncmp(p, name, nameLen) == 0 && p[nameLen] == '=') {
+            size_t n = 0;
+            uint8_t escaped;
+            for (const char* v = p + nameLen + 1; v < end; v++) {
+                char c = *v;
+                if (c == '+') {
+                    c = ' ';
+                } else if (c == '%' && v + 2 < end && Hex::decode(v + 1, &escaped, 1)) {
+                    c = (char)escaped;
+                    v += 2;
+                }
+                if (n + 1 >= outLen) {
+                    return false;
+                }
+                out[n++] = c;
+            }
+            out[n] = '\0';
+            return true;
+        }
+
+        p = *end ? end + 1 : end;
+    }
+    return false;
+}
+
+// ===== RESPONSE =====
+void HttpResponse::header(const char* name, const char* value) {
+    size_t room = sizeof(conn->extra) - conn->extraLen;
+    int n = snprintf(conn->extra + conn->extraLen, room, "%s: %s\r\n", name, value);
+    if (n > 0 && (size_t)n < room) {
+        conn->extraLen += n;
+    } else {
+        conn->extra[conn->extraLen] = '\0';
+    }
+}
+
+static size_t writeHead(HttpConnection& conn, int code, const char* contentType, size_t length) {
+    int n = snprintf(conn.tx, sizeof(conn.tx),
+                     "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: %s\r\n%.*s\r\n",
+                     code, reasonPhrase(code), contentType, (unsigned)length,
+                     conn.keepAlive ? "keep-alive" : "close", (int)conn.extraLen, conn.extra);
+    return n > 0 && (size_t)n < sizeof(conn.tx) ? (size_t)n : 0;
+}
+
+void HttpResponse::send(int code, const char* contentType, const char* body) {
+    size_t bodyLen = strlen(body);
+    size_t headLen = writeHead(*conn, code, contentType, bodyLen);
+    if (headLen == 0 || headLen + bodyLen > sizeof(conn->tx)) {
+        conn->extraLen = 0;
+        conn->keepAlive = false;
+        headLen = writeHead(*conn, 500, "text/plain", 0);
+        bodyLen = 0;
+    }
+
+    memcpy(conn->tx + headLen, body, bodyLen);
+    conn->txLen = headLen + bodyLen;
+    conn->staticBody = nullptr;
+    conn->staticLen = 0;
+    conn->responded = true;
+}
+
+void HttpResponse::sendStatic(int code, const char* contentType, const uint8_t* body, size_t len) {
+    conn->txLen = writeHead(*conn, code, contentType, len);
+    conn->staticBody = body;
+    conn->staticLen = len;
+    conn->responded = true;
+}
+
+bool HttpResponse::sent() const {
+    return conn->responded;
+}
+
+// ===== SERVER =====
+AsyncHttpServer::AsyncHttpServer(uint16_t port)
+    : tcp(port), routeCount(0), lock(nullptr), deferredQueue(nullptr), rejectedAt(0) {
+    memset(&counters, 0, sizeof(counters));
+}
+
+void AsyncHttpServer::on(const char* path, HttpHandler handler, bool deferred) {
+    if (routeCount < HTTP_MAX_ROUTES) {
+        routes[routeCount++] = {path, handler, deferred, false};
+    }
+}
+
+void AsyncHttpServer::onEvents(const char* path) {
+    if (routeCount < HTTP_MAX_ROUTES) {
+        routes[routeCount++] = {path, nullptr, false, true};
+    }
+}
+
+void AsyncHttpServer::begin() {
+    lock = xSemaphoreCreateRecursiveMutex();
+    deferredQueue = xQueueCreate(HTTP_MAX_CONNECTIONS, sizeof(uint8_t));
+
+    tcp.onClient([](void* arg, AsyncClient* client) {
+        static_cast<AsyncHttpServer*>(arg)->accept(client);
+    }, this);
+    tcp.setNoDelay(true);
+    tcp.begin();
+}
+
+HttpServerStats AsyncHttpServer::stats() const {
+    return counters;
+}
+
+const AsyncHttpServer::Route* AsyncHttpServer::route(const char* path) const {
+    for (size_t i = 0; i < routeCount; i++) {
+        if (strcmp(routes[i].path, path) == 0) {
+            return &routes[i];
+        }
+    }
+    return nullptr;
+}
+
+void AsyncHttpServer::accept(AsyncClient* client) {
+    HttpConnection* conn = nullptr;
+    {
+        ServerLock guard(lock);
+        for (size_t i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+            if (connections[i].state == CONN_FREE) {
+                conn = &connections[i];
+                break;
+            }
+        }
+
+        if (conn == nullptr) {
+            counters.rejected++;
+            rejectedAt = millis();
+        } else {
+            memset(conn, 0, sizeof(*conn));
+            conn->server = this;
+            conn->client = client;
+            conn->state = CONN_READING;
+            conn->lastActivity = millis();
+            conn->request.remoteAddr = (uint32_t)client->remoteIP();
+            counters.active++;
+        }
+    }
+
+    if (conn == nullptr) {
+        // Over the connection limit: answer without keeping any state
+        client->onDisconnect([](void*, AsyncClient* c) { delete c; });
+        client->write(BUSY_RESPONSE, sizeof(BUSY_RESPONSE) - 1);
+        client->close();
+        return;
+    }
+
+    client->setNoDelay(true);
+    client->onData([](void* arg, AsyncClient*, void* data, size_t len) {
+        HttpConnection* c = static_cast<HttpConnection*>(arg);
+        c->server->onData(*c, static_cast<const char*>(data), len);
+    }, conn);
+    client->onAck([](void* arg, AsyncClient*, size_t, uint32_t) {
+        HttpConnection* c = static_cast<HttpConnection*>(arg);
+        c->server->onAck(*c);
+    }, conn);
+    client->onPoll([](void* arg, AsyncClient*) {
+        HttpConnection* c = static_cast<HttpConnection*>(arg);
+        c->server->onPoll(*c);
+    }, conn);
+    client->onDisconnect([](void* arg, AsyncClient* c) {
+        HttpConnection* hc = static_cast<HttpConnection*>(arg);
+        hc->server->onDisconnect(*hc);
+        delete c;
+    }, conn);
+}
+
+void AsyncHttpServer::onData(HttpConnection& conn, const char* data, size_t len) {
+    ServerLock guard(lock);
+
+    if (conn.state == CONN_CLOSING || conn.state == CONN_STREAMING) {
+        return;  // Subscribers have nothing more to say
+    }
+    if (conn.rxLen + len > sizeof(conn.rx)) {
+        if (conn.state == CONN_READING) {
+            reply(conn, 431, "Request too large");
+        } else {
+            conn.client->close();
+        }
+        return;
+    }
+
+    if (conn.rxLen == 0) {
+        conn.requestStart = millis();
+    }
+    memcpy(conn.rx + conn.rxLen, data, len);
+    conn.rxLen += len;
+    conn.lastActivity = millis();
+
+    // Pipelined bytes wait until the current response is out
+    if (conn.state == CONN_READING) {
+        process(conn);
+    }
+}
+
+void AsyncHttpServer::onAck(HttpConnection& conn) {
+    ServerLock guard(lock);
+    conn.lastActivity = millis();
+    if (conn.state == CONN_SENDING) {
+        pump(conn);
+    }
+}
+
+void AsyncHttpServer::onPoll(HttpConnection& conn) {
+    ServerLock guard(lock);
+    uint32_t now = millis();
+
+    if (conn.state == CONN_SENDING) {
+        pump(conn);
+    } else if (conn.state == CONN_STREAMING) {
+        // Keep idle subscribers (and any proxy in between) from timing out
+        if (now - conn.lastActivity > HTTP_SSE_PING_MS && conn.client->space() >= sizeof(EVENTS_PING)) {
+            conn.client->write(EVENTS_PING, sizeof(EVENTS_PING) - 1);
+            conn.lastActivity = now;
+        }
+    } else if (conn.state == CONN_READING) {
+        if (conn.rxLen > 0 && now - conn.requestStart > HTTP_REQUEST_TIMEOUT_MS) {
+            counters.timeouts++;
+            reply(conn, 408, "Request timeout");
+        } else if (conn.rxLen == 0 && now - conn.lastActivity > HTTP_KEEPALIVE_MS) {
+            conn.client->close();
+        }
+    }
+}
+
+void AsyncHttpServer::onDisconnect(HttpConnection& conn) {
+    ServerLock guard(lock);
+    conn.client = nullptr;
+    if (conn.state == CONN_HANDLING) {
+        conn.closing = true;  // handleDeferred() frees the slot
+    } else {
+        release(conn);
+    }
+}
+
+void AsyncHttpServer::release(HttpConnection& conn) {
+    if (conn.state != CONN_FREE) {
+        if (conn.state == CONN_STREAMING) {
+            counters.subscribers--;
+        }
+        conn.state = CONN_FREE;
+        conn.client = nullptr;
+        counters.active--;
+    }
+}
+
+bool AsyncHttpServer::parse(HttpConnection& conn, HttpRequest& request) {
+    char* line = conn.rx;
+    char* headEnd = conn.rx + conn.consumed - 4;
+    *headEnd = '\0';
+
+    // Request line: METHOD SP target SP version
+    char* eol = strstr(line, "\r\n");
+    if (eol != nullptr) {
+        *eol = '\0';
+    }
+    char* target = strchr(line, ' ');
+    if (target == nullptr) {
+        return false;
+    }
+    *target++ = '\0';
+    char* version = strchr(target, ' ');
+    if (version == nullptr) {
+        return false;
+    }
+    *version++ = '\0';
+
+    char* query = strchr(target, '?');
+    if (query != nullptr) {
+        *query++ = '\0';
+    }
+    request.reqPath = target;
+    request.reqQuery = query;
+    request.etag = nullptr;
+    conn.keepAlive = strcmp(version, "HTTP/1.1") == 0;
+
+    while (eol != nullptr) {
+        line = eol + 2;
+        eol = strstr(line, "\r\n");
+        if (eol != nullptr) {
+            *eol = '\0';
+        }
+
+        char* value = strchr(line, ':');
+        if (value == nullptr) {
+            continue;
+        }
+        *value++ = '\0';
+        while (*value == ' ') {
+            value++;
+        }
+
+        if (strcasecmp(line, "Connection") == 0) {
+            if (strcasecmp(value, "close") == 0) {
+                conn.keepAlive = false;
+            } else if (strcasecmp(value, "keep-alive") == 0) {
+                conn.keepAlive = true;
+            }
+        } else if (strcasecmp(line, "If-None-Match") == 0) {
+            request.etag = value;
+        }
+    }
+
+    return true;
+}
+
+void AsyncHttpServer::process(HttpConnection& conn) {
+    char* headEnd = nullptr;
+    for (size_t i = 3; i < conn.rxLen; i++) {
+        if (memcmp(conn.rx + i - 3, "\r\n\r\n", 4) == 0) {
+            headEnd = conn.rx + i + 1;
+            break;
+        }
+    }
+    if (headEnd == nullptr) {
+        if (conn.rxLen == sizeof(conn.rx)) {
+            reply(conn, 431, "Request too large");
+        }
+        return;
+    }
+    conn.consumed = headEnd - conn.rx;
+
+    if (!parse(conn, conn.request)) {
+        conn.keepAlive = false;
+        reply(conn, 400, "Bad request");
+        return;
+    }
+    if (counters.rejected && millis() - rejectedAt < HTTP_BUSY_CLOSE_MS) {
+        conn.keepAlive = false;  // Someone is waiting for this slot
+    }
+    if (strcmp(conn.rx, "GET") != 0) {
+        reply(conn, 405, "Only GET is supported");
+        return;
+    }
+
+    const Route* target = route(conn.request.reqPath);
+    if (target == nullptr) {
+        reply(conn, 404, "Not found");
+        return;
+    }
+    dispatch(conn, target);
+}
+
+void AsyncHttpServer::dispatch(HttpConnection& conn, const Route* target) {
+    counters.requests++;
+    conn.handler = target->handler;
+
+    if (target->events) {
+        subscribe(conn);
+        return;
+    }
+
+    if (target->deferred) {
+        uint8_t index = &conn - connections;
+        conn.state = CONN_HANDLING;
+        if (xQueueSend(deferredQueue, &index, 0) != pdTRUE) {
+            conn.state = CONN_READING;
+            reply(conn, 503, "Busy");
+        } else {
+            counters.deferred++;
+        }
+        return;
+    }
+
+    HttpResponse response;
+    response.conn = &conn;
+    conn.handler(conn.request, response);
+    if (!conn.responded) {
+        response.send(500, "text/plain", "No response");
+    }
+    conn.state = CONN_SENDING;
+    pump(conn);
+}
+
+void AsyncHttpServer::subscribe(HttpConnection& conn) {
+    if (counters.subscribers >= HTTP_MAX_SUBSCRIBERS) {
+        reply(conn, 503, "Too many subscribers");
+        return;
+    }
+
+    counters.subscribers++;
+    conn.state = CONN_STREAMING;
+    conn.lastActivity = millis();
+    conn.rxLen = 0;
+    conn.client->setRxTimeout(0);
+    conn.client->write(EVENTS_RESPONSE, sizeof(EVENTS_RESPONSE) - 1);
+}
+
+void AsyncHttpServer::broadcast(const char* event, const char* data) {
+    char message[HTTP_SSE_EVENT_LEN];
+    int len = snprintf(message, sizeof(message), "event: %s\ndata: %s\n\n", event, data);
+    if (len <= 0 || (size_t)len >= sizeof(message)) {
+        return;
+    }
+
+    ServerLock guard(lock);
+    if (counters.subscribers == 0) {
+        return;
+    }
+
+    uint32_t now = millis();
+    for (size_t i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        HttpConnection& conn = connections[i];
+        if (conn.state != CONN_STREAMING || conn.client == nullptr) {
+            continue;
+        }
+
+        if (conn.client->space() < (size_t)len) {
+            // Backed up; the browser reconnects and resyncs from /api/status
+            conn.state = CONN_CLOSING;
+            counters.subscribers--;
+            conn.client->close();
+            continue;
+        }
+        conn.client->add(message, len, ASYNC_WRITE_FLAG_COPY);
+        conn.client->send();
+        conn.lastActivity = now;
+    }
+    counters.events++;
+}
+
+void AsyncHttpServer::handleDeferred() {
+    // Only what is queued now: requests arriving meanwhile wait for the
+    // next call, so a steady stream of them cannot starve the rest of loop()
+    UBaseType_t queued = uxQueueMessagesWaiting(deferredQueue);
+    uint8_t index;
+    while (queued-- > 0 && xQueueReceive(deferredQueue, &index, 0) == pdTRUE) {
+        HttpConnection& conn = connections[index];
+
+        // Slow work happens here without the lock; the slot stays reserved
+        // in CONN_HANDLING so its request buffer cannot be reused meanwhile
+        HttpResponse response;
+        response.conn = &conn;
+        if (!conn.closing) {
+            conn.handler(conn.request, response);
+        }
+
+        ServerLock guard(lock);
+        if (conn.closing) {
+            release(conn);
+            continue;
+        }
+        if (!conn.responded) {
+            response.send(500, "text/plain", "No response");
+        }
+        conn.state = CONN_SENDING;
+        pump(conn);
+    }
+}
+
+void AsyncHttpServer::reply(HttpConnection& conn, int code, const char* body) {
+    if (code == 408 || code == 431 || code >= 500) {
+        conn.keepAlive = false;
+    }
+    if (conn.consumed == 0) {
+        conn.consumed = conn.rxLen;
+    }
+
+    HttpResponse response;
+    response.conn = &conn;
+    conn.extraLen = 0;
+    response.send(code, "text/plain", body);
+    conn.state = CONN_SENDING;
+    pump(conn);
+}
+
+void AsyncHttpServer::pump(HttpConnection& conn) {
+    if (conn.client == nullptr) {
+        return;
+    }
+
+    size_t total = conn.txLen + conn.staticLen;
+    while (conn.sentLen < total) {
+        size_t room = conn.client->space();
+        if (room == 0) {
+            break;
+        }
+
+        size_t n;
+        if (conn.sentLen < conn.txLen) {
+            n = min(room, conn.txLen - conn.sentLen);
+            conn.client->add(conn.tx + conn.sentLen, n, ASYNC_WRITE_FLAG_COPY);
+        } else {
+            size_t offset = conn.sentLen - conn.txLen;
+            n = min(room, conn.staticLen - offset);
+            conn.client->add((const char*)conn.staticBody + offset, n, 0);
+        }
+        conn.sentLen += n;
+    }
+    conn.client->send();
+
+    if (conn.sentLen == total) {
+        finish(conn);
+    }
+}
+
+void AsyncHttpServer::finish(HttpConnection& conn) {
+    conn.requests++;
+    if (!conn.keepAlive || conn.requests >= HTTP_MAX_REQUESTS_PER_CONN) {
+        conn.state = CONN_CLOSING;
+        conn.client->close();
+        return;
+    }
+
+    // Keep any pipelined bytes that followed this request
+    memmove(conn.rx, conn.rx + conn.consumed, conn.rxLen - conn.consumed);
+    conn.rxLen -= conn.consumed;
+    conn.consumed = 0;
+    conn.extraLen = 0;
+    conn.txLen = 0;
+    conn.staticBody = nullptr;
+    conn.staticLen = 0;
+    conn.sentLen = 0;
+    conn.responded = false;
+    conn.state = CONN_READING;
+    conn.lastActivity = conn.requestStart = millis();
+
+    if (conn.rxLen > 0) {
+        process(conn);
+    }
+}
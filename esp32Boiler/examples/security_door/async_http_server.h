@@ -0,0 +1,149 @@
+/*
+ * Async HTTP Server
+ *
+ * Small event-driven HTTP/1.1 server on top of AsyncTCP for the security
+ * door. Unlike the synchronous WebServer it never blocks on a slow client:
+ * all socket I/O happens in AsyncTCP callbacks, and handlers that may take
+ * long (signature recovery, RPC calls) are deferred to loop() so they do not
+ * stall other connections.
+ *
+ * - Fixed pool of HTTP_MAX_CONNECTIONS connections, extra clients get 503
+ * - Keep-alive with idle timeout and a per-connection request cap; while
+ *   clients are being turned away, replies close their connection so
+ *   the slots rotate instead of staying with whoever holds them
+ * - Request timeout for clients that never finish their headers (408)
+ * - GET only, no request bodies; responses from RAM or straight from flash
+ * - Server-sent events: subscribers hold a connection open and receive
+ *   broadcast() pushes; an idle subscriber costs one slot and a ping
+ */
+
+#ifndef ASYNC_HTTP_SERVER_H
+#define ASYNC_HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+
+#ifndef HTTP_MAX_CONNECTIONS
+#define HTTP_MAX_CONNECTIONS 8
+#endif
+#define HTTP_RX_BUFFER 1024
+#ifndef HTTP_TX_BUFFER
+#define HTTP_TX_BUFFER 1280    // Fits an /api/proof reply from the access log
+#endif
+#define HTTP_EXTRA_HEADERS 192
+#define HTTP_MAX_ROUTES 12
+#define HTTP_KEEPALIVE_MS 5000
+#define HTTP_REQUEST_TIMEOUT_MS 3000
+#define HTTP_MAX_REQUESTS_PER_CONN 100
+#define HTTP_BUSY_CLOSE_MS 1000     // No keep-alive this long after turning a client away
+#define HTTP_MAX_SUBSCRIBERS 4      // Leave connection slots for the API
+#define HTTP_SSE_PING_MS 15000
+#define HTTP_SSE_EVENT_LEN 192
+
+class AsyncHttpServer;
+struct HttpConnection;
+
+class HttpRequest {
+public:
+    const char* path() const { return reqPath; }
+    const char* ifNoneMatch() const { return etag; }
+    uint32_t remoteIP() const { return remoteAddr; }
+
+    // Copy the URL-decoded value of a query parameter into out.
+    // Returns false if the parameter is missing or does not fit.
+    bool arg(const char* name, char* out, size_t outLen) const;
+
+private:
+    friend class AsyncHttpServer;
+    const char* reqPath;
+    const char* reqQuery;
+    const char* etag;
+    uint32_t remoteAddr;
+};
+
+class HttpResponse {
+public:
+    // Extra header for the next send(); call before send()
+    void header(const char* name, const char* value);
+
+    // Body is copied into the connection's transmit buffer
+    void send(int code, const char* contentType, const char* body);
+    void send(int code) { send(code, "text/plain", ""); }
+
+    // Body is sent from flash or other memory that outlives the response
+    void sendStatic(int code, const char* contentType, const uint8_t* body, size_t len);
+
+    bool sent() const;
+
+private:
+    friend class AsyncHttpServer;
+    HttpConnection* conn;
+};
+
+typedef void (*HttpHandler)(const HttpRequest& request, HttpResponse& response);
+
+struct HttpServerStats {
+    uint32_t requests;
+    uint32_t rejected;   // Turned away at the connection limit
+    uint32_t timeouts;   // Closed for an incomplete request
+    uint32_t deferred;   // Handled from loop()
+    uint32_t events;     // Server-sent events pushed
+    uint8_t active;
+    uint8_t subscribers;
+};
+
+class AsyncHttpServer {
+public:
+    explicit AsyncHttpServer(uint16_t port);
+
+    // deferred handlers run from handleDeferred() on the loop() task
+    void on(const char* path, HttpHandler handler, bool deferred = false);
+
+    // Register a server-sent events endpoint
+    void onEvents(const char* path);
+
+    void begin();
+
+    // Push an event to every subscriber. Safe to call from any task,
+    // including handlers. Subscribers too slow to take it are dropped.
+    void broadcast(const char* event, const char* data);
+
+    // Run queued deferred handlers; call from loop()
+    void handleDeferred();
+
+    HttpServerStats stats() const;
+
+private:
+    struct Route {
+        const char* path;
+        HttpHandler handler;
+        bool deferred;
+        bool events;
+    };
+
+    AsyncServer tcp;
+    Route routes[HTTP_MAX_ROUTES];
+    size_t routeCount;
+    SemaphoreHandle_t lock;
+    QueueHandle_t deferredQueue;
+    HttpServerStats counters;
+    uint32_t rejectedAt;
+
+    void accept(AsyncClient* client);
+    void onData(HttpConnection& conn, const char* data, size_t len);
+    void onAck(HttpConnection& conn);
+    void onPoll(HttpConnection& conn);
+    void onDisconnect(HttpConnection& conn);
+
+    void process(HttpConnection& conn);
+    bool parse(HttpConnection& conn, HttpRequest& request);
+    void dispatch(HttpConnection& conn, const Route* route);
+    void subscribe(HttpConnection& conn);
+    void pump(HttpConnection& conn);
+    void finish(HttpConnection& conn);
+    void reply(HttpConnection& conn, int code, const char* body);
+    void release(HttpConnection& conn);
+    const Route* route(const char* path) const;
+};
+
+#endif // ASYNC_HTTP_SERVER_H
@@ -3,24 +3,56 @@
  * 
  * This example demonstrates a real-world IoT application using Web3:
  * - Token-based access control
- * - Challenge-response authentication
+ * - Challenge-response authentication, with format, rate and replay checks
+ *   ahead of signature recovery
  * - Integration with physical hardware (relays, sensors)
+ * - Merkle-anchored access log with inclusion proofs
+ * - Local token holder snapshot, so access decisions survive node outages
  * 
  * Based on AlphaWallet's office door implementation
  */
 
 #include <WiFi.h>
-#include <WebServer.h>
+#include <LittleFS.h>
+#include <time.h>
 #include <Web3.h>
 #include <Contract.h>
 #include <Crypto.h>
 #include <Util.h>
 
+#include "../../src/abi/access_log_anchor.h"
+#include "../../src/abi/erc721.h"
+#include "../../src/arena.h"
+#include "../../src/eip712.h"
+#include "../../src/hex.h"
+#include "../../src/rpc_client.h"
+#include "../../src/uint256.h"
+#include "access_log.h"
+#include "async_http_server.h"
+#include "challenge_table.h"
+#include "holder_snapshot.h"
+#include "sig_guard.h"
+#include "door_page.h"  // Generated from web/index.html by scripts/embed_assets.py
+
 // Configuration
 const char* WIFI_SSID = "YOUR_WIFI_SSID";
 const char* WIFI_PASSWORD = "YOUR_WIFI_PASSWORD";
 #define DOOR_CONTRACT "0x0000000000000000000000000000000000000000"  // Access token contract
+#ifndef SERVER_PORT
 #define SERVER_PORT 80
+#endif
+
+// Holder snapshot: built from Transfer logs, read through its own RPC client
+#define DOOR_RPC_URL "https://ethereum-sepolia-rpc.publicnode.com"
+#define DOOR_CONTRACT_BLOCK 0            // Deployment block of DOOR_CONTRACT; the snapshot stays off while 0
+#define HOLDER_FRESH_MS 300000           // Trust a local "holder" answer this long after the last sync
+#define HOLDER_OFFLINE_MS 86400000UL     // Fall back to an older snapshot while the node is down
+
+// Access log anchoring; the door's own account pays for one transaction per period
+#define ANCHOR_CONTRACT "0x0000000000000000000000000000000000000000"  // contracts/AccessLogAnchor.sol
+#define DOOR_ADDRESS "0x0000000000000000000000000000000000000000"
+#define DOOR_PRIVATE_KEY "0000000000000000000000000000000000000000000000000000000000000000"  // Testnet only!
+#define ANCHOR_RETRY_MS 60000
 
 // Hardware pins
 #define DOOR_RELAY_PIN 2
@@ -29,10 +61,39 @@ const char* WIFI_PASSWORD = "YOUR_WIFI_PASSWORD";
 
 // Global variables
 Web3* web3;
-WebServer server(SERVER_PORT);
-String currentChallenge;
-unsigned long challengeTime;
+AsyncHttpServer server(SERVER_PORT);
 const unsigned long CHALLENGE_TIMEOUT = 300000; // 5 minutes
+ChallengeTable challenges(CHALLENGE_TIMEOUT);     // One challenge per login attempt
+portMUX_TYPE challengeLock = portMUX_INITIALIZER_UNLOCKED;  // Shared by HTTP and loop tasks
+SigGuard sigGuard;                                // Format, rate and replay checks before recovery
+
+enum SigVerdict : uint8_t { VERDICT_PASS, VERDICT_NO_TOKEN, VERDICT_MISMATCH };
+const char* const VERDICT_REPLIES[] = {"pass", "fail: no access token", "fail: signature verification failed"};
+
+// Scratch memory for inline HTTP handlers, which all run on the AsyncTCP task
+static uint8_t httpArenaMemory[1024];
+Arena httpArena(httpArenaMemory, sizeof(httpArenaMemory));
+
+const unsigned long DOOR_OPEN_TIME = 5000;
+unsigned long doorOpenedAt = 0;
+bool doorOpen = false;
+
+// Access decisions are acted on from loop() once the HTTP response is out
+#define ACCESS_QUEUE_LEN 4
+struct AccessEvent {
+    bool granted;
+    char user[43];
+};
+AccessEvent accessEvents[ACCESS_QUEUE_LEN];
+uint8_t accessHead = 0;
+uint8_t accessCount = 0;
+
+AccessLog accessLog(LittleFS);
+unsigned long anchorRetryAt = 0;
+
+RpcClient rpc;
+HolderSnapshot holders(LittleFS, DOOR_CONTRACT, DOOR_CONTRACT_BLOCK);
+bool holdersReady = false;
 
 void setup() {
     Serial.begin(115200);
@@ -50,26 +111,62 @@ void setup() {
     // Initialize Web3
     web3 = new Web3(SEPOLIA_ID);
     
+    // Access log: entries carry wall-clock time once NTP has synced
+    configTime(0, 0, "pool.ntp.org");
+    if (!LittleFS.begin(true) || !accessLog.begin(millis())) {
+        Serial.println("Warning: access log unavailable");
+    } else {
+        Serial.printf("Access log: period %lu, %lu entries, %lu awaiting anchor\n",
+                      (unsigned long)accessLog.openPeriod(), (unsigned long)accessLog.openEntries(),
+                      (unsigned long)accessLog.unanchored());
+    }
+    
+    // Holder snapshot: resumes from flash, catches up from loop()
+    rpc.addEndpoint(DOOR_RPC_URL);
+    holdersReady = strlen(DOOR_CONTRACT) >= 10 && holders.begin();
+    if (holdersReady) {
+        holders.report(Serial, millis());
+    } else {
+        Serial.println("Holder snapshot off: set DOOR_CONTRACT and DOOR_CONTRACT_BLOCK");
+    }
+    
     // Setup web server
     setupWebServer();
     
-    // Generate initial challenge
-    updateChallenge();
-    
     Serial.println("Security door system ready!");
     Serial.print("Access URL: http://");
     Serial.println(WiFi.localIP());
 }
 
 void loop() {
-    server.handleClient();
+    // Socket I/O runs in the AsyncTCP task; only slow handlers run here
+    server.handleDeferred();
+    processAccessEvents();
+    
+    // Drop challenges nobody answered in time
+    portENTER_CRITICAL(&challengeLock);
+    size_t pending = challenges.live();
+    challenges.expire(millis());
+    bool expired = challenges.live() != pending;
+    portEXIT_CRITICAL(&challengeLock);
+    if (expired) {
+        publishChallenges();
+    }
     
-    // Update challenge periodically
-    if (millis() - challengeTime > CHALLENGE_TIMEOUT) {
-        updateChallenge();
+    // Close the door once the open time has passed
+    if (doorOpen && millis() - doorOpenedAt > DOOR_OPEN_TIME) {
+        closeDoor();
     }
     
-    delay(100);
+    // Close the log period when due and anchor its root
+    accessLog.roll(millis());
+    anchorAccessLog();
+    
+    if (holdersReady) {
+        holders.sync(rpc, millis());
+    }
+    
+    delay(10);
 }
 
 void setupHardware() {
@@ -110,247 +207,253 @@ void setupWebServer() {
     
     // API endpoints
     server.on("/api/getChallenge", handleGetChallenge);
-    server.on("/api/checkSignature", handleCheckSignature);
+    server.on("/api/checkSignature", handleCheckSignature, true);  // Recovery and RPC run from loop()
     server.on("/api/status", handleStatus);
+    server.on("/api/proof", handleProof, true);  // Rehashes the period from flash
+    server.onEvents("/api/events");  // Pushes door, challenge and access updates
     
     // Start server
     server.begin();
     Serial.println("Web server started");
 }
 
-void handleRoot() {
-    String html = generateDAppHTML();
-    server.send(200, "text/html", html);
+void handleRoot(const HttpRequest& request, HttpResponse& response) {
+    // Page is gzipped at build time and served straight from flash;
+    // a matching If-None-Match means the browser copy is still current
+    const char* etag = request.ifNoneMatch();
+    if (etag != nullptr && strcmp(etag, DOOR_PAGE_ETAG) == 0) {
+        response.header("ETag", DOOR_PAGE_ETAG);
+        response.send(304);
+        return;
+    }
+    
+    response.header("Content-Encoding", "gzip");
+    response.header("ETag", DOOR_PAGE_ETAG);
+    response.header("Cache-Control", "no-cache");
+    response.sendStatic(200, "text/html", DOOR_PAGE_GZ, DOOR_PAGE_GZ_LEN);
 }
 
-String generateDAppHTML() {
-    String html = R"(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>Blockchain Security Door</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            max-width: 500px;
-            margin: 50px auto;
-            padding: 20px;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: white;
-        }
-        .container {
-            background: rgba(255,255,255,0.1);
-            padding: 30px;
-            border-radius: 15px;
-            backdrop-filter: blur(10px);
-        }
-        button {
-            background: #4CAF50;
-            color: white;
-            padding: 15px 30px;
-            border: none;
-            border-radius: 8px;
-            cursor: pointer;
-            font-size: 16px;
-            width: 100%;
-            margin: 10px 0;
+void handleGetChallenge(const HttpRequest& request, HttpResponse& response) {
+    uint32_t id;
+    char challenge[CHALLENGE_TEXT_LEN];
+    ChallengeIssue result;
+    do {
+        id = esp_random();
+        uint32_t seed = esp_random();
+        portENTER_CRITICAL(&challengeLock);
+        result = challenges.issue(id, seed, request.remoteIP(), millis());
+        if (result == CHALLENGE_ISSUED) {
+            strcpy(challenge, challenges.find(id, millis()));
         }
-        button:hover {
-            background: #45a049;
-        }
-        .status {
-            margin: 20px 0;
-            padding: 15px;
-            border-radius: 8px;
-            background: rgba(255,255,255,0.1);
-        }
-        .error {
-            background: rgba(255,0,0,0.3);
-        }
-        .success {
-            background: rgba(0,255,0,0.3);
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>🔐 Blockchain Security Door</h1>
-        <p>Authenticate with your Ethereum wallet to access the door</p>
-        
-        <div id="status" class="status">
-            Ready to authenticate...
-        </div>
-        
-        <button onclick="openDoor()">Open Door</button>
-        <button onclick="checkStatus()">Check Status</button>
-        
-        <div style="margin-top: 20px; font-size: 12px; opacity: 0.7;">
-            <p>Requirements:</p>
-            <ul>
-                <li>MetaMask or Web3 wallet</li>
-                <li>Valid access token</li>
-                <li>Sepolia testnet</li>
-            </ul>
-        </div>
-    </div>
-
-    <script>
-        async function openDoor() {
-            const statusDiv = document.getElementById('status');
-            
-            try {
-                // Check if Web3 is available
-                if (typeof window.ethereum === 'undefined') {
-                    throw new Error('Please install MetaMask or another Web3 wallet');
-                }
-                
-                statusDiv.innerHTML = '🔄 Getting challenge...';
-                statusDiv.className = 'status';
-                
-                // Get challenge from device
-                const challengeResponse = await fetch('/api/getChallenge');
-                const challenge = await challengeResponse.text();
-                
-                statusDiv.innerHTML = '📝 Please sign the challenge in your wallet...';
-                
-                // Request account access
-                await window.ethereum.request({ method: 'eth_requestAccounts' });
-                
-                // Sign the challenge
-                const accounts = await window.ethereum.request({ method: 'eth_accounts' });
-                const signature = await window.ethereum.request({
-                    method: 'personal_sign',
-                    params: [challenge, accounts[0]]
-                });
-                
-                statusDiv.innerHTML = '🔍 Verifying signature...';
-                
-                // Send signature to device
-                const verifyResponse = await fetch(`/api/checkSignature?sig=${signature}&addr=${accounts[0]}`);
-                const result = await verifyResponse.text();
-                
-                if (result.includes('pass')) {
-                    statusDiv.innerHTML = '✅ Access granted! Door opening...';
-                    statusDiv.className = 'status success';
-                } else {
-                    statusDiv.innerHTML = '❌ Access denied: ' + result;
-                    statusDiv.className = 'status error';
-                }
-                
-            } catch (error) {
-                statusDiv.innerHTML = '❌ Error: ' + error.message;
-                statusDiv.className = 'status error';
-                console.error('Error:', error);
-            }
-        }
-        
-        async function checkStatus() {
-            try {
-                const response = await fetch('/api/status');
-                const status = await response.text();
-                document.getElementById('status').innerHTML = status;
-            } catch (error) {
-                console.error('Status check failed:', error);
-            }
-        }
-        
-        // Auto-refresh status every 10 seconds
-        setInterval(checkStatus, 10000);
-    </script>
-</body>
-</html>
-)";
-    return html;
-}
-
-void handleGetChallenge() {
-    updateChallenge();
-    server.send(200, "text/plain", currentChallenge);
+        portEXIT_CRITICAL(&challengeLock);
+    } while (result == CHALLENGE_COLLISION);
+    
+    if (result == CHALLENGE_FULL) {
+        response.header("Retry-After", "30");
+        response.send(503, "text/plain", "fail: too many pending challenges");
+        return;
+    }
+    
+    char body[96];
+    snprintf(body, sizeof(body), "{\"id\":\"%08lx\",\"challenge\":\"%s\"}", (unsigned long)id, challenge);
+    response.send(200, "application/json", body);
+    publishChallenges();
     
     Serial.print("Challenge generated: ");
-    Serial.println(currentChallenge);
+    Serial.println(challenge);
+}
+
+// Keccak of the EIP-191 personal_sign wrapping of the challenge text
+static void personalMessageHash(const char* message, uint8_t out[32]) {
+    char prefixed[CHALLENGE_TEXT_LEN + 32];
+    int len = snprintf(prefixed, sizeof(prefixed), "\x19" "Ethereum Signed Message:\n%u%s",
+                       (unsigned)strlen(message), message);
+    Crypto::Keccak256((const uint8_t*)prefixed, len, out);
 }
 
-void handleCheckSignature() {
-    String signature = server.arg("sig");
-    String userAddress = server.arg("addr");
+void handleCheckSignature(const HttpRequest& request, HttpResponse& response) {
+    char signature[140];
+    char userAddress[43] = "";
+    char challengeId[12] = "";
     
-    if (signature.length() == 0) {
-        server.send(400, "text/plain", "Missing signature parameter");
+    if (!request.arg("sig", signature, sizeof(signature))) {
+        response.send(400, "text/plain", "Missing signature parameter");
+        return;
+    }
+    request.arg("addr", userAddress, sizeof(userAddress));
+    request.arg("id", challengeId, sizeof(challengeId));
+    uint32_t id = strtoul(challengeId, nullptr, 16);
+    
+    // Cheap checks first; only a well-formed, new (challenge, signature)
+    // pair within the client's budget reaches recovery
+    uint8_t sig[65];
+    SigCheck format = sigGuard.parse(signature, sig);
+    if (format != SIG_OK) {
+        response.send(400, "text/plain", format == SIG_HIGH_S ? "fail: non-canonical signature" : "fail: malformed signature");
+        return;
+    }
+    uint8_t verdict;
+    if (sigGuard.recall(id, sig, millis(), &verdict)) {
+        response.send(200, "text/plain", VERDICT_REPLIES[verdict]);  // A retry; the door already acted on it
+        return;
+    }
+    if (!sigGuard.admit(request.remoteIP(), millis())) {
+        response.header("Retry-After", "2");
+        response.send(429, "text/plain", "fail: too many attempts");
+        return;
+    }
+    
+    // Each challenge is single use: take it out of the table before verifying
+    char challenge[CHALLENGE_TEXT_LEN];
+    portENTER_CRITICAL(&challengeLock);
+    bool known = challenges.consume(id, millis(), challenge, sizeof(challenge));
+    portEXIT_CRITICAL(&challengeLock);
+    publishChallenges();
+    if (!known) {
+        // Not logged: anyone can post made-up ids, and each log entry ends up in an anchor tx
+        response.send(200, "text/plain", "fail: unknown or expired challenge");
         return;
     }
     
     Serial.println("Checking signature...");
-    Serial.print("Signature: ");
-    Serial.println(signature);
     Serial.print("User Address: ");
     Serial.println(userAddress);
     
-    try {
-        // Recover address from signature
-        string sigStr = signature.c_str();
-        string challengeStr = currentChallenge.c_str();
-        string recoveredAddress = Crypto::ECRecoverFromPersonalMessage(&sigStr, &challengeStr);
-        
+    // Recover address from signature
+    uint8_t digest[32], recovered[20], claimed[20];
+    char recoveredHex[HEX_ADDRESS_CHARS];
+    personalMessageHash(challenge, digest);
+    bool claimedOk = Hex::parseAddress(userAddress, claimed);
+    if (!Eip712Signer::recover(digest, sig, recovered) || !claimedOk || memcmp(recovered, claimed, 20) != 0) {
+        verdict = VERDICT_MISMATCH;
+    } else {
         Serial.print("Recovered address: ");
-        Serial.println(recoveredAddress.c_str());
+        Serial.println(Hex::format(recovered, 20, recoveredHex, sizeof(recoveredHex)));
+        Serial.println("Address verification passed");
         
-        // Verify address matches
-        if (userAddress.equalsIgnoreCase(recoveredAddress.c_str())) {
-            Serial.println("Address verification passed");
-            
-            // Check if user has access token
-            bool hasToken = checkAccessToken(recoveredAddress);
-            
-            if (hasToken) {
-                server.send(200, "text/plain", "pass");
-                grantAccess(userAddress);
-                updateChallenge(); // Generate new challenge
-            } else {
-                server.send(200, "text/plain", "fail: no access token");
-                denyAccess(userAddress);
-            }
-        } else {
-            server.send(200, "text/plain", "fail: signature verification failed");
-            denyAccess(userAddress);
-        }
-        
-    } catch (const std::exception& e) {
-        Serial.print("Error in signature verification: ");
-        Serial.println(e.what());
-        server.send(500, "text/plain", "fail: verification error");
+        // Check if user has access token
+        verdict = checkAccessToken(recoveredHex) ? VERDICT_PASS : VERDICT_NO_TOKEN;
     }
+    
+    sigGuard.remember(id, sig, verdict, millis());
+    response.send(200, "text/plain", VERDICT_REPLIES[verdict]);
+    queueAccess(verdict == VERDICT_PASS, userAddress);
 }
 
-void handleStatus() {
-    String status = "🔐 Door Status: ";
-    status += digitalRead(DOOR_RELAY_PIN) ? "OPEN" : "LOCKED";
-    status += "<br>Challenge expires in: ";
-    status += String((CHALLENGE_TIMEOUT - (millis() - challengeTime)) / 1000);
-    status += " seconds";
+// Inclusion proof for one entry of a closed period, checkable with
+// AccessLogAnchor.verify() against the root the door anchored
+void handleProof(const HttpRequest& request, HttpResponse& response) {
+    char periodArg[12], indexArg[12];
+    if (!request.arg("period", periodArg, sizeof(periodArg)) || !request.arg("index", indexArg, sizeof(indexArg))) {
+        response.send(400, "text/plain", "Missing period or index parameter");
+        return;
+    }
+    
+    // Deferred handlers all run on the loop() task, one at a time
+    static AccessProof proof;
+    static char body[HTTP_TX_BUFFER - 160];
+    if (!accessLog.proof(strtoul(periodArg, nullptr, 10), strtoul(indexArg, nullptr, 10), &proof)) {
+        response.send(404, "text/plain", "No such entry in a closed period");
+        return;
+    }
     
-    server.send(200, "text/html", status);
+    char user[HEX_ADDRESS_CHARS], leaf[67], root[67];
+    int len = snprintf(body, sizeof(body),
+                       "{\"period\":%lu,\"index\":%lu,\"entries\":%lu,\"time\":%lu,\"granted\":%s,"
+                       "\"user\":\"%s\",\"leaf\":\"%s\",\"root\":\"%s\",\"tx\":",
+                       (unsigned long)proof.period, (unsigned long)proof.index, (unsigned long)proof.count,
+                       (unsigned long)proof.entry.time, proof.entry.granted ? "true" : "false",
+                       Hex::format(proof.entry.user, 20, user, sizeof(user)), Hex::format(proof.leaf, 32, leaf, sizeof(leaf)),
+                       Hex::format(proof.root, 32, root, sizeof(root)));
+    len += snprintf(body + len, sizeof(body) - len, proof.txHash[0] ? "\"%s\",\"proof\":[" : "null%s,\"proof\":[",
+                    proof.txHash);
+    for (uint8_t i = 0; i < proof.depth; i++) {
+        char sibling[67];
+        len += snprintf(body + len, sizeof(body) - len, "%s\"%s\"", i ? "," : "",
+                        Hex::format(proof.siblings[i], 32, sibling, sizeof(sibling)));
+    }
+    snprintf(body + len, sizeof(body) - len, "]}");
+    response.send(200, "application/json", body);
 }
 
-bool checkAccessToken(const string& userAddress) {
+void handleStatus(const HttpRequest& request, HttpResponse& response) {
+    ArenaScope scope(httpArena);
+    ArenaString status(httpArena, 512);
+    HttpServerStats http = server.stats();
+    
+    status.append("🔐 Door Status: ").append(digitalRead(DOOR_RELAY_PIN) ? "OPEN" : "LOCKED");
+    status.appendf("<br>Pending challenges: %u (issued %lu, rejected %lu, turned away %lu)",
+                   (unsigned)challenges.live(), (unsigned long)challenges.issuedTotal(),
+                   (unsigned long)challenges.rejectedTotal(), (unsigned long)challenges.turnedAwayTotal());
+    SigGuardStats guard = sigGuard.stats();
+    status.appendf("<br>Signatures: %lu recovered, %lu malformed, %lu rate limited, %lu repeats",
+                   (unsigned long)guard.admitted, (unsigned long)guard.malformed, (unsigned long)guard.limited,
+                   (unsigned long)guard.recalled);
+    status.appendf("<br>HTTP: %u open, %lu served, %lu turned away, %u listening",
+                   http.active, (unsigned long)http.requests, (unsigned long)http.rejected, http.subscribers);
+    status.appendf("<br>Access log: period %lu, %lu entries, %lu awaiting anchor",
+                   (unsigned long)accessLog.openPeriod(), (unsigned long)accessLog.openEntries(),
+                   (unsigned long)accessLog.unanchored());
+    if (holdersReady) {
+        status.appendf("<br>Holders: %lu at block %llu, %s", (unsigned long)holders.size(),
+                       (unsigned long long)holders.block(),
+                       holders.current(millis(), HOLDER_FRESH_MS) ? "current" : "stale");
+    }
+    
+    response.send(200, "text/html", status.c_str());
+}
+
+// A fresh snapshot answers for known holders; anyone it does not know may
+// have received a token since, so they get a live balance check. If the
+// node is unreachable, a snapshot up to HOLDER_OFFLINE_MS old still answers.
+bool checkAccessToken(const char* userAddress) {
     if (strlen(DOOR_CONTRACT) < 10) {
         Serial.println("Warning: No door contract configured, allowing access");
         return true; // Allow access if no contract is configured (for testing)
     }
     
+    uint8_t user[20];
+    bool parsed = Hex::parseAddress(userAddress, user);
+    if (holdersReady && parsed && holders.current(millis(), HOLDER_FRESH_MS) && holders.holds(user)) {
+        Serial.println("Token holder (local snapshot)");
+        return true;
+    }
+    
+    bool hasToken;
+    if (queryTokenBalance(userAddress, &hasToken)) {
+        return hasToken;
+    }
+    if (holdersReady && parsed && holders.current(millis(), HOLDER_OFFLINE_MS) && holders.holds(user)) {
+        Serial.printf("Node unreachable; token holder per snapshot from %lu s ago\n",
+                      (unsigned long)(holders.ageMs(millis()) / 1000));
+        return true;
+    }
+    return false;
+}
+
+bool queryTokenBalance(const char* userAddress, bool* hasToken) {
     try {
         Contract contract(web3, DOOR_CONTRACT);
         
         // Check ERC721 balance (NFT-based access)
-        string balanceParam = contract.SetupContractData("balanceOf(address)", &userAddress);
+        char data[Erc721Abi::BALANCE_OF_LEN + 1];
+        if (!Erc721Abi::balanceOf(data, sizeof(data), userAddress)) {
+            return false;
+        }
+        string balanceParam = data;
         string balanceResult = contract.ViewCall(&balanceParam);
-        uint256_t balance = web3->getUint256(&balanceResult);
+        UInt256 balance;
+        if (!Erc721Abi::decodeBalanceOf(balanceResult, &balance)) {
+            return false;
+        }
         
+        char balanceText[UINT256_DEC_CHARS];
+        balance.toDecimal(balanceText, sizeof(balanceText));
         Serial.print("User token balance: ");
-        Serial.println(balance.str().c_str());
+        Serial.println(balanceText);
         
-        return balance > 0;
+        *hasToken = balance > 0;
+        return true;
         
     } catch (const std::exception& e) {
         Serial.print("Error checking access token: ");
@@ -359,6 +462,116 @@ bool checkAccessToken(const string& userAddress) {
     }
 }
 
+void queueAccess(bool granted, const char* userAddress) {
+    if (accessCount == ACCESS_QUEUE_LEN) {
+        Serial.println("Access event queue full, dropping event");
+        return;
+    }
+    
+    // The address came from the client: only a well-formed one, re-encoded
+    // by us, ever reaches the log or the page
+    AccessEvent& event = accessEvents[(accessHead + accessCount) % ACCESS_QUEUE_LEN];
+    event.granted = granted;
+    uint8_t user[20];
+    if (Hex::parseAddress(userAddress, user)) {
+        Hex::format(user, 20, event.user, sizeof(event.user));
+    } else {
+        event.user[0] = '\0';
+    }
+    accessCount++;
+}
+
+void processAccessEvents() {
+    while (accessCount > 0) {
+        AccessEvent& event = accessEvents[accessHead];
+        accessHead = (accessHead + 1) % ACCESS_QUEUE_LEN;
+        accessCount--;
+        
+        char data[80];
+        if (event.user[0]) {
+            snprintf(data, sizeof(data), "{\"granted\":%s,\"user\":\"%s\"}",
+                     event.granted ? "true" : "false", event.user);
+        } else {
+            snprintf(data, sizeof(data), "{\"granted\":%s,\"user\":null}", event.granted ? "true" : "false");
+        }
+        server.broadcast("access", data);
+        logAccess(event.granted, event.user);
+        
+        if (event.granted) {
+            grantAccess(event.user);
+        } else {
+            denyAccess(event.user);
+        }
+    }
+}
+
+// Every decision goes to the flash log; time stays 0 until NTP has synced
+void logAccess(bool granted, const char* userAddress) {
+    time_t now = time(nullptr);
+    uint32_t stamp = now > 1600000000 ? (uint32_t)now : 0;
+    if (!accessLog.append(millis(), stamp, granted, userAddress)) {
+        Serial.println("Warning: access log write failed");
+    }
+}
+
+// One closed period per call. The hash is recorded once the node accepts
+// the transaction; the Anchored event confirms it made it into a block.
+void anchorAccessLog() {
+    if (accessLog.unanchored() == 0 || strlen(ANCHOR_CONTRACT) < 10 || (long)(millis() - anchorRetryAt) < 0) {
+        return;
+    }
+    uint32_t period, count;
+    uint8_t root[32];
+    if (!accessLog.pendingAnchor(&period, root, &count)) {
+        return;
+    }
+    anchorRetryAt = millis() + ANCHOR_RETRY_MS;
+    
+    try {
+        char data[AccessLogAnchorAbi::ANCHOR_LEN + 1];
+        if (!AccessLogAnchorAbi::anchor(data, sizeof(data), period, root, count)) {
+            return;
+        }
+        Contract contract(web3, ANCHOR_CONTRACT);
+        contract.SetPrivateKey(DOOR_PRIVATE_KEY);
+        
+        string doorAddress = DOOR_ADDRESS;
+        uint32_t nonce = (uint32_t)web3->EthGetTransactionCount(&doorAddress);
+        string to = ANCHOR_CONTRACT;
+        string param = data;
+        uint256_t value = 0;
+        string result = contract.SendTransaction(nonce, 20000000000ULL, 120000, &to, &value, &param);
+        string txHash = web3->getString(&result);
+        
+        if (txHash.length() == 66 && accessLog.markAnchored(period, txHash.c_str())) {
+            Serial.printf("Access log period %lu (%lu entries) anchored: %s\n", (unsigned long)period,
+                          (unsigned long)count, txHash.c_str());
+            anchorRetryAt = millis();  // Next backlog period right away
+            
+            char event[64];
+            snprintf(event, sizeof(event), "{\"period\":%lu,\"entries\":%lu}", (unsigned long)period,
+                     (unsigned long)count);
+            server.broadcast("anchor", event);
+        } else {
+            Serial.print("Anchor transaction rejected: ");
+            Serial.println(result.c_str());
+        }
+    } catch (const std::exception& e) {
+        Serial.print("Error anchoring access log: ");
+        Serial.println(e.what());
+    }
+}
+
+void publishChallenges() {
+    portENTER_CRITICAL(&challengeLock);
+    size_t pending = challenges.live();
+    portEXIT_CRITICAL(&challengeLock);
+    
+    char data[24];
+    snprintf(data, sizeof(data), "{\"pending\":%u}", (unsigned)pending);
+    server.broadcast("challenge", data);
+}
+
 void grantAccess(const String& userAddress) {
     Serial.println("ACCESS GRANTED");
     Serial.print("User: ");
@@ -383,14 +596,17 @@ void denyAccess(const String& userAddress) {
 void openDoor() {
     Serial.println("Opening door...");
     
-    // Activate door relay
+    // Activate door relay; loop() closes it after DOOR_OPEN_TIME
     digitalWrite(DOOR_RELAY_PIN, HIGH);
-    
-    // Keep door open for 5 seconds
-    delay(5000);
-    
-    // Close door
+    doorOpen = true;
+    doorOpenedAt = millis();
+    server.broadcast("door", "{\"state\":\"OPEN\"}");
+}
+
+void closeDoor() {
     digitalWrite(DOOR_RELAY_PIN, LOW);
+    doorOpen = false;
+    server.broadcast("door", "{\"state\":\"LOCKED\"}");
     
     Serial.println("Door closed");
 }
@@ -419,17 +635,4 @@ void signalAccess(bool granted) {
         digitalWrite(BUZZER_PIN, LOW);
         digitalWrite(STATUS_LED_PIN, HIGH); // Return to normal
     }
-}
-
-void updateChallenge() {
-    // Generate random challenge string
-    String words[] = {"apple", "banana", "cherry", "dragon", "eagle", "falcon", "grape", "honey"};
-    int randomWord = random(0, 8);
-    int randomNumber = random(10000, 99999);
-    
-    currentChallenge = words[randomWord] + " " + String(randomNumber);
-    challengeTime = millis();
-    
-    Serial.print("New challenge: ");
-    Serial.println(currentChallenge);
-} 
\ No newline at end of file
+}
\ No newline at end of file
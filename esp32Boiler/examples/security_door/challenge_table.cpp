@@ -0,0 +1,151 @@
+/*
+ * Challenge Table implementation
+ */
+
+#include "challenge_table.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* const CHALLENGE_WORDS[] = {
+    "apple", "banana", "cherry", "dragon", "eagle", "falcon", "grape", "honey"
+};
+
+ChallengeTable::ChallengeTable(uint32_t timeoutMs)
+    : timeoutMs(timeoutMs), liveCount(0), issued(0), rejected(0), evicted(0), turnedAway(0) {
+    memset(slots, 0, sizeof(slots));
+}
+
+size_t ChallengeTable::home(uint32_t id) {
+    // Fibonacci hashing spreads sequential or low-entropy ids across the table
+    return (size_t)((id * 2654435769u) >> 16) & (CHALLENGE_SLOTS - 1);
+}
+
+bool ChallengeTable::isExpired(const Slot& slot, uint32_t now) const {
+    return (uint32_t)(now - slot.issuedAt) > timeoutMs;
+}
+
+int ChallengeTable::locate(uint32_t id, uint32_t now) const {
+    size_t index = home(id);
+    for (size_t probe = 0; probe < CHALLENGE_SLOTS; probe++) {
+        const Slot& slot = slots[index];
+        if (slot.state == SLOT_EMPTY) {
+            return -1;
+        }
+        if (slot.state == SLOT_LIVE && slot.id == id) {
+            return isExpired(slot, now) ? -1 : (int)index;
+        }
+        index = (index + 1) & (CHALLENGE_SLOTS - 1);
+    }
+    return -1;
+}
+
+void ChallengeTable::release(Slot& slot) {
+    slot.state = SLOT_TOMBSTONE;
+    slot.id = 0;
+    slot.text[0] = '\0';
+    liveCount--;
+}
+
+ChallengeTable::Slot* ChallengeTable::oldestOf(uint32_t client, size_t* held) {
+    Slot* pick = nullptr;
+    *held = 0;
+    for (size_t i = 0; i < CHALLENGE_SLOTS; i++) {
+        Slot& slot = slots[i];
+        if (slot.state != SLOT_LIVE || slot.client != client) {
+            continue;
+        }
+        (*held)++;
+        if (pick == nullptr || (int32_t)(slot.issuedAt - pick->issuedAt) < 0) {
+            pick = &slot;
+        }
+    }
+    return pick;
+}
+
+ChallengeIssue ChallengeTable::issue(uint32_t id, uint32_t seed, uint32_t client, uint32_t now) {
+    if (id == 0) {
+        return CHALLENGE_COLLISION;
+    }
+
+    // Walk the probe sequence, remembering the first reusable slot. Expired
+    // entries are reclaimed in place.
+    Slot* target = nullptr;
+    size_t index = home(id);
+    for (size_t probe = 0; probe < CHALLENGE_SLOTS; probe++) {
+        Slot& slot = slots[index];
+        if (slot.state == SLOT_LIVE && isExpired(slot, now)) {
+            release(slot);
+        }
+        if (slot.state == SLOT_LIVE && slot.id == id) {
+            return CHALLENGE_COLLISION;
+        }
+        if (slot.state != SLOT_LIVE && target == nullptr) {
+            target = &slot;
+        }
+        if (slot.state == SLOT_EMPTY) {
+            break;
+        }
+        index = (index + 1) & (CHALLENGE_SLOTS - 1);
+    }
+
+    // A client at its quota gives up its own oldest challenge. With no
+    // reusable slot in the probe sequence the walk covered the whole table,
+    // so that slot is reachable from home(id) too.
+    size_t held;
+    Slot* own = oldestOf(client, &held);
+    if (own != nullptr && (held >= CHALLENGE_PER_CLIENT || target == nullptr)) {
+        release(*own);
+        evicted++;
+        if (target == nullptr) {
+            target = own;
+        }
+    }
+    if (target == nullptr) {
+        turnedAway++;
+        return CHALLENGE_FULL;
+    }
+
+    target->id = id;
+    target->issuedAt = now;
+    target->client = client;
+    target->state = SLOT_LIVE;
+    snprintf(target->text, sizeof(target->text), "%s %lu #%08lx",
+             CHALLENGE_WORDS[seed & 7], (unsigned long)(10000 + (seed >> 3) % 90000),
+             (unsigned long)id);
+    liveCount++;
+    issued++;
+    return CHALLENGE_ISSUED;
+}
+
+const char* ChallengeTable::find(uint32_t id, uint32_t now) const {
+    int index = locate(id, now);
+    return index < 0 ? nullptr : slots[index].text;
+}
+
+bool ChallengeTable::consume(uint32_t id, uint32_t now, char* out, size_t outLen) {
+    int index = locate(id, now);
+    if (index < 0) {
+        rejected++;
+        return false;
+    }
+
+    Slot& slot = slots[index];
+    strncpy(out, slot.text, outLen);
+    out[outLen - 1] = '\0';
+    release(slot);
+    return true;
+}
+
+void ChallengeTable::expire(uint32_t now) {
+    for (size_t i = 0; i < CHALLENGE_SLOTS; i++) {
+        if (slots[i].state == SLOT_LIVE && isExpired(slots[i], now)) {
+            release(slots[i]);
+        }
+    }
+
+    // With nothing live, clear tombstones so probe chains stay short
+    if (liveCount == 0) {
+        memset(slots, 0, sizeof(slots));
+    }
+}
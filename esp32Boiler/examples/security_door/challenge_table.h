@@ -0,0 +1,94 @@
+/*
+ * Challenge Table
+ *
+ * Fixed-size open-addressing table of outstanding login challenges for the
+ * security door. Every /api/getChallenge call issues its own challenge, so
+ * several users can authenticate at the same time without invalidating each
+ * other.
+ *
+ * - Slots are keyed by a random 32-bit challenge id (linear probing)
+ * - Entries expire after CHALLENGE_TIMEOUT milliseconds
+ * - consume() removes the entry, so a challenge can only be used once
+ * - Each client IP holds at most CHALLENGE_PER_CLIENT challenges; asking
+ *   for another replaces that client's own oldest one
+ * - When the table is full of other clients' live challenges, new ones are
+ *   turned away rather than evicting anyone, so a flood cannot push real
+ *   users' challenges out before they sign
+ *
+ * No heap allocation; the whole table lives in .bss.
+ */
+
+#ifndef CHALLENGE_TABLE_H
+#define CHALLENGE_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef CHALLENGE_SLOTS
+#define CHALLENGE_SLOTS 32  // Must be a power of two
+#endif
+
+#ifndef CHALLENGE_PER_CLIENT
+#define CHALLENGE_PER_CLIENT 4
+#endif
+
+#define CHALLENGE_TEXT_LEN 48
+
+enum ChallengeIssue : uint8_t {
+    CHALLENGE_ISSUED,
+    CHALLENGE_COLLISION,  // Id is 0 or already live; draw another
+    CHALLENGE_FULL        // No free slot and nothing of this client's to replace
+};
+
+class ChallengeTable {
+public:
+    explicit ChallengeTable(uint32_t timeoutMs);
+
+    // Issue a new challenge with the given random id for a client. The
+    // challenge text is written to the slot and can be read back with find()
+    // or consume().
+    ChallengeIssue issue(uint32_t id, uint32_t seed, uint32_t client, uint32_t now);
+
+    // Look up a live challenge without using it up.
+    const char* find(uint32_t id, uint32_t now) const;
+
+    // Take a live challenge out of the table. Copies its text into out and
+    // returns true; returns false if the id is unknown, expired or already used.
+    bool consume(uint32_t id, uint32_t now, char* out, size_t outLen);
+
+    // Drop expired entries. Cheap enough to call from loop().
+    void expire(uint32_t now);
+
+    size_t live() const { return liveCount; }
+    uint32_t issuedTotal() const { return issued; }
+    uint32_t rejectedTotal() const { return rejected; }
+    uint32_t evictedTotal() const { return evicted; }
+    uint32_t turnedAwayTotal() const { return turnedAway; }
+
+private:
+    enum SlotState : uint8_t { SLOT_EMPTY = 0, SLOT_LIVE, SLOT_TOMBSTONE };
+
+    struct Slot {
+        uint32_t id;
+        uint32_t issuedAt;
+        uint32_t client;
+        SlotState state;
+        char text[CHALLENGE_TEXT_LEN];
+    };
+
+    Slot slots[CHALLENGE_SLOTS];
+    uint32_t timeoutMs;
+    size_t liveCount;
+    uint32_t issued;
+    uint32_t rejected;
+    uint32_t evicted;
+    uint32_t turnedAway;
+
+    bool isExpired(const Slot& slot, uint32_t now) const;
+    int locate(uint32_t id, uint32_t now) const;
+    void release(Slot& slot);
+    Slot* oldestOf(uint32_t client, size_t* held);
+    static size_t home(uint32_t id);
+};
+
+#endif // CHALLENGE_TABLE_H
@@ -0,0 +1,144 @@
+/*
+ * Generated by scripts/embed_assets.py from index.html - do not edit.
+ * 6702 bytes raw, 2020 bytes gzipped.
+ */
+
+#ifndef DOOR_PAGE_H
+#define DOOR_PAGE_H
+
+#include <Arduino.h>
+
+#define DOOR_PAGE_ETAG "\"43495e24581b348e\""
+#define DOOR_PAGE_GZ_LEN 2020
+
+static const uint8_t DOOR_PAGE_GZ[DOOR_PAGE_GZ_LEN] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x59, 0x5b, 0x8f, 0xdb, 0xc6,
+    0x15, 0x7e, 0xf7, 0xaf, 0x38, 0x96, 0x9b, 0x90, 0x42, 0xb5, 0x94, 0x76, 0xed, 0xb5, 0x5b, 0xdd,
+    0x82, 0xcd, 0x7a, 0xdb, 0xa6, 0xf0, 0x25, 0xb0, 0x8c, 0x14, 0x85, 0x61, 0x24, 0x23, 0x72, 0x24,
+    0x4d, 0x96, 0xe2, 0xb0, 0xc3, 0xa1, 0x64, 0x75, 0xa3, 0xb7, 0xe4, 0x2d, 0x01, 0x0a, 0x34, 0x8f,
+    0x0d, 0xfa, 0xdf, 0xfa, 0x0b, 0xfa, 0x13, 0x7a, 0xce, 0x0c, 0x45, 0x89, 0x14, 0x29, 0x69, 0x1d,
+    0x54, 0x86, 0x21, 0x71, 0x2e, 0xe7, 0x7c, 0xe7, 0x3b, 0x97, 0x39, 0xc3, 0xed, 0x3f, 0x7c, 0xfe,
+    0xfa, 0xfa, 0xed, 0x5f, 0xbf, 0xbc, 0x81, 0x99, 0x9e, 0x87, 0xc3, 0x07, 0xfd, 0xcd, 0x17, 0x67,
+    0xc1, 0xf0, 0x01, 0xe0, 0xa7, 0xaf, 0x85, 0x0e, 0xf9, 0xf0, 0xf3, 0x50, 0xfa, 0xb7, 0xfe, 0x8c,
+    0x89, 0x08, 0x46, 0xdc, 0x4f, 0x95, 0xd0, 0x2b, 0x78, 0x2e, 0xa5, 0xea, 0xb7, 0xed, 0xbc, 0x5d,
+    0x3b, 0xe7, 0x9a, 0x41, 0xc4, 0xe6, 0x7c, 0xd0, 0x58, 0x08, 0xbe, 0x8c, 0xa5, 0xd2, 0x0d, 0xf0,
+    0x65, 0xa4, 0x79, 0xa4, 0x07, 0x8d, 0xa5, 0x08, 0xf4, 0x6c, 0x10, 0xf0, 0x85, 0xf0, 0xf9, 0x99,
+    0x79, 0x68, 0x81, 0x88, 0x84, 0x16, 0x2c, 0x3c, 0x4b, 0x7c, 0x16, 0xf2, 0xc1, 0x79, 0x23, 0x13,
+    0x94, 0xe8, 0xd5, 0x46, 0x28, 0x7d, 0xc6, 0x32, 0x58, 0xc1, 0x5d, 0xfe, 0x48, 0x9f, 0x09, 0x4a,
+    0x3d, 0x9b, 0xb0, 0xb9, 0x08, 0x57, 0x5d, 0xb8, 0x52, 0x28, 0xa3, 0x05, 0x09, 0x8b, 0x92, 0xb3,
+    0x84, 0x2b, 0x31, 0xe9, 0x15, 0xd6, 0xce, 0xd9, 0x07, 0xab, 0xaf, 0x0b, 0x97, 0x9d, 0x4e, 0xfc,
+    0xa1, 0x3c, 0xab, 0xa6, 0x22, 0xa2, 0xa9, 0xf8, 0x03, 0xb0, 0x54, 0xcb, 0xe2, 0x74, 0xcc, 0x82,
+    0x40, 0x44, 0xd3, 0x2e, 0x5c, 0xec, 0xed, 0x1c, 0x33, 0xff, 0x76, 0xaa, 0x64, 0x1a, 0x05, 0x5d,
+    0x08, 0x45, 0xc4, 0x99, 0x3a, 0x9b, 0x2a, 0x16, 0x08, 0xb4, 0xd6, 0x3d, 0x7f, 0x7c, 0x19, 0xf0,
+    0x69, 0x0b, 0x1e, 0x3d, 0x7d, 0xfa, 0x8c, 0x73, 0x06, 0x9d, 0x4f, 0xf0, 0xf7, 0xb3, 0xa7, 0x4f,
+    0xc6, 0xec, 0x02, 0xce, 0x3b, 0x9d, 0x4f, 0x9a, 0x45, 0x51, 0xbe, 0x0c, 0xa5, 0xea, 0xc2, 0x72,
+    0x26, 0x34, 0xdf, 0xce, 0xac, 0xf3, 0x5f, 0x1e, 0xb1, 0x88, 0xec, 0x73, 0x55, 0xe2, 0x61, 0x17,
+    0x83, 0x9a, 0x8e, 0x99, 0x7b, 0x71, 0x79, 0xd9, 0xda, 0xfc, 0xef, 0x78, 0xe7, 0xcd, 0x1a, 0x6b,
+    0x1e, 0xef, 0x5b, 0x23, 0x55, 0xc0, 0xd5, 0x19, 0x19, 0x90, 0x26, 0x5d, 0x38, 0xbf, 0xac, 0x32,
+    0x37, 0x50, 0x32, 0x3e, 0x9b, 0x88, 0x50, 0x73, 0x44, 0x3b, 0x0e, 0x53, 0xe5, 0x9e, 0xa3, 0xa0,
+    0x66, 0x15, 0xe4, 0x71, 0xaa, 0xb5, 0x8c, 0x0e, 0xc0, 0x7d, 0xf4, 0xe4, 0xfa, 0xea, 0x0f, 0x97,
+    0x9d, 0x53, 0x88, 0x28, 0x40, 0x27, 0x64, 0xb5, 0xf8, 0xbb, 0x10, 0xc9, 0x88, 0x1f, 0xb4, 0xec,
+    0x77, 0xe5, 0x9d, 0x18, 0xcf, 0x09, 0x29, 0x8d, 0xa5, 0xc0, 0x50, 0x55, 0xbd, 0xfd, 0x40, 0x4b,
+    0xc4, 0xdf, 0x39, 0x2a, 0x7e, 0x5a, 0xde, 0x99, 0x45, 0x15, 0x39, 0xb4, 0x3a, 0xa8, 0x88, 0x1d,
+    0xe8, 0xd4, 0xd3, 0xd3, 0x9d, 0xc9, 0xc5, 0x41, 0x9f, 0x3e, 0x7a, 0x72, 0xc9, 0x3a, 0x4f, 0x7e,
+    0x5f, 0x19, 0x13, 0x89, 0x66, 0x3a, 0x4d, 0x4a, 0x9b, 0x37, 0x9a, 0x2f, 0x4a, 0x9a, 0xf7, 0x28,
+    0xbc, 0x1f, 0x47, 0xf7, 0x88, 0xb3, 0x1d, 0x84, 0x5c, 0x29, 0x79, 0x52, 0xc4, 0x76, 0xe8, 0x9f,
+    0xf7, 0xb8, 0x5a, 0x4a, 0x92, 0xfa, 0x3e, 0x4f, 0x92, 0x63, 0x72, 0x3a, 0xad, 0x4c, 0x52, 0x85,
+    0x9c, 0x7e, 0x3b, 0x2b, 0x29, 0xfd, 0xb6, 0xad, 0x6d, 0x7d, 0xaa, 0x29, 0x59, 0xb5, 0x09, 0xc4,
+    0x02, 0xfc, 0x90, 0x25, 0xc9, 0xa0, 0x91, 0xa7, 0x59, 0x63, 0x5b, 0x7d, 0xfa, 0xb3, 0xf3, 0xe1,
+    0x7f, 0xff, 0xfd, 0xf3, 0x3f, 0xa0, 0xbe, 0x08, 0xe2, 0x8a, 0xed, 0xf2, 0x78, 0x78, 0x95, 0xea,
+    0x19, 0x16, 0x01, 0xe1, 0x33, 0xcd, 0x31, 0x46, 0xf4, 0x0c, 0x56, 0x32, 0x55, 0x70, 0x83, 0xa3,
+    0x8a, 0xa7, 0x73, 0x58, 0xb2, 0x30, 0xe4, 0x1a, 0xb4, 0x04, 0x66, 0x2d, 0xc3, 0x09, 0x08, 0x8c,
+    0xa4, 0x78, 0x2b, 0x68, 0x2b, 0x91, 0x00, 0x8a, 0x60, 0xd0, 0xb0, 0x0e, 0x6f, 0x6c, 0xc0, 0x66,
+    0x8f, 0xc3, 0x02, 0x2d, 0x6f, 0xd0, 0xbc, 0x95, 0x11, 0xbd, 0x03, 0xc2, 0xf3, 0xbc, 0xad, 0xb4,
+    0x36, 0x8a, 0x3b, 0xa4, 0x25, 0x14, 0x0b, 0x7e, 0x58, 0xc7, 0xb5, 0x8c, 0x22, 0xee, 0x6b, 0x0c,
+    0x25, 0x52, 0x44, 0xc0, 0x4f, 0x52, 0x90, 0x55, 0x04, 0x19, 0xf9, 0xa1, 0xf0, 0x6f, 0x07, 0x0d,
+    0x19, 0xf3, 0x88, 0xf8, 0x73, 0x9b, 0x8d, 0xe1, 0x6b, 0xfc, 0x9d, 0x91, 0x69, 0x97, 0x0d, 0xeb,
+    0xf7, 0xf9, 0x33, 0xee, 0xdf, 0x8e, 0x0c, 0x30, 0xda, 0x7a, 0x4d, 0x8f, 0x60, 0x9f, 0xf7, 0x77,
+    0x17, 0xed, 0x33, 0x51, 0x30, 0x68, 0xd8, 0x24, 0x39, 0xd3, 0x32, 0xce, 0xea, 0x7a, 0x21, 0xcd,
+    0x2f, 0x68, 0x40, 0xc6, 0xcc, 0x47, 0x07, 0x77, 0xa1, 0xe3, 0x3d, 0xeb, 0x95, 0xec, 0x47, 0x17,
+    0xbf, 0xe1, 0x7f, 0x4b, 0x85, 0xe2, 0x73, 0x64, 0x38, 0xe9, 0x16, 0xdc, 0x66, 0x16, 0xa4, 0x61,
+    0x71, 0xc0, 0x0c, 0x86, 0x62, 0xf8, 0x12, 0x4f, 0xc8, 0x97, 0x2c, 0xb9, 0x05, 0x4c, 0x8b, 0xbf,
+    0xf0, 0xf1, 0xe3, 0x2c, 0x14, 0xfa, 0x6d, 0x9c, 0xab, 0xdc, 0xf0, 0x15, 0x0b, 0x45, 0x90, 0x87,
+    0x89, 0xbc, 0xe5, 0x51, 0xfd, 0xda, 0x11, 0x8f, 0x65, 0x28, 0x18, 0x68, 0x9e, 0xe8, 0xa8, 0x4a,
+    0x68, 0xbf, 0xbd, 0x8b, 0x6b, 0xc7, 0x4f, 0xd9, 0xcf, 0xec, 0xf0, 0xf5, 0x95, 0x88, 0xf5, 0x76,
+    0x1d, 0x4b, 0x56, 0x91, 0x0f, 0x93, 0x34, 0x42, 0x8f, 0x93, 0x1b, 0x72, 0xaf, 0x95, 0x12, 0x12,
+    0x73, 0x27, 0xd1, 0x60, 0x03, 0xe6, 0x39, 0x72, 0x3d, 0xc0, 0xc8, 0xf0, 0x53, 0x62, 0xc8, 0x9b,
+    0x72, 0x7d, 0x13, 0x1a, 0xb2, 0x3e, 0x5f, 0x7d, 0x11, 0xb8, 0x8e, 0x5d, 0xe4, 0x94, 0x0e, 0xa7,
+    0xc2, 0x83, 0x56, 0xe5, 0x23, 0x9f, 0x3e, 0xed, 0x36, 0x58, 0x77, 0x8b, 0x89, 0xe5, 0x4f, 0x24,
+    0xc0, 0x16, 0x4c, 0x84, 0x6c, 0x1c, 0xf2, 0xbd, 0xd5, 0xb8, 0xc8, 0xd5, 0xab, 0x98, 0xcb, 0x09,
+    0x66, 0x61, 0x14, 0xc8, 0xa5, 0xc7, 0x37, 0x29, 0x38, 0x18, 0x0c, 0xc0, 0xc1, 0xda, 0xc1, 0x27,
+    0x98, 0xed, 0x81, 0xd3, 0xac, 0xd0, 0x65, 0x50, 0xcc, 0x94, 0x5c, 0x42, 0xc4, 0x97, 0x70, 0x43,
+    0xa5, 0xcc, 0x75, 0xbe, 0x0c, 0x39, 0x4b, 0x38, 0xf6, 0x2d, 0x68, 0x42, 0x18, 0xc2, 0xae, 0x3f,
+    0x59, 0x24, 0x49, 0xfa, 0xae, 0x5f, 0xcb, 0x16, 0x16, 0x0b, 0x5b, 0xa5, 0xdd, 0xf4, 0xc9, 0x39,
+    0xf4, 0x34, 0xff, 0xa0, 0xaf, 0x6d, 0x03, 0x85, 0x7c, 0x3a, 0x58, 0x86, 0xbe, 0x87, 0x3f, 0x72,
+    0x6d, 0x52, 0x0f, 0x2b, 0x11, 0xea, 0x88, 0xa6, 0x94, 0xdd, 0x4e, 0xef, 0x80, 0x10, 0x93, 0xca,
+    0xaf, 0xb0, 0x2d, 0x23, 0x11, 0x19, 0xf5, 0xbd, 0xe3, 0x28, 0x90, 0x6b, 0x54, 0x05, 0x6c, 0xab,
+    0x08, 0x90, 0x48, 0x2a, 0x64, 0x72, 0x19, 0xc1, 0x44, 0xc9, 0xb9, 0xad, 0x5b, 0xa6, 0xa1, 0xdb,
+    0xdb, 0x6d, 0xa3, 0x21, 0xdf, 0xfa, 0x86, 0x27, 0x31, 0x8e, 0x10, 0x04, 0xb6, 0x64, 0x42, 0xc3,
+    0x84, 0x6b, 0x7f, 0xe6, 0x3a, 0x6d, 0x16, 0x8b, 0x36, 0x86, 0xc7, 0xf5, 0x66, 0x61, 0x15, 0x65,
+    0xe4, 0xc7, 0x87, 0x7b, 0xa2, 0x3c, 0x79, 0x7b, 0xaa, 0xdb, 0xac, 0xca, 0x7d, 0x09, 0x44, 0xaf,
+    0xdb, 0x3c, 0xc9, 0x49, 0xd6, 0x9e, 0x3b, 0xac, 0x90, 0xad, 0x1d, 0x42, 0xd6, 0xb9, 0x3d, 0xfb,
+    0xc2, 0xbf, 0x4d, 0x64, 0xe4, 0x36, 0x7b, 0xbf, 0xca, 0xdd, 0xff, 0xfc, 0x05, 0xb2, 0x88, 0x4b,
+    0xc4, 0x34, 0x32, 0x7c, 0x6f, 0x95, 0xe3, 0x39, 0x64, 0xce, 0x15, 0x1b, 0x6b, 0xd5, 0x51, 0x50,
+    0xe5, 0x55, 0xaa, 0x5d, 0x58, 0x22, 0xa8, 0xaa, 0xe0, 0xf1, 0xa9, 0xb3, 0xea, 0xb2, 0xb7, 0xd2,
+    0xda, 0x55, 0x4a, 0x1c, 0x4f, 0xd9, 0xcd, 0xee, 0x1d, 0x60, 0xb7, 0x3f, 0x93, 0x78, 0xf8, 0x3a,
+    0xf8, 0xfd, 0x75, 0x36, 0x7c, 0x65, 0x45, 0x26, 0x0e, 0xac, 0x9b, 0xa7, 0x81, 0x19, 0xed, 0xd9,
+    0x55, 0x43, 0x7d, 0x86, 0x36, 0xc9, 0x19, 0x3f, 0x11, 0x19, 0x3b, 0x08, 0x29, 0x2b, 0x5a, 0x08,
+    0x02, 0x7d, 0xa0, 0xf8, 0x71, 0xe1, 0x95, 0xf1, 0x96, 0x2b, 0x8c, 0x39, 0xb6, 0x92, 0x11, 0x0b,
+    0xbf, 0x26, 0x89, 0x4e, 0xab, 0x72, 0x71, 0xcc, 0x14, 0x9b, 0x63, 0x8f, 0xf5, 0x2e, 0xb7, 0xb8,
+    0x95, 0x1b, 0xf7, 0xae, 0xf3, 0xfe, 0xfd, 0x7e, 0x30, 0xfe, 0xca, 0x20, 0xfa, 0xf9, 0x27, 0xf8,
+    0x8a, 0x6e, 0x45, 0x2b, 0xaa, 0x1a, 0xb9, 0xa9, 0xa7, 0xc7, 0xcb, 0x88, 0x47, 0xc1, 0x0e, 0x45,
+    0x74, 0xe4, 0x1f, 0xca, 0xf9, 0x85, 0xd1, 0x55, 0x93, 0xf0, 0xdf, 0x98, 0x84, 0xb7, 0x27, 0xf8,
+    0x46, 0xe2, 0x67, 0xd8, 0x75, 0xfc, 0xe6, 0x4e, 0x04, 0xeb, 0x4f, 0x51, 0x09, 0xfe, 0xca, 0x55,
+    0xad, 0x3f, 0xc5, 0x86, 0x55, 0xe1, 0xc8, 0x0e, 0x3d, 0xeb, 0x6f, 0x6a, 0xbd, 0xa8, 0x78, 0x92,
+    0x86, 0x3a, 0x57, 0x58, 0xc4, 0x91, 0xe5, 0xfa, 0x09, 0x16, 0x53, 0xb5, 0xb1, 0xa2, 0x3c, 0x81,
+    0x2d, 0x47, 0x1a, 0xf0, 0xc4, 0x75, 0x62, 0x2c, 0xa1, 0x4e, 0xb3, 0xae, 0xde, 0xd4, 0x92, 0xff,
+    0x9f, 0x7f, 0xfd, 0x00, 0x57, 0xf6, 0xf0, 0xc6, 0xab, 0x21, 0x0e, 0x07, 0x0f, 0x4d, 0x97, 0x63,
+    0x4e, 0x51, 0x74, 0x47, 0xb5, 0x13, 0x8e, 0x96, 0x6f, 0xc8, 0x5a, 0xe2, 0x8a, 0xbd, 0x6b, 0xe0,
+    0x21, 0xb2, 0x7e, 0x5f, 0x9c, 0xbf, 0xfc, 0xb8, 0xc1, 0x19, 0x20, 0x30, 0x4e, 0xb1, 0x0c, 0xbf,
+    0xcd, 0x18, 0xfd, 0x18, 0x80, 0xa6, 0xf3, 0x77, 0xee, 0x7d, 0xfa, 0xad, 0x01, 0xdb, 0x55, 0x7f,
+    0x06, 0xae, 0xd9, 0x5f, 0x45, 0xf7, 0x41, 0x13, 0x4c, 0xb5, 0xb7, 0xd0, 0x8d, 0x00, 0x6f, 0x8e,
+    0x16, 0xb1, 0x29, 0xbf, 0xe7, 0xe9, 0x58, 0x8b, 0x9e, 0xe2, 0x4c, 0x86, 0xdc, 0xde, 0x6b, 0x5c,
+    0xc7, 0xaa, 0x73, 0x5a, 0x76, 0x7d, 0x29, 0xb6, 0xd6, 0x15, 0x57, 0x99, 0xba, 0x9e, 0xaa, 0xd0,
+    0xd1, 0x96, 0x8c, 0xae, 0x6e, 0x84, 0xf2, 0x88, 0xaf, 0x3f, 0x55, 0xab, 0x9b, 0xac, 0x72, 0xa7,
+    0x96, 0x6f, 0x55, 0xc7, 0x12, 0xe5, 0x68, 0x37, 0x87, 0xe9, 0x82, 0x37, 0xa7, 0x3f, 0xbd, 0x7d,
+    0xf9, 0x02, 0x85, 0xda, 0xc1, 0xde, 0x3d, 0xbd, 0x5b, 0x22, 0xd8, 0x52, 0x62, 0xe9, 0x81, 0x09,
+    0xb6, 0x79, 0x18, 0x98, 0x1f, 0x43, 0x37, 0x16, 0xb1, 0x17, 0x78, 0xab, 0x31, 0x57, 0x15, 0x83,
+    0x8c, 0x43, 0x9c, 0x26, 0x33, 0x1e, 0xc0, 0x78, 0xb5, 0xd3, 0xc4, 0x80, 0xb9, 0x8c, 0x27, 0x5c,
+    0xe1, 0xd7, 0x59, 0x42, 0x71, 0xc5, 0x17, 0xd4, 0xe0, 0x3f, 0x28, 0x12, 0x47, 0x17, 0x24, 0xb4,
+    0xf0, 0xce, 0x88, 0xc3, 0x68, 0xa3, 0x24, 0x6e, 0x01, 0x26, 0xb4, 0xbd, 0x5c, 0x47, 0x69, 0x18,
+    0xb6, 0x00, 0xa3, 0x4a, 0xdb, 0xdf, 0xb0, 0xee, 0x55, 0x22, 0xba, 0x21, 0xd9, 0x10, 0x30, 0xcd,
+    0xa8, 0x8b, 0x4d, 0x66, 0xd4, 0x55, 0x31, 0x6c, 0xf2, 0x91, 0xfe, 0x16, 0xf6, 0x2e, 0x04, 0x05,
+    0x8f, 0x8a, 0x04, 0x41, 0xe2, 0x28, 0xde, 0x58, 0x6e, 0xd3, 0x38, 0xdf, 0x9e, 0x47, 0x8e, 0x42,
+    0xad, 0x5c, 0x91, 0x71, 0x35, 0xfd, 0x38, 0xbd, 0x98, 0x22, 0x27, 0xbf, 0x73, 0xcc, 0x1d, 0xd6,
+    0x14, 0x1f, 0x4b, 0xab, 0xcd, 0x13, 0x32, 0xc6, 0x23, 0x43, 0xde, 0x17, 0xf9, 0xa4, 0x2a, 0x68,
+    0xe6, 0x32, 0xbb, 0xe0, 0x21, 0x76, 0xcc, 0x64, 0x4e, 0xd3, 0x8a, 0xf4, 0x88, 0x40, 0xec, 0x87,
+    0xb3, 0xd9, 0xfc, 0x2c, 0xdb, 0x15, 0x9b, 0x6d, 0x6d, 0xd6, 0x48, 0x26, 0x8a, 0x8a, 0xd2, 0x5e,
+    0x30, 0x3a, 0xe8, 0xb5, 0xe6, 0xf3, 0x58, 0xef, 0xc8, 0x31, 0x0b, 0x7b, 0x15, 0xc6, 0x05, 0x87,
+    0xaf, 0x19, 0xb4, 0xb9, 0x1c, 0xff, 0xc1, 0x7e, 0xe5, 0x28, 0x25, 0xba, 0x05, 0x34, 0x91, 0xea,
+    0x86, 0x61, 0x2e, 0xb9, 0xf4, 0xd8, 0x02, 0xd1, 0x84, 0xc1, 0xb0, 0x22, 0x60, 0xc9, 0x18, 0x9c,
+    0x23, 0xa9, 0x2c, 0x26, 0x7b, 0xaf, 0x67, 0x22, 0x0c, 0xdc, 0x1c, 0x92, 0xaf, 0x38, 0x46, 0x5b,
+    0x86, 0xca, 0x75, 0xc6, 0xca, 0xa9, 0x6a, 0x37, 0x8f, 0x6c, 0x7f, 0x8b, 0x78, 0x5f, 0xc9, 0x80,
+    0x1b, 0x2c, 0xe5, 0xfd, 0xeb, 0xca, 0x97, 0x26, 0x75, 0x95, 0x06, 0xb3, 0x1c, 0x9f, 0x0f, 0xc4,
+    0xcb, 0x47, 0x94, 0x94, 0x23, 0xfc, 0x17, 0xca, 0xc2, 0x91, 0x5a, 0x53, 0x61, 0x00, 0x31, 0x9c,
+    0x75, 0x63, 0x26, 0x63, 0x46, 0xd8, 0xf2, 0xfa, 0xbc, 0x1a, 0xbc, 0x4d, 0x57, 0x54, 0x63, 0x5a,
+    0xff, 0xed, 0xea, 0x0c, 0xbe, 0x9d, 0x2e, 0xc3, 0xb7, 0xa3, 0x9e, 0x8c, 0xe8, 0x4c, 0xc6, 0xbd,
+    0x5b, 0x8a, 0x7a, 0xf6, 0xc2, 0x69, 0x6a, 0x56, 0x1a, 0x03, 0x9b, 0x68, 0xcc, 0x49, 0xec, 0x0d,
+    0x9a, 0x7e, 0xfe, 0x02, 0xa4, 0x4a, 0x12, 0x36, 0x2d, 0x46, 0xf7, 0x0b, 0x91, 0x60, 0x88, 0x71,
+    0xac, 0x63, 0x94, 0x5f, 0x58, 0x22, 0x5c, 0x5e, 0x13, 0x45, 0x79, 0x12, 0xa2, 0xfa, 0x3f, 0x8f,
+    0x5e, 0xbf, 0xf2, 0x4c, 0xe2, 0xbb, 0x38, 0x86, 0xd5, 0xa1, 0x69, 0x5e, 0xf4, 0x55, 0x9c, 0x61,
+    0xbb, 0xb9, 0x5f, 0x1f, 0x13, 0x07, 0x81, 0xe5, 0x69, 0x7b, 0x14, 0xdd, 0xa6, 0x0c, 0x54, 0x02,
+    0xcc, 0x26, 0xff, 0x2f, 0x10, 0xed, 0xed, 0xe4, 0x10, 0xbe, 0xfc, 0x7e, 0x40, 0xed, 0x4b, 0x15,
+    0xbe, 0x5e, 0xb5, 0x49, 0x54, 0x56, 0x70, 0xbd, 0x6b, 0x77, 0x7a, 0x59, 0x83, 0x06, 0x9f, 0xd9,
+    0xb6, 0x6d, 0xf3, 0x88, 0xed, 0xae, 0x03, 0x5d, 0xdb, 0x5f, 0xd8, 0xde, 0xc8, 0x0c, 0x35, 0xb1,
+    0x38, 0x6d, 0x76, 0xa6, 0x78, 0x64, 0xc0, 0x77, 0xdf, 0x81, 0xc3, 0x22, 0xbc, 0x94, 0x2d, 0xec,
+    0x2b, 0x1b, 0xec, 0x5c, 0x09, 0x77, 0xf3, 0x63, 0x49, 0xa9, 0x6c, 0xe4, 0x30, 0x1c, 0x5f, 0x49,
+    0x18, 0x8d, 0x6e, 0xb0, 0x03, 0x8c, 0xe9, 0xef, 0x2b, 0xf4, 0xd6, 0x1a, 0x8f, 0x18, 0x3a, 0x2d,
+    0x56, 0x70, 0xde, 0xc1, 0xc3, 0x0b, 0xd9, 0x08, 0x8a, 0x97, 0xb9, 0x84, 0xeb, 0x2f, 0xe8, 0xc5,
+    0x36, 0x02, 0x73, 0xb7, 0xc1, 0xdd, 0xa2, 0xd7, 0xd6, 0x9d, 0x4e, 0xd5, 0xab, 0xd2, 0xec, 0x05,
+    0x50, 0xbf, 0x6d, 0x5f, 0x92, 0xf6, 0xdb, 0xf6, 0xcf, 0x42, 0xff, 0x03, 0x26, 0x30, 0x6d, 0xae,
+    0x2e, 0x1a, 0x00, 0x00,
+};
+
+#endif // DOOR_PAGE_H
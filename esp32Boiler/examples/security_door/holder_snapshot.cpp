@@ -0,0 +1,347 @@
+/*
+ * Holder Snapshot implementation
+ */
+
+#include "holder_snapshot.h"
+
+#include <algorithm>
+
+#include "../../src/abi/erc721.h"
+#include "../../src/hex.h"
+
+#define HOLDER_MAGIC 0x31534E48           // "HNS1"
+#define HOLDER_HEADER_SIZE 36             // magic, count, block, contract
+#define HOLDER_TEMP_FILE "/holders.tmp"
+
+static const uint8_t ZERO_ADDRESS[20] = {0};
+
+static void putLE(uint8_t* p, uint64_t v, int n) {
+    for (int i = 0; i < n; i++) {
+        p[i] = v >> (8 * i);
+    }
+}
+
+static uint64_t getLE(const uint8_t* p, int n) {
+    uint64_t v = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+HolderSnapshot::HolderSnapshot(fs::FS& fs, const char* contract, uint64_t startBlock)
+    : fs(fs), contract(contract), startBlock(startBlock), synced(0), saved(0), holders(0),
+      window(HOLDER_WINDOW_BLOCKS), polledAt(0), syncedAt(0), caughtUp(false), polled(false),
+      filterHits(0), filterMisses(0), falseHits(0), deltaCount(0), overflow(false) {
+    memset(bloom, 0, sizeof(bloom));
+}
+
+// ===== FILTER =====
+void HolderSnapshot::addToFilter(const uint8_t address[20]) {
+    for (int i = 0; i < HOLDER_BLOOM_HASHES; i++) {
+        uint32_t bit = (address[2 * i] | address[2 * i + 1] << 8) % HOLDER_BLOOM_BITS;
+        bloom[bit >> 3] |= 1 << (bit & 7);
+    }
+}
+
+bool HolderSnapshot::mayHold(const uint8_t address[20]) const {
+    for (int i = 0; i < HOLDER_BLOOM_HASHES; i++) {
+        uint32_t bit = (address[2 * i] | address[2 * i + 1] << 8) % HOLDER_BLOOM_BITS;
+        if (!(bloom[bit >> 3] & (1 << (bit & 7)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HolderSnapshot::holds(const uint8_t address[20]) {
+    if (!mayHold(address)) {
+        filterMisses++;
+        return false;
+    }
+    filterHits++;
+
+    File f = fs.open(HOLDER_SNAPSHOT_FILE, FILE_READ);
+    if (!f) {
+        return false;
+    }
+    uint32_t lo = 0, hi = holders;
+    uint8_t record[HOLDER_RECORD_SIZE];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!f.seek(HOLDER_HEADER_SIZE + mid * HOLDER_RECORD_SIZE) ||
+            f.read(record, sizeof(record)) != sizeof(record)) {
+            return false;
+        }
+        int order = memcmp(record, address, 20);
+        if (order == 0) {
+            return getLE(record + 20, 2) > 0;
+        }
+        if (order < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    falseHits++;
+    return false;
+}
+
+// ===== TABLE =====
+bool HolderSnapshot::begin() {
+    // Block 0 would mean scanning the whole chain, and from a wrong block
+    // the holders who received before it are missing
+    uint8_t configured[20];
+    if (startBlock == 0 || !Hex::parseAddress(contract, configured)) {
+        return false;
+    }
+    synced = saved = startBlock - 1;
+    holders = 0;
+    memset(bloom, 0, sizeof(bloom));
+
+    File f = fs.open(HOLDER_SNAPSHOT_FILE, FILE_READ);
+    uint8_t header[HOLDER_HEADER_SIZE];
+    if (!f || f.read(header, sizeof(header)) != sizeof(header) || getLE(header, 4) != HOLDER_MAGIC ||
+        memcmp(header + 16, configured, 20) != 0) {
+        f.close();
+        fs.remove(HOLDER_SNAPSHOT_FILE);
+        return saveHeader();        // Empty table; scan from the start block
+    }
+
+    uint32_t count = getLE(header + 4, 4);
+    uint8_t record[HOLDER_RECORD_SIZE];
+    for (uint32_t i = 0; i < count; i++) {
+        if (f.read(record, sizeof(record)) != sizeof(record)) {
+            return false;
+        }
+        addToFilter(record);
+    }
+    holders = count;
+    synced = saved = getLE(header + 8, 8);
+    return true;
+}
+
+bool HolderSnapshot::saveHeader() {
+    File f = fs.open(HOLDER_SNAPSHOT_FILE, fs.exists(HOLDER_SNAPSHOT_FILE) ? "r+" : FILE_WRITE);
+    if (!f) {
+        return false;
+    }
+    uint8_t header[HOLDER_HEADER_SIZE];
+    putLE(header, HOLDER_MAGIC, 4);
+    putLE(header + 4, holders, 4);
+    putLE(header + 8, synced, 8);
+    Hex::parseAddress(contract, header + 16);
+    bool ok = f.write(header, sizeof(header)) == sizeof(header);
+    saved = ok ? synced : saved;
+    return ok;
+}
+
+void HolderSnapshot::addDelta(const uint8_t address[20], int32_t change) {
+    for (size_t i = 0; i < deltaCount; i++) {
+        if (memcmp(deltas[i].address, address, 20) == 0) {
+            deltas[i].change += change;
+            return;
+        }
+    }
+    if (deltaCount == HOLDER_DELTA_MAX) {
+        // Progress is recorded per window, so merging part of one is only
+        // done once the window cannot shrink any further
+        if (window > 1) {
+            overflow = true;
+            return;
+        }
+        if (!merge()) {
+            overflow = true;        // Back at the saved block; the window is read again
+            return;
+        }
+    }
+    memcpy(deltas[deltaCount].address, address, 20);
+    deltas[deltaCount].change = change;
+    deltaCount++;
+}
+
+void HolderSnapshot::applyTransfer(const uint8_t from[20], const uint8_t to[20]) {
+    if (memcmp(from, ZERO_ADDRESS, 20) != 0) {      // Not a mint
+        addDelta(from, -1);
+    }
+    if (memcmp(to, ZERO_ADDRESS, 20) != 0) {        // Not a burn
+        addDelta(to, 1);
+    }
+}
+
+// Stream the sorted table and the sorted deltas into a new table, then
+// swap it in and rebuild the filter from it
+bool HolderSnapshot::merge() {
+    if (deltaCount == 0) {
+        return true;
+    }
+    std::sort(deltas, deltas + deltaCount,
+              [](const Delta& a, const Delta& b) { return memcmp(a.address, b.address, 20) < 0; });
+
+    // Every current holder has to be copied over: a table that cannot be
+    // read is an error, not an empty one
+    File in = fs.open(HOLDER_SNAPSHOT_FILE, FILE_READ);
+    if (holders > 0 && (!in || !in.seek(HOLDER_HEADER_SIZE))) {
+        return abortMerge();
+    }
+    File out = fs.open(HOLDER_TEMP_FILE, FILE_WRITE);
+    if (!out) {
+        return abortMerge();
+    }
+    uint8_t header[HOLDER_HEADER_SIZE] = {0};
+    out.write(header, sizeof(header));              // Rewritten below with the count
+
+    memset(bloom, 0, sizeof(bloom));
+    uint32_t remaining = holders;
+    uint32_t written = 0;
+    size_t d = 0;
+    uint8_t record[HOLDER_RECORD_SIZE];
+    bool haveRecord = false;
+    while (remaining > 0 || haveRecord || d < deltaCount) {
+        if (!haveRecord && remaining > 0) {
+            if (in.read(record, sizeof(record)) != sizeof(record)) {
+                out.close();
+                return abortMerge();
+            }
+            haveRecord = true;
+            remaining--;
+        }
+        int order = !haveRecord ? 1 : d == deltaCount ? -1 : memcmp(record, deltas[d].address, 20);
+        uint8_t next[HOLDER_RECORD_SIZE];
+        int64_t balance;
+        if (order <= 0) {
+            memcpy(next, record, 20);
+            balance = (int64_t)getLE(record + 20, 2) + (order == 0 ? deltas[d++].change : 0);
+            haveRecord = false;
+        } else {
+            memcpy(next, deltas[d].address, 20);
+            balance = deltas[d++].change;
+        }
+        if (balance <= 0) {
+            continue;               // Sold out, or a sender first seen before the start block
+        }
+        putLE(next + 20, balance > 0xFFFF ? 0xFFFF : balance, 2);
+        if (out.write(next, sizeof(next)) != sizeof(next)) {
+            out.close();
+            return abortMerge();
+        }
+        addToFilter(next);
+        written++;
+    }
+    in.close();
+
+    putLE(header, HOLDER_MAGIC, 4);
+    putLE(header + 4, written, 4);
+    putLE(header + 8, synced, 8);
+    Hex::parseAddress(contract, header + 16);
+    out.seek(0);
+    out.write(header, sizeof(header));
+    out.close();
+
+    fs.remove(HOLDER_SNAPSHOT_FILE);
+    if (!fs.rename(HOLDER_TEMP_FILE, HOLDER_SNAPSHOT_FILE)) {
+        return abortMerge();
+    }
+    holders = written;
+    saved = synced;
+    deltaCount = 0;
+    return true;
+}
+
+// Drop the deltas and go back to the table in flash; the blocks since it
+// was saved are read again on the next sync
+bool HolderSnapshot::abortMerge() {
+    fs.remove(HOLDER_TEMP_FILE);
+    deltaCount = 0;
+    begin();
+    return false;
+}
+
+// ===== SYNC =====
+// Walk the "topics" arrays of an eth_getLogs reply: [Transfer, from, to, tokenId]
+bool HolderSnapshot::applyLogs(const std::string& response) {
+    if (response.find("\"result\":[") == std::string::npos) {
+        return false;
+    }
+    size_t at = 0;
+    while ((at = response.find("\"topics\":[", at)) != std::string::npos) {
+        at += 10;
+        uint8_t parties[2][20];
+        bool ok = true;
+        for (int t = 0; t < 3 && ok; t++) {
+            size_t open = response.find('"', at);
+            ok = open != std::string::npos && open + 67 < response.size() && response[open + 67] == '"';
+            if (ok && t > 0) {
+                ok = Hex::decode(response.c_str() + open + 27, parties[t - 1], 20);
+            }
+            at = open + 68;
+        }
+        // ERC-20 tokens emit the same topic with 3 topics; only ERC-721 has 4
+        if (ok && response.compare(at, 2, ",\"") == 0) {
+            applyTransfer(parties[0], parties[1]);
+        }
+    }
+    return true;
+}
+
+bool HolderSnapshot::sync(RpcClient& rpc, uint32_t now) {
+    if (polled && caughtUp && now - polledAt < HOLDER_POLL_MS) {
+        return true;
+    }
+    polled = true;
+    polledAt = now;
+
+    std::string response;
+    uint64_t head;
+    if (!rpc.read("eth_blockNumber", "[]", &response) || !RpcClient::resultQuantity(response, &head)) {
+        return false;
+    }
+    uint64_t target = head > HOLDER_CONFIRMATIONS ? head - HOLDER_CONFIRMATIONS : 0;
+    if (synced >= target) {
+        caughtUp = true;
+        syncedAt = now;
+        return true;
+    }
+
+    uint64_t from = synced + 1;
+    uint64_t to = std::min<uint64_t>(target, from + window - 1);
+    char params[256];
+    snprintf(params, sizeof(params),
+             "[{\"address\":\"%s\",\"topics\":[\"%s\"],\"fromBlock\":\"0x%llx\",\"toBlock\":\"0x%llx\"}]",
+             contract, Erc721Abi::TRANSFER_TOPIC, (unsigned long long)from, (unsigned long long)to);
+    if (!rpc.read("eth_getLogs", params, &response)) {
+        return false;
+    }
+    overflow = false;
+    bool parsed = applyLogs(response);
+    if (!parsed || overflow) {
+        // "Too many results" from the provider, or too many holders changed
+        // for one merge: retry with a smaller range
+        deltaCount = 0;
+        window = window > 1 ? window / 2 : 1;
+        return overflow;
+    }
+
+    synced = to;
+    bool ok = deltaCount > 0 ? merge() : synced - saved < HOLDER_SAVE_BLOCKS || saveHeader();
+    window = std::min<uint32_t>(window * 2, HOLDER_WINDOW_BLOCKS);
+    if (synced >= target) {
+        caughtUp = true;
+        syncedAt = now;
+    }
+    return ok;
+}
+
+bool HolderSnapshot::current(uint32_t now, uint32_t maxAgeMs) const {
+    return caughtUp && now - syncedAt <= maxAgeMs;
+}
+
+void HolderSnapshot::report(Print& out, uint32_t now) const {
+    char age[24] = "catching up";
+    if (caughtUp) {
+        snprintf(age, sizeof(age), "%lu s old", (unsigned long)((now - syncedAt) / 1000));
+    }
+    out.printf("Holders: %lu at block %llu, %s, filter %lu hits / %lu misses / %lu false\n",
+               (unsigned long)holders, (unsigned long long)synced, age,
+               (unsigned long)filterHits, (unsigned long)filterMisses, (unsigned long)falseHits);
+}
@@ -0,0 +1,104 @@
+/*
+ * Holder Snapshot
+ *
+ * Local copy of who holds the door's access token, so most decisions need
+ * no RPC and the door keeps working while the node is unreachable. Built
+ * from the token's ERC-721 Transfer logs (eth_getLogs) and then kept up to
+ * date incrementally, a block window per poll.
+ *
+ * - Exact table in flash (HOLDER_SNAPSHOT_FILE): header, then 22-byte
+ *   records (address, balance) sorted by address, searched by bisection
+ * - Bloom filter over the same addresses in RAM: a miss answers "not in
+ *   the snapshot" without touching flash; a hit is confirmed by the table
+ * - Logs are read HOLDER_CONFIRMATIONS behind the head, so reorged
+ *   transfers are not applied; balance changes are collected per window
+ *   and merged into a new table file in one sequential pass
+ * - Addresses are already Keccak output, so the filter takes its bit
+ *   positions straight from the address bytes
+ *
+ * The snapshot has to start at or before the token's deployment block
+ * (DOOR_CONTRACT_BLOCK in the door); transfers before that are not seen.
+ * begin() refuses a start block of 0.
+ */
+
+#ifndef HOLDER_SNAPSHOT_H
+#define HOLDER_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <string>
+
+#include "../../src/rpc_client.h"
+
+#define HOLDER_SNAPSHOT_FILE "/holders.bin"
+#define HOLDER_BLOOM_BITS 16384           // 2 KB; ~0.25% false hits at 1024 holders
+#define HOLDER_BLOOM_HASHES 4
+#define HOLDER_RECORD_SIZE 22
+#define HOLDER_DELTA_MAX 64               // Distinct addresses per merge
+#define HOLDER_CONFIRMATIONS 6
+#define HOLDER_WINDOW_BLOCKS 2000         // eth_getLogs range; halved on provider errors
+#define HOLDER_POLL_MS 15000              // Once caught up
+#define HOLDER_SAVE_BLOCKS 5000           // Persist progress without changes this often
+
+class HolderSnapshot {
+public:
+    HolderSnapshot(fs::FS& fs, const char* contract, uint64_t startBlock);
+
+    // Load the table and rebuild the filter. A table for another contract
+    // is discarded. False without a start block or a valid contract
+    // address. Call once the filesystem is mounted.
+    bool begin();
+
+    // One step of catching up with the chain; call from loop(). Polls every
+    // HOLDER_POLL_MS once caught up, every call while behind.
+    bool sync(RpcClient& rpc, uint32_t now);
+
+    // Bloom filter only: false means definitely not in the snapshot
+    bool mayHold(const uint8_t address[20]) const;
+
+    // Filter, then the exact table
+    bool holds(const uint8_t address[20]);
+
+    // Caught up to the head at some point within maxAgeMs
+    bool current(uint32_t now, uint32_t maxAgeMs) const;
+    uint32_t ageMs(uint32_t now) const { return caughtUp ? now - syncedAt : UINT32_MAX; }
+
+    uint64_t block() const { return synced; }
+    uint32_t size() const { return holders; }
+    void report(Print& out, uint32_t now) const;
+
+private:
+    struct Delta {
+        uint8_t address[20];
+        int32_t change;
+    };
+
+    fs::FS& fs;
+    const char* contract;
+    uint64_t startBlock;
+    uint64_t synced;                  // Last block applied
+    uint64_t saved;                   // Block recorded in flash
+    uint32_t holders;
+    uint32_t window;
+    uint32_t polledAt;
+    uint32_t syncedAt;
+    bool caughtUp;
+    bool polled;
+    uint32_t filterHits;
+    uint32_t filterMisses;
+    uint32_t falseHits;
+    uint8_t bloom[HOLDER_BLOOM_BITS / 8];
+    Delta deltas[HOLDER_DELTA_MAX];
+    size_t deltaCount;
+    bool overflow;
+
+    void applyTransfer(const uint8_t from[20], const uint8_t to[20]);
+    void addDelta(const uint8_t address[20], int32_t change);
+    bool merge();
+    bool abortMerge();
+    bool saveHeader();
+    void addToFilter(const uint8_t address[20]);
+    bool applyLogs(const std::string& response);
+};
+
+#endif // HOLDER_SNAPSHOT_H
@@ -0,0 +1,125 @@
+/*
+ * Signature Guard implementation
+ */
+
+#include "sig_guard.h"
+
+#include <string.h>
+
+#include "../../src/hex.h"
+
+// secp256k1 group order n, and n / 2
+static const uint8_t CURVE_ORDER[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41,
+};
+static const uint8_t HALF_ORDER[32] = {
+    0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x5D, 0x57, 0x6E, 0x73, 0x57, 0xA4, 0x50, 0x1D, 0xDF, 0xE9, 0x2F, 0x46, 0x68, 0x1B, 0x20, 0xA0,
+};
+
+static bool isZero(const uint8_t* p, size_t n) {
+    uint8_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc |= p[i];
+    }
+    return acc == 0;
+}
+
+SigGuard::SigGuard() : nextVerdict(0) {
+    memset(clients, 0, sizeof(clients));
+    memset(&global, 0, sizeof(global));
+    global.tokens = SIG_GUARD_GLOBAL_BURST;
+    memset(cache, 0, sizeof(cache));
+    memset(&counters, 0, sizeof(counters));
+}
+
+// ===== FORMAT =====
+SigCheck SigGuard::parse(const char* hex, uint8_t out[65]) {
+    if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex += 2;
+    }
+    if (strnlen(hex, 131) != 130 || !Hex::decode(hex, out, 65)) {
+        counters.malformed++;
+        return SIG_MALFORMED;
+    }
+    uint8_t v = out[64];
+    if ((v != 0 && v != 1 && v != 27 && v != 28) || isZero(out, 32) || isZero(out + 32, 32) ||
+        memcmp(out, CURVE_ORDER, 32) >= 0) {
+        counters.malformed++;
+        return SIG_MALFORMED;
+    }
+    if (memcmp(out + 32, HALF_ORDER, 32) > 0) {
+        counters.malformed++;
+        return SIG_HIGH_S;
+    }
+    out[64] = v < 27 ? v + 27 : v;
+    return SIG_OK;
+}
+
+// ===== RATE LIMIT =====
+void SigGuard::refill(Bucket& b, uint8_t burst, uint32_t refillMs, uint32_t now) {
+    uint32_t earned = (now - b.refilledAt) / refillMs;
+    if (earned == 0) {
+        return;
+    }
+    b.tokens = b.tokens + earned >= burst ? burst : b.tokens + earned;
+    b.refilledAt = b.tokens == burst ? now : b.refilledAt + earned * refillMs;
+}
+
+// Existing bucket for the client, or the least recently seen one reset
+// for it. Evicting an address hands it a full bucket, which is no more
+// than a new client would get.
+SigGuard::Bucket& SigGuard::bucketFor(uint32_t client, uint32_t now) {
+    Bucket* victim = &clients[0];
+    for (Bucket& b : clients) {
+        if (b.lastSeen != 0 && b.client == client) {
+            return b;
+        }
+        if (victim->lastSeen != 0 && (b.lastSeen == 0 || (int32_t)(b.lastSeen - victim->lastSeen) < 0)) {
+            victim = &b;
+        }
+    }
+    victim->client = client;
+    victim->tokens = SIG_GUARD_BURST;
+    victim->refilledAt = now;
+    victim->lastSeen = now;
+    return *victim;
+}
+
+bool SigGuard::admit(uint32_t client, uint32_t now) {
+    Bucket& b = bucketFor(client, now);
+    b.lastSeen = now ? now : 1;
+    refill(b, SIG_GUARD_BURST, SIG_GUARD_REFILL_MS, now);
+    refill(global, SIG_GUARD_GLOBAL_BURST, SIG_GUARD_GLOBAL_REFILL_MS, now);
+    if (b.tokens == 0 || global.tokens == 0) {
+        counters.limited++;
+        return false;
+    }
+    b.tokens--;
+    global.tokens--;
+    counters.admitted++;
+    return true;
+}
+
+// ===== VERDICT CACHE =====
+bool SigGuard::recall(uint32_t challengeId, const uint8_t signature[65], uint32_t now, uint8_t* verdict) {
+    for (const Verdict& v : cache) {
+        if (v.challengeId == challengeId && challengeId != 0 && now - v.storedAt <= SIG_GUARD_CACHE_MS &&
+            memcmp(v.signature, signature, 65) == 0) {
+            *verdict = v.verdict;
+            counters.recalled++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SigGuard::remember(uint32_t challengeId, const uint8_t signature[65], uint8_t verdict, uint32_t now) {
+    Verdict& v = cache[nextVerdict];
+    nextVerdict = (nextVerdict + 1) % SIG_GUARD_CACHE;
+    v.challengeId = challengeId;
+    v.storedAt = now;
+    memcpy(v.signature, signature, 65);
+    v.verdict = verdict;
+}
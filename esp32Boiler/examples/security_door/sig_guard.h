@@ -0,0 +1,87 @@
+/*
+ * Signature Guard
+ *
+ * Cheap checks in front of public key recovery for /api/checkSignature.
+ * Recovery is tens of milliseconds of CPU per request, so a client that
+ * posts signatures in a loop could otherwise keep real users out.
+ *
+ * - parse(): exactly 65 bytes of hex into a fixed buffer, r and s in
+ *   range, s in the lower half of the curve order (as every wallet signs),
+ *   v as 0/1 or 27/28; anything else is rejected before recovery
+ * - admit(): token bucket per client address plus one shared bucket, so
+ *   neither one client nor many together exceed the recovery budget
+ * - recall()/remember(): verdicts of recent (challenge, signature) pairs;
+ *   a resubmitted pair gets its earlier answer without another recovery
+ *
+ * No heap allocation; the tables live in .bss.
+ */
+
+#ifndef SIG_GUARD_H
+#define SIG_GUARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIG_GUARD_CLIENTS 16
+#define SIG_GUARD_BURST 3              // Recoveries a client may run back to back
+#define SIG_GUARD_REFILL_MS 2000       // One more per client this often
+#define SIG_GUARD_GLOBAL_BURST 8
+#define SIG_GUARD_GLOBAL_REFILL_MS 250 // Caps recovery at ~4 per second overall
+#define SIG_GUARD_CACHE 16
+#define SIG_GUARD_CACHE_MS 60000
+
+enum SigCheck : uint8_t {
+    SIG_OK = 0,
+    SIG_MALFORMED,         // Wrong length, not hex, or r/s/v out of range
+    SIG_HIGH_S,            // Malleated: s above half the curve order
+};
+
+struct SigGuardStats {
+    uint32_t malformed;
+    uint32_t limited;
+    uint32_t recalled;
+    uint32_t admitted;
+};
+
+class SigGuard {
+public:
+    SigGuard();
+
+    // "0x" + 130 hex digits into r || s || v with v normalised to 27/28
+    SigCheck parse(const char* hex, uint8_t out[65]);
+
+    // Take one recovery token for client; false means try again later
+    bool admit(uint32_t client, uint32_t now);
+
+    // Verdict stored for this challenge and signature, if still cached
+    bool recall(uint32_t challengeId, const uint8_t signature[65], uint32_t now, uint8_t* verdict);
+    void remember(uint32_t challengeId, const uint8_t signature[65], uint8_t verdict, uint32_t now);
+
+    SigGuardStats stats() const { return counters; }
+
+private:
+    struct Bucket {
+        uint32_t client;
+        uint32_t refilledAt;
+        uint32_t lastSeen;
+        uint8_t tokens;
+    };
+
+    struct Verdict {
+        uint32_t challengeId;         // 0 = empty
+        uint32_t storedAt;
+        uint8_t signature[65];
+        uint8_t verdict;
+    };
+
+    Bucket clients[SIG_GUARD_CLIENTS];
+    Bucket global;
+    Verdict cache[SIG_GUARD_CACHE];
+    uint8_t nextVerdict;
+    SigGuardStats counters;
+
+    Bucket& bucketFor(uint32_t client, uint32_t now);
+    static void refill(Bucket& b, uint8_t burst, uint32_t refillMs, uint32_t now);
+};
+
+#endif // SIG_GUARD_H
@@ -13,6 +13,8 @@
 #include <Contract.h>
 #include <Util.h>
 
+#include "../../src/amount.h"
+
 // Configuration
 const char* WIFI_SSID = "YOUR_WIFI_SSID";
 const char* WIFI_PASSWORD = "YOUR_WIFI_PASSWORD";
@@ -71,10 +73,10 @@ void runERC20Examples() {
     delay(2000);
     
     // Example 3: Transfer tokens (commented out for safety)
-    // transferTokens(USDC_CONTRACT, "0x742d35Cc6734C5c3d8D654B2C6d1d9BfbFD31930", 1);
+    // transferTokens(USDC_CONTRACT, "0x742d35Cc6734C5c3d8D654B2C6d1d9BfbFD31930", "1");
     
     // Example 4: Approve token spending
-    // approveTokens(USDC_CONTRACT, "0x742d35Cc6734C5c3d8D654B2C6d1d9BfbFD31930", 100);
+    // approveTokens(USDC_CONTRACT, "0x742d35Cc6734C5c3d8D654B2C6d1d9BfbFD31930", "100");
 }
 
 void getTokenInfo(const char* tokenContract) {
@@ -104,7 +106,8 @@ void getTokenInfo(const char* tokenContract) {
         string supplyParam = contract.SetupContractData("totalSupply()");
         string supplyResult = contract.ViewCall(&supplyParam);
         uint256_t totalSupply = web3->getUint256(&supplyResult);
-        string supplyStr = Util::ConvertWeiToEthString(&totalSupply, decimals);
+        char supplyStr[AMOUNT_MAX_CHARS];
+        Amount::format(totalSupply, decimals, supplyStr, sizeof(supplyStr));
         
         Serial.print("Name: ");
         Serial.println(tokenName.c_str());
@@ -113,7 +116,7 @@ void getTokenInfo(const char* tokenContract) {
         Serial.print("Decimals: ");
         Serial.println(decimals);
         Serial.print("Total Supply: ");
-        Serial.print(supplyStr.c_str());
+        Serial.print(supplyStr);
         Serial.print(" ");
         Serial.println(tokenSymbol.c_str());
         
@@ -141,10 +144,11 @@ void checkTokenBalance(const char* tokenContract) {
         string balanceResult = contract.ViewCall(&balanceParam);
         uint256_t tokenBalance = web3->getUint256(&balanceResult);
         
-        string balanceStr = Util::ConvertWeiToEthString(&tokenBalance, decimals);
+        char balanceStr[AMOUNT_MAX_CHARS];
+        Amount::format(tokenBalance, decimals, balanceStr, sizeof(balanceStr));
         
         Serial.print("Your balance: ");
-        Serial.print(balanceStr.c_str());
+        Serial.print(balanceStr);
         Serial.println(" tokens");
         
         // Also show raw balance
@@ -158,7 +162,7 @@ void checkTokenBalance(const char* tokenContract) {
     }
 }
 
-void transferTokens(const char* tokenContract, const char* toAddress, double amount) {
+void transferTokens(const char* tokenContract, const char* toAddress, const char* amount) {
     Serial.println("\n=== Transferring Tokens ===");
     Serial.print("To: ");
     Serial.println(toAddress);
@@ -177,8 +181,12 @@ void transferTokens(const char* tokenContract, const char* toAddress, double amo
         string decimalsResult = contract.ViewCall(&decimalsParam);
         int decimals = web3->getInt(&decimalsResult);
         
-        // Convert amount to wei
-        uint256_t transferAmount = Util::ConvertToWei(amount, decimals);
+        // Convert the decimal amount to base units exactly
+        uint256_t transferAmount;
+        if (!Amount::parse(amount, decimals, &transferAmount)) {
+            Serial.println("Invalid amount");
+            return;
+        }
         
         // Get transaction details
         uint32_t nonceVal = (uint32_t)web3->EthGetTransactionCount(&myAddress);
@@ -208,7 +216,7 @@ void transferTokens(const char* tokenContract, const char* toAddress, double amo
     }
 }
 
-void approveTokens(const char* tokenContract, const char* spenderAddress, double amount) {
+void approveTokens(const char* tokenContract, const char* spenderAddress, const char* amount) {
     Serial.println("\n=== Approving Token Spending ===");
     Serial.print("Spender: ");
     Serial.println(spenderAddress);
@@ -227,8 +235,12 @@ void approveTokens(const char* tokenContract, const char* spenderAddress, double
         string decimalsResult = contract.ViewCall(&decimalsParam);
         int decimals = web3->getInt(&decimalsResult);
         
-        // Convert amount to wei
-        uint256_t approveAmount = Util::ConvertToWei(amount, decimals);
+        // Convert the decimal amount to base units exactly
+        uint256_t approveAmount;
+        if (!Amount::parse(amount, decimals, &approveAmount)) {
+            Serial.println("Invalid amount");
+            return;
+        }
         
         // Get transaction details
         uint32_t nonceVal = (uint32_t)web3->EthGetTransactionCount(&myAddress);
@@ -275,10 +287,11 @@ void checkAllowance(const char* tokenContract, const char* ownerAddress, const c
         string allowanceResult = contract.ViewCall(&allowanceParam);
         uint256_t allowance = web3->getUint256(&allowanceResult);
         
-        string allowanceStr = Util::ConvertWeiToEthString(&allowance, decimals);
+        char allowanceStr[AMOUNT_MAX_CHARS];
+        Amount::format(allowance, decimals, allowanceStr, sizeof(allowanceStr));
         
         Serial.print("Allowance: ");
-        Serial.print(allowanceStr.c_str());
+        Serial.print(allowanceStr);
         Serial.println(" tokens");
         
     } catch (const std::exception& e) {
@@ -294,9 +307,10 @@ void checkAllBalances() {
     string myAddress = MY_ADDRESS;
     try {
         uint256_t ethBalance = web3->EthGetBalance(&myAddress);
-        string ethBalanceStr = Util::ConvertWeiToEthString(&ethBalance, 18);
+        char ethBalanceStr[AMOUNT_MAX_CHARS];
+        Amount::format(ethBalance, 18, ethBalanceStr, sizeof(ethBalanceStr));
         Serial.print("ETH Balance: ");
-        Serial.print(ethBalanceStr.c_str());
+        Serial.print(ethBalanceStr);
         Serial.println(" ETH");
     } catch (const std::exception& e) {
         Serial.print("Error checking ETH balance: ");
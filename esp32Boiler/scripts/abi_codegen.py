@@ -0,0 +1,373 @@
+"""
+Contract binding generator
+
+Reads contract ABI JSON files and writes one C++ header per contract with
+typed bindings, so call sites stop hand-writing signature strings that
+Web3E re-hashes with Keccak on every call:
+
+- constexpr 4-byte selectors (and event topics), hashed here at build time
+- encoders that write 0x-hex calldata into a caller buffer without
+  allocating, with a *_LEN constant for functions with static arguments
+- typed decoders for return values, reading the raw JSON-RPC reply
+
+The runtime they use is src/abi.h.
+
+Usage:
+    python scripts/abi_codegen.py [abi_dir] [out_dir]
+
+Defaults are abi/ and src/abi/. It also runs as a PlatformIO pre-build
+script (extra_scripts in platformio.ini). Headers are only rewritten when
+their content changes, so unchanged ABIs do not trigger a rebuild.
+"""
+
+import json
+import os
+import re
+import sys
+
+# ===== KECCAK-256 =====
+# Pure Python so the build needs no extra packages. This is the original
+# Keccak padding (0x01) that Ethereum uses, not NIST SHA3-256 (0x06).
+
+_RC = [
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808A, 0x8000000080008000,
+    0x000000000000808B, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008A, 0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+    0x000000008000808B, 0x800000000000008B, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800A, 0x800000008000000A,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+]
+_ROT = [
+    [0, 36, 3, 41, 18],
+    [1, 44, 10, 45, 2],
+    [62, 6, 43, 15, 61],
+    [28, 55, 25, 21, 56],
+    [27, 20, 39, 8, 14],
+]
+_MASK = (1 << 64) - 1
+
+
+def _rol(x, n):
+    return ((x << n) | (x >> (64 - n))) & _MASK if n else x
+
+
+def _keccak_f(a):
+    for rc in _RC:
+        c = [a[x][0] ^ a[x][1] ^ a[x][2] ^ a[x][3] ^ a[x][4] for x in range(5)]
+        d = [c[(x - 1) % 5] ^ _rol(c[(x + 1) % 5], 1) for x in range(5)]
+        a = [[a[x][y] ^ d[x] for y in range(5)] for x in range(5)]
+        b = [[0] * 5 for _ in range(5)]
+        for x in range(5):
+            for y in range(5):
+                b[y][(2 * x + 3 * y) % 5] = _rol(a[x][y], _ROT[x][y])
+        a = [[b[x][y] ^ ((~b[(x + 1) % 5][y]) & b[(x + 2) % 5][y]) for y in range(5)] for x in range(5)]
+        a[0][0] ^= rc
+    return a
+
+
+def keccak256(data):
+    rate = 136
+    msg = bytearray(data) + b"\x01"
+    while len(msg) % rate:
+        msg += b"\x00"
+    msg[-1] |= 0x80
+
+    a = [[0] * 5 for _ in range(5)]
+    for off in range(0, len(msg), rate):
+        for i in range(rate // 8):
+            a[i % 5][i // 5] ^= int.from_bytes(msg[off + 8 * i:off + 8 * i + 8], "little")
+        a = _keccak_f(a)
+    return b"".join(a[i % 5][i // 5].to_bytes(8, "little") for i in range(4))
+
+
+# ===== TYPE MAPPING =====
+CPP_KEYWORDS = {"operator", "delete", "new", "default", "class", "register", "template",
+                "this", "union", "switch", "case", "short", "long", "signed", "unsigned"}
+# Names the generated bodies use themselves
+RESERVED = CPP_KEYWORDS | {"out", "len", "w", "r", "tail", "response"}
+
+
+def canonical(param):
+    t = param["type"]
+    if t.startswith("tuple"):
+        inner = ",".join(canonical(c) for c in param["components"])
+        return "(" + inner + ")" + t[len("tuple"):]
+    return t
+
+
+def signature(item):
+    return "%s(%s)" % (item["name"], ",".join(canonical(p) for p in item["inputs"]))
+
+
+def screaming(name):
+    return re.sub(r"(?<=[a-z0-9])(?=[A-Z])", "_", name).upper()
+
+
+def arg_name(param, index):
+    name = param.get("name") or "arg%d" % index
+    name = name.lstrip("_") or "arg%d" % index
+    return name + "_" if name in RESERVED else name
+
+
+def int_bits(t, prefix):
+    bits = t[len(prefix):]
+    return int(bits) if bits else 256
+
+
+def input_binding(t, name):
+    """(parameter list, head statement, is dynamic) or None when unsupported."""
+    if t == "address":
+        return ["const char* %s" % name], "w.address(%s);" % name, False
+    if t == "bool":
+        return ["bool %s" % name], "w.boolean(%s);" % name, False
+    if t == "string":
+        return ["const char* %s" % name], None, True
+    if t == "bytes":
+        return ["const uint8_t* %s" % name, "size_t %sLen" % name], None, True
+    if re.fullmatch(r"bytes([1-9]|[12][0-9]|3[0-2])", t):
+        return ["const uint8_t* %s" % name], "w.fixedBytes(%s, %s);" % (name, t[5:]), False
+    if re.fullmatch(r"uint\d*", t):
+        if int_bits(t, "uint") <= 64:
+            return ["uint64_t %s" % name], "w.uint(%s);" % name, False
+        return ["const UInt256& %s" % name], "w.uint(%s);" % name, False
+    if re.fullmatch(r"int\d*", t) and int_bits(t, "int") <= 64:
+        return ["int64_t %s" % name], "w.integer(%s);" % name, False
+    return None
+
+
+def output_binding(t, name, index):
+    """(parameter list, read expression) or None when unsupported."""
+    if t == "address":
+        return ["char* %s" % name], "r.address(%d, %s)" % (index, name)
+    if t == "bool":
+        return ["bool* %s" % name], "r.boolean(%d, %s)" % (index, name)
+    if t == "string":
+        return ["char* %s" % name, "size_t %sCap" % name], "r.string(%d, %s, %sCap)" % (index, name, name)
+    if re.fullmatch(r"bytes([1-9]|[12][0-9]|3[0-2])", t):
+        return ["uint8_t* %s" % name], "r.fixedBytes(%d, %s, %s)" % (index, name, t[5:])
+    if re.fullmatch(r"uint\d*", t):
+        bits = int_bits(t, "uint")
+        if bits > 64:
+            return ["UInt256* %s" % name], "r.uint(%d, %s)" % (index, name)
+        if bits == 64:
+            return ["uint64_t* %s" % name], "r.uint(%d, %s)" % (index, name)
+        ctype = "uint%d_t" % (8 if bits <= 8 else 16 if bits <= 16 else 32)
+        return ["%s* %s" % (ctype, name)], "r.narrow(%d, %s)" % (index, name)
+    return None
+
+
+# ===== CODE GENERATION =====
+def encoder(item, const):
+    inputs = item["inputs"]
+    bindings = []
+    for i, p in enumerate(inputs):
+        b = input_binding(p["type"], arg_name(p, i))
+        if b is None:
+            return None
+        bindings.append((arg_name(p, i), p["type"], b))
+
+    params = ["char* out", "size_t len"] + [decl for _, _, b in bindings for decl in b[0]]
+    lines = ["inline size_t %s(%s) {" % (item["name"], ", ".join(params))]
+    dynamic = [(n, t) for n, t, b in bindings if b[2]]
+    for n, t in dynamic:
+        if t == "string":
+            lines.append("    size_t %sLen = strlen(%s);" % (n, n))
+
+    lines.append("    AbiWriter w(out, len);")
+    lines.append("    w.selector(%s);" % const)
+    if dynamic:
+        lines.append("    size_t tail = %d;" % (32 * len(inputs)))
+    for n, t, b in bindings:
+        if b[2]:
+            lines.append("    w.uint((uint64_t)tail);")
+            lines.append("    tail += AbiWriter::dynamicSize(%sLen);" % n)
+        else:
+            lines.append("    " + b[1])
+    for n, t in dynamic:
+        cast = "(const uint8_t*)" if t == "string" else ""
+        lines.append("    w.dynamic(%s%s, %sLen);" % (cast, n, n))
+    if dynamic:
+        lines.append("    (void)tail;")
+    lines.append("    return w.finish();")
+    lines.append("}")
+    return lines, not dynamic
+
+
+def is_static(t):
+    return t not in ("string", "bytes") and not t.endswith("[]")
+
+
+def fields(components, reader, params, reads):
+    """Typed reads for a flat list of values; False if any is unsupported."""
+    for i, p in enumerate(components):
+        name = arg_name(p, i) if p.get("name") else "out%d" % i
+        b = output_binding(p["type"], name, i)
+        if b is None or p["type"].startswith("tuple"):
+            return False
+        params += b[0]
+        reads.append(b[1].replace("r.", reader + ".", 1))
+    return True
+
+
+def array_decoder(item, emitted):
+    """Lazy decoder for a single T[] return: an AbiArray over the reply and,
+    for tuple elements, a per-element decode<Struct>()."""
+    out = item["outputs"][0]
+    element = out["type"][:-2]
+    if element.endswith("]"):
+        return None
+
+    lines = []
+    if element == "tuple":
+        components = out["components"]
+        struct = out.get("internalType", "").split(".")[-1].rstrip("[]") or "Element"
+        struct = struct[0].upper() + struct[1:]
+        params, reads = ["const AbiReader& element"], []
+        if not fields(components, "element", params, reads):
+            return None
+        stride = len(components) if all(is_static(c["type"]) for c in components) else 0
+        if struct not in emitted:
+            emitted.add(struct)
+            lines += ["// %s: %s" % (struct, canonical(out)[:-2]),
+                      "inline bool decode%s(%s) {" % (struct, ", ".join(params)),
+                      "    return %s;" % " &&\n           ".join(reads),
+                      "}"]
+    elif is_static(element) and output_binding(element, "out", 0):
+        stride = 1    # Read element k with at(k).uint(0, ...) and friends
+    else:
+        return None
+
+    fname = "decode" + item["name"][0].upper() + item["name"][1:]
+    lines += ["inline AbiArray %s(const std::string& response) {" % fname,
+              "    return AbiArray(AbiReader(response), 0, %d);" % stride,
+              "}"]
+    return lines
+
+
+def decoder(item, emitted):
+    outputs = item.get("outputs", [])
+    if not outputs:
+        return None
+    if len(outputs) == 1 and outputs[0]["type"].endswith("[]"):
+        return array_decoder(item, emitted)
+    params = ["const std::string& response"]
+    reads = []
+    for i, p in enumerate(outputs):
+        name = arg_name(p, i) if p.get("name") else ("out" if len(outputs) == 1 else "out%d" % i)
+        b = output_binding(p["type"], name, i)
+        if b is None:
+            return None
+        params += b[0]
+        reads.append(b[1])
+
+    fname = "decode" + item["name"][0].upper() + item["name"][1:]
+    lines = ["inline bool %s(%s) {" % (fname, ", ".join(params)),
+             "    AbiReader r(response);",
+             "    return r.ok() && %s;" % " &&\n           ".join(reads),
+             "}"]
+    return lines
+
+
+def generate(abi_path, out_path):
+    with open(abi_path) as f:
+        abi = json.load(f)
+
+    base = os.path.splitext(os.path.basename(abi_path))[0]
+    namespace = "".join(part.capitalize() for part in base.split("_")) + "Abi"
+    guard = "ABI_%s_H" % base.upper()
+
+    functions = [item for item in abi if item.get("type") == "function"]
+    events = [item for item in abi if item.get("type") == "event"]
+    structs = set()
+    counts = {}
+    for item in functions:
+        counts[item["name"]] = counts.get(item["name"], 0) + 1
+
+    body = []
+    for item in functions:
+        sig = signature(item)
+        const = screaming(item["name"])
+        if counts[item["name"]] > 1:
+            const += "_%d" % len(item["inputs"])
+        selector = keccak256(sig.encode()).hex()[:8]
+
+        body.append("// %s" % sig)
+        body.append("constexpr uint32_t %s = 0x%s;" % (const, selector))
+
+        enc = encoder(item, const)
+        if enc is None:
+            body.append("// (no encoder: argument types not supported)")
+        else:
+            lines, static = enc
+            if static:
+                body.append("constexpr size_t %s_LEN = %d;" % (const, 10 + 64 * len(item["inputs"])))
+            body += lines
+
+        if item.get("outputs"):
+            dec = decoder(item, structs)
+            if dec is None:
+                ret = ",".join(canonical(p) for p in item["outputs"])
+                body.append("// (no decoder: returns %s)" % ret)
+            else:
+                body += dec
+        body.append("")
+
+    for item in events:
+        sig = signature(item)
+        topic = keccak256(sig.encode()).hex()
+        body.append("// event %s" % sig)
+        body.append("constexpr const char* %s_TOPIC = \"0x%s\";" % (screaming(item["name"]), topic))
+        body.append("")
+
+    header = "\n".join([
+        "/*",
+        " * Generated by scripts/abi_codegen.py from abi/%s - do not edit." % os.path.basename(abi_path),
+        " */",
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include \"../abi.h\"",
+        "",
+        "namespace %s {" % namespace,
+        "",
+        *body,
+        "} // namespace %s" % namespace,
+        "",
+        "#endif // %s" % guard,
+        "",
+    ])
+
+    old = None
+    if os.path.exists(out_path):
+        with open(out_path) as f:
+            old = f.read()
+    if old != header:
+        with open(out_path, "w", newline="\n") as f:
+            f.write(header)
+        print("%s: %d functions, %d events" % (out_path, len(functions), len(events)))
+
+
+def generate_all(abi_dir, out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    for name in sorted(os.listdir(abi_dir)):
+        if name.endswith(".json"):
+            generate(os.path.join(abi_dir, name), os.path.join(out_dir, name[:-5] + ".h"))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 3 or (len(sys.argv) > 1 and sys.argv[1] in ("-h", "--help")):
+        print(__doc__)
+        sys.exit(1)
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    abi_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "abi")
+    out_dir = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, "src", "abi")
+    generate_all(abi_dir, out_dir)
+else:
+    # PlatformIO extra_scripts entry point
+    try:
+        Import("env")  # noqa: F821
+        project = env.subst("$PROJECT_DIR")  # noqa: F821
+        generate_all(os.path.join(project, "abi"), os.path.join(project, "src", "abi"))
+    except NameError:
+        pass
@@ -0,0 +1,73 @@
+"""
+Static asset embedder
+
+Gzips a web asset at build time and writes it out as a C header holding a
+flash-resident byte array plus a strong ETag, so firmware can serve the page
+straight from flash with Content-Encoding: gzip and answer conditional
+requests with 304 Not Modified.
+
+Usage:
+    python scripts/embed_assets.py <input> <output.h> <SYMBOL>
+
+Example (security door page):
+    python scripts/embed_assets.py examples/security_door/web/index.html \
+        examples/security_door/door_page.h DOOR_PAGE
+
+Output is deterministic (gzip mtime is zeroed), so the header only changes
+when the asset does.
+"""
+
+import gzip
+import hashlib
+import os
+import sys
+
+BYTES_PER_LINE = 16
+
+
+def embed(src_path, out_path, symbol):
+    with open(src_path, "rb") as f:
+        raw = f.read()
+
+    packed = gzip.compress(raw, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(raw).hexdigest()[:16]
+    guard = os.path.basename(out_path).upper().replace(".", "_")
+
+    lines = []
+    for i in range(0, len(packed), BYTES_PER_LINE):
+        chunk = packed[i:i + BYTES_PER_LINE]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+
+    header = "\n".join([
+        "/*",
+        " * Generated by scripts/embed_assets.py from %s - do not edit." % os.path.basename(src_path),
+        " * %d bytes raw, %d bytes gzipped." % (len(raw), len(packed)),
+        " */",
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#define %s_ETAG \"\\\"%s\\\"\"" % (symbol, etag),
+        "#define %s_GZ_LEN %d" % (symbol, len(packed)),
+        "",
+        "static const uint8_t %s_GZ[%s_GZ_LEN] PROGMEM = {" % (symbol, symbol),
+        *lines,
+        "};",
+        "",
+        "#endif // %s" % guard,
+        "",
+    ])
+
+    with open(out_path, "w", newline="\n") as f:
+        f.write(header)
+
+    print("%s: %d -> %d bytes, ETag %s" % (out_path, len(raw), len(packed), etag))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 4:
+        print(__doc__)
+        sys.exit(1)
+    embed(sys.argv[1], sys.argv[2], sys.argv[3])
@@ -0,0 +1,373 @@
+/*
+ * ABI Encoding Runtime
+ *
+ * Helpers behind the generated contract bindings in src/abi/ (see
+ * scripts/abi_codegen.py). AbiWriter encodes calldata as 0x-hex straight
+ * into a caller buffer; AbiReader decodes return values from the "result"
+ * field of a raw JSON-RPC reply without copying it. Neither allocates.
+ *
+ *   char data[Erc20Abi::BALANCE_OF_LEN + 1];
+ *   Erc20Abi::balanceOf(data, sizeof(data), owner);
+ *   ...
+ *   UInt256 balance;
+ *   Erc20Abi::decodeBalanceOf(response, &balance);
+ */
+
+#ifndef ABI_H
+#define ABI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <uint256/uint256_t.h>
+
+#include "hex.h"
+#include "uint256.h"
+
+#define ABI_WORD_HEX 64
+
+class AbiWriter {
+public:
+    AbiWriter(char* out, size_t capacity) : buf(out), cap(capacity), len(0), bad(false) {}
+
+    void selector(uint32_t sel) {
+        put("0x", 2);
+        hex(sel, 8);
+    }
+
+    void uint(uint64_t value) {
+        pad(48);
+        hex(value, 16);
+    }
+
+    void uint(const uint256_t& value) {
+        hex(value.upper().upper(), 16);
+        hex(value.upper().lower(), 16);
+        hex(value.lower().upper(), 16);
+        hex(value.lower().lower(), 16);
+    }
+
+    void uint(const UInt256& value) {
+        for (int i = 3; i >= 0; i--) {
+            hex(value.word(i), 16);
+        }
+    }
+
+    // Two's complement, sign-extended to 256 bits
+    void integer(int64_t value) {
+        if (value < 0) {
+            put("ffffffffffffffffffffffffffffffffffffffffffffffff", 48);
+        } else {
+            pad(48);
+        }
+        hex((uint64_t)value, 16);
+    }
+
+    void boolean(bool value) {
+        uint(value ? 1ULL : 0ULL);
+    }
+
+    // 0x-prefixed, 40 hex digits; anything else marks the encoding invalid.
+    // Written back in lower case whatever the checksum casing.
+    void address(const char* addr) {
+        uint8_t parsed[20];
+        if (!Hex::parseAddress(addr, parsed)) {
+            bad = true;
+            return;
+        }
+        pad(24);
+        bytes(parsed, 20);
+    }
+
+    // bytesN: left-aligned, zero-padded to a word
+    void fixedBytes(const uint8_t* data, size_t n) {
+        bytes(data, n);
+        pad((32 - n % 32) % 32 * 2);
+    }
+
+    // Tail part of a dynamic argument: length word, then padded data
+    void dynamic(const uint8_t* data, size_t n) {
+        uint((uint64_t)n);
+        if (n) {
+            fixedBytes(data, n);
+        }
+    }
+
+    // Bytes a dynamic value of n bytes occupies in the tail
+    static size_t dynamicSize(size_t n) {
+        return 32 + (n + 31) / 32 * 32;
+    }
+
+    // Encoded length, or 0 when the buffer was too small or an argument
+    // was invalid
+    size_t finish() {
+        if (bad || len >= cap) {
+            if (cap) {
+                buf[0] = '\0';
+            }
+            return 0;
+        }
+        buf[len] = '\0';
+        return len;
+    }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool bad;
+
+    void put(const char* text, size_t n) {
+        if (len + n >= cap) {
+            bad = true;
+            return;
+        }
+        memcpy(buf + len, text, n);
+        len += n;
+    }
+
+    void pad(size_t zeros) {
+        if (len + zeros >= cap) {
+            bad = true;
+            return;
+        }
+        memset(buf + len, '0', zeros);
+        len += zeros;
+    }
+
+    void hex(uint64_t value, int digits) {
+        if (len + digits >= cap) {
+            bad = true;
+            return;
+        }
+        Hex::encodeWord(value, digits, buf + len);
+        len += digits;
+    }
+
+    void bytes(const uint8_t* data, size_t n) {
+        if (len + n * 2 >= cap) {
+            bad = true;
+            return;
+        }
+        Hex::encode(data, n, buf + len);
+        len += n * 2;
+    }
+};
+
+class AbiReader {
+public:
+    // Points into response; it must outlive the reader
+    explicit AbiReader(const std::string& response) : hex(nullptr), size(0) {
+        size_t at = response.find("\"result\":\"0x");
+        if (at == std::string::npos) {
+            return;
+        }
+        hex = response.c_str() + at + 12;
+        const char* end = strchr(hex, '"');
+        size = end ? (size_t)(end - hex) : 0;
+    }
+
+    AbiReader(const char* data, size_t hexLen) : hex(data), size(hexLen) {}
+    AbiReader() : hex(nullptr), size(0) {}
+
+    bool ok() const { return hex && size >= ABI_WORD_HEX && size % ABI_WORD_HEX == 0; }
+    size_t words() const { return ok() ? size / ABI_WORD_HEX : 0; }
+
+    // Reader over the same data starting at word; offsets inside a tuple
+    // are relative to its start, so a tuple is read through its own view
+    AbiReader view(size_t word) const {
+        if (word >= words()) {
+            return AbiReader();
+        }
+        return AbiReader(hex + word * ABI_WORD_HEX, size - word * ABI_WORD_HEX);
+    }
+
+    bool uint(size_t word, uint256_t* out) const {
+        uint64_t limbs[4];
+        for (int i = 0; i < 4; i++) {
+            if (!limb(word, i, &limbs[i])) {
+                return false;
+            }
+        }
+        *out = uint256_t(uint128_t(limbs[0], limbs[1]), uint128_t(limbs[2], limbs[3]));
+        return true;
+    }
+
+    bool uint(size_t word, UInt256* out) const {
+        uint64_t limbs[4];
+        for (int i = 0; i < 4; i++) {
+            if (!limb(word, i, &limbs[i])) {
+                return false;
+            }
+        }
+        *out = UInt256(limbs[0], limbs[1], limbs[2], limbs[3]);
+        return true;
+    }
+
+    // Fails if the value does not fit in 64 bits
+    bool uint(size_t word, uint64_t* out) const {
+        uint64_t high;
+        for (int i = 0; i < 3; i++) {
+            if (!limb(word, i, &high) || high != 0) {
+                return false;
+            }
+        }
+        return limb(word, 3, out);
+    }
+
+    template <typename T>
+    bool narrow(size_t word, T* out) const {
+        uint64_t value;
+        if (!uint(word, &value) || value > (uint64_t)(T)~(T)0) {
+            return false;
+        }
+        *out = (T)value;
+        return true;
+    }
+
+    bool boolean(size_t word, bool* out) const {
+        uint64_t value;
+        if (!uint(word, &value) || value > 1) {
+            return false;
+        }
+        *out = value == 1;
+        return true;
+    }
+
+    // out receives "0x" + 40 lowercase hex digits. The word must be an
+    // address as abi.encode pads it: 24 leading '0' digits, then 40 hex
+    // digits; anything else is a malformed reply and out is left alone.
+    bool address(size_t word, char out[43]) const {
+        if (word >= words()) {
+            return false;
+        }
+        const char* w = hex + word * ABI_WORD_HEX;
+        for (int i = 0; i < 24; i++) {
+            if (w[i] != '0') {
+                return false;
+            }
+        }
+        uint8_t bytes[20];
+        if (!Hex::decode(w + 24, bytes, 20)) {
+            return false;
+        }
+        out[0] = '0';
+        out[1] = 'x';
+        Hex::encode(bytes, 20, out + 2);
+        out[42] = '\0';
+        return true;
+    }
+
+    bool fixedBytes(size_t word, uint8_t* out, size_t n) const {
+        if (word >= words() || n > 32) {
+            return false;
+        }
+        return Hex::decode(hex + word * ABI_WORD_HEX, out, n);
+    }
+
+    // string/bytes whose head word (the offset) is at word. Text that does
+    // not fit in cap - 1 is truncated; returns false only on malformed data.
+    // Offset and length come from the node: both are checked against the
+    // reply in 64 bits, before anything narrows them to a 32-bit size_t.
+    bool string(size_t word, char* out, size_t cap, size_t* length = nullptr) const {
+        uint64_t offset, n;
+        if (cap == 0 || !uint(word, &offset) || offset % 32 || offset / 32 >= words() ||
+            !uint((size_t)(offset / 32), &n) || n > (uint64_t)(words() - offset / 32 - 1) * 32) {
+            return false;
+        }
+        size_t copy = n < cap ? n : cap - 1;
+        if (!Hex::decode(hex + (offset / 32 + 1) * ABI_WORD_HEX, (uint8_t*)out, copy)) {
+            return false;
+        }
+        out[copy] = '\0';
+        if (length) {
+            *length = n;
+        }
+        return true;
+    }
+
+private:
+    const char* hex;
+    size_t size;
+
+    bool limb(size_t word, int i, uint64_t* out) const {
+        if (word >= words()) {
+            return false;
+        }
+        return Hex::word(hex + word * ABI_WORD_HEX + i * 16, 16, out);
+    }
+};
+
+// Lazy view over an ABI-encoded array (T[] return values, e.g. Device[]).
+// Each element is handed out as an AbiReader positioned on it; nothing is
+// copied or converted until a field is read, so memory use does not grow
+// with the number of elements.
+//
+//   for (AbiReader device : Polka32Abi::decodeGet(response)) {
+//       Polka32Abi::decodeDevice(device, name, sizeof(name), &time);
+//   }
+class AbiArray {
+public:
+    AbiArray() : count(0), stride(0) {}
+
+    // head: word holding the array's offset. stride: words per element for
+    // static element types, 0 for dynamic ones (reached via an offset table).
+    AbiArray(const AbiReader& reader, size_t head, size_t stride) : count(0), stride(stride) {
+        // The offset is checked in 64 bits before it narrows to size_t, as
+        // AbiReader::string() does, so a huge one cannot wrap into range
+        uint64_t offset, n;
+        if (!reader.uint(head, &offset) || offset % 32 || offset / 32 >= reader.words() ||
+            !reader.uint((size_t)(offset / 32), &n)) {
+            return;
+        }
+        elements = reader.view((size_t)(offset / 32) + 1);
+        // Every element takes at least one word, which bounds bogus lengths
+        size_t minWords = stride ? stride : 1;
+        if (n == 0 || (n <= elements.words() / minWords)) {
+            count = (size_t)n;
+        }
+    }
+
+    size_t size() const { return count; }
+
+    // Element k, or an empty reader (ok() == false) if it is malformed
+    AbiReader at(size_t k) const {
+        if (k >= count) {
+            return AbiReader();
+        }
+        if (stride) {
+            return elements.view(k * stride);
+        }
+        uint64_t offset;
+        if (!elements.uint(k, &offset) || offset % 32 || offset / 32 >= elements.words()) {
+            return AbiReader();
+        }
+        return elements.view((size_t)(offset / 32));
+    }
+
+    class Iterator {
+    public:
+        Iterator(const AbiArray* array, size_t index) : array(array), index(index) {}
+        AbiReader operator*() const { return array->at(index); }
+        Iterator& operator++() {
+            index++;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        const AbiArray* array;
+        size_t index;
+    };
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, count); }
+
+private:
+    AbiReader elements;
+    size_t count;
+    size_t stride;
+};
+
+#endif // ABI_H
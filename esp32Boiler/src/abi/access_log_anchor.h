@@ -0,0 +1,44 @@
+/*
+ * Generated by scripts/abi_codegen.py from abi/access_log_anchor.json - do not edit.
+ */
+
+#ifndef ABI_ACCESS_LOG_ANCHOR_H
+#define ABI_ACCESS_LOG_ANCHOR_H
+
+#include "../abi.h"
+
+namespace AccessLogAnchorAbi {
+
+// anchor(uint64,bytes32,uint32)
+constexpr uint32_t ANCHOR = 0xa149a214;
+constexpr size_t ANCHOR_LEN = 202;
+inline size_t anchor(char* out, size_t len, uint64_t period, const uint8_t* root, uint64_t entries) {
+    AbiWriter w(out, len);
+    w.selector(ANCHOR);
+    w.uint(period);
+    w.fixedBytes(root, 32);
+    w.uint(entries);
+    return w.finish();
+}
+
+// roots(address,uint64)
+constexpr uint32_t ROOTS = 0xf13e43b0;
+constexpr size_t ROOTS_LEN = 138;
+inline size_t roots(char* out, size_t len, const char* device, uint64_t period) {
+    AbiWriter w(out, len);
+    w.selector(ROOTS);
+    w.address(device);
+    w.uint(period);
+    return w.finish();
+}
+inline bool decodeRoots(const std::string& response, uint8_t* out) {
+    AbiReader r(response);
+    return r.ok() && r.fixedBytes(0, out, 32);
+}
+
+// event Anchored(address,uint64,bytes32,uint32)
+constexpr const char* ANCHORED_TOPIC = "0xcf931ee76403486f668ee91d0dded4a8c6a7c42df32d8b2f8f350d76d1b3f892";
+
+} // namespace AccessLogAnchorAbi
+
+#endif // ABI_ACCESS_LOG_ANCHOR_H
@@ -0,0 +1,147 @@
+/*
+ * Generated by scripts/abi_codegen.py from abi/erc20.json - do not edit.
+ */
+
+#ifndef ABI_ERC20_H
+#define ABI_ERC20_H
+
+#include "../abi.h"
+
+namespace Erc20Abi {
+
+// name()
+constexpr uint32_t NAME = 0x06fdde03;
+constexpr size_t NAME_LEN = 10;
+inline size_t name(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(NAME);
+    return w.finish();
+}
+inline bool decodeName(const std::string& response, char* out, size_t outCap) {
+    AbiReader r(response);
+    return r.ok() && r.string(0, out, outCap);
+}
+
+// symbol()
+constexpr uint32_t SYMBOL = 0x95d89b41;
+constexpr size_t SYMBOL_LEN = 10;
+inline size_t symbol(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(SYMBOL);
+    return w.finish();
+}
+inline bool decodeSymbol(const std::string& response, char* out, size_t outCap) {
+    AbiReader r(response);
+    return r.ok() && r.string(0, out, outCap);
+}
+
+// decimals()
+constexpr uint32_t DECIMALS = 0x313ce567;
+constexpr size_t DECIMALS_LEN = 10;
+inline size_t decimals(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(DECIMALS);
+    return w.finish();
+}
+inline bool decodeDecimals(const std::string& response, uint8_t* out) {
+    AbiReader r(response);
+    return r.ok() && r.narrow(0, out);
+}
+
+// totalSupply()
+constexpr uint32_t TOTAL_SUPPLY = 0x18160ddd;
+constexpr size_t TOTAL_SUPPLY_LEN = 10;
+inline size_t totalSupply(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(TOTAL_SUPPLY);
+    return w.finish();
+}
+inline bool decodeTotalSupply(const std::string& response, UInt256* out) {
+    AbiReader r(response);
+    return r.ok() && r.uint(0, out);
+}
+
+// balanceOf(address)
+constexpr uint32_t BALANCE_OF = 0x70a08231;
+constexpr size_t BALANCE_OF_LEN = 74;
+inline size_t balanceOf(char* out, size_t len, const char* account) {
+    AbiWriter w(out, len);
+    w.selector(BALANCE_OF);
+    w.address(account);
+    return w.finish();
+}
+inline bool decodeBalanceOf(const std::string& response, UInt256* out) {
+    AbiReader r(response);
+    return r.ok() && r.uint(0, out);
+}
+
+// allowance(address,address)
+constexpr uint32_t ALLOWANCE = 0xdd62ed3e;
+constexpr size_t ALLOWANCE_LEN = 138;
+inline size_t allowance(char* out, size_t len, const char* owner, const char* spender) {
+    AbiWriter w(out, len);
+    w.selector(ALLOWANCE);
+    w.address(owner);
+    w.address(spender);
+    return w.finish();
+}
+inline bool decodeAllowance(const std::string& response, UInt256* out) {
+    AbiReader r(response);
+    return r.ok() && r.uint(0, out);
+}
+
+// transfer(address,uint256)
+constexpr uint32_t TRANSFER = 0xa9059cbb;
+constexpr size_t TRANSFER_LEN = 138;
+inline size_t transfer(char* out, size_t len, const char* to, const UInt256& amount) {
+    AbiWriter w(out, len);
+    w.selector(TRANSFER);
+    w.address(to);
+    w.uint(amount);
+    return w.finish();
+}
+inline bool decodeTransfer(const std::string& response, bool* out) {
+    AbiReader r(response);
+    return r.ok() && r.boolean(0, out);
+}
+
+// approve(address,uint256)
+constexpr uint32_t APPROVE = 0x095ea7b3;
+constexpr size_t APPROVE_LEN = 138;
+inline size_t approve(char* out, size_t len, const char* spender, const UInt256& amount) {
+    AbiWriter w(out, len);
+    w.selector(APPROVE);
+    w.address(spender);
+    w.uint(amount);
+    return w.finish();
+}
+inline bool decodeApprove(const std::string& response, bool* out) {
+    AbiReader r(response);
+    return r.ok() && r.boolean(0, out);
+}
+
+// transferFrom(address,address,uint256)
+constexpr uint32_t TRANSFER_FROM = 0x23b872dd;
+constexpr size_t TRANSFER_FROM_LEN = 202;
+inline size_t transferFrom(char* out, size_t len, const char* from, const char* to, const UInt256& amount) {
+    AbiWriter w(out, len);
+    w.selector(TRANSFER_FROM);
+    w.address(from);
+    w.address(to);
+    w.uint(amount);
+    return w.finish();
+}
+inline bool decodeTransferFrom(const std::string& response, bool* out) {
+    AbiReader r(response);
+    return r.ok() && r.boolean(0, out);
+}
+
+// event Transfer(address,address,uint256)
+constexpr const char* TRANSFER_TOPIC = "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+
+// event Approval(address,address,uint256)
+constexpr const char* APPROVAL_TOPIC = "0x8c5be1e5ebec7d5bd14f71427d1e84f3dd0314c0f7b2291e5b200ac8c7c3b925";
+
+} // namespace Erc20Abi
+
+#endif // ABI_ERC20_H
@@ -0,0 +1,176 @@
+/*
+ * Generated by scripts/abi_codegen.py from abi/erc721.json - do not edit.
+ */
+
+#ifndef ABI_ERC721_H
+#define ABI_ERC721_H
+
+#include "../abi.h"
+
+namespace Erc721Abi {
+
+// name()
+constexpr uint32_t NAME = 0x06fdde03;
+constexpr size_t NAME_LEN = 10;
+inline size_t name(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(NAME);
+    return w.finish();
+}
+inline bool decodeName(const std::string& response, char* out, size_t outCap) {
+    AbiReader r(response);
+    return r.ok() && r.string(0, out, outCap);
+}
+
+// symbol()
+constexpr uint32_t SYMBOL = 0x95d89b41;
+constexpr size_t SYMBOL_LEN = 10;
+inline size_t symbol(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(SYMBOL);
+    return w.finish();
+}
+inline bool decodeSymbol(const std::string& response, char* out, size_t outCap) {
+    AbiReader r(response);
+    return r.ok() && r.string(0, out, outCap);
+}
+
+// tokenURI(uint256)
+constexpr uint32_t TOKEN_URI = 0xc87b56dd;
+constexpr size_t TOKEN_URI_LEN = 74;
+inline size_t tokenURI(char* out, size_t len, const UInt256& tokenId) {
+    AbiWriter w(out, len);
+    w.selector(TOKEN_URI);
+    w.uint(tokenId);
+    return w.finish();
+}
+inline bool decodeTokenURI(const std::string& response, char* out, size_t outCap) {
+    AbiReader r(response);
+    return r.ok() && r.string(0, out, outCap);
+}
+
+// balanceOf(address)
+constexpr uint32_t BALANCE_OF = 0x70a08231;
+constexpr size_t BALANCE_OF_LEN = 74;
+inline size_t balanceOf(char* out, size_t len, const char* owner) {
+    AbiWriter w(out, len);
+    w.selector(BALANCE_OF);
+    w.address(owner);
+    return w.finish();
+}
+inline bool decodeBalanceOf(const std::string& response, UInt256* out) {
+    AbiReader r(response);
+    return r.ok() && r.uint(0, out);
+}
+
+// ownerOf(uint256)
+constexpr uint32_t OWNER_OF = 0x6352211e;
+constexpr size_t OWNER_OF_LEN = 74;
+inline size_t ownerOf(char* out, size_t len, const UInt256& tokenId) {
+    AbiWriter w(out, len);
+    w.selector(OWNER_OF);
+    w.uint(tokenId);
+    return w.finish();
+}
+inline bool decodeOwnerOf(const std::string& response, char* out) {
+    AbiReader r(response);
+    return r.ok() && r.address(0, out);
+}
+
+// getApproved(uint256)
+constexpr uint32_t GET_APPROVED = 0x081812fc;
+constexpr size_t GET_APPROVED_LEN = 74;
+inline size_t getApproved(char* out, size_t len, const UInt256& tokenId) {
+    AbiWriter w(out, len);
+    w.selector(GET_APPROVED);
+    w.uint(tokenId);
+    return w.finish();
+}
+inline bool decodeGetApproved(const std::string& response, char* out) {
+    AbiReader r(response);
+    return r.ok() && r.address(0, out);
+}
+
+// isApprovedForAll(address,address)
+constexpr uint32_t IS_APPROVED_FOR_ALL = 0xe985e9c5;
+constexpr size_t IS_APPROVED_FOR_ALL_LEN = 138;
+inline size_t isApprovedForAll(char* out, size_t len, const char* owner, const char* operator_) {
+    AbiWriter w(out, len);
+    w.selector(IS_APPROVED_FOR_ALL);
+    w.address(owner);
+    w.address(operator_);
+    return w.finish();
+}
+inline bool decodeIsApprovedForAll(const std::string& response, bool* out) {
+    AbiReader r(response);
+    return r.ok() && r.boolean(0, out);
+}
+
+// approve(address,uint256)
+constexpr uint32_t APPROVE = 0x095ea7b3;
+constexpr size_t APPROVE_LEN = 138;
+inline size_t approve(char* out, size_t len, const char* to, const UInt256& tokenId) {
+    AbiWriter w(out, len);
+    w.selector(APPROVE);
+    w.address(to);
+    w.uint(tokenId);
+    return w.finish();
+}
+
+// setApprovalForAll(address,bool)
+constexpr uint32_t SET_APPROVAL_FOR_ALL = 0xa22cb465;
+constexpr size_t SET_APPROVAL_FOR_ALL_LEN = 138;
+inline size_t setApprovalForAll(char* out, size_t len, const char* operator_, bool approved) {
+    AbiWriter w(out, len);
+    w.selector(SET_APPROVAL_FOR_ALL);
+    w.address(operator_);
+    w.boolean(approved);
+    return w.finish();
+}
+
+// transferFrom(address,address,uint256)
+constexpr uint32_t TRANSFER_FROM = 0x23b872dd;
+constexpr size_t TRANSFER_FROM_LEN = 202;
+inline size_t transferFrom(char* out, size_t len, const char* from, const char* to, const UInt256& tokenId) {
+    AbiWriter w(out, len);
+    w.selector(TRANSFER_FROM);
+    w.address(from);
+    w.address(to);
+    w.uint(tokenId);
+    return w.finish();
+}
+
+// safeTransferFrom(address,address,uint256)
+constexpr uint32_t SAFE_TRANSFER_FROM_3 = 0x42842e0e;
+constexpr size_t SAFE_TRANSFER_FROM_3_LEN = 202;
+inline size_t safeTransferFrom(char* out, size_t len, const char* from, const char* to, const UInt256& tokenId) {
+    AbiWriter w(out, len);
+    w.selector(SAFE_TRANSFER_FROM_3);
+    w.address(from);
+    w.address(to);
+    w.uint(tokenId);
+    return w.finish();
+}
+
+// safeTransferFrom(address,address,uint256,bytes)
+constexpr uint32_t SAFE_TRANSFER_FROM_4 = 0xb88d4fde;
+inline size_t safeTransferFrom(char* out, size_t len, const char* from, const char* to, const UInt256& tokenId, const uint8_t* data, size_t dataLen) {
+    AbiWriter w(out, len);
+    w.selector(SAFE_TRANSFER_FROM_4);
+    size_t tail = 128;
+    w.address(from);
+    w.address(to);
+    w.uint(tokenId);
+    w.uint((uint64_t)tail);
+    tail += AbiWriter::dynamicSize(dataLen);
+    w.dynamic(data, dataLen);
+    (void)tail;
+    return w.finish();
+}
+
+// event Transfer(address,address,uint256)
+constexpr const char* TRANSFER_TOPIC = "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+
+} // namespace Erc721Abi
+
+#endif // ABI_ERC721_H
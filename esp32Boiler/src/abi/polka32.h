@@ -0,0 +1,88 @@
+/*
+ * Generated by scripts/abi_codegen.py from abi/polka32.json - do not edit.
+ */
+
+#ifndef ABI_POLKA32_H
+#define ABI_POLKA32_H
+
+#include "../abi.h"
+
+namespace Polka32Abi {
+
+// add(string)
+constexpr uint32_t ADD = 0xb0c8f9dc;
+inline size_t add(char* out, size_t len, const char* name) {
+    size_t nameLen = strlen(name);
+    AbiWriter w(out, len);
+    w.selector(ADD);
+    size_t tail = 32;
+    w.uint((uint64_t)tail);
+    tail += AbiWriter::dynamicSize(nameLen);
+    w.dynamic((const uint8_t*)name, nameLen);
+    (void)tail;
+    return w.finish();
+}
+
+// ping(uint256)
+constexpr uint32_t PING = 0x773acdef;
+constexpr size_t PING_LEN = 74;
+inline size_t ping(char* out, size_t len, const UInt256& i) {
+    AbiWriter w(out, len);
+    w.selector(PING);
+    w.uint(i);
+    return w.finish();
+}
+
+// get(address)
+constexpr uint32_t GET = 0xc2bc2efc;
+constexpr size_t GET_LEN = 74;
+inline size_t get(char* out, size_t len, const char* a) {
+    AbiWriter w(out, len);
+    w.selector(GET);
+    w.address(a);
+    return w.finish();
+}
+// Device: (string,uint256)
+inline bool decodeDevice(const AbiReader& element, char* name, size_t nameCap, UInt256* time) {
+    return element.string(0, name, nameCap) &&
+           element.uint(1, time);
+}
+inline AbiArray decodeGet(const std::string& response) {
+    return AbiArray(AbiReader(response), 0, 0);
+}
+
+// devices(address,uint256)
+constexpr uint32_t DEVICES = 0xde6ff06b;
+constexpr size_t DEVICES_LEN = 138;
+inline size_t devices(char* out, size_t len, const char* arg0, const UInt256& arg1) {
+    AbiWriter w(out, len);
+    w.selector(DEVICES);
+    w.address(arg0);
+    w.uint(arg1);
+    return w.finish();
+}
+inline bool decodeDevices(const std::string& response, char* name, size_t nameCap, UInt256* time) {
+    AbiReader r(response);
+    return r.ok() && r.string(0, name, nameCap) &&
+           r.uint(1, time);
+}
+
+// total()
+constexpr uint32_t TOTAL = 0x2ddbd13a;
+constexpr size_t TOTAL_LEN = 10;
+inline size_t total(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(TOTAL);
+    return w.finish();
+}
+inline bool decodeTotal(const std::string& response, UInt256* out) {
+    AbiReader r(response);
+    return r.ok() && r.uint(0, out);
+}
+
+// event Reg(address)
+constexpr const char* REG_TOPIC = "0xf2361efabc8c73d5fb33058beea312f9b1209d6251effba31047abe678221db4";
+
+} // namespace Polka32Abi
+
+#endif // ABI_POLKA32_H
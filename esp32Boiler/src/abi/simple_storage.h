@@ -0,0 +1,37 @@
+/*
+ * Generated by scripts/abi_codegen.py from abi/simple_storage.json - do not edit.
+ */
+
+#ifndef ABI_SIMPLE_STORAGE_H
+#define ABI_SIMPLE_STORAGE_H
+
+#include "../abi.h"
+
+namespace SimpleStorageAbi {
+
+// store(uint256)
+constexpr uint32_t STORE = 0x6057361d;
+constexpr size_t STORE_LEN = 74;
+inline size_t store(char* out, size_t len, const UInt256& num) {
+    AbiWriter w(out, len);
+    w.selector(STORE);
+    w.uint(num);
+    return w.finish();
+}
+
+// retrieve()
+constexpr uint32_t RETRIEVE = 0x2e64cec1;
+constexpr size_t RETRIEVE_LEN = 10;
+inline size_t retrieve(char* out, size_t len) {
+    AbiWriter w(out, len);
+    w.selector(RETRIEVE);
+    return w.finish();
+}
+inline bool decodeRetrieve(const std::string& response, UInt256* out) {
+    AbiReader r(response);
+    return r.ok() && r.uint(0, out);
+}
+
+} // namespace SimpleStorageAbi
+
+#endif // ABI_SIMPLE_STORAGE_H
@@ -0,0 +1,168 @@
+/*
+ * Token Amounts
+ *
+ * Exact conversion between uint256 base-unit amounts (wei, token units) and
+ * decimal strings, without the heap and without going through double.
+ *
+ *   char buf[AMOUNT_MAX_CHARS];
+ *   Amount::format(balance, 18, buf, sizeof(buf));   // "1.5"
+ *
+ *   uint256_t wei;
+ *   Amount::parse("0.001", 18, &wei);                // 1000000000000000
+ *
+ * Takes UInt256 (uint256.h) or Web3E's uint256_t. Header-only so the
+ * examples can share it with src/main.cpp.
+ */
+
+#ifndef AMOUNT_H
+#define AMOUNT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <uint256/uint256_t.h>
+
+#include "uint256.h"
+
+#define AMOUNT_MAX_DIGITS 78                        // 2^256 has 78 decimal digits
+#define AMOUNT_MAX_CHARS (AMOUNT_MAX_DIGITS + 3)    // "0." prefix and terminator
+
+class Amount {
+public:
+    // Write value / 10^decimals as a decimal string. fractionDigits fixes
+    // the number of digits after the point (truncating, never rounding);
+    // -1 trims trailing zeros. Returns the string length, or 0 if out is
+    // too small.
+    static size_t format(const UInt256& value, int decimals, char* out, size_t outLen,
+                         int fractionDigits = -1) {
+        char digits[AMOUNT_MAX_DIGITS];
+        int count = toDigits(value, digits);  // Least significant first
+
+        if (decimals < 0 || decimals > AMOUNT_MAX_DIGITS) {
+            return 0;
+        }
+        int fraction = fractionDigits < 0 ? decimals : (fractionDigits < decimals ? fractionDigits : decimals);
+        if (fractionDigits < 0) {
+            // Trailing zeros of the fraction are the lowest digits
+            while (fraction > 0 && (decimals - fraction >= count || digits[decimals - fraction] == '0')) {
+                fraction--;
+            }
+        }
+
+        int whole = count > decimals ? count - decimals : 1;
+        size_t needed = whole + (fraction > 0 ? fraction + 1 : 0);
+        if (needed + 1 > outLen) {
+            return 0;
+        }
+
+        char* p = out;
+        for (int i = whole - 1; i >= 0; i--) {
+            int pos = decimals + i;
+            *p++ = pos < count ? digits[pos] : '0';
+        }
+        if (fraction > 0) {
+            *p++ = '.';
+            for (int i = 1; i <= fraction; i++) {
+                int pos = decimals - i;
+                *p++ = pos < count ? digits[pos] : '0';
+            }
+        }
+        *p = '\0';
+        return needed;
+    }
+
+    // Parse a plain decimal string ("12", "0.001", ".5") into base units.
+    // Fails on signs, exponents, junk, more fraction digits than decimals
+    // (unless they are zeros) and anything that overflows 256 bits.
+    static bool parse(const char* text, int decimals, uint256_t* out) {
+        UInt256 value;
+        if (!parse(text, decimals, &value)) {
+            return false;
+        }
+        *out = value;
+        return true;
+    }
+
+    static bool parse(const char* text, int decimals, UInt256* out) {
+        uint32_t limbs[8] = {0};
+        bool seenDigit = false;
+        bool inFraction = false;
+        int fraction = 0;
+
+        if (text == nullptr || decimals < 0 || decimals > AMOUNT_MAX_DIGITS) {
+            return false;
+        }
+
+        for (const char* p = text; *p; p++) {
+            if (*p == '.') {
+                if (inFraction) {
+                    return false;
+                }
+                inFraction = true;
+                continue;
+            }
+            if (*p < '0' || *p > '9') {
+                return false;
+            }
+            seenDigit = true;
+
+            if (inFraction && fraction == decimals) {
+                if (*p != '0') {
+                    return false;  // Finer than the token's smallest unit
+                }
+                continue;
+            }
+            if (!mulAdd(limbs, 10, *p - '0')) {
+                return false;
+            }
+            if (inFraction) {
+                fraction++;
+            }
+        }
+
+        if (!seenDigit) {
+            return false;
+        }
+        for (; fraction < decimals; fraction++) {
+            if (!mulAdd(limbs, 10, 0)) {
+                return false;
+            }
+        }
+
+        *out = fromLimbs(limbs);
+        return true;
+    }
+
+private:
+    // Little-endian 32-bit limbs keep the arithmetic native on the ESP32
+    static UInt256 fromLimbs(const uint32_t limbs[8]) {
+        uint64_t words[4];
+        for (int i = 0; i < 4; i++) {
+            words[i] = (uint64_t)limbs[2 * i + 1] << 32 | limbs[2 * i];
+        }
+        return UInt256(words[3], words[2], words[1], words[0]);
+    }
+
+    // limbs = limbs * mul + add; false on overflow
+    static bool mulAdd(uint32_t limbs[8], uint32_t mul, uint32_t add) {
+        uint64_t carry = add;
+        for (int i = 0; i < 8; i++) {
+            uint64_t t = (uint64_t)limbs[i] * mul + carry;
+            limbs[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        return carry == 0;
+    }
+
+    // Decimal digits of value, least significant first; returns the count
+    // (at least 1)
+    static int toDigits(const UInt256& value, char digits[AMOUNT_MAX_DIGITS]) {
+        char text[UINT256_DEC_CHARS];
+        int count = (int)value.toDecimal(text, sizeof(text));
+        for (int i = 0; i < count; i++) {
+            digits[i] = text[count - 1 - i];
+        }
+        return count;
+    }
+};
+
+#endif // AMOUNT_H
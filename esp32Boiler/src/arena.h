@@ -0,0 +1,212 @@
+/*
+ * Request Arena
+ *
+ * Bump-pointer allocator for the short-lived strings and buffers of a
+ * single RPC call or HTTP handler. Memory comes from one fixed block, so
+ * per-request churn never reaches the heap and cannot fragment it over
+ * days of uptime.
+ *
+ *   static uint8_t rpcMemory[4096];
+ *   Arena rpcArena(rpcMemory, sizeof(rpcMemory));
+ *
+ *   void handler() {
+ *       ArenaScope scope(rpcArena);        // Everything below is freed in O(1)
+ *       ArenaString line(rpcArena, 128);   // when scope goes out of scope
+ *       line.appendf("balance: %s", ...);
+ *   }
+ *
+ * An arena belongs to one task. Scopes nest; inner scopes release only
+ * what they allocated. ArenaAllocator lets std containers use the arena,
+ * falling back to the heap once it is exhausted.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+class Arena {
+public:
+    Arena(uint8_t* memory, size_t capacity)
+        : base(memory), cap(capacity), top(0), high(0), misses(0) {}
+
+    // Returns nullptr when the arena cannot fit the request
+    void* alloc(size_t size, size_t align = sizeof(void*)) {
+        size_t start = (top + align - 1) & ~(align - 1);
+        if (start + size > cap) {
+            misses++;
+            return nullptr;
+        }
+        top = start + size;
+        if (top > high) {
+            high = top;
+        }
+        return base + start;
+    }
+
+    bool owns(const void* p) const {
+        return p >= base && p < base + cap;
+    }
+
+    size_t mark() const { return top; }
+    void rewind(size_t saved) { top = saved; }
+    void reset() { top = 0; }
+
+    size_t used() const { return top; }
+    size_t peak() const { return high; }
+    size_t capacity() const { return cap; }
+    uint32_t failures() const { return misses; }
+
+private:
+    uint8_t* base;
+    size_t cap;
+    size_t top;
+    size_t high;
+    uint32_t misses;
+};
+
+// Releases everything allocated from the arena during its lifetime
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) : arena(arena), saved(arena.mark()) {}
+    ~ArenaScope() { arena.rewind(saved); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& arena;
+    size_t saved;
+};
+
+// Fixed-capacity string carved from an arena. Appends past the capacity
+// are truncated (and flagged) rather than reallocating.
+class ArenaString {
+public:
+    ArenaString(Arena& arena, size_t capacity)
+        : len(0), clipped(false) {
+        buf = static_cast<char*>(arena.alloc(capacity, 1));
+        cap = buf ? capacity : 0;
+        if (buf) {
+            buf[0] = '\0';
+        }
+    }
+
+    ArenaString& append(const char* text) {
+        return append(text, strlen(text));
+    }
+
+    ArenaString& append(const char* text, size_t n) {
+        if (cap == 0) {
+            clipped = true;
+            return *this;
+        }
+        size_t room = cap - 1 - len;
+        if (n > room) {
+            n = room;
+            clipped = true;
+        }
+        memcpy(buf + len, text, n);
+        len += n;
+        buf[len] = '\0';
+        return *this;
+    }
+
+    ArenaString& append(unsigned long value) {
+        char digits[12];
+        int n = snprintf(digits, sizeof(digits), "%lu", value);
+        return append(digits, n);
+    }
+
+    ArenaString& appendf(const char* format, ...) {
+        if (cap == 0) {
+            clipped = true;
+            return *this;
+        }
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buf + len, cap - len, format, args);
+        va_end(args);
+        if (n < 0) {
+            buf[len] = '\0';
+        } else if ((size_t)n >= cap - len) {
+            len = cap - 1;
+            clipped = true;
+        } else {
+            len += n;
+        }
+        return *this;
+    }
+
+    void clear() {
+        len = 0;
+        if (buf) {
+            buf[0] = '\0';
+        }
+    }
+
+    const char* c_str() const { return buf ? buf : ""; }
+    char* data() { return buf; }
+    size_t length() const { return len; }
+    size_t capacity() const { return cap; }
+    bool truncated() const { return clipped; }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool clipped;
+};
+
+// Raw byte buffer carved from an arena (decoded hex, signatures, ABI words)
+class ArenaBuffer {
+public:
+    ArenaBuffer(Arena& arena, size_t size)
+        : bytes(static_cast<uint8_t*>(arena.alloc(size))), len(bytes ? size : 0) {}
+
+    uint8_t* data() { return bytes; }
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return len; }
+    bool ok() const { return bytes != nullptr; }
+
+private:
+    uint8_t* bytes;
+    size_t len;
+};
+
+// std allocator over an arena, for containers that live inside a scope
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(Arena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        void* p = arena->alloc(n * sizeof(T), alignof(T));
+        return static_cast<T*>(p ? p : malloc(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        // Arena memory goes back when the scope ends
+        if (!arena->owns(p)) {
+            free(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+    Arena* arena;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,120 @@
+/*
+ * Boot Profile
+ *
+ * Timestamps the phases of setup() so time-to-ready can be measured and
+ * compared between normal and fast start (FAST_START in platformio.ini
+ * [env:esp32dev-fast]). Phases may overlap: each one has its own start and
+ * end, and a phase may be ended from another task than the one that
+ * started it.
+ *
+ *   int wifi = boot.begin("wifi");
+ *   ...
+ *   boot.end(wifi);
+ *   boot.ready();               // First useful action possible
+ *   boot.report(Serial);
+ *
+ * The first TLS handshake happens inside the first RPC, so it is not a
+ * phase of its own; the caller copies its timing in with handshake() and
+ * the report shows it under the phase that contains it.
+ *
+ * Times are micros() since the app started; the ROM and second-stage
+ * bootloaders (typically a few hundred ms) come before that and are not
+ * included.
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+// Overlap independent setup phases and skip fixed delays; -DFAST_START=1
+#ifndef FAST_START
+#define FAST_START 0
+#endif
+
+#define BOOT_MAX_PHASES 12
+
+struct BootPhase {
+    const char* name;
+    uint32_t startUs;
+    volatile uint32_t endUs;            // 0 while running
+};
+
+class BootProfile {
+public:
+    BootProfile() : count(0), readyUs(0), tlsStartUs(0), tlsEndUs(0), tlsResumed(false) {}
+
+    // Returns the phase handle for end(), or -1 when the table is full.
+    // Call from one task only.
+    int begin(const char* name) {
+        if (count == BOOT_MAX_PHASES) {
+            return -1;
+        }
+        BootPhase& p = phases[count];
+        p.name = name;
+        p.startUs = micros();
+        p.endUs = 0;
+        return count++;
+    }
+
+    void end(int phase) {
+        if (phase >= 0 && phase < count) {
+            uint32_t now = micros();
+            phases[phase].endUs = now ? now : 1;
+        }
+    }
+
+    void ready() {
+        if (readyUs == 0) {
+            readyUs = micros();
+        }
+    }
+
+    // First TLS handshake since boot, in micros(); kept once set
+    void handshake(uint32_t startUs, uint32_t endUs, bool resumed) {
+        if (tlsEndUs == 0 && endUs != 0) {
+            tlsStartUs = startUs;
+            tlsResumed = resumed;
+            tlsEndUs = endUs;
+        }
+    }
+
+    bool isReady() const { return readyUs != 0; }
+    uint32_t readyMs() const { return readyUs / 1000; }
+
+    void report(Print& out) const {
+        out.printf("Boot profile (%s start):\n", FAST_START ? "fast" : "normal");
+        uint32_t serialUs = 0;
+        for (int i = 0; i < count; i++) {
+            const BootPhase& p = phases[i];
+            if (p.endUs) {
+                serialUs += p.endUs - p.startUs;
+                out.printf("  %-14s at %6lu ms  took %6lu ms\n", p.name, (unsigned long)(p.startUs / 1000),
+                           (unsigned long)((p.endUs - p.startUs) / 1000));
+            } else {
+                out.printf("  %-14s at %6lu ms  running\n", p.name, (unsigned long)(p.startUs / 1000));
+            }
+        }
+        if (tlsEndUs) {
+            out.printf("  %-14s at %6lu ms  took %6lu ms (%s)\n", "tls handshake", (unsigned long)(tlsStartUs / 1000),
+                       (unsigned long)((tlsEndUs - tlsStartUs) / 1000), tlsResumed ? "resumed" : "full");
+        }
+        if (readyUs) {
+            // More time in phases than wall clock means phases overlapped
+            out.printf("  ready at %lu ms (phases sum to %lu ms)\n", (unsigned long)(readyUs / 1000),
+                       (unsigned long)(serialUs / 1000));
+        } else {
+            out.println("  not ready yet");
+        }
+    }
+
+private:
+    BootPhase phases[BOOT_MAX_PHASES];
+    volatile int count;
+    volatile uint32_t readyUs;
+    uint32_t tlsStartUs;
+    volatile uint32_t tlsEndUs;
+    bool tlsResumed;
+};
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,81 @@
+/*
+ * EIP-712 Typed Data implementation
+ *
+ * Signing and recovery go straight to the secp256k1 code bundled with
+ * Web3E (Trezor crypto), on 32-byte digests.
+ */
+
+#include "eip712.h"
+
+extern "C" {
+#include <Trezor/ecdsa.h>
+#include <Trezor/secp256k1.h>
+}
+
+// secp256k1 group order / 2; canonical signatures have s at or below it
+static const uint8_t HALF_ORDER[32] = {
+    0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x5D, 0x57, 0x6E, 0x73, 0x57, 0xA4, 0x50, 0x1D, 0xDF, 0xE9, 0x2F, 0x46, 0x68, 0x1B, 0x20, 0xA0,
+};
+
+static bool canonical(const uint8_t signature[65]) {
+    uint8_t v = signature[64];
+    return (v == 27 || v == 28) && memcmp(signature + 32, HALF_ORDER, 32) <= 0;
+}
+
+Eip712Signer::Eip712Signer() : ready(false) {
+    memset(key, 0, sizeof(key));
+}
+
+bool Eip712Signer::begin(const char* privateKey) {
+    if (privateKey && privateKey[0] == '0' && (privateKey[1] == 'x' || privateKey[1] == 'X')) {
+        privateKey += 2;
+    }
+    if (!privateKey || strlen(privateKey) != 64 || !Hex::decode(privateKey, key, 32)) {
+        ready = false;
+        return false;
+    }
+
+    uint8_t pub65[65];
+    ecdsa_get_public_key65(&secp256k1, key, pub65);
+    memcpy(pub, pub65 + 1, 64);
+    publicKeyToAddress(pub, addr);
+    ready = true;
+    return true;
+}
+
+bool Eip712Signer::sign(const uint8_t digest[32], uint8_t signature[65]) const {
+    uint8_t recid = 0;
+    if (!ready || ecdsa_sign_digest(&secp256k1, key, digest, signature, &recid, nullptr) != 0) {
+        return false;
+    }
+    signature[64] = 27 + recid;
+    return true;
+}
+
+bool Eip712Signer::recover(const uint8_t digest[32], const uint8_t signature[65], uint8_t address[20],
+                           uint8_t publicKey[64]) {
+    uint8_t pub65[65];
+    if (!canonical(signature) ||
+        ecdsa_recover_pub_from_sig(&secp256k1, pub65, signature, digest, signature[64] - 27) != 0) {
+        return false;
+    }
+    publicKeyToAddress(pub65 + 1, address);
+    if (publicKey) {
+        memcpy(publicKey, pub65 + 1, 64);
+    }
+    return true;
+}
+
+bool Eip712Signer::verify(const uint8_t publicKey[64], const uint8_t digest[32], const uint8_t signature[65]) {
+    uint8_t pub65[65];
+    pub65[0] = 0x04;
+    memcpy(pub65 + 1, publicKey, 64);
+    return canonical(signature) && ecdsa_verify_digest(&secp256k1, pub65, signature, digest) == 0;
+}
+
+void Eip712Signer::publicKeyToAddress(const uint8_t publicKey[64], uint8_t address[20]) {
+    uint8_t hash[32];
+    Crypto::Keccak256(publicKey, 64, hash);
+    memcpy(address, hash + 12, 20);
+}
@@ -0,0 +1,287 @@
+/*
+ * EIP-712 Typed Data
+ *
+ * Domain separators, struct hashes and signing digests for EIP-712 typed
+ * data, plus a signer over the raw digest. This lets a device exchange
+ * signed vouchers off chain and settle now and then, instead of sending
+ * a transaction per use (see voucher.h).
+ *
+ *   static Eip712Type MAIL("Mail(address to,string contents)");
+ *   static Eip712Domain DOMAIN("Ether Mail", "1", CHAIN_ID, CONTRACT);
+ *   Eip712Struct mail(MAIL);
+ *   mail.address(to).text("Hello");
+ *   uint8_t digest[32], signature[65];
+ *   DOMAIN.digest(mail, digest);
+ *   signer.sign(digest, signature);
+ *
+ * Each type hashes its type string once, on first use, and each domain
+ * computes its separator once. A struct encodes into a fixed buffer
+ * inside Eip712Struct and is hashed with one Keccak call, so nothing is
+ * allocated. Fields are added in the order of the type string. Strings,
+ * bytes and nested structs go in as their hashes, as the spec encodes
+ * them; arrays are not supported.
+ */
+
+#ifndef EIP712_H
+#define EIP712_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <Crypto.h>
+#include <uint256/uint256_t.h>
+
+#include "abi.h"
+#include "hex.h"
+
+#define EIP712_MAX_FIELDS 12
+
+class Eip712Type {
+public:
+    // encoding is the full encodeType string, referenced types included
+    // and sorted as the spec requires; it must outlive the type
+    explicit Eip712Type(const char* encoding) : encoding(encoding), fields(0), cached(false) {}
+
+    const uint8_t* typeHash() {
+        load();
+        return hash;
+    }
+
+    // Members of the primary type (the first one in the encoding)
+    uint8_t fieldCount() {
+        load();
+        return fields;
+    }
+
+    const char* encodeType() const { return encoding; }
+
+private:
+    const char* encoding;
+    uint8_t hash[32];
+    uint8_t fields;
+    bool cached;
+
+    void load() {
+        if (cached) {
+            return;
+        }
+        Crypto::Keccak256((const uint8_t*)encoding, (uint16_t)strlen(encoding), hash);
+        const char* open = strchr(encoding, '(');
+        fields = 0;
+        if (open && open[1] != ')') {
+            fields = 1;
+            for (const char* p = open + 1; *p && *p != ')'; p++) {
+                fields += *p == ',';
+            }
+        }
+        cached = true;
+    }
+};
+
+class Eip712Struct {
+public:
+    explicit Eip712Struct(Eip712Type& type) : type(type), count(0), bad(false) {}
+
+    Eip712Struct& address(const uint8_t addr[20]) {
+        uint8_t* w = next();
+        if (w) {
+            memcpy(w + 12, addr, 20);
+        }
+        return *this;
+    }
+
+    // 0x-prefixed, 40 hex digits; anything else makes hash() fail
+    Eip712Struct& address(const char* addr) {
+        uint8_t parsed[20];
+        if (!Hex::parseAddress(addr, parsed)) {
+            bad = true;
+            return *this;
+        }
+        return address(parsed);
+    }
+
+    Eip712Struct& uint(uint64_t value) {
+        uint8_t* w = next();
+        if (w) {
+            putBE64(w + 24, value);
+        }
+        return *this;
+    }
+
+    Eip712Struct& uint(const uint256_t& value) {
+        uint8_t* w = next();
+        if (w) {
+            putBE64(w, value.upper().upper());
+            putBE64(w + 8, value.upper().lower());
+            putBE64(w + 16, value.lower().upper());
+            putBE64(w + 24, value.lower().lower());
+        }
+        return *this;
+    }
+
+    // Two's complement, sign-extended to 256 bits
+    Eip712Struct& integer(int64_t value) {
+        uint8_t* w = next();
+        if (w) {
+            memset(w, value < 0 ? 0xFF : 0x00, 24);
+            putBE64(w + 24, (uint64_t)value);
+        }
+        return *this;
+    }
+
+    Eip712Struct& boolean(bool value) {
+        return uint(value ? 1ULL : 0ULL);
+    }
+
+    // bytesN: left-aligned, zero-padded
+    Eip712Struct& fixedBytes(const uint8_t* data, size_t n) {
+        uint8_t* w = next();
+        if (w && n <= 32) {
+            memcpy(w, data, n);
+        } else {
+            bad = true;
+        }
+        return *this;
+    }
+
+    // string and bytes are encoded as keccak256 of their contents
+    Eip712Struct& text(const char* value) {
+        return bytes((const uint8_t*)value, strlen(value));
+    }
+
+    Eip712Struct& bytes(const uint8_t* data, size_t n) {
+        uint8_t* w = next();
+        if (w) {
+            Crypto::Keccak256(data, (uint16_t)n, w);
+        }
+        return *this;
+    }
+
+    // A member of struct type is encoded as that struct's hash
+    Eip712Struct& nested(Eip712Struct& member) {
+        uint8_t* w = next();
+        if (w && !member.hash(w)) {
+            bad = true;
+        }
+        return *this;
+    }
+
+    // hashStruct: keccak256(typeHash || encodeData). Fails when a field
+    // was invalid or the field count does not match the type.
+    bool hash(uint8_t out[32]) {
+        if (bad || count != type.fieldCount()) {
+            return false;
+        }
+        memcpy(words, type.typeHash(), 32);
+        Crypto::Keccak256(words, (uint16_t)((count + 1) * 32), out);
+        return true;
+    }
+
+    // Reuse the buffer for another value of the same type
+    void reset() {
+        count = 0;
+        bad = false;
+    }
+
+private:
+    Eip712Type& type;
+    uint8_t words[(EIP712_MAX_FIELDS + 1) * 32];    // Type hash, then one word per field
+    uint8_t count;
+    bool bad;
+
+    uint8_t* next() {
+        if (count >= EIP712_MAX_FIELDS) {
+            bad = true;
+            return nullptr;
+        }
+        uint8_t* w = words + 32 * (++count);
+        memset(w, 0, 32);
+        return w;
+    }
+
+    static void putBE64(uint8_t* p, uint64_t v) {
+        for (int i = 7; i >= 0; i--, v >>= 8) {
+            p[i] = (uint8_t)v;
+        }
+    }
+};
+
+// EIP712Domain with name, version, chainId and, unless null,
+// verifyingContract. Other domain fields (salt) are not supported.
+class Eip712Domain {
+public:
+    Eip712Domain(const char* name, const char* version, uint64_t chainId, const char* verifyingContract = nullptr)
+        : name(name), version(version), chainId(chainId), contract(verifyingContract), cached(false), bad(false) {}
+
+    // Null when verifyingContract is not a valid address
+    const uint8_t* separator() {
+        if (!cached) {
+            static Eip712Type full("EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)");
+            static Eip712Type noContract("EIP712Domain(string name,string version,uint256 chainId)");
+            Eip712Struct domain(contract ? full : noContract);
+            domain.text(name).text(version).uint(chainId);
+            if (contract) {
+                domain.address(contract);
+            }
+            bad = !domain.hash(sep);
+            cached = true;
+        }
+        return bad ? nullptr : sep;
+    }
+
+    // keccak256("\x19\x01" || domainSeparator || hashStruct(message))
+    bool digest(Eip712Struct& message, uint8_t out[32]) {
+        uint8_t buf[66] = {0x19, 0x01};
+        const uint8_t* s = separator();
+        if (!s || !message.hash(buf + 34)) {
+            return false;
+        }
+        memcpy(buf + 2, s, 32);
+        Crypto::Keccak256(buf, sizeof(buf), out);
+        return true;
+    }
+
+private:
+    const char* name;
+    const char* version;
+    uint64_t chainId;
+    const char* contract;
+    uint8_t sep[32];
+    bool cached;
+    bool bad;
+};
+
+// Signs digests directly with secp256k1: no hex strings, no personal
+// message prefix, and always low-s as Ethereum requires.
+// Signatures are r || s || v with v = 27 or 28.
+class Eip712Signer {
+public:
+    Eip712Signer();
+
+    // 64 hex digits, with or without 0x
+    bool begin(const char* privateKey);
+
+    bool sign(const uint8_t digest[32], uint8_t signature[65]) const;
+
+    const uint8_t* address() const { return addr; }
+    const uint8_t* publicKey() const { return pub; }
+
+    // Signer address (and, if asked, public key) of a signature; rejects
+    // high-s and malformed ones
+    static bool recover(const uint8_t digest[32], const uint8_t signature[65], uint8_t address[20],
+                        uint8_t publicKey[64] = nullptr);
+
+    // Cheaper than recover() when the signer's public key (64 bytes, x || y)
+    // is already known, e.g. from an earlier recover()
+    static bool verify(const uint8_t publicKey[64], const uint8_t digest[32], const uint8_t signature[65]);
+
+    static void publicKeyToAddress(const uint8_t publicKey[64], uint8_t address[20]);
+
+private:
+    uint8_t key[32];
+    uint8_t pub[64];
+    uint8_t addr[20];
+    bool ready;
+};
+
+#endif // EIP712_H
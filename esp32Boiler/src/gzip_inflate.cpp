@@ -0,0 +1,180 @@
+/*
+ * Gzip Inflater implementation
+ */
+
+#include "gzip_inflate.h"
+
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+#define GZIP_FLAG_RESERVED 0xE0
+
+GzipInflater::GzipInflater(std::string* out, size_t maxOutput)
+    : out(out), maxOutput(maxOutput), decomp(nullptr), inBytes(0), outBytes(0), state(HEADER),
+      part(FIXED), flags(0), pos(0), skip(0) {
+    out->clear();
+}
+
+GzipInflater::~GzipInflater() {
+    delete decomp;
+    if (state == HEADER || state == BODY) {
+        out->resize(outBytes);       // Truncated body: drop the unused tail
+    }
+}
+
+bool GzipInflater::feed(const uint8_t* data, size_t len) {
+    inBytes += len;
+    while (len > 0 && state != FAILED) {
+        size_t used = 1;
+        switch (state) {
+        case HEADER:
+            if (!header(*data)) {
+                fail();
+            }
+            break;
+        case BODY:
+            used = inflate(data, len);
+            break;
+        case TRAILER:
+            trailer[pos++] = *data;
+            if (pos == sizeof(trailer)) {
+                // ISIZE: inflated length mod 2^32, little endian
+                uint32_t size = trailer[4] | trailer[5] << 8 | trailer[6] << 16 | (uint32_t)trailer[7] << 24;
+                if (size == (uint32_t)outBytes) {
+                    state = DONE;
+                } else {
+                    fail();
+                }
+            }
+            break;
+        default:
+            used = len;                  // Anything after the first member is ignored
+            break;
+        }
+        data += used;
+        len -= used;
+    }
+    return state != FAILED;
+}
+
+// ===== HEADER =====
+bool GzipInflater::header(uint8_t b) {
+    switch (part) {
+    case FIXED:
+        // magic 1f 8b, method 8 (deflate), flags, mtime, xfl, os
+        if ((pos == 0 && b != 0x1F) || (pos == 1 && b != 0x8B) || (pos == 2 && b != 8) ||
+            (pos == 3 && (b & GZIP_FLAG_RESERVED))) {
+            return false;
+        }
+        if (pos == 3) {
+            flags = b;
+        }
+        if (++pos == 10) {
+            nextHeaderPart();
+        }
+        break;
+    case EXTRA_LENGTH:
+        skip |= (uint16_t)b << (8 * pos);
+        if (++pos == 2) {
+            part = EXTRA;
+            if (skip == 0) {
+                nextHeaderPart();
+            }
+        }
+        break;
+    case EXTRA:
+    case HEADER_CRC:
+        if (--skip == 0) {
+            nextHeaderPart();
+        }
+        break;
+    case NAME:
+    case COMMENT:
+        if (b == 0) {
+            nextHeaderPart();
+        }
+        break;
+    }
+    return true;
+}
+
+void GzipInflater::nextHeaderPart() {
+    pos = 0;
+    skip = 0;
+    if (flags & GZIP_FLAG_EXTRA) {
+        flags &= ~GZIP_FLAG_EXTRA;
+        part = EXTRA_LENGTH;
+    } else if (flags & GZIP_FLAG_NAME) {
+        flags &= ~GZIP_FLAG_NAME;
+        part = NAME;
+    } else if (flags & GZIP_FLAG_COMMENT) {
+        flags &= ~GZIP_FLAG_COMMENT;
+        part = COMMENT;
+    } else if (flags & GZIP_FLAG_HCRC) {
+        flags &= ~GZIP_FLAG_HCRC;
+        part = HEADER_CRC;
+        skip = 2;
+    } else {
+        decomp = new tinfl_decompressor;
+        tinfl_init(decomp);
+        state = BODY;
+    }
+}
+
+// ===== BODY =====
+// Returns the compressed bytes used; fewer than len once the deflate stream
+// ends and the rest belongs to the trailer
+size_t GzipInflater::inflate(const uint8_t* data, size_t len) {
+    size_t used = 0;
+    for (;;) {
+        if (outBytes == out->size() && !grow()) {
+            fail();
+            return len;
+        }
+
+        // Non-wrapping output: back references point into the reply itself.
+        // The base is passed on every call, so growing (moving) it is fine.
+        uint8_t* base = reinterpret_cast<uint8_t*>(&(*out)[0]);
+        size_t inSize = len - used;
+        size_t outSize = out->size() - outBytes;
+        tinfl_status status =
+            tinfl_decompress(decomp, data + used, &inSize, base, base + outBytes, &outSize,
+                             TINFL_FLAG_HAS_MORE_INPUT | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+        used += inSize;
+        outBytes += outSize;
+
+        if (status == TINFL_STATUS_DONE) {
+            delete decomp;
+            decomp = nullptr;
+            out->resize(outBytes);
+            state = TRAILER;
+            pos = 0;
+            return used;
+        }
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && used == len) {
+            return used;
+        }
+        if (status < 0 || (inSize == 0 && outSize == 0 && status != TINFL_STATUS_HAS_MORE_OUTPUT)) {
+            fail();                      // Corrupt, or no progress possible
+            return len;
+        }
+    }
+}
+
+bool GzipInflater::grow() {
+    size_t size = out->size();
+    if (size >= maxOutput) {
+        return false;
+    }
+    size = size < GZIP_MIN_GROWTH ? GZIP_MIN_GROWTH : size * 2;
+    out->resize(size < maxOutput ? size : maxOutput);
+    return true;
+}
+
+void GzipInflater::fail() {
+    delete decomp;
+    decomp = nullptr;
+    out->clear();
+    state = FAILED;
+}
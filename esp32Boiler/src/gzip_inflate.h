@@ -0,0 +1,75 @@
+/*
+ * Gzip Inflater
+ *
+ * Streaming gzip decoder for HTTP bodies sent with Content-Encoding: gzip.
+ * JSON-RPC replies are mostly hex digits and repeated keys, so log queries,
+ * Device[] reads and receipts typically shrink 3-6x on the wire.
+ *
+ * Compressed bytes are fed in whatever pieces the network delivers and are
+ * inflated straight into the reply string the JSON handling reads, so there
+ * is no compressed copy and no separate 32 KB history window: the output
+ * itself serves as the deflate window. Inflation uses the tinfl decoder in
+ * the ESP32 ROM; its ~11 KB state lives on the heap only while a body is
+ * being decoded.
+ *
+ *   std::string reply;
+ *   GzipInflater gz(&reply, RPC_INFLATE_MAX);
+ *   while (...) gz.feed(chunk, n);
+ *   if (gz.finished()) parse(reply);
+ *
+ * The trailer length is checked; the CRC is not, since the body already
+ * arrived over an authenticated TLS connection.
+ */
+
+#ifndef GZIP_INFLATE_H
+#define GZIP_INFLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include <rom/miniz.h>
+
+#define GZIP_MIN_GROWTH 1024        // First output allocation; doubles after
+
+class GzipInflater {
+public:
+    // out is cleared; inflated output beyond maxOutput is an error
+    GzipInflater(std::string* out, size_t maxOutput);
+    ~GzipInflater();
+
+    // Next piece of the compressed body. False once the stream turned out
+    // malformed or too large; later calls then do nothing.
+    bool feed(const uint8_t* data, size_t len);
+
+    // Whole member decoded and the trailer length matched
+    bool finished() const { return state == DONE; }
+    bool failed() const { return state == FAILED; }
+
+    size_t consumed() const { return inBytes; }   // Compressed bytes fed
+    size_t produced() const { return outBytes; }  // Inflated bytes in out
+
+private:
+    enum State : uint8_t { HEADER, BODY, TRAILER, DONE, FAILED };
+    enum HeaderPart : uint8_t { FIXED, EXTRA_LENGTH, EXTRA, NAME, COMMENT, HEADER_CRC };
+
+    std::string* out;
+    size_t maxOutput;
+    tinfl_decompressor* decomp;
+    size_t inBytes;
+    size_t outBytes;
+    State state;
+    HeaderPart part;
+    uint8_t flags;
+    uint8_t pos;
+    uint16_t skip;
+    uint8_t trailer[8];
+
+    bool header(uint8_t b);
+    void nextHeaderPart();
+    size_t inflate(const uint8_t* data, size_t len);
+    bool grow();
+    void fail();
+};
+
+#endif // GZIP_INFLATE_H
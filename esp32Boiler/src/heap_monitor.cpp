@@ -0,0 +1,140 @@
+/*
+ * Heap Monitor implementation
+ */
+
+#include "heap_monitor.h"
+
+#include <esp_heap_caps.h>
+
+static volatile uint32_t allocCount = 0;
+
+#ifdef HEAP_MONITOR_WRAP
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so every heap
+// allocation in the image, including operator new and mbedTLS, passes here
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* p, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* p, size_t size) {
+    __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+    return __real_realloc(p, size);
+}
+}
+#endif
+
+uint32_t heapAllocCount() {
+    return allocCount;
+}
+
+HeapMonitor::HeapMonitor() {
+    reset();
+}
+
+void HeapMonitor::reset() {
+    memset(ops, 0, sizeof(ops));
+    count = 0;
+}
+
+HeapSample HeapMonitor::sample() {
+    HeapSample s;
+    s.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    s.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    s.allocs = heapAllocCount();
+    return s;
+}
+
+uint8_t HeapMonitor::fragmentation(const HeapSample& s) {
+    if (s.freeBytes == 0) {
+        return 100;
+    }
+    return 100 - (uint8_t)((uint64_t)s.largestBlock * 100 / s.freeBytes);
+}
+
+int HeapMonitor::add(const char* name, uint32_t allocBudget) {
+    if (count == HEAP_MONITOR_MAX_OPS) {
+        return -1;
+    }
+    ops[count].name = name;
+    ops[count].allocBudget = allocBudget;
+    ops[count].minLargestBlock = UINT32_MAX;
+    return count++;
+}
+
+void HeapMonitor::run(int id, bool (*fn)()) {
+    if (id < 0 || id >= count) {
+        return;
+    }
+    HeapOpStats& op = ops[id];
+
+    // The ESP-IDF low-water mark is global and never rises, so a run only
+    // registers a peak when it drives the heap to a new low
+    HeapSample before = sample();
+    uint32_t lowBefore = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    bool ok;
+    try {
+        ok = fn();
+    } catch (...) {
+        ok = false;
+    }
+    HeapSample after = sample();
+    uint32_t lowAfter = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+
+    op.runs++;
+    op.failures += !ok;
+    op.allocs += after.allocs - before.allocs;
+    if (lowAfter < lowBefore && before.freeBytes - lowAfter > op.peakUsed) {
+        op.peakUsed = before.freeBytes - lowAfter;
+    }
+
+    uint8_t frag = fragmentation(after);
+    if (frag > op.worstFragPct) {
+        op.worstFragPct = frag;
+    }
+    if (after.largestBlock < op.minLargestBlock) {
+        op.minLargestBlock = after.largestBlock;
+    }
+
+    if (op.runs == SOAK_WARMUP_RUNS) {
+        op.baselineFree = after.freeBytes;
+    } else if (op.runs > SOAK_WARMUP_RUNS) {
+        op.leaked = (int32_t)op.baselineFree - (int32_t)after.freeBytes;
+    }
+}
+
+bool HeapMonitor::check(Print& out) const {
+    bool pass = true;
+
+    out.println("op          runs  fail  allocs/run  peak   leak  frag%  min block");
+    for (int i = 0; i < count; i++) {
+        const HeapOpStats& op = ops[i];
+        uint32_t perRun = op.runs ? op.allocs / op.runs : 0;
+
+        bool ok = op.leaked <= SOAK_LEAK_BUDGET_BYTES &&
+                  op.worstFragPct <= SOAK_FRAG_BUDGET_PCT &&
+                  op.minLargestBlock >= SOAK_MIN_LARGEST_BLOCK &&
+                  (uint64_t)op.failures * 100 <= (uint64_t)op.runs * SOAK_FAIL_BUDGET_PCT;
+#ifdef HEAP_MONITOR_WRAP
+        ok = ok && perRun <= op.allocBudget;
+#endif
+
+        out.printf("%-10s %5lu %5lu %11lu %6lu %6ld %6u %10lu  %s\n",
+                   op.name, (unsigned long)op.runs, (unsigned long)op.failures,
+                   (unsigned long)perRun, (unsigned long)op.peakUsed, (long)op.leaked,
+                   op.worstFragPct, (unsigned long)op.minLargestBlock, ok ? "ok" : "OVER BUDGET");
+        pass = pass && ok;
+    }
+
+    out.println(pass ? "SOAK PASS" : "SOAK FAIL");
+    return pass;
+}
@@ -0,0 +1,91 @@
+/*
+ * Heap Monitor
+ *
+ * Tracks what each firmware operation does to the heap over many runs, so
+ * slow leaks and fragmentation show up on the bench instead of in a field
+ * unit after weeks of uptime.
+ *
+ * For every operation type it records runs, failed runs, heap allocations
+ * (soak build only, see platformio.ini [env:esp32dev-soak]), peak usage,
+ * fragmentation (largest free block vs total free) and net leak after a
+ * warm-up period. check() compares the results against budgets and
+ * reports PASS/FAIL. tools/heap_soak runs the same monitor on a PC.
+ */
+
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <Arduino.h>
+
+// Budgets; override with -D in build_flags
+#ifndef SOAK_ITERATIONS
+#define SOAK_ITERATIONS 1000
+#endif
+#ifndef SOAK_WARMUP_RUNS
+#define SOAK_WARMUP_RUNS 10            // Lazy init and caches settle here
+#endif
+#ifndef SOAK_LEAK_BUDGET_BYTES
+#define SOAK_LEAK_BUDGET_BYTES 256     // Net heap loss per operation type
+#endif
+#ifndef SOAK_FRAG_BUDGET_PCT
+#define SOAK_FRAG_BUDGET_PCT 50        // 100 - largest block / free heap
+#endif
+#ifndef SOAK_MIN_LARGEST_BLOCK
+#define SOAK_MIN_LARGEST_BLOCK 40000   // A TLS handshake needs roughly this much
+#endif
+#ifndef SOAK_ALLOC_BUDGET
+#define SOAK_ALLOC_BUDGET 400          // Heap allocations per run (soak build only)
+#endif
+#ifndef SOAK_FAIL_BUDGET_PCT
+#define SOAK_FAIL_BUDGET_PCT 1         // Runs that may fail, e.g. on a flaky public node
+#endif
+
+#define HEAP_MONITOR_MAX_OPS 8
+
+struct HeapSample {
+    uint32_t freeBytes;
+    uint32_t largestBlock;
+    uint32_t allocs;
+};
+
+struct HeapOpStats {
+    const char* name;
+    uint32_t runs;
+    uint32_t failures;          // Runs that returned false or threw
+    uint32_t allocs;            // Total heap allocations
+    uint32_t allocBudget;       // Allocations allowed per run
+    uint32_t peakUsed;          // Largest heap drop seen during one run
+    uint32_t baselineFree;      // Free heap after warm-up
+    int32_t leaked;             // baselineFree - free heap after last run
+    uint8_t worstFragPct;
+    uint32_t minLargestBlock;
+};
+
+class HeapMonitor {
+public:
+    HeapMonitor();
+
+    static HeapSample sample();
+    static uint8_t fragmentation(const HeapSample& s);
+
+    // Register an operation type; returns its id or -1 when full
+    int add(const char* name, uint32_t allocBudget = SOAK_ALLOC_BUDGET);
+
+    // Run fn once and account its heap effect to operation id; fn returns
+    // false when the operation did not do its job
+    void run(int id, bool (*fn)());
+
+    // Print per-operation results; returns true when all budgets hold
+    bool check(Print& out) const;
+
+    void reset();
+
+private:
+    HeapOpStats ops[HEAP_MONITOR_MAX_OPS];
+    int count;
+};
+
+// Heap allocations since boot; only counts in builds with HEAP_MONITOR_WRAP
+uint32_t heapAllocCount();
+
+#endif // HEAP_MONITOR_H
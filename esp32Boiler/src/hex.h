@@ -0,0 +1,202 @@
+/*
+ * Hex Codec
+ *
+ * Every byte on the RPC path crosses hex at least once: calldata going
+ * out, results and logs coming back, addresses, signatures and keys. All
+ * of it goes through here. Decoding looks each character up in a
+ * 256-entry table where non-digits map to 0xFF, so a whole run is
+ * validated by OR-ing the looked-up values and testing the high bits once
+ * at the end. Encoding writes each byte as one entry of a 512-character
+ * pair table.
+ *
+ *   uint8_t user[20];
+ *   Hex::parseAddress("0xAb5801a7...", user);      // 0x + 40 digits, any case
+ *   Hex::addressEquals(recovered, claimed);        // Compared as 20 bytes
+ *
+ *   char text[2 * 32 + 3];
+ *   Serial.println(Hex::format(digest, 32, text, sizeof(text)));
+ *
+ * Header-only so the examples can share it with src/main.cpp.
+ */
+
+#ifndef HEX_H
+#define HEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HEX_ADDRESS_CHARS 43                // "0x", 40 digits and the terminator
+
+class Hex {
+public:
+    // Value of one digit, or -1
+    static int nibble(char c) {
+        uint8_t v = values()[(uint8_t)c];
+        return v == INVALID ? -1 : v;
+    }
+
+    // 2n lowercase digits; no prefix, no terminator
+    static void encode(const uint8_t* data, size_t n, char* out) {
+        const char* pairs = digitPairs();
+        for (size_t i = 0; i < n; i++) {
+            memcpy(out + 2 * i, pairs + 2 * data[i], 2);
+        }
+    }
+
+    // Expands the first n bytes of buf into 2n digits in the same buffer,
+    // which must hold 2n chars. Runs back to front so no byte is
+    // overwritten before it is read.
+    static void encodeInPlace(uint8_t* buf, size_t n) {
+        const char* pairs = digitPairs();
+        for (size_t i = n; i-- > 0;) {
+            memcpy(buf + 2 * i, pairs + 2 * buf[i], 2);
+        }
+    }
+
+    // "0x" + 2n digits into a fixed buffer of cap >= 2n + 3. Returns out,
+    // which is left empty if it is too small, so it can go straight into
+    // a print call.
+    static const char* format(const uint8_t* data, size_t n, char* out, size_t cap) {
+        if (cap < 2 * n + 3) {
+            if (cap) {
+                out[0] = '\0';
+            }
+            return out;
+        }
+        out[0] = '0';
+        out[1] = 'x';
+        encode(data, n, out + 2);
+        out[2 + 2 * n] = '\0';
+        return out;
+    }
+
+    // The lowest `digits` nibbles of value, most significant first
+    static void encodeWord(uint64_t value, int digits, char* out) {
+        const char* pairs = digitPairs();
+        int i = digits;
+        for (; i >= 2; i -= 2, value >>= 8) {
+            memcpy(out + i - 2, pairs + 2 * (value & 0xFF), 2);
+        }
+        if (i) {
+            out[0] = pairs[2 * (value & 0xF) + 1];
+        }
+    }
+
+    // n bytes from exactly 2n digits (no prefix); false on any non-digit.
+    // out may be partly written on failure.
+    static bool decode(const char* hex, uint8_t* out, size_t n) {
+        const uint8_t* table = values();
+        uint8_t bad = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint8_t hi = table[(uint8_t)hex[2 * i]];
+            uint8_t lo = table[(uint8_t)hex[2 * i + 1]];
+            bad |= hi | lo;
+            out[i] = hi << 4 | lo;
+        }
+        return (bad & 0xF0) == 0;
+    }
+
+    // Hex text (optional 0x, even number of digits, terminated) turned into
+    // bytes at the start of the same buffer; *n receives the byte count.
+    // Byte i is written at i while digits 2i and 2i + 1 are read at or
+    // after it, so nothing is clobbered before use.
+    static bool decodeInPlace(char* text, size_t* n) {
+        const char* hex = text;
+        if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+            hex += 2;
+        }
+        size_t len = strlen(hex);
+        if (len % 2) {
+            return false;
+        }
+        if (!decode(hex, (uint8_t*)text, len / 2)) {
+            return false;
+        }
+        *n = len / 2;
+        return true;
+    }
+
+    // Up to 16 digits as one big-endian word
+    static bool word(const char* hex, size_t digits, uint64_t* out) {
+        const uint8_t* table = values();
+        uint8_t bad = digits > 16 ? INVALID : 0;
+        uint64_t value = 0;
+        for (size_t i = 0; i < digits && i < 16; i++) {
+            uint8_t v = table[(uint8_t)hex[i]];
+            bad |= v;
+            value = value << 4 | (v & 0xF);
+        }
+        if (bad & 0xF0) {
+            return false;
+        }
+        *out = value;
+        return true;
+    }
+
+    // "0x" or "0X" and exactly 40 digits in either case
+    static bool parseAddress(const char* text, uint8_t out[20]) {
+        return addressShape(text) && decode(text + 2, out, 20);
+    }
+
+    // Same account regardless of checksum casing; false if either side is
+    // not an address. One pass over both, comparing digit values rather
+    // than characters.
+    static bool addressEquals(const char* a, const char* b) {
+        if (!addressShape(a) || !addressShape(b)) {
+            return false;
+        }
+        const uint8_t* table = values();
+        uint8_t bad = 0, diff = 0;
+        for (int i = 2; i < 42; i++) {
+            uint8_t x = table[(uint8_t)a[i]];
+            uint8_t y = table[(uint8_t)b[i]];
+            bad |= x | y;
+            diff |= x ^ y;
+        }
+        return (bad & 0xF0) == 0 && diff == 0;
+    }
+
+private:
+    static const uint8_t INVALID = 0xFF;
+
+    static bool addressShape(const char* text) {
+        return text && text[0] == '0' && (text[1] == 'x' || text[1] == 'X') && strnlen(text + 2, 41) == 40;
+    }
+
+    static const uint8_t* values() {
+        static const uint8_t TABLE[256] = {
+#define XX INVALID
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+             0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+            XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+            XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+#undef XX
+        };
+        return TABLE;
+    }
+
+    // "000102...feff": byte b is at 2 * b
+    static const char* digitPairs() {
+#define HEX_ROW(h) h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" h "8" h "9" h "a" h "b" h "c" h "d" h "e" h "f"
+        static const char PAIRS[] = HEX_ROW("0") HEX_ROW("1") HEX_ROW("2") HEX_ROW("3") HEX_ROW("4") HEX_ROW("5")
+            HEX_ROW("6") HEX_ROW("7") HEX_ROW("8") HEX_ROW("9") HEX_ROW("a") HEX_ROW("b") HEX_ROW("c") HEX_ROW("d")
+            HEX_ROW("e") HEX_ROW("f");
+#undef HEX_ROW
+        return PAIRS;
+    }
+};
+
+#endif // HEX_H
@@ -0,0 +1,159 @@
+/*
+ * Meta-Transaction Client implementation
+ */
+
+#include "meta_tx.h"
+
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <time.h>
+
+MetaTxClient::MetaTxClient(const char* forwarder, const char* relayerUrl, uint64_t chainId)
+    : relayerUrl(relayerUrl), domain(META_TX_DOMAIN_NAME, "1", chainId, forwarder),
+      nonce(0), synced(false) {
+    from[0] = '\0';
+    memset(&counters, 0, sizeof(counters));
+}
+
+bool MetaTxClient::begin(const char* privateKey) {
+    if (!signer.begin(privateKey) || !domain.separator()) {
+        return false;
+    }
+    Hex::format(signer.address(), 20, from, sizeof(from));
+    synced = false;
+    return true;
+}
+
+bool MetaTxClient::send(const char* to, const char* data, uint32_t gas, MetaTxReceipt* receipt) {
+    static Eip712Type type(META_TX_TYPE);
+    uint8_t calldata[META_TX_DATA_MAX];
+    size_t hexLen = data ? strlen(data) : 0;
+    size_t len = hexLen >= 2 ? (hexLen - 2) / 2 : 0;
+    if (hexLen < 2 || data[0] != '0' || data[1] != 'x' || hexLen % 2 != 0 || len > sizeof(calldata) ||
+        !Hex::decode(data + 2, calldata, len)) {
+        return false;
+    }
+    if (!synced && !syncNonce()) {
+        counters.failed++;
+        return false;
+    }
+
+    time_t now = time(nullptr);
+    uint64_t deadline = now > 1600000000 ? (uint64_t)now + META_TX_DEADLINE_S : 0;
+
+    Eip712Struct forward(type);
+    forward.address(signer.address()).address(to).uint(0ULL).uint((uint64_t)gas).uint(nonce).uint(deadline);
+    forward.bytes(calldata, len);
+    uint8_t digest[32], signature[65];
+    if (!domain.digest(forward, digest) || !signer.sign(digest, signature)) {
+        return false;
+    }
+
+    char sigHex[133];
+    char head[256];
+    Hex::format(signature, sizeof(signature), sigHex, sizeof(sigHex));
+    snprintf(head, sizeof(head),
+             "{\"from\":\"%s\",\"to\":\"%s\",\"value\":\"0\",\"gas\":\"%lu\",\"nonce\":\"%llu\",\"deadline\":\"%llu\",",
+             from, to, (unsigned long)gas, (unsigned long long)nonce, (unsigned long long)deadline);
+    std::string body;
+    body.reserve(strlen(head) + hexLen + sizeof(sigHex) + 32);
+    body.append(head).append("\"data\":\"").append(data).append("\",\"signature\":\"").append(sigHex).append("\"}");
+
+    std::string reply;
+    int status = request("/relay", &body, &reply);
+    if (status <= 0) {
+        counters.failed++;
+        return false;
+    }
+    if (status != 200 || reply.find("\"queued\":true") == std::string::npos) {
+        // The relayer says which nonce it expects; take it for the next send
+        uint64_t expected;
+        if (jsonNumber(reply, "nonce", &expected)) {
+            nonce = expected;
+        } else {
+            synced = false;
+        }
+        counters.rejected++;
+        Serial.printf("[meta-tx] rejected: %s\n", reply.c_str());
+        return false;
+    }
+
+    receipt->nonce = nonce++;
+    receipt->id[0] = '\0';
+    size_t at = reply.find("\"id\":\"");
+    if (at != std::string::npos) {
+        size_t end = reply.find('"', at + 6);
+        size_t n = end == std::string::npos ? 0 : end - at - 6;
+        n = n < sizeof(receipt->id) - 1 ? n : sizeof(receipt->id) - 1;
+        memcpy(receipt->id, reply.c_str() + at + 6, n);
+        receipt->id[n] = '\0';
+    }
+    counters.sent++;
+    return true;
+}
+
+bool MetaTxClient::syncNonce() {
+    char path[64];
+    snprintf(path, sizeof(path), "/nonce/%s", from);
+    std::string reply;
+    counters.nonceSyncs++;
+    if (request(path, nullptr, &reply) != 200 || !jsonNumber(reply, "nonce", &nonce)) {
+        return false;
+    }
+    synced = true;
+    return true;
+}
+
+// GET when body is null, POST otherwise. Returns the HTTP status, or <= 0
+// when the relayer could not be reached.
+int MetaTxClient::request(const char* path, const std::string* body, std::string* reply) {
+    WiFiClient plain;
+    WiFiClientSecure tls;
+    bool secure = strncmp(relayerUrl, "https://", 8) == 0;
+    if (secure) {
+        tls.setInsecure();          // Local relayer; requests are signed anyway
+    }
+
+    std::string url = std::string(relayerUrl) + path;
+    HTTPClient http;
+    if (!http.begin(secure ? (WiFiClient&)tls : plain, url.c_str())) {
+        return -1;
+    }
+    http.setConnectTimeout(META_TX_TIMEOUT_MS);
+    http.setTimeout(META_TX_TIMEOUT_MS);
+
+    int status;
+    if (body) {
+        http.addHeader("Content-Type", "application/json");
+        status = http.POST((uint8_t*)body->data(), body->size());
+    } else {
+        status = http.GET();
+    }
+    if (status > 0) {
+        String payload = http.getString();
+        reply->assign(payload.c_str(), payload.length());
+    }
+    http.end();
+    return status;
+}
+
+// "key":123 or "key":"123"
+bool MetaTxClient::jsonNumber(const std::string& json, const char* key, uint64_t* value) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t at = json.find(pattern);
+    if (at == std::string::npos) {
+        return false;
+    }
+    const char* p = json.c_str() + at + pattern.size();
+    p += *p == '"';
+    char* end;
+    *value = strtoull(p, &end, 10);
+    return end != p;
+}
+
+void MetaTxClient::report(Print& out) const {
+    out.printf("meta-tx %s via %s: nonce %llu%s, queued %lu, rejected %lu, unreachable %lu, nonce syncs %lu\n",
+               from, relayerUrl, (unsigned long long)nonce, synced ? "" : " (unsynced)",
+               (unsigned long)counters.sent, (unsigned long)counters.rejected, (unsigned long)counters.failed,
+               (unsigned long)counters.nonceSyncs);
+}
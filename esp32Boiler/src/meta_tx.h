@@ -0,0 +1,85 @@
+/*
+ * Meta-Transaction Client (ERC-2771)
+ *
+ * Gasless writes through a relayer. The device signs an EIP-712
+ * ForwardRequest and POSTs it to the relayer. The relayer checks it,
+ * batches it with requests from other devices and submits the batch with
+ * BatchForwarder.executeBatch() (contracts/BatchForwarder.sol) in one
+ * transaction. The target contract sees the device as the sender through
+ * ERC-2771, provided it trusts the forwarder.
+ *
+ * Compared with SignerPool::send() the device makes no node RPCs per write:
+ * no eth_getTransactionCount, no gas price, no eth_sendRawTransaction and
+ * no native gas token. The forwarder nonce comes from the relayer once and
+ * is then counted locally; it is fetched again only when the relayer
+ * rejects a nonce.
+ *
+ *   MetaTxClient meta(FORWARDER_ADDRESS, RELAYER_URL, CHAIN_ID);
+ *   meta.begin(PRIVATE_KEY);
+ *   MetaTxReceipt receipt;
+ *   meta.send(CONTRACT_ADDRESS, calldata, 100000, &receipt);
+ *
+ * Relayer protocol (tools/relayer/relayer.py is the reference):
+ *   GET  <url>/nonce/<address>  -> {"nonce":N}  next nonce incl. queued requests
+ *   POST <url>/relay            <- {"from","to","value","gas","nonce","deadline","data","signature"}
+ *                               -> {"queued":true,"id":"..."} or {"error":"...","nonce":N}
+ */
+
+#ifndef META_TX_H
+#define META_TX_H
+
+#include <Arduino.h>
+#include <string>
+
+#include "eip712.h"
+
+#define META_TX_TYPE \
+    "ForwardRequest(address from,address to,uint256 value,uint256 gas,uint256 nonce,uint48 deadline,bytes data)"
+#define META_TX_DOMAIN_NAME "PolkaESP Forwarder"
+#define META_TX_DATA_MAX 512           // Calldata bytes per request
+#define META_TX_DEADLINE_S 3600        // Validity once the clock is set; none before that
+#define META_TX_TIMEOUT_MS 5000
+
+struct MetaTxReceipt {
+    uint64_t nonce;
+    char id[32];                       // Relayer's id for the queued request
+};
+
+struct MetaTxStats {
+    uint32_t sent;                     // Queued by the relayer
+    uint32_t rejected;                 // Refused (bad nonce, signature, deadline...)
+    uint32_t failed;                   // Relayer unreachable
+    uint32_t nonceSyncs;               // Nonce fetches from the relayer
+};
+
+class MetaTxClient {
+public:
+    // Both strings are kept by pointer. relayerUrl has no trailing slash.
+    MetaTxClient(const char* forwarder, const char* relayerUrl, uint64_t chainId);
+
+    // Private key as 64 hex digits; the forwarder nonce is fetched on the
+    // first send
+    bool begin(const char* privateKey);
+
+    // data is 0x-hex calldata for to; gas is what the forwarded call may use
+    bool send(const char* to, const char* data, uint32_t gas, MetaTxReceipt* receipt);
+
+    const char* address() const { return from; }
+    MetaTxStats stats() const { return counters; }
+    void report(Print& out) const;
+
+private:
+    const char* relayerUrl;
+    Eip712Domain domain;
+    Eip712Signer signer;
+    char from[43];
+    uint64_t nonce;
+    bool synced;
+    MetaTxStats counters;
+
+    bool syncNonce();
+    int request(const char* path, const std::string* body, std::string* reply);
+    static bool jsonNumber(const std::string& json, const char* key, uint64_t* value);
+};
+
+#endif // META_TX_H
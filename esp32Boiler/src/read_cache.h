@@ -0,0 +1,180 @@
+/*
+ * Block-scoped Read Cache
+ *
+ * State read at "latest" (eth_call, eth_getBalance) cannot change until
+ * the next block, so repeated reads within one block are served from RAM
+ * instead of another HTTPS round trip.
+ *
+ * Entries are keyed by a hash of (method, params) - params carries the
+ * target address and calldata - and tagged with the endpoint that served
+ * them and the block number they were read at. A throttled eth_blockNumber
+ * poll tracks the chain head; once it moves, older entries stop matching.
+ * Endpoints can lag each other by a few blocks, so the head is only valid
+ * for the endpoint that reported it: a reply from any other endpoint is
+ * passed through uncached, and when the poll lands on another endpoint the
+ * existing entries stop matching too. If the head cannot be polled, reads
+ * bypass the cache rather than risk serving stale state.
+ *
+ *   ReadCache cache(rpc);
+ *   std::string response;
+ *   cache.read("eth_call", params, &response);
+ */
+
+#ifndef READ_CACHE_H
+#define READ_CACHE_H
+
+#include <Arduino.h>
+#include <string>
+
+#include "rpc_client.h"
+
+#define READ_CACHE_SLOTS 16
+#define READ_CACHE_VALUE_LEN 320     // Replies longer than this are not cached
+#define READ_CACHE_POLL_MS 3000      // How often to ask for the block number
+
+class ReadCache {
+public:
+    explicit ReadCache(RpcClient& rpc, uint32_t pollMs = READ_CACHE_POLL_MS)
+        : rpc(rpc), pollMs(pollMs), head(0), headEndpoint(-1), polledAt(0), headKnown(false),
+          hitCount(0), missCount(0), newBlocks(0), switches(0) {
+        memset(slots, 0, sizeof(slots));
+    }
+
+    // rpc.read() with the cache in front. Only for params at "latest".
+    bool read(const char* method, const char* params, std::string* out) {
+        bool cacheable = refreshHead();
+        uint64_t key = cacheable ? hash(method, params) : 0;
+
+        if (cacheable) {
+            for (const Slot& s : slots) {
+                if (s.used && s.key == key && s.block == head && s.endpoint == headEndpoint) {
+                    out->assign(s.value, s.length);
+                    hitCount++;
+                    return true;
+                }
+            }
+        }
+
+        missCount++;
+        int servedBy = -1;
+        if (!rpc.read(method, params, out, &servedBy)) {
+            return false;
+        }
+        if (cacheable && servedBy == headEndpoint && out->size() < READ_CACHE_VALUE_LEN &&
+            out->find("\"result\"") != std::string::npos) {
+            store(key, *out);
+        }
+        return true;
+    }
+
+    // Poll the block number if the last poll is older than pollMs. Returns
+    // true while the head is known and fresh enough to tag entries with.
+    bool refreshHead() {
+        uint32_t now = millis();
+        if (headKnown && now - polledAt < pollMs) {
+            return true;
+        }
+
+        std::string response;
+        int servedBy = -1;
+        headKnown = false;
+        if (!rpc.read("eth_blockNumber", "[]", &response, &servedBy)) {
+            return false;
+        }
+        uint64_t block;
+        if (!RpcClient::resultQuantity(response, &block)) {
+            return false;
+        }
+
+        if (servedBy != headEndpoint) {
+            // Another node's head; it may be behind the one entries were read at
+            switches += headEndpoint >= 0;
+            headEndpoint = servedBy;
+            head = block;
+        } else if (block != head) {
+            head = block;
+            newBlocks++;
+        }
+        polledAt = now;
+        headKnown = true;
+        return true;
+    }
+
+    void clear() {
+        memset(slots, 0, sizeof(slots));
+    }
+
+    uint64_t block() const { return head; }
+    uint32_t hits() const { return hitCount; }
+    uint32_t misses() const { return missCount; }
+    uint32_t blocksSeen() const { return newBlocks; }
+    uint32_t endpointSwitches() const { return switches; }
+
+    void report(Print& out) const {
+        out.printf("Read cache: block %llu, %lu hits, %lu misses, %lu new blocks, %lu endpoint switches\n",
+                   (unsigned long long)head, (unsigned long)hitCount,
+                   (unsigned long)missCount, (unsigned long)newBlocks, (unsigned long)switches);
+    }
+
+private:
+    struct Slot {
+        bool used;
+        uint64_t key;
+        uint64_t block;
+        int8_t endpoint;
+        uint16_t length;
+        char value[READ_CACHE_VALUE_LEN];
+    };
+
+    RpcClient& rpc;
+    uint32_t pollMs;
+    uint64_t head;
+    int headEndpoint;                 // Endpoint that reported head
+    uint32_t polledAt;
+    bool headKnown;
+    Slot slots[READ_CACHE_SLOTS];
+    uint32_t hitCount;
+    uint32_t missCount;
+    uint32_t newBlocks;
+    uint32_t switches;
+
+    // 64-bit FNV-1a over method, a separator and params
+    static uint64_t hash(const char* method, const char* params) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (const char* p = method; *p; p++) {
+            h = (h ^ (uint8_t)*p) * 0x100000001b3ULL;
+        }
+        h = (h ^ 0xFF) * 0x100000001b3ULL;
+        for (const char* p = params; *p; p++) {
+            h = (h ^ (uint8_t)*p) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    void store(uint64_t key, const std::string& value) {
+        // Reuse the same key's slot, else a slot from an older block or
+        // another endpoint, else slot 0 onwards in turn
+        Slot* target = nullptr;
+        for (Slot& s : slots) {
+            if (s.used && s.key == key) {
+                target = &s;
+                break;
+            }
+            if (!target && (!s.used || s.block != head || s.endpoint != headEndpoint)) {
+                target = &s;
+            }
+        }
+        if (!target) {
+            target = &slots[(hitCount + missCount) % READ_CACHE_SLOTS];
+        }
+
+        target->used = true;
+        target->key = key;
+        target->block = head;
+        target->endpoint = (int8_t)headEndpoint;
+        target->length = value.size();
+        memcpy(target->value, value.data(), value.size());
+    }
+};
+
+#endif // READ_CACHE_H
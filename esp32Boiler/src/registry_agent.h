@@ -0,0 +1,326 @@
+/*
+ * Registry Agent
+ *
+ * Device-side logic for contracts/PolkaESPRegistry.sol: register once with
+ * add(name), then heartbeat with ping(0) and read back with get(address).
+ * Failed and rate-limited calls back off exponentially with jitter, so a
+ * fleet that boots at once does not hammer the node in lockstep.
+ *
+ * The agent only decides what to call next and encodes the calldata with
+ * the generated Polka32Abi bindings; the caller performs the call and hands
+ * the raw JSON-RPC reply to interpret(). That keeps it free of Arduino and
+ * network code, so the firmware (examples/device_registry) and the host
+ * fleet simulator (tools/fleet_sim) run the same logic.
+ *
+ *   RegistryCall call;
+ *   if (agent.next(millis(), &call)) {
+ *       std::string response = perform(call);
+ *       uint64_t value;
+ *       RegistryStatus status = RegistryAgent::interpret(call, response, &value);
+ *       agent.complete(millis(), status, value);
+ *   }
+ */
+
+#ifndef REGISTRY_AGENT_H
+#define REGISTRY_AGENT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#include "abi/polka32.h"
+#include "hex.h"
+
+#define REGISTRY_NAME_MAX 32          // add(string) name fits one ABI word
+#define REGISTRY_CALLDATA_LEN 204     // "0x" + selector + 3 words + NUL
+
+enum RegistryCallType {
+    REGISTRY_NONCE,        // eth_getTransactionCount(address, "pending")
+    REGISTRY_ADD,          // Transaction: add(name)
+    REGISTRY_RECEIPT,      // eth_getTransactionCount(address, "latest") past the nonce?
+    REGISTRY_PING,         // Transaction: ping(0)
+    REGISTRY_GET           // eth_call: get(address); value = device count
+};
+
+enum RegistryStatus {
+    REGISTRY_OK,
+    REGISTRY_PENDING,      // Receipt not available yet
+    REGISTRY_RATE_LIMITED,
+    REGISTRY_NONCE_ERROR,
+    REGISTRY_FAILED
+};
+
+struct RegistryCall {
+    RegistryCallType type;
+    uint32_t nonce;        // Transactions and receipts
+    char data[REGISTRY_CALLDATA_LEN];
+};
+
+struct RegistryAgentConfig {
+    uint32_t heartbeatMs;
+    uint32_t readMs;
+    uint32_t receiptPollMs;
+    uint32_t receiptPolls;   // Give up and re-register after this many
+    uint32_t backoffBaseMs;
+    uint32_t backoffMaxMs;
+};
+
+static const RegistryAgentConfig REGISTRY_DEFAULTS = {
+    60000,    // heartbeatMs
+    300000,   // readMs
+    3000,     // receiptPollMs
+    40,       // receiptPolls
+    500,      // backoffBaseMs
+    60000     // backoffMaxMs
+};
+
+class RegistryAgent {
+public:
+    enum Phase { NEED_NONCE, REGISTER, AWAIT_RECEIPT, RUNNING };
+
+    // name and address (0x-prefixed) are copied; seed decorrelates jitter
+    RegistryAgent(const char* name, const char* address, uint32_t seed,
+                  const RegistryAgentConfig& config = REGISTRY_DEFAULTS)
+        : cfg(config), phase(NEED_NONCE), current(REGISTRY_NONCE), nonce(0),
+          inFlight(false), registeredOnce(false), registeredAt(0), devices(0),
+          dueAt(0), pingAt(0), readAt(0), polls(0), failures(0), rng(seed ? seed : 1),
+          backoffCount(0), backoffTotalMs(0), maxFailures(0) {
+        snprintf(deviceName, sizeof(deviceName), "%s", name);
+        snprintf(deviceAddress, sizeof(deviceAddress), "%s", address);
+    }
+
+    // Fill call with the next request if one is due at now. Returns false
+    // while a call is in flight or nothing is due before wakeAt().
+    bool next(uint32_t now, RegistryCall* call) {
+        if (inFlight || (int32_t)(now - wakeAt()) < 0) {
+            return false;
+        }
+
+        call->nonce = nonce;
+        call->data[0] = '\0';
+        switch (phase) {
+            case NEED_NONCE:
+                call->type = REGISTRY_NONCE;
+                break;
+            case REGISTER:
+                call->type = REGISTRY_ADD;
+                encodeAdd(call->data);
+                break;
+            case AWAIT_RECEIPT:
+                call->type = REGISTRY_RECEIPT;
+                call->nonce = nonce - 1;
+                break;
+            case RUNNING:
+                if ((int32_t)(pingAt - readAt) <= 0) {
+                    call->type = REGISTRY_PING;
+                    encodePing(call->data, 0);
+                } else {
+                    call->type = REGISTRY_GET;
+                    encodeGet(call->data);
+                }
+                break;
+        }
+        current = call->type;
+        inFlight = true;
+        return true;
+    }
+
+    // Report the outcome of the call returned by next()
+    void complete(uint32_t now, RegistryStatus status, uint64_t value) {
+        inFlight = false;
+
+        if (status == REGISTRY_RATE_LIMITED || status == REGISTRY_FAILED) {
+            backOff(now);
+            return;
+        }
+        if (status == REGISTRY_NONCE_ERROR) {
+            phase = NEED_NONCE;
+            dueAt = now;
+            return;
+        }
+        failures = 0;
+
+        switch (current) {
+            case REGISTRY_NONCE:
+                nonce = (uint32_t)value;
+                phase = registeredOnce ? RUNNING : REGISTER;
+                dueAt = now;
+                break;
+            case REGISTRY_ADD:
+                nonce++;
+                phase = AWAIT_RECEIPT;
+                polls = 0;
+                dueAt = now + cfg.receiptPollMs;
+                break;
+            case REGISTRY_RECEIPT:
+                if (status == REGISTRY_PENDING) {
+                    // Dropped or starved: resync and send add() again
+                    if (++polls >= cfg.receiptPolls) {
+                        phase = NEED_NONCE;
+                        dueAt = now;
+                    } else {
+                        dueAt = now + cfg.receiptPollMs;
+                    }
+                    break;
+                }
+                registeredOnce = true;
+                registeredAt = now;
+                phase = RUNNING;
+                pingAt = now + jitter(cfg.heartbeatMs);
+                readAt = now + jitter(cfg.readMs);
+                break;
+            case REGISTRY_PING:
+                nonce++;
+                pingAt = now + cfg.heartbeatMs;
+                break;
+            case REGISTRY_GET:
+                devices = (uint32_t)value;
+                readAt = now + cfg.readMs;
+                break;
+        }
+    }
+
+    // Earliest time next() may return a call
+    uint32_t wakeAt() const {
+        if (phase != RUNNING) {
+            return dueAt;
+        }
+        // Next timer, unless a backoff pushed the agent further out
+        uint32_t timer = (int32_t)(pingAt - readAt) <= 0 ? pingAt : readAt;
+        return (int32_t)(dueAt - timer) > 0 ? dueAt : timer;
+    }
+
+    Phase state() const { return phase; }
+    bool registered() const { return registeredOnce; }
+    uint32_t registeredTime() const { return registeredAt; }
+    uint32_t deviceCount() const { return devices; }
+    uint32_t backoffs() const { return backoffCount; }
+    uint32_t backoffMs() const { return backoffTotalMs; }
+    uint32_t worstFailureStreak() const { return maxFailures; }
+    const char* address() const { return deviceAddress; }
+
+    // Map a raw JSON-RPC reply to call onto a status, and value for
+    // complete(): the nonce, or the number of Device entries for get()
+    static RegistryStatus interpret(const RegistryCall& call, const std::string& response, uint64_t* value) {
+        *value = 0;
+        switch (call.type) {
+            case REGISTRY_NONCE:
+                return quantity(response, value) ? REGISTRY_OK : classifyReply(response);
+            case REGISTRY_RECEIPT: {
+                // Mined once the confirmed count has moved past the nonce
+                uint64_t mined;
+                if (!quantity(response, &mined)) {
+                    return classifyReply(response);
+                }
+                return mined > call.nonce ? REGISTRY_OK : REGISTRY_PENDING;
+            }
+            case REGISTRY_GET: {
+                if (!AbiReader(response).ok()) {
+                    return classifyReply(response);
+                }
+                *value = Polka32Abi::decodeGet(response).size();
+                return REGISTRY_OK;
+            }
+            case REGISTRY_ADD:
+            case REGISTRY_PING:
+                return classifyReply(response);
+        }
+        return REGISTRY_FAILED;
+    }
+
+    // Any result is success; JSON-RPC errors are sorted into nonce trouble,
+    // provider rate limits (-32005, -32029 or a "rate limit" message) and
+    // everything else, which includes reverts
+    static RegistryStatus classifyReply(const std::string& response) {
+        if (response.find("\"result\"") != std::string::npos) {
+            return REGISTRY_OK;
+        }
+        if (response.find("nonce") != std::string::npos) {
+            return REGISTRY_NONCE_ERROR;
+        }
+        if (response.find("-32005") != std::string::npos || response.find("-32029") != std::string::npos ||
+            response.find("rate limit") != std::string::npos) {
+            return REGISTRY_RATE_LIMITED;
+        }
+        return REGISTRY_FAILED;
+    }
+
+private:
+    RegistryAgentConfig cfg;
+    char deviceName[REGISTRY_NAME_MAX + 1];
+    char deviceAddress[43];
+    Phase phase;
+    RegistryCallType current;
+    uint32_t nonce;
+    bool inFlight;
+    bool registeredOnce;
+    uint32_t registeredAt;
+    uint32_t devices;
+    uint32_t dueAt;
+    uint32_t pingAt;
+    uint32_t readAt;
+    uint32_t polls;
+    uint32_t failures;
+    uint32_t rng;
+    uint32_t backoffCount;
+    uint32_t backoffTotalMs;
+    uint32_t maxFailures;
+
+    uint32_t random32() {
+        // xorshift32
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    // Uniform in [ms/2, ms]: spreads the fleet without ever retrying at once
+    uint32_t jitter(uint32_t ms) {
+        return ms / 2 + (ms ? random32() % (ms / 2 + 1) : 0);
+    }
+
+    void backOff(uint32_t now) {
+        failures++;
+        if (failures > maxFailures) {
+            maxFailures = failures;
+        }
+        uint32_t shift = failures > 16 ? 16 : failures - 1;
+        uint64_t delay = (uint64_t)cfg.backoffBaseMs << shift;
+        if (delay > cfg.backoffMaxMs) {
+            delay = cfg.backoffMaxMs;
+        }
+        uint32_t wait = jitter((uint32_t)delay);
+        backoffCount++;
+        backoffTotalMs += wait;
+
+        // Retry the same call; RUNNING timers are pushed back as well
+        dueAt = now + wait;
+    }
+
+    // Hex quantity result ("0x1a2b"), at most 64 bits
+    static bool quantity(const std::string& response, uint64_t* value) {
+        size_t at = response.find("\"result\":\"0x");
+        if (at == std::string::npos) {
+            return false;
+        }
+        const char* digits = response.c_str() + at + 12;
+        const char* end = strchr(digits, '"');
+        return end && end > digits && Hex::word(digits, end - digits, value);
+    }
+
+    // An invalid name or address leaves data empty, which the node rejects
+    void encodeAdd(char* out) const {
+        Polka32Abi::add(out, REGISTRY_CALLDATA_LEN, deviceName);
+    }
+
+    static void encodePing(char* out, uint32_t index) {
+        Polka32Abi::ping(out, REGISTRY_CALLDATA_LEN, UInt256(index));
+    }
+
+    void encodeGet(char* out) const {
+        Polka32Abi::get(out, REGISTRY_CALLDATA_LEN, deviceAddress);
+    }
+};
+
+#endif // REGISTRY_AGENT_H
@@ -0,0 +1,557 @@
+/*
+ * RPC Client implementation
+ */
+
+#include "rpc_client.h"
+
+#include <HTTPClient.h>
+#include <algorithm>
+
+#include "gzip_inflate.h"
+#include "tls_resume.h"
+
+// Lets HTTPClient::writeToStream(), which also undoes chunked framing, hand
+// the body straight to the inflater; times only the inflate work
+class InflateSink : public Stream {
+public:
+    explicit InflateSink(GzipInflater& gz) : gz(gz), inflateUs(0) {}
+
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size) override {
+        uint32_t start = micros();
+        bool ok = gz.feed(buf, size);
+        inflateUs += micros() - start;
+        return ok ? size : 0;        // A short write makes writeToStream() give up
+    }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+
+    uint32_t elapsedUs() const { return inflateUs; }
+
+private:
+    GzipInflater& gz;
+    uint32_t inflateUs;
+};
+
+struct RpcTransferStats {
+    uint32_t replies;
+    uint32_t gzipped;
+    uint32_t inflateErrors;
+    uint64_t wireBytes;             // Reply bodies as received
+    uint64_t bodyBytes;             // After inflating
+    uint64_t inflateUs;
+};
+
+// One TLS connection plus HTTP client; kept alive between requests to the
+// same endpoint so repeated calls skip the handshake. Reconnects (after a
+// reboot, deep sleep or endpoint switch) resume a saved TLS session.
+class RpcTransport {
+public:
+    RpcTransport() : connectedTo(-1), transfer() {
+        http.setReuse(true);
+#if RPC_ACCEPT_GZIP
+        http.setAcceptEncoding("gzip");
+#endif
+    }
+
+    int post(int index, const char* url, const char* caCert, const std::string& body,
+             std::string* out) {
+        if (connectedTo != index) {
+            http.end();
+            tls.stop();
+            if (caCert) {
+                tls.setCACert(caCert);
+            } else {
+                tls.setInsecure();
+            }
+        }
+
+        if (!http.begin(tls, url)) {
+            connectedTo = -1;
+            return -1;
+        }
+        http.setConnectTimeout(RPC_TIMEOUT_MS);
+        http.setTimeout(RPC_TIMEOUT_MS);
+        http.addHeader("Content-Type", "application/json");
+        static const char* replyHeaders[] = {"Content-Encoding"};
+        http.collectHeaders(replyHeaders, 1);
+
+        int status = http.POST((uint8_t*)body.data(), body.size());
+        if (status > 0 && http.header("Content-Encoding").equalsIgnoreCase("gzip")) {
+            if (!inflateReply(out)) {
+                status = -1;             // Treated like a broken connection: next endpoint
+            }
+        } else if (status > 0) {
+            String payload = http.getString();
+            out->assign(payload.c_str(), payload.length());
+            transfer.replies++;
+            transfer.wireBytes += payload.length();
+            transfer.bodyBytes += payload.length();
+        }
+
+        if (status > 0) {
+            connectedTo = index;
+        } else {
+            http.end();
+            connectedTo = -1;
+        }
+        return status;
+    }
+
+    const RpcTransferStats& stats() const { return transfer; }
+
+private:
+    ResumableTlsClient tls;
+    HTTPClient http;
+    int connectedTo;
+    RpcTransferStats transfer;
+
+    bool inflateReply(std::string* out) {
+        GzipInflater gz(out, RPC_INFLATE_MAX);
+        InflateSink sink(gz);
+        bool ok = http.writeToStream(&sink) >= 0 && gz.finished();
+
+        transfer.replies++;
+        transfer.gzipped++;
+        transfer.wireBytes += gz.consumed();
+        transfer.bodyBytes += gz.produced();
+        transfer.inflateUs += sink.elapsedUs();
+        if (!ok) {
+            transfer.inflateErrors++;
+            out->clear();
+        }
+        return ok;
+    }
+};
+
+class RpcLock {
+public:
+    explicit RpcLock(SemaphoreHandle_t lock) : lock(lock) { xSemaphoreTake(lock, portMAX_DELAY); }
+    ~RpcLock() { xSemaphoreGive(lock); }
+private:
+    SemaphoreHandle_t lock;
+};
+
+RpcClient::RpcClient()
+    : count(0), requestId(0), transport(nullptr), hedgeEnabled(false),
+      lock(nullptr), completed(nullptr), activeJob(0), activeOut(nullptr),
+      activeDone(false), activeFailures(0), activeWinner(-1), hedges(0), hedgeWins(0) {
+    memset(endpoints, 0, sizeof(endpoints));
+    for (Worker& w : workers) {
+        w.owner = this;
+        w.transport = nullptr;
+        w.task = nullptr;
+        w.busy = false;
+        w.jobId = 0;
+        w.endpoint = -1;
+        w.role = 0;
+    }
+}
+
+bool RpcClient::addEndpoint(const char* url, const char* caCert) {
+    if (count == RPC_MAX_ENDPOINTS) {
+        return false;
+    }
+    if (lock == nullptr) {
+        lock = xSemaphoreCreateMutex();
+        completed = xSemaphoreCreateCounting(4, 0);
+    }
+
+    Endpoint& e = endpoints[count++];
+    e.url = url;
+    e.caCert = caCert;
+    e.cooldownMs = RPC_COOLDOWN_MS;
+    return true;
+}
+
+void RpcClient::setHedging(bool enabled) {
+    hedgeEnabled = enabled;
+    if (enabled) {
+        startWorkers();
+    }
+}
+
+RpcTransport& RpcClient::local() {
+    if (transport == nullptr) {
+        transport = new RpcTransport();
+    }
+    return *transport;
+}
+
+void RpcClient::startWorkers() {
+    for (size_t i = 0; i < 2; i++) {
+        Worker& w = workers[i];
+        if (w.task == nullptr) {
+            w.transport = new RpcTransport();
+            xTaskCreate(workerLoop, i == 0 ? "rpc0" : "rpc1", 8192, &w, 1, &w.task);
+        }
+    }
+}
+
+// ===== HEALTH SCORING =====
+uint32_t RpcClient::percentile(const Endpoint& e, int pct) const {
+    if (e.samples == 0) {
+        return 0;
+    }
+    uint16_t sorted[RPC_LATENCY_WINDOW];
+    memcpy(sorted, e.latency, e.samples * sizeof(uint16_t));
+    std::sort(sorted, sorted + e.samples);
+    return sorted[(e.samples - 1) * pct / 100];
+}
+
+float RpcClient::score(const Endpoint& e, uint32_t now) const {
+    if (e.cooldownUntil && (int32_t)(e.cooldownUntil - now) > 0) {
+        return 1e9f;  // Only used when every endpoint is cooling down
+    }
+    // Unmeasured endpoints look average so they get tried
+    float latency = e.samples ? (float)percentile(e, 50) : 300.0f;
+    return latency * (1.0f + 4.0f * e.errorRate);
+}
+
+size_t RpcClient::rank(int* order) const {
+    uint32_t now = millis();
+    float scores[RPC_MAX_ENDPOINTS];
+    {
+        RpcLock guard(lock);
+        for (size_t i = 0; i < count; i++) {
+            order[i] = i;
+            scores[i] = score(endpoints[i], now);
+        }
+    }
+    std::sort(order, order + count, [&](int a, int b) { return scores[a] < scores[b]; });
+
+    size_t healthy = 0;
+    while (healthy < count && scores[order[healthy]] < 1e9f) {
+        healthy++;
+    }
+    return healthy;
+}
+
+void RpcClient::record(int index, bool ok, uint32_t elapsedMs) {
+    RpcLock guard(lock);
+    Endpoint& e = endpoints[index];
+
+    e.requests++;
+    e.errorRate = e.errorRate * 0.875f + (ok ? 0.0f : 0.125f);
+    if (ok) {
+        e.latency[e.next] = elapsedMs > 0xFFFF ? 0xFFFF : elapsedMs;
+        e.next = (e.next + 1) % RPC_LATENCY_WINDOW;
+        if (e.samples < RPC_LATENCY_WINDOW) {
+            e.samples++;
+        }
+        e.consecutiveFailures = 0;
+        e.cooldownUntil = 0;
+        e.cooldownMs = RPC_COOLDOWN_MS;
+        return;
+    }
+
+    e.errors++;
+    if (++e.consecutiveFailures >= RPC_COOLDOWN_FAILURES) {
+        e.cooldownUntil = millis() + e.cooldownMs;
+        if (e.cooldownUntil == 0) {
+            e.cooldownUntil = 1;
+        }
+        e.cooldownMs = std::min<uint32_t>(e.cooldownMs * 2, RPC_COOLDOWN_MAX_MS);
+    }
+}
+
+// ===== REQUESTS =====
+size_t RpcClient::buildRequest(const char* method, const char* params, std::string* body) {
+    char head[96];
+    int n = snprintf(head, sizeof(head), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"method\":\"%s\",\"params\":",
+                     (unsigned long)++requestId, method);
+    body->reserve(n + strlen(params) + 1);
+    body->assign(head, n);
+    body->append(params);
+    body->push_back('}');
+    return body->size();
+}
+
+bool RpcClient::isRetryable(int httpStatus, const std::string& response) {
+    if (httpStatus != 200) {
+        return true;
+    }
+    // Provider rate limits come back as JSON-RPC errors on HTTP 200
+    if (response.find("\"code\":-32005") != std::string::npos ||
+        response.find("\"code\":-32029") != std::string::npos) {
+        return true;
+    }
+    // Anything that is not a JSON-RPC reply (captive portal, proxy page)
+    return response.find("\"result\"") == std::string::npos &&
+           response.find("\"error\"") == std::string::npos;
+}
+
+// Digits of a "0x..." string result, in place in the reply
+static bool resultDigits(const std::string& response, const char** digits, size_t* n) {
+    size_t at = response.find("\"result\":\"0x");
+    if (at == std::string::npos) {
+        return false;
+    }
+    size_t end = response.find('"', at + 12);
+    if (end == std::string::npos || end == at + 12) {
+        return false;
+    }
+    *digits = response.c_str() + at + 12;
+    *n = end - (at + 12);
+    return true;
+}
+
+bool RpcClient::resultQuantity(const std::string& response, uint64_t* value) {
+    const char* digits;
+    size_t n;
+    return resultDigits(response, &digits, &n) && Hex::word(digits, n, value);
+}
+
+bool RpcClient::resultQuantity(const std::string& response, UInt256* value) {
+    const char* digits;
+    size_t n;
+    return resultDigits(response, &digits, &n) && UInt256::fromHex(digits, n, value);
+}
+
+bool RpcClient::attempt(RpcTransport& t, int index, const std::string& body, std::string* out) {
+    uint32_t start = millis();
+    int status = t.post(index, endpoints[index].url, endpoints[index].caCert, body, out);
+    bool ok = status > 0 && !isRetryable(status, *out);
+    record(index, ok, millis() - start);
+    return ok;
+}
+
+bool RpcClient::call(const char* method, const char* params, std::string* out, int* servedBy) {
+    if (count == 0) {
+        return false;
+    }
+    std::string body;
+    buildRequest(method, params, &body);
+
+    // Best endpoint first, then the rest in score order (cooling ones last)
+    int order[RPC_MAX_ENDPOINTS];
+    rank(order);
+    for (size_t i = 0; i < count; i++) {
+        if (attempt(local(), order[i], body, out)) {
+            if (servedBy) {
+                *servedBy = order[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RpcClient::read(const char* method, const char* params, std::string* out, int* servedBy) {
+    int order[RPC_MAX_ENDPOINTS];
+    size_t healthy = count ? rank(order) : 0;
+    if (!hedgeEnabled || healthy < 2) {
+        return call(method, params, out, servedBy);
+    }
+
+    std::string body;
+    buildRequest(method, params, &body);
+    if (hedgedRead(body, out, order, healthy, servedBy)) {
+        return true;
+    }
+
+    // Both hedged attempts failed; walk the remaining endpoints in order
+    for (size_t i = 2; i < count; i++) {
+        if (attempt(local(), order[i], body, out)) {
+            if (servedBy) {
+                *servedBy = order[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===== HEDGED READS =====
+bool RpcClient::hedgedRead(const std::string& body, std::string* out, const int* order, size_t ranked,
+                           int* servedBy) {
+    // A worker can still be finishing a late request from an earlier read.
+    // The primary then goes to the free worker and a hedge, if it fires, is
+    // sent from this task on the local transport; only with both workers
+    // busy does the read go out unhedged.
+    Worker* idle[2];
+    size_t free = 0;
+    for (Worker& w : workers) {
+        if (!w.busy) {
+            idle[free++] = &w;
+        }
+    }
+    if (free == 0) {
+        if (!attempt(local(), order[0], body, out)) {
+            return false;
+        }
+        if (servedBy) {
+            *servedBy = order[0];
+        }
+        return true;
+    }
+
+    uint32_t hedgeAfter;
+    uint32_t id;
+    {
+        RpcLock guard(lock);
+        hedgeAfter = std::max<uint32_t>(percentile(endpoints[order[0]], RPC_HEDGE_PERCENTILE), RPC_HEDGE_MIN_MS);
+        id = ++requestId;
+        activeJob = id;
+        activeOut = out;
+        activeDone = false;
+        activeFailures = 0;
+        activeWinner = -1;
+        while (xSemaphoreTake(completed, 0) == pdTRUE) {
+            // Drain completions left by earlier hedged reads
+        }
+    }
+
+    uint8_t launched = 0;
+    auto launch = [&](Worker& w, int endpoint) {
+        w.request = body;
+        w.endpoint = endpoint;
+        w.jobId = id;
+        w.role = launched;
+        w.busy = true;
+        launched++;
+        xTaskNotifyGive(w.task);
+    };
+
+    launch(*idle[0], order[0]);
+    uint32_t start = millis();
+    bool done = false;
+
+    while (!done) {
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= RPC_TIMEOUT_MS * 2) {
+            break;
+        }
+
+        // Until the hedge fires, wait only as long as the primary should take
+        uint32_t wait = (launched == 1 && ranked > 1) ? (hedgeAfter > elapsed ? hedgeAfter - elapsed : 0)
+                                                      : RPC_TIMEOUT_MS * 2 - elapsed;
+        bool signalled = xSemaphoreTake(completed, pdMS_TO_TICKS(wait)) == pdTRUE;
+
+        bool hedgeHere = false;
+        {
+            RpcLock guard(lock);
+            done = activeDone;
+            if (!done && launched == 1 && ranked > 1 && (!signalled || activeFailures == 1)) {
+                // Primary is slow or already failed: send to the runner-up
+                hedges++;
+                if (free == 2) {
+                    launch(*idle[1], order[1]);
+                } else {
+                    launched++;
+                    hedgeHere = true;
+                }
+            } else if (!done && launched == 2 && activeFailures == 2) {
+                break;
+            }
+        }
+
+        if (hedgeHere) {
+            std::string response;
+            bool ok = attempt(local(), order[1], body, &response);
+            RpcLock guard(lock);
+            if (ok && !activeDone) {
+                out->swap(response);
+                activeDone = true;
+                activeWinner = 1;
+            } else if (!ok) {
+                activeFailures++;
+            }
+            done = activeDone;
+            if (!done && activeFailures == 2) {
+                break;
+            }
+        }
+    }
+
+    RpcLock guard(lock);
+    bool ok = activeDone;
+    if (ok && activeWinner == 1) {
+        hedgeWins++;
+    }
+    if (ok && servedBy) {
+        *servedBy = order[activeWinner];
+    }
+    activeJob = 0;  // Late finishers must not touch out any more
+    activeOut = nullptr;
+    return ok;
+}
+
+void RpcClient::workerLoop(void* arg) {
+    Worker& w = *static_cast<Worker*>(arg);
+    RpcClient& client = *w.owner;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool ok = client.attempt(*w.transport, w.endpoint, w.request, &w.response);
+        {
+            RpcLock guard(client.lock);
+            if (w.jobId == client.activeJob && !client.activeDone) {
+                if (ok) {
+                    client.activeOut->swap(w.response);
+                    client.activeDone = true;
+                    client.activeWinner = w.role;
+                } else {
+                    client.activeFailures++;
+                }
+            }
+            w.busy = false;
+        }
+        xSemaphoreGive(client.completed);
+    }
+}
+
+// ===== REPORTING =====
+RpcEndpointStats RpcClient::stats(size_t index) const {
+    RpcEndpointStats s = {};
+    if (index >= count) {
+        return s;
+    }
+
+    RpcLock guard(lock);
+    const Endpoint& e = endpoints[index];
+    s.url = e.url;
+    s.requests = e.requests;
+    s.errors = e.errors;
+    s.p50Ms = percentile(e, 50);
+    s.p90Ms = percentile(e, 90);
+    s.errorRate = e.errorRate;
+    s.coolingDown = e.cooldownUntil && (int32_t)(e.cooldownUntil - millis()) > 0;
+    return s;
+}
+
+void RpcClient::report(Print& out) const {
+    for (size_t i = 0; i < count; i++) {
+        RpcEndpointStats s = stats(i);
+        out.printf("%s\n  %lu requests, %lu errors (%.0f%%), p50 %lu ms, p90 %lu ms%s\n", s.url,
+                   (unsigned long)s.requests, (unsigned long)s.errors, s.errorRate * 100,
+                   (unsigned long)s.p50Ms, (unsigned long)s.p90Ms, s.coolingDown ? ", cooling down" : "");
+    }
+    if (hedgeEnabled) {
+        out.printf("Hedged reads: %lu sent, %lu won\n", (unsigned long)hedges, (unsigned long)hedgeWins);
+    }
+
+    RpcTransferStats t = {};
+    const RpcTransport* transports[] = {transport, workers[0].transport, workers[1].transport};
+    for (const RpcTransport* p : transports) {
+        if (p) {
+            const RpcTransferStats& s = p->stats();
+            t.replies += s.replies;
+            t.gzipped += s.gzipped;
+            t.inflateErrors += s.inflateErrors;
+            t.wireBytes += s.wireBytes;
+            t.bodyBytes += s.bodyBytes;
+            t.inflateUs += s.inflateUs;
+        }
+    }
+    if (t.replies) {
+        out.printf("Replies: %lu (%lu gzipped, %lu inflate errors), %llu bytes on the wire for %llu (%.1fx), "
+                   "inflate %llu us total\n",
+                   (unsigned long)t.replies, (unsigned long)t.gzipped, (unsigned long)t.inflateErrors,
+                   (unsigned long long)t.wireBytes, (unsigned long long)t.bodyBytes,
+                   t.wireBytes ? (double)t.bodyBytes / t.wireBytes : 1.0, (unsigned long long)t.inflateUs);
+    }
+}
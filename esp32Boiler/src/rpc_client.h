@@ -0,0 +1,150 @@
+/*
+ * RPC Client
+ *
+ * JSON-RPC over HTTPS against a set of endpoints for one chain, so a slow
+ * or rate-limiting node does not stall the firmware. Web3E binds a Web3
+ * object to a single host; read paths go through this client instead,
+ * while transactions are still signed and sent by Web3E.
+ *
+ * - Health score per endpoint from a rolling latency window and an error
+ *   rate; requests go to the best-scoring endpoint first
+ * - Failover to the next endpoint on transport errors, HTTP errors and
+ *   rate-limit replies; repeatedly failing endpoints cool down
+ * - Optional hedged reads: if the first endpoint has not answered within
+ *   its RPC_HEDGE_PERCENTILE latency, the same request goes to the next
+ *   endpoint and the first answer wins
+ * - Replies are requested gzip-compressed and inflated as they arrive
+ *   (gzip_inflate.h); servers that ignore the request answer in plain text
+ *
+ *   RpcClient rpc;
+ *   rpc.addEndpoint("https://ethereum-sepolia-rpc.publicnode.com");
+ *   rpc.addEndpoint("https://sepolia.drpc.org");
+ *   std::string response;
+ *   rpc.call("eth_blockNumber", "[]", &response);   // Raw JSON reply
+ */
+
+#ifndef RPC_CLIENT_H
+#define RPC_CLIENT_H
+
+#include <Arduino.h>
+#include <string>
+
+#include "uint256.h"
+
+#define RPC_MAX_ENDPOINTS 4
+#define RPC_LATENCY_WINDOW 16
+#define RPC_TIMEOUT_MS 8000
+#define RPC_HEDGE_PERCENTILE 90
+#define RPC_HEDGE_MIN_MS 150          // Never hedge sooner than this
+#define RPC_COOLDOWN_FAILURES 3       // Consecutive failures before cooling down
+#define RPC_COOLDOWN_MS 30000         // Doubles on every further failure, capped
+#define RPC_COOLDOWN_MAX_MS 600000
+#ifndef RPC_ACCEPT_GZIP
+#define RPC_ACCEPT_GZIP 1             // Ask for gzip; replies are inflated while they stream in
+#endif
+#define RPC_INFLATE_MAX 65536         // Largest inflated reply; bounds a decompression bomb
+
+class RpcTransport;
+
+struct RpcEndpointStats {
+    const char* url;
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t p50Ms;
+    uint32_t p90Ms;
+    float errorRate;           // Exponentially weighted, 0..1
+    bool coolingDown;
+};
+
+class RpcClient {
+public:
+    RpcClient();
+
+    // url is kept by pointer; use string literals or other static storage.
+    // caCert may be nullptr for testnets and local nodes (no verification).
+    bool addEndpoint(const char* url, const char* caCert = nullptr);
+
+    // Send params (a JSON array) to method; the raw JSON reply goes to out.
+    // Returns false only when every endpoint failed. A JSON-RPC error in the
+    // reply (e.g. a revert) is still a successful call. servedBy, if given,
+    // receives the index of the endpoint whose reply is in out.
+    bool call(const char* method, const char* params, std::string* out, int* servedBy = nullptr);
+
+    // Reads that may be hedged (eth_call, eth_getBalance, ...). Falls back
+    // to call() when hedging is off or fewer than two endpoints are healthy.
+    bool read(const char* method, const char* params, std::string* out, int* servedBy = nullptr);
+
+    // Parse a hex quantity result ("0x1a2b") from a raw reply
+    static bool resultQuantity(const std::string& response, uint64_t* value);
+    static bool resultQuantity(const std::string& response, UInt256* value);
+
+    void setHedging(bool enabled);
+    bool hedging() const { return hedgeEnabled; }
+
+    size_t endpointCount() const { return count; }
+    RpcEndpointStats stats(size_t index) const;
+    uint32_t hedgesSent() const { return hedges; }
+    uint32_t hedgesWon() const { return hedgeWins; }
+    void report(Print& out) const;
+
+private:
+    struct Endpoint {
+        const char* url;
+        const char* caCert;
+        uint16_t latency[RPC_LATENCY_WINDOW];
+        uint8_t samples;
+        uint8_t next;
+        float errorRate;
+        uint8_t consecutiveFailures;
+        uint32_t cooldownUntil;
+        uint32_t cooldownMs;
+        uint32_t requests;
+        uint32_t errors;
+    };
+
+    struct Worker {
+        RpcClient* owner;
+        RpcTransport* transport;
+        TaskHandle_t task;
+        volatile bool busy;
+        uint32_t jobId;
+        int endpoint;
+        uint8_t role;                 // 0: primary, 1: hedge
+        std::string request;
+        std::string response;
+    };
+
+    Endpoint endpoints[RPC_MAX_ENDPOINTS];
+    size_t count;
+    uint32_t requestId;
+
+    RpcTransport* transport;          // For plain calls on the caller's task
+    Worker workers[2];                // For hedged reads
+    bool hedgeEnabled;
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t completed;
+
+    // Hedged read in flight, guarded by lock
+    uint32_t activeJob;
+    std::string* activeOut;
+    bool activeDone;
+    uint8_t activeFailures;
+    int activeWinner;
+    uint32_t hedges;
+    uint32_t hedgeWins;
+
+    size_t buildRequest(const char* method, const char* params, std::string* body);
+    size_t rank(int* order) const;
+    float score(const Endpoint& e, uint32_t now) const;
+    uint32_t percentile(const Endpoint& e, int pct) const;
+    void record(int index, bool ok, uint32_t elapsedMs);
+    bool attempt(RpcTransport& t, int index, const std::string& body, std::string* out);
+    bool hedgedRead(const std::string& body, std::string* out, const int* order, size_t ranked, int* servedBy);
+    void startWorkers();
+    RpcTransport& local();
+
+    static void workerLoop(void* arg);
+    static bool isRetryable(int httpStatus, const std::string& response);
+};
+
+#endif // RPC_CLIENT_H
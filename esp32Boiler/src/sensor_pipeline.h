@@ -0,0 +1,303 @@
+/*
+ * Sensor Aggregation Pipeline
+ *
+ * Turns a high-rate sample stream into one on-chain write per window
+ * instead of one per sample. A sampler (timer or task) pushes readings
+ * into a lock-free ring; loop() drains the ring into a running
+ * min/max/mean/count. A window closes after windowMs, or early when the
+ * reading crosses the alert threshold. Closed windows wait in a small
+ * outbox until their transaction is accepted. When sends fall behind, the
+ * newest windows are merged rather than dropped, so a slow node costs
+ * resolution, not data. When sampling stops, flush() closes the partial
+ * window so it is committed now rather than whenever sampling resumes.
+ *
+ *   SensorPipeline pipeline;
+ *   pipeline.push(millis(), reading);          // Sampler, any rate
+ *   pipeline.drain(millis());                  // loop(); flush() once stopped
+ *   SensorWindow window;
+ *   if (pipeline.peek(&window) && send(SensorPipeline::pack(window))) {
+ *       pipeline.pop();
+ *   }
+ *
+ * Readings are fixed-point int32 (e.g. milli-degrees). There is no
+ * Arduino dependency, so tools/sensor_sim runs the same code on the host.
+ */
+
+#ifndef SENSOR_PIPELINE_H
+#define SENSOR_PIPELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <uint256/uint256_t.h>
+
+// Power of two; must hold sample rate x the longest loop() stall (a send)
+#ifndef SENSOR_RING_SIZE
+#define SENSOR_RING_SIZE 256
+#endif
+#define SENSOR_OUTBOX_SIZE 4          // Closed windows awaiting a transaction
+
+// Why a window closed
+#define SENSOR_FLAG_TIMER 0x01        // windowMs elapsed
+#define SENSOR_FLAG_ALERT 0x02        // Reading crossed the alert threshold
+#define SENSOR_FLAG_ABOVE 0x04        // Reading was above the threshold at the end
+#define SENSOR_FLAG_MERGED 0x08       // Outbox was full; holds several windows
+#define SENSOR_FLAG_STOPPED 0x10      // Sampling stopped; cut short by flush()
+
+struct SensorSample {
+    uint32_t timeMs;
+    int32_t value;
+};
+
+struct SensorWindow {
+    uint32_t sequence;                // 24 bits on chain
+    uint8_t flags;
+    uint32_t startMs;
+    uint32_t durationMs;
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    int32_t last;
+};
+
+struct SensorPipelineConfig {
+    uint32_t windowMs;                // Commit at least this often while sampling
+    uint32_t minWindowMs;             // Alerts do not close windows shorter than this
+    bool alerts;
+    int32_t alertHigh;                // Crossing upwards closes the window
+    int32_t alertHysteresis;          // Back below alertHigh - this closes it again
+};
+
+static const SensorPipelineConfig SENSOR_DEFAULTS = {
+    300000,   // windowMs: one commit per 5 minutes
+    10000,    // minWindowMs
+    false,    // alerts
+    0,        // alertHigh
+    0         // alertHysteresis
+};
+
+struct SensorPipelineStats {
+    uint32_t samples;                 // Pushed by the sampler
+    uint32_t dropped;                 // Ring full; drain() runs too rarely
+    uint32_t windows;                 // Closed
+    uint32_t merged;                  // Folded into a queued window
+    uint32_t committed;               // Popped after a successful send
+};
+
+class SensorPipeline {
+public:
+    explicit SensorPipeline(const SensorPipelineConfig& config = SENSOR_DEFAULTS)
+        : cfg(config), head(0), tail(0), sum(0), lastMs(0), open(false), above(false), sequence(0),
+          outHead(0), outSize(0), stats() {}
+
+    // Producer side; safe to call from another task or core than drain().
+    // Returns false (and counts a drop) when the ring is full.
+    bool push(uint32_t now, int32_t value) {
+        uint16_t h = head.load(std::memory_order_relaxed);
+        uint16_t next = (h + 1) & (SENSOR_RING_SIZE - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        ring[h].timeMs = now;
+        ring[h].value = value;
+        head.store(next, std::memory_order_release);
+        pushed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer side: aggregate everything pushed so far and close the
+    // window if it is due. Returns the number of windows closed.
+    int drain(uint32_t now) {
+        int closed = 0;
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        uint16_t h = head.load(std::memory_order_acquire);
+        while (t != h) {
+            closed += add(ring[t]);
+            t = (t + 1) & (SENSOR_RING_SIZE - 1);
+        }
+        tail.store(t, std::memory_order_release);
+
+        if (open && now - current.startMs >= cfg.windowMs) {
+            close(SENSOR_FLAG_TIMER);
+            closed++;
+        }
+        return closed;
+    }
+
+    // Sampling stopped: aggregate what is left in the ring and close the
+    // open window without waiting for windowMs. Safe to call on every
+    // loop() pass while stopped; a sample the sampler pushed after it was
+    // told to stop ends up in a window of its own.
+    int flush(uint32_t now) {
+        int closed = drain(now);
+        if (open) {
+            close(SENSOR_FLAG_STOPPED);
+            closed++;
+        }
+        return closed;
+    }
+
+    // Samples or an open window that have not reached the outbox yet
+    bool pending() const {
+        return open || head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed);
+    }
+
+    // Oldest closed window not yet committed
+    bool peek(SensorWindow* out) const {
+        if (outSize == 0) {
+            return false;
+        }
+        *out = outbox[outHead];
+        return true;
+    }
+
+    // The window from peek() was committed
+    void pop() {
+        if (outSize > 0) {
+            outHead = (outHead + 1) % SENSOR_OUTBOX_SIZE;
+            outSize--;
+            stats.committed++;
+        }
+    }
+
+    size_t backlog() const { return outSize; }
+
+    SensorPipelineStats snapshot() const {
+        SensorPipelineStats s = stats;
+        s.samples = pushed.load(std::memory_order_relaxed);
+        s.dropped = dropped.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // One storage word, eight 32-bit fields from the top: sequence << 8 |
+    // flags, startMs, durationMs, count, min, max, mean, last
+    static uint256_t pack(const SensorWindow& w) {
+        uint64_t f0 = (uint64_t)((w.sequence & 0xFFFFFF) << 8 | w.flags) << 32 | w.startMs;
+        uint64_t f1 = (uint64_t)w.durationMs << 32 | w.count;
+        uint64_t f2 = (uint64_t)(uint32_t)w.min << 32 | (uint32_t)w.max;
+        uint64_t f3 = (uint64_t)(uint32_t)w.mean << 32 | (uint32_t)w.last;
+        return uint256_t(uint128_t(f0, f1), uint128_t(f2, f3));
+    }
+
+    static SensorWindow unpack(const uint256_t& word) {
+        uint64_t f0 = word.upper().upper(), f1 = word.upper().lower();
+        uint64_t f2 = word.lower().upper(), f3 = word.lower().lower();
+        SensorWindow w;
+        w.sequence = (uint32_t)(f0 >> 40);
+        w.flags = (uint8_t)(f0 >> 32);
+        w.startMs = (uint32_t)f0;
+        w.durationMs = (uint32_t)(f1 >> 32);
+        w.count = (uint32_t)f1;
+        w.min = (int32_t)(uint32_t)(f2 >> 32);
+        w.max = (int32_t)(uint32_t)f2;
+        w.mean = (int32_t)(uint32_t)(f3 >> 32);
+        w.last = (int32_t)(uint32_t)f3;
+        return w;
+    }
+
+private:
+    SensorPipelineConfig cfg;
+
+    SensorSample ring[SENSOR_RING_SIZE];
+    std::atomic<uint16_t> head;
+    std::atomic<uint16_t> tail;
+    std::atomic<uint32_t> pushed{0};
+    std::atomic<uint32_t> dropped{0};
+
+    // Window being filled
+    SensorWindow current;
+    int64_t sum;
+    uint32_t lastMs;
+    bool open;
+    bool above;
+    uint32_t sequence;
+
+    SensorWindow outbox[SENSOR_OUTBOX_SIZE];
+    int64_t outSums[SENSOR_OUTBOX_SIZE];     // Exact means when merging
+    uint8_t outHead;
+    uint8_t outSize;
+    SensorPipelineStats stats;
+
+    int add(const SensorSample& s) {
+        int closed = 0;
+        if (open && s.timeMs - current.startMs >= cfg.windowMs) {
+            close(SENSOR_FLAG_TIMER);
+            closed++;
+        }
+        if (cfg.alerts) {
+            bool crossed = above ? s.value <= cfg.alertHigh - cfg.alertHysteresis
+                                 : s.value >= cfg.alertHigh;
+            if (crossed) {
+                above = !above;
+                if (open && s.timeMs - current.startMs >= cfg.minWindowMs) {
+                    close(SENSOR_FLAG_ALERT);
+                    closed++;
+                } else if (open) {
+                    current.flags |= SENSOR_FLAG_ALERT;
+                }
+            }
+        }
+
+        if (!open) {
+            current.flags = 0;
+            current.startMs = s.timeMs;
+            current.count = 0;
+            current.min = s.value;
+            current.max = s.value;
+            sum = 0;
+            open = true;
+        }
+        current.count++;
+        current.min = s.value < current.min ? s.value : current.min;
+        current.max = s.value > current.max ? s.value : current.max;
+        current.last = s.value;
+        sum += s.value;
+        lastMs = s.timeMs;
+        return closed;
+    }
+
+    // durationMs spans the window's first to last sample
+    void close(uint8_t reason) {
+        open = false;
+        current.flags |= reason | (above ? SENSOR_FLAG_ABOVE : 0);
+        current.durationMs = lastMs - current.startMs;
+        current.mean = mean(sum, current.count);
+        current.sequence = sequence++;
+        stats.windows++;
+
+        if (outSize < SENSOR_OUTBOX_SIZE) {
+            uint8_t at = (outHead + outSize) % SENSOR_OUTBOX_SIZE;
+            outbox[at] = current;
+            outSums[at] = sum;
+            outSize++;
+            return;
+        }
+
+        // Outbox full: fold into the newest entry, never the one that may
+        // be in flight at outHead
+        uint8_t at = (outHead + outSize - 1) % SENSOR_OUTBOX_SIZE;
+        SensorWindow& w = outbox[at];
+        outSums[at] += sum;
+        w.flags = (w.flags & ~SENSOR_FLAG_ABOVE) | current.flags | SENSOR_FLAG_MERGED;
+        w.durationMs = current.startMs + current.durationMs - w.startMs;
+        w.count += current.count;
+        w.min = current.min < w.min ? current.min : w.min;
+        w.max = current.max > w.max ? current.max : w.max;
+        w.mean = mean(outSums[at], w.count);
+        w.last = current.last;
+        w.sequence = current.sequence;
+        stats.merged++;
+    }
+
+    static int32_t mean(int64_t total, uint32_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        // Round half away from zero
+        return (int32_t)(total >= 0 ? (total + n / 2) / (int64_t)n : (total - n / 2) / (int64_t)n);
+    }
+};
+
+#endif // SENSOR_PIPELINE_H
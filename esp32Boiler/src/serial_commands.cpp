@@ -0,0 +1,240 @@
+/*
+ * Serial Command Processor implementation
+ */
+
+#include "serial_commands.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hex.h"
+
+SerialCommands::SerialCommands(Stream& io, const Command* table, size_t count)
+    : io(io), table(table), count(count), connected(false), head(0), tail(0), lines(0),
+      discarding(false), scriptLen(0), recording(false), replaying(false) {}
+
+bool SerialCommands::isAddress(const char* text) {
+    uint8_t parsed[20];
+    return Hex::parseAddress(text, parsed);
+}
+
+// ===== INPUT =====
+void SerialCommands::poll() {
+    // Take only what is already buffered; a line finishes on a later call
+    while (io.available() > 0) {
+        int c = io.read();
+        if (c < 0) {
+            break;
+        }
+        uint16_t next = (head + 1) & (CMD_RING_SIZE - 1);
+        bool eol = c == '\n' || c == '\r';
+
+        if (next == tail) {
+            if (lines > 0) {
+                break;    // Run what is complete first; the UART keeps the rest
+            }
+            // One line filled the ring: drop it up to its newline
+            head = tail;
+            discarding = true;
+            io.println("ERR line too long");
+        }
+        if (discarding) {
+            discarding = !eol;
+            continue;
+        }
+        ring[head] = (char)c;
+        head = next;
+        lines += eol;
+    }
+
+    char line[CMD_LINE_MAX];
+    while (nextLine(line, sizeof(line))) {
+        handleLine(line);
+    }
+}
+
+bool SerialCommands::nextLine(char* out, size_t cap) {
+    while (lines > 0) {
+        size_t len = 0;
+        bool truncated = false;
+        while (true) {
+            char c = ring[tail];
+            tail = (tail + 1) & (CMD_RING_SIZE - 1);
+            if (c == '\n' || c == '\r') {
+                break;
+            }
+            if (len + 1 < cap) {
+                out[len++] = c;
+            } else {
+                truncated = true;
+            }
+        }
+        lines--;
+        out[len] = '\0';
+
+        if (truncated) {
+            io.println("ERR line too long");
+        } else if (len > 0) {
+            return true;    // "\r\n" leaves an empty line; skip it
+        }
+    }
+    return false;
+}
+
+void SerialCommands::handleLine(char* line) {
+    if (!recording) {
+        execute(line);
+        return;
+    }
+    if (strcmp(line, "end") == 0) {
+        recording = false;
+        io.printf("OK begin %u bytes\n", (unsigned)scriptLen);
+        runScript(1);
+        return;
+    }
+    size_t len = strlen(line);
+    if (scriptLen + len + 1 >= CMD_SCRIPT_SIZE) {
+        recording = false;
+        scriptLen = 0;
+        io.println("ERR begin script too long, discarded");
+        return;
+    }
+    memcpy(script + scriptLen, line, len);
+    scriptLen += len;
+    script[scriptLen++] = '\n';
+}
+
+// ===== EXECUTION =====
+bool SerialCommands::execute(char* line) {
+    char* rest = line;
+    while (rest) {
+        char* text = rest;
+        char* sep = strchr(rest, ';');
+        if (sep) {
+            *sep = '\0';
+            rest = sep + 1;
+        } else {
+            rest = nullptr;
+        }
+        if (!runOne(text)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SerialCommands::runScript(uint32_t times) {
+    if (scriptLen == 0) {
+        io.println("ERR run no script recorded");
+        return false;
+    }
+    replaying = true;
+    bool ok = true;
+    for (uint32_t i = 0; i < times && ok; i++) {
+        size_t at = 0;
+        while (at < scriptLen) {
+            const char* end = (const char*)memchr(script + at, '\n', scriptLen - at);
+            size_t len = end - (script + at);
+            char line[CMD_LINE_MAX];
+            memcpy(line, script + at, len);
+            line[len] = '\0';
+            at += len + 1;
+            if (!execute(line)) {
+                io.printf("ERR run stopped in pass %lu\n", (unsigned long)(i + 1));
+                ok = false;
+                break;
+            }
+        }
+    }
+    replaying = false;
+    return ok;
+}
+
+bool SerialCommands::runOne(char* text) {
+    char* argv[CMD_MAX_ARGS + 2];
+    int argc = 0;
+    char* save = nullptr;
+    for (char* tok = strtok_r(text, " \t", &save); tok; tok = strtok_r(nullptr, " \t", &save)) {
+        if (argc == CMD_MAX_ARGS + 1) {
+            io.println("ERR too many parameters");
+            return false;
+        }
+        argv[argc++] = tok;
+    }
+    if (argc == 0) {
+        return true;    // "a;;b" or trailing ';'
+    }
+    const char* name = argv[0];
+
+    // Built-ins
+    if (strcmp(name, "help") == 0 || strcmp(name, "?") == 0) {
+        printHelp();
+        return true;
+    }
+    if ((strcmp(name, "begin") == 0 || strcmp(name, "run") == 0) && replaying) {
+        io.printf("ERR %s not allowed inside a script\n", name);
+        return false;
+    }
+    if (strcmp(name, "begin") == 0) {
+        recording = true;
+        scriptLen = 0;
+        io.println("Recording; send \"end\" to run");
+        return true;
+    }
+    if (strcmp(name, "run") == 0) {
+        long times = argc > 1 ? strtol(argv[1], nullptr, 10) : 1;
+        if (times < 1) {
+            io.println("ERR run usage: run [times]");
+            return false;
+        }
+        return runScript((uint32_t)times);
+    }
+
+    const Command* cmd = find(name);
+    if (!cmd) {
+        io.printf("ERR %s unknown command (try help)\n", name);
+        return false;
+    }
+    int params = argc - 1;
+    if (params < cmd->minArgs || params > cmd->maxArgs) {
+        io.printf("ERR %s usage: %s %s\n", cmd->name, cmd->name, cmd->usage);
+        return false;
+    }
+    if (cmd->online && !connected) {
+        io.printf("ERR %s Web3 not connected\n", cmd->name);
+        return false;
+    }
+
+    uint32_t start = millis();
+    bool ok = cmd->handler(params, argv + 1);
+    uint32_t elapsed = millis() - start;
+    if (ok) {
+        io.printf("OK %s %lu ms\n", cmd->name, (unsigned long)elapsed);
+    } else {
+        io.printf("ERR %s failed after %lu ms\n", cmd->name, (unsigned long)elapsed);
+    }
+    return ok;
+}
+
+const Command* SerialCommands::find(const char* name) const {
+    for (size_t i = 0; i < count; i++) {
+        if (strcasecmp(name, table[i].name) == 0 || (table[i].alias && strcmp(name, table[i].alias) == 0)) {
+            return &table[i];
+        }
+    }
+    return nullptr;
+}
+
+void SerialCommands::printHelp() {
+    io.println();
+    io.println("========== COMMANDS ==========");
+    for (size_t i = 0; i < count; i++) {
+        const Command& c = table[i];
+        io.printf("%-2s %-9s %s\n", c.alias ? c.alias : "", c.name, c.usage);
+    }
+    io.println("   help      this list");
+    io.println("   begin     record lines until \"end\", then run them");
+    io.println("   run       [times] - repeat the recorded script");
+    io.println("Separate commands with ';' to run them back to back.");
+    io.println("==============================");
+}
@@ -0,0 +1,87 @@
+/*
+ * Serial Command Processor
+ *
+ * Line-oriented, non-blocking replacement for Serial.readString(). poll()
+ * moves whatever the UART has into a ring buffer and returns at once; a
+ * command runs only when its full line has arrived, so loop() never waits
+ * out the stream timeout and a test rig can send commands back to back.
+ *
+ * Commands come from a table of {name, alias, handler, arg limits}:
+ *
+ *   balance 0xabc...                 one command with parameters
+ *   1                                legacy menu number (alias)
+ *   balance; send 0xabc... 0.01      batch: ';' runs several in order
+ *   begin / ... / end                script: lines between run at "end"
+ *   run 10                           repeat the last script 10 times
+ *
+ * Each command reports "OK <name> <ms> ms" or "ERR <name> <reason>" on its
+ * own line, which is what a rig should wait for before sending the next
+ * line. A batch stops at the first error.
+ */
+
+#ifndef SERIAL_COMMANDS_H
+#define SERIAL_COMMANDS_H
+
+#include <Arduino.h>
+
+#define CMD_RING_SIZE 512             // Power of two; raw bytes not yet parsed
+#define CMD_LINE_MAX 256              // Longest line, including ';' batches
+#define CMD_MAX_ARGS 6                // Parameters after the command name
+#define CMD_SCRIPT_SIZE 1024          // Recorded begin/end script
+
+// Returns false on failure; argv[0] is the first parameter, not the name
+typedef bool (*CommandHandler)(int argc, char** argv);
+
+struct Command {
+    const char* name;
+    const char* alias;                // Old menu number, or nullptr
+    CommandHandler handler;
+    uint8_t minArgs;
+    uint8_t maxArgs;
+    bool online;                      // Needs the Web3 connection
+    const char* usage;                // Parameters and description for help
+};
+
+class SerialCommands {
+public:
+    SerialCommands(Stream& io, const Command* table, size_t count);
+
+    // Call from loop(); never blocks
+    void poll();
+
+    // Run one line (may contain ';' batches). line is modified.
+    bool execute(char* line);
+
+    // Commands marked online are refused while this is false
+    void setOnline(bool online) { connected = online; }
+
+    void printHelp();
+
+    // Parameter checks for handlers
+    static bool isAddress(const char* text);
+
+private:
+    Stream& io;
+    const Command* table;
+    size_t count;
+    bool connected;
+
+    char ring[CMD_RING_SIZE];
+    uint16_t head;                    // Next write
+    uint16_t tail;                    // Next read
+    uint16_t lines;                   // Complete lines in the ring
+    bool discarding;                  // Dropping an overlong line
+
+    char script[CMD_SCRIPT_SIZE];
+    size_t scriptLen;
+    bool recording;
+    bool replaying;                   // Scripts cannot start scripts
+
+    bool nextLine(char* out, size_t cap);
+    void handleLine(char* line);
+    bool runScript(uint32_t times);
+    bool runOne(char* text);
+    const Command* find(const char* name) const;
+};
+
+#endif // SERIAL_COMMANDS_H
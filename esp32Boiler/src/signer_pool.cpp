@@ -0,0 +1,179 @@
+/*
+ * Signer Pool implementation
+ */
+
+#include "signer_pool.h"
+
+#include <Contract.h>
+
+SignerPool::SignerPool(Web3* web3, RpcClient& rpc)
+    : web3(web3), rpc(rpc), count(0), rotate(0), polledAt(0) {
+    memset(lanesArr, 0, sizeof(lanesArr));
+}
+
+bool SignerPool::addSigner(const char* privateKey, const char* address) {
+    if (count == SIGNER_MAX_LANES || strlen(privateKey) != 64) {
+        return false;
+    }
+    Lane& lane = lanesArr[count++];
+    lane.key = privateKey;
+    lane.address = address;
+    return true;
+}
+
+bool SignerPool::syncNonce(Lane& lane, const char* tag, uint32_t* nonce) {
+    char params[72];
+    snprintf(params, sizeof(params), "[\"%s\",\"%s\"]", lane.address, tag);
+
+    std::string response;
+    uint64_t value;
+    if (!rpc.call("eth_getTransactionCount", params, &response) ||
+        !RpcClient::resultQuantity(response, &value)) {
+        return false;
+    }
+    *nonce = (uint32_t)value;
+    return true;
+}
+
+bool SignerPool::isStuck(const Lane& lane, uint32_t now) const {
+    return lane.size > 0 && now - lane.pending[lane.head].sentAt > SIGNER_STUCK_MS;
+}
+
+// Fewest unconfirmed transactions wins; ties rotate so idle lanes share
+// the load instead of the first one taking every burst
+int SignerPool::pickLane(uint32_t now) {
+    int best = -1;
+    for (size_t n = 0; n < count; n++) {
+        size_t i = (rotate + n) % count;
+        const Lane& lane = lanesArr[i];
+        if (lane.size == SIGNER_LANE_DEPTH || isStuck(lane, now)) {
+            continue;
+        }
+        if (best < 0 || lane.size < lanesArr[best].size) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        rotate = best + 1;
+    }
+    return best;
+}
+
+bool SignerPool::send(const std::string& to, const uint256_t& value, const std::string& data,
+                      unsigned long long gasPrice, uint32_t gasLimit, SignerReceipt* receipt) {
+    uint32_t now = millis();
+    int index = pickLane(now);
+    if (index < 0) {
+        return false;
+    }
+    Lane& lane = lanesArr[index];
+
+    if (!lane.nonceKnown) {
+        if (!syncNonce(lane, "pending", &lane.nextNonce)) {
+            return false;
+        }
+        lane.nonceKnown = true;
+    }
+
+    Contract contract(web3, to.c_str());
+    contract.SetPrivateKey(lane.key);
+    std::string toAddr = to;
+    uint256_t callValue = value;
+    std::string callData = data;
+    std::string result = contract.SendTransaction(lane.nextNonce, gasPrice, gasLimit, &toAddr, &callValue, &callData);
+
+    size_t at = result.find("\"result\":\"0x");
+    if (at == std::string::npos || result.size() < at + 10 + 66) {
+        lane.failed++;
+        // Nonce drift (another sender, a dropped tx): resync on next use
+        if (result.find("nonce") != std::string::npos) {
+            lane.nonceKnown = false;
+        }
+        return false;
+    }
+
+    if (receipt) {
+        receipt->lane = index;
+        receipt->nonce = lane.nextNonce;
+        memcpy(receipt->txHash, result.c_str() + at + 10, 66);
+        receipt->txHash[66] = '\0';
+    }
+
+    Pending& slot = lane.pending[(lane.head + lane.size) % SIGNER_LANE_DEPTH];
+    slot.nonce = lane.nextNonce;
+    slot.sentAt = now;
+    lane.size++;
+    lane.nextNonce++;
+    lane.sent++;
+    return true;
+}
+
+void SignerPool::poll() {
+    uint32_t now = millis();
+    if (now - polledAt < SIGNER_POLL_MS) {
+        return;
+    }
+    polledAt = now;
+
+    for (size_t i = 0; i < count; i++) {
+        Lane& lane = lanesArr[i];
+        if (lane.size == 0) {
+            continue;
+        }
+
+        // The mined nonce count retires every pending entry below it
+        uint32_t mined;
+        if (!syncNonce(lane, "latest", &mined)) {
+            continue;
+        }
+        while (lane.size > 0 && (int32_t)(lane.pending[lane.head].nonce - mined) < 0) {
+            lane.head = (lane.head + 1) % SIGNER_LANE_DEPTH;
+            lane.size--;
+            lane.confirmed++;
+        }
+
+        // Stuck and unknown to the node's mempool: the transactions were
+        // dropped, so free the lane and take nonces from the node again
+        uint32_t known;
+        if (isStuck(lane, now) && syncNonce(lane, "pending", &known) &&
+            (int32_t)(known - lane.pending[lane.head].nonce) <= 0) {
+            lane.failed += lane.size;
+            lane.size = 0;
+            lane.nonceKnown = false;
+        }
+    }
+}
+
+size_t SignerPool::backlog() const {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += lanesArr[i].size;
+    }
+    return total;
+}
+
+SignerLaneStats SignerPool::stats(size_t index) const {
+    SignerLaneStats s = {};
+    if (index >= count) {
+        return s;
+    }
+    const Lane& lane = lanesArr[index];
+    s.address = lane.address;
+    s.nextNonce = lane.nextNonce;
+    s.backlog = lane.size;
+    s.stuck = isStuck(lane, millis());
+    s.sent = lane.sent;
+    s.confirmed = lane.confirmed;
+    s.failed = lane.failed;
+    return s;
+}
+
+void SignerPool::report(Print& out) const {
+    for (size_t i = 0; i < count; i++) {
+        SignerLaneStats s = stats(i);
+        out.printf("lane %u %s nonce %lu backlog %u sent %lu mined %lu failed %lu%s\n",
+                   (unsigned)i, s.address, (unsigned long)s.nextNonce, s.backlog,
+                   (unsigned long)s.sent, (unsigned long)s.confirmed, (unsigned long)s.failed,
+                   s.stuck ? " STUCK" : "");
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Signer Pool
+ *
+ * Several signing keys, each with its own nonce lane. One key means one
+ * sequential nonce stream: throughput is capped by it and a single stuck
+ * transaction blocks everything queued behind it. With a pool, each
+ * outgoing transaction goes to the least-loaded lane, and a lane with a
+ * stuck transaction is skipped until it clears.
+ *
+ *   SignerPool pool(web3, rpc);
+ *   pool.addSigner(KEY_A, ADDRESS_A);
+ *   pool.addSigner(KEY_B, ADDRESS_B);
+ *   SignerReceipt receipt;
+ *   pool.send(contractAddr, value, data, gasPrice, gasLimit, &receipt);
+ *   pool.poll();                       // From loop(); tracks confirmations
+ *
+ * Nonces are assigned locally and resynced from the node ("pending") on
+ * start and after a nonce error. Every address needs its own gas funds.
+ */
+
+#ifndef SIGNER_POOL_H
+#define SIGNER_POOL_H
+
+#include <Arduino.h>
+#include <Web3.h>
+#include <string>
+
+#include "rpc_client.h"
+
+#define SIGNER_MAX_LANES 4
+#define SIGNER_LANE_DEPTH 8           // Unconfirmed transactions per lane
+#define SIGNER_POLL_MS 4000           // Confirmation polling interval
+#define SIGNER_STUCK_MS 120000        // Oldest pending older than this = stuck
+
+struct SignerReceipt {
+    int lane;
+    uint32_t nonce;
+    char txHash[67];
+};
+
+struct SignerLaneStats {
+    const char* address;
+    uint32_t nextNonce;
+    uint8_t backlog;                  // Sent but not yet mined
+    bool stuck;
+    uint32_t sent;
+    uint32_t confirmed;
+    uint32_t failed;
+};
+
+class SignerPool {
+public:
+    SignerPool(Web3* web3, RpcClient& rpc);
+
+    // Both strings are kept by pointer and must outlive the pool.
+    // privateKey is hex without 0x; address is the matching 0x address.
+    bool addSigner(const char* privateKey, const char* address);
+
+    // Sign and send through the least-loaded lane. Returns false when every
+    // lane is full or stuck, or the node rejected the transaction.
+    bool send(const std::string& to, const uint256_t& value, const std::string& data,
+              unsigned long long gasPrice, uint32_t gasLimit, SignerReceipt* receipt);
+
+    // Retire mined transactions and flag stuck lanes; cheap to call often
+    void poll();
+
+    size_t lanes() const { return count; }
+    size_t backlog() const;
+    SignerLaneStats stats(size_t lane) const;
+    void report(Print& out) const;
+
+private:
+    struct Pending {
+        uint32_t nonce;
+        uint32_t sentAt;
+    };
+
+    struct Lane {
+        const char* key;
+        const char* address;
+        uint32_t nextNonce;
+        bool nonceKnown;
+        Pending pending[SIGNER_LANE_DEPTH];
+        uint8_t head;
+        uint8_t size;
+        uint32_t sent;
+        uint32_t confirmed;
+        uint32_t failed;
+    };
+
+    Web3* web3;
+    RpcClient& rpc;
+    Lane lanesArr[SIGNER_MAX_LANES];
+    size_t count;
+    size_t rotate;
+    uint32_t polledAt;
+
+    int pickLane(uint32_t now);
+    bool syncNonce(Lane& lane, const char* tag, uint32_t* nonce);
+    bool isStuck(const Lane& lane, uint32_t now) const;
+};
+
+#endif // SIGNER_POOL_H
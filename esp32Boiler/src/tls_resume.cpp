@@ -0,0 +1,436 @@
+/*
+ * Resumable TLS Client implementation
+ */
+
+#include "tls_resume.h"
+
+#include <esp_attr.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/version.h>
+#include <time.h>
+
+#define TLS_SLOT_MAGIC 0x544C5331           // "TLS1"
+
+// Session fields are private from mbedtls 3 on (ESP32 core 3.x)
+#if MBEDTLS_VERSION_MAJOR >= 3
+#define SESSION_FIELD(s, f) ((s)->MBEDTLS_PRIVATE(f))
+#else
+#define SESSION_FIELD(s, f) ((s)->f)
+#endif
+
+struct SessionSlot {
+    uint32_t magic;
+    uint32_t host;                          // FNV-1a of "host:port"
+    uint32_t savedAt;                       // time(), seconds
+    uint32_t length;
+    uint32_t check;
+    uint8_t data[TLS_SESSION_MAX];
+};
+
+// Not cleared at boot; survives deep sleep and esp_restart()
+RTC_NOINIT_ATTR static SessionSlot slots[TLS_SESSION_SLOTS];
+static SemaphoreHandle_t slotLock = nullptr;
+static TlsResumeStats counters;
+
+static uint32_t fnv1a(uint32_t h, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+
+static uint32_t hostKey(const char* host, uint16_t port) {
+    uint32_t h = fnv1a(2166136261u, (const uint8_t*)host, strlen(host));
+    return fnv1a(h, (const uint8_t*)&port, sizeof(port));
+}
+
+static uint32_t slotCheck(const SessionSlot& s) {
+    uint32_t h = fnv1a(2166136261u, (const uint8_t*)&s.host, 3 * sizeof(uint32_t));
+    return fnv1a(h, s.data, s.length);
+}
+
+static bool slotValid(const SessionSlot& s, uint32_t now) {
+    return s.magic == TLS_SLOT_MAGIC && s.length <= TLS_SESSION_MAX && slotCheck(s) == s.check &&
+           now >= s.savedAt && now - s.savedAt < TLS_SESSION_TTL_S;
+}
+
+class SlotGuard {
+public:
+    SlotGuard() { xSemaphoreTake(slotLock, portMAX_DELAY); }
+    ~SlotGuard() { xSemaphoreGive(slotLock); }
+};
+
+// ===== SESSION SLOTS =====
+// Offers the saved session for key on ssl; session keeps a copy so the
+// handshake can be checked against it afterwards
+static bool loadSession(uint32_t key, mbedtls_ssl_context* ssl, mbedtls_ssl_session* session) {
+    SlotGuard guard;
+    uint32_t now = (uint32_t)time(nullptr);
+    for (SessionSlot& s : slots) {
+        if (s.magic != TLS_SLOT_MAGIC || s.host != key) {
+            continue;
+        }
+        if (!slotValid(s, now)) {
+            s.magic = 0;
+            return false;
+        }
+        bool ok = mbedtls_ssl_session_load(session, s.data, s.length) == 0 &&
+                  mbedtls_ssl_set_session(ssl, session) == 0;
+        if (!ok) {
+            s.magic = 0;
+        }
+        return ok;
+    }
+    return false;
+}
+
+// A resumed handshake continues the offered session: same master secret,
+// and for ID resumption the same ID. With a ticket the client sends a
+// fresh random ID, so there only the secret tells.
+static bool resumedFrom(const mbedtls_ssl_context* ssl, const mbedtls_ssl_session* offered) {
+    mbedtls_ssl_session negotiated;
+    mbedtls_ssl_session_init(&negotiated);
+    bool same = mbedtls_ssl_get_session(ssl, &negotiated) == 0 &&
+                memcmp(SESSION_FIELD(&negotiated, master), SESSION_FIELD(offered, master),
+                       sizeof(SESSION_FIELD(offered, master))) == 0;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+    bool byTicket = SESSION_FIELD(offered, ticket_len) > 0;
+#else
+    bool byTicket = false;
+#endif
+    if (same && !byTicket) {
+        same = SESSION_FIELD(&negotiated, id_len) == SESSION_FIELD(offered, id_len) &&
+               memcmp(SESSION_FIELD(&negotiated, id), SESSION_FIELD(offered, id), SESSION_FIELD(offered, id_len)) == 0;
+    }
+    mbedtls_ssl_session_free(&negotiated);
+    return same;
+}
+
+static void saveSession(uint32_t key, const mbedtls_ssl_context* ssl) {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    if (mbedtls_ssl_get_session(ssl, &session) != 0) {
+        mbedtls_ssl_session_free(&session);
+        return;
+    }
+
+    SlotGuard guard;
+    // Same host, else an empty or invalid slot, else the oldest
+    uint32_t now = (uint32_t)time(nullptr);
+    SessionSlot* target = nullptr;
+    for (SessionSlot& s : slots) {
+        bool valid = slotValid(s, now);
+        if (valid && s.host == key) {
+            target = &s;
+            break;
+        }
+        if (!target || (!valid && slotValid(*target, now)) ||
+            (valid && slotValid(*target, now) && s.savedAt < target->savedAt)) {
+            target = &s;
+        }
+    }
+
+    size_t length = 0;
+    if (mbedtls_ssl_session_save(&session, target->data, sizeof(target->data), &length) == 0) {
+        target->host = key;
+        target->savedAt = now;
+        target->length = length;
+        target->check = slotCheck(*target);
+        target->magic = TLS_SLOT_MAGIC;
+        counters.saved++;
+    } else {
+        target->magic = 0;          // Too large to keep (long certificate chain); full handshakes it is
+    }
+    mbedtls_ssl_session_free(&session);
+}
+
+static void dropSession(uint32_t key) {
+    SlotGuard guard;
+    for (SessionSlot& s : slots) {
+        if (s.host == key) {
+            s.magic = 0;
+        }
+    }
+}
+
+// ===== CONNECTION =====
+ResumableTlsClient::ResumableTlsClient()
+    : rootCA(nullptr), configured(false), established(false), lastResumed(false), peeked(-1),
+      handshakeTimeoutMs(TLS_HANDSHAKE_TIMEOUT_MS) {
+    if (slotLock == nullptr) {
+        slotLock = xSemaphoreCreateMutex();
+    }
+    mbedtls_ssl_init(&ssl);
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_ctr_drbg_init(&drbg);
+    mbedtls_entropy_init(&entropy);
+    mbedtls_x509_crt_init(&caCert);
+}
+
+ResumableTlsClient::~ResumableTlsClient() {
+    stop();
+    mbedtls_x509_crt_free(&caCert);
+    mbedtls_entropy_free(&entropy);
+    mbedtls_ctr_drbg_free(&drbg);
+    mbedtls_ssl_config_free(&conf);
+}
+
+void ResumableTlsClient::setCACert(const char* pem) {
+    rootCA = pem;
+    configured = false;
+}
+
+void ResumableTlsClient::setInsecure() {
+    rootCA = nullptr;
+    configured = false;
+}
+
+bool ResumableTlsClient::configure() {
+    if (configured) {
+        return true;
+    }
+    mbedtls_ssl_config_free(&conf);
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_x509_crt_free(&caCert);
+    mbedtls_x509_crt_init(&caCert);
+
+    static const char personalization[] = "tls_resume";
+    if (mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, (const unsigned char*)personalization,
+                              sizeof(personalization)) != 0 ||
+        mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+        return false;
+    }
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &drbg);
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+    mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+    if (rootCA) {
+        if (mbedtls_x509_crt_parse(&caCert, (const unsigned char*)rootCA, strlen(rootCA) + 1) != 0) {
+            return false;
+        }
+        mbedtls_ssl_conf_ca_chain(&conf, &caCert, nullptr);
+        mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    } else {
+        mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_NONE);
+    }
+    configured = true;
+    return true;
+}
+
+int ResumableTlsClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip, port, (int32_t)handshakeTimeoutMs);
+}
+
+int ResumableTlsClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, (int32_t)handshakeTimeoutMs);
+}
+
+int ResumableTlsClient::connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+    char host[16];
+    snprintf(host, sizeof(host), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return connect(host, port, timeoutMs);
+}
+
+int ResumableTlsClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    stop();
+    int result = handshake(host, port, timeoutMs, true);
+    if (result < 0) {
+        // The server rejected the saved session (e.g. lost its ticket key); full handshake
+        result = handshake(host, port, timeoutMs, false);
+    }
+    return result > 0 ? 1 : 0;
+}
+
+// 1 on success, 0 on failure, -1 when the server sent an alert in answer
+// to a saved session
+int ResumableTlsClient::handshake(const char* host, uint16_t port, int32_t timeoutMs, bool offerSession) {
+    if (!configure() || !WiFiClient::connect(host, port, timeoutMs)) {
+        counters.failed++;
+        return 0;
+    }
+
+    uint32_t key = hostKey(host, port);
+    mbedtls_ssl_init(&ssl);
+    if (mbedtls_ssl_setup(&ssl, &conf) != 0 || mbedtls_ssl_set_hostname(&ssl, host) != 0) {
+        teardown();
+        counters.failed++;
+        return 0;
+    }
+    mbedtls_ssl_set_bio(&ssl, this, sendCallback, recvCallback, nullptr);
+    mbedtls_ssl_session offeredSession;
+    mbedtls_ssl_session_init(&offeredSession);
+    bool offered = offerSession && loadSession(key, &ssl, &offeredSession);
+
+    uint32_t startUs = micros();
+    uint32_t start = millis();
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+        if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+            millis() - start > handshakeTimeoutMs) {
+            break;
+        }
+        delay(1);
+    }
+    uint32_t elapsed = millis() - start;
+    counters.lastHandshakeMs = elapsed;
+
+    if (ret != 0) {
+        mbedtls_ssl_session_free(&offeredSession);
+        teardown();
+        counters.failed++;
+        // Only an alert says the session was refused; a timeout or reset
+        // says nothing about it, and retrying would double the wait
+        if (offered && ret == MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE) {
+            dropSession(key);
+            return -1;
+        }
+        return 0;
+    }
+
+    established = true;
+    lastResumed = offered && resumedFrom(&ssl, &offeredSession);
+    mbedtls_ssl_session_free(&offeredSession);
+    if (counters.firstEndUs == 0) {
+        counters.firstStartUs = startUs;
+        counters.firstEndUs = micros() | 1;
+        counters.firstResumed = lastResumed;
+    }
+    if (lastResumed) {
+        counters.resumed++;
+        counters.resumedMs += elapsed;
+    } else {
+        counters.full++;
+        counters.fullMs += elapsed;
+        counters.refused += offered;
+        // Resumed sessions keep their original save time, so the TTL
+        // counts from the handshake that created them
+        saveSession(key, &ssl);
+    }
+    return 1;
+}
+
+void ResumableTlsClient::teardown() {
+    mbedtls_ssl_free(&ssl);
+    mbedtls_ssl_init(&ssl);
+    established = false;
+    peeked = -1;
+    WiFiClient::stop();
+}
+
+void ResumableTlsClient::stop() {
+    if (established) {
+        mbedtls_ssl_close_notify(&ssl);
+    }
+    teardown();
+}
+
+uint8_t ResumableTlsClient::connected() {
+    if (!established) {
+        return 0;
+    }
+    return available() > 0 || WiFiClient::connected();
+}
+
+// ===== I/O =====
+int ResumableTlsClient::sendCallback(void* ctx, const unsigned char* buf, size_t len) {
+    ResumableTlsClient* self = static_cast<ResumableTlsClient*>(ctx);
+    if (!self->WiFiClient::connected()) {
+        return MBEDTLS_ERR_NET_CONN_RESET;
+    }
+    size_t n = self->WiFiClient::write(buf, len);
+    return n > 0 ? (int)n : MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+int ResumableTlsClient::recvCallback(void* ctx, unsigned char* buf, size_t len) {
+    ResumableTlsClient* self = static_cast<ResumableTlsClient*>(ctx);
+    int avail = self->WiFiClient::available();
+    if (avail <= 0) {
+        return self->WiFiClient::connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    }
+    int n = self->WiFiClient::read(buf, len < (size_t)avail ? len : (size_t)avail);
+    return n > 0 ? n : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+size_t ResumableTlsClient::write(const uint8_t* buf, size_t size) {
+    if (!established) {
+        return 0;
+    }
+    size_t sent = 0;
+    uint32_t start = millis();
+    while (sent < size) {
+        int ret = mbedtls_ssl_write(&ssl, buf + sent, size - sent);
+        if (ret > 0) {
+            sent += ret;
+        } else if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+                   millis() - start > handshakeTimeoutMs) {
+            stop();
+            break;
+        } else {
+            delay(1);
+        }
+    }
+    return sent;
+}
+
+// Same approach as the core's ssl_client: a zero-length read makes mbedtls
+// decrypt a pending record, after which its plaintext is counted
+int ResumableTlsClient::available() {
+    if (!established) {
+        return 0;
+    }
+    int ret = mbedtls_ssl_read(&ssl, nullptr, 0);
+    int pending = (int)mbedtls_ssl_get_bytes_avail(&ssl) + (peeked >= 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE && pending <= 0) {
+        stop();
+    }
+    return pending;
+}
+
+int ResumableTlsClient::read(uint8_t* buf, size_t size) {
+    if (!established || size == 0) {
+        return -1;
+    }
+    size_t n = 0;
+    if (peeked >= 0) {
+        buf[n++] = (uint8_t)peeked;
+        peeked = -1;
+    }
+    if (n < size && mbedtls_ssl_get_bytes_avail(&ssl) > 0) {
+        int ret = mbedtls_ssl_read(&ssl, buf + n, size - n);
+        n += ret > 0 ? ret : 0;
+    }
+    return n > 0 ? (int)n : -1;
+}
+
+int ResumableTlsClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int ResumableTlsClient::peek() {
+    if (peeked < 0 && available() > 0) {
+        peeked = read();
+    }
+    return peeked;
+}
+
+// ===== STATS =====
+TlsResumeStats ResumableTlsClient::stats() {
+    return counters;
+}
+
+void ResumableTlsClient::forgetSessions() {
+    SlotGuard guard;
+    for (SessionSlot& s : slots) {
+        s.magic = 0;
+    }
+}
+
+void ResumableTlsClient::report(Print& out) {
+    TlsResumeStats s = counters;
+    out.printf("TLS: %lu full (avg %lu ms), %lu resumed (avg %lu ms), %lu refused, %lu failed, %lu saved\n",
+               (unsigned long)s.full, (unsigned long)(s.full ? s.fullMs / s.full : 0), (unsigned long)s.resumed,
+               (unsigned long)(s.resumed ? s.resumedMs / s.resumed : 0), (unsigned long)s.refused,
+               (unsigned long)s.failed, (unsigned long)s.saved);
+}
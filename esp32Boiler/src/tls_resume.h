@@ -0,0 +1,114 @@
+/*
+ * Resumable TLS Client
+ *
+ * HTTPS transport for RpcClient that remembers TLS sessions across
+ * reboots and deep sleep. A full handshake (certificate chain, ECDHE,
+ * signature checks) is the most expensive step of a short duty cycle;
+ * resuming a saved session skips the certificate and key exchange work
+ * and one round trip.
+ *
+ * - Drop-in for WiFiClientSecure under HTTPClient: a WiFiClient for the
+ *   TCP side with mbedtls layered on top, so setCACert()/setInsecure()
+ *   and HTTPClient's begin(client, url) work unchanged
+ * - After every handshake the session (ID or ticket, whichever the server
+ *   issued) is serialised with mbedtls_ssl_session_save() into RTC memory,
+ *   one slot per host. RTC_NOINIT memory survives deep sleep and software
+ *   resets but not power loss; slots carry a checksum for that case.
+ *   NVS was not used: it would take a flash write per handshake.
+ * - A saved session is offered on the next connect to the same host
+ *   while younger than TLS_SESSION_TTL_S. If the server does not accept it
+ *   mbedtls falls back to a full handshake by itself; if the server answers
+ *   the offer with a TLS alert, the slot is dropped and the connect is
+ *   retried once without it. A timeout or a dropped connection is not
+ *   retried, so a dead network costs one handshake timeout, not two.
+ * - Whether a handshake resumed is read from the negotiated session
+ *   (mbedtls_ssl_get_session): a resumed one carries on the offered
+ *   session's master secret, and its ID unless it came from a ticket
+ *
+ * Web3E opens its own connections for transactions; only RpcClient reads
+ * (including the first balance check after boot) go through this client.
+ */
+
+#ifndef TLS_RESUME_H
+#define TLS_RESUME_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+#define TLS_SESSION_SLOTS 2                // Hosts remembered; RPC_ENDPOINTS are tried best first
+#define TLS_SESSION_MAX 1536               // Serialised session incl. peer certificate
+#define TLS_SESSION_TTL_S 3600             // Servers rarely honour tickets for longer
+#define TLS_HANDSHAKE_TIMEOUT_MS 8000
+
+struct TlsResumeStats {
+    uint32_t full;                         // Handshakes with a certificate exchange
+    uint32_t resumed;                      // Abbreviated handshakes from a saved session
+    uint32_t refused;                      // Session offered, server did a full handshake
+    uint32_t saved;                        // Sessions written to RTC memory
+    uint32_t failed;
+    uint32_t lastHandshakeMs;
+    uint32_t fullMs;                       // Sum over full handshakes
+    uint32_t resumedMs;                    // Sum over resumed ones
+    uint32_t firstStartUs;                 // First handshake since boot, micros(); for BootProfile
+    uint32_t firstEndUs;                   // 0 until it completed
+    bool firstResumed;
+};
+
+class ResumableTlsClient : public WiFiClient {
+public:
+    ResumableTlsClient();
+    ~ResumableTlsClient();
+
+    void setCACert(const char* rootCA);    // PEM; kept by pointer
+    void setInsecure();                    // No certificate verification
+    void setHandshakeTimeout(uint32_t ms) { handshakeTimeoutMs = ms; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    // HTTPClient uses these; virtual in ESPLwIPClient on ESP32 core 2.x
+    int connect(IPAddress ip, uint16_t port, int32_t timeoutMs);
+    int connect(const char* host, uint16_t port, int32_t timeoutMs);
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+
+    // Whether the last handshake resumed a saved session
+    bool resumedSession() const { return lastResumed; }
+
+    static TlsResumeStats stats();
+    static void forgetSessions();          // Next connects do full handshakes
+    static void report(Print& out);
+
+private:
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_entropy_context entropy;
+    mbedtls_x509_crt caCert;
+    const char* rootCA;
+    bool configured;
+    bool established;
+    bool lastResumed;
+    int peeked;
+    uint32_t handshakeTimeoutMs;
+
+    bool configure();
+    int handshake(const char* host, uint16_t port, int32_t timeoutMs, bool offerSession);
+    void teardown();
+
+    static int sendCallback(void* ctx, const unsigned char* buf, size_t len);
+    static int recvCallback(void* ctx, unsigned char* buf, size_t len);
+};
+
+#endif // TLS_RESUME_H
@@ -0,0 +1,593 @@
+/*
+ * Fixed-width 256-bit Unsigned Integer
+ *
+ * UInt256 holds balances, token ids and amounts as four 64-bit limbs and
+ * does every operation with straight-line word arithmetic: add and
+ * subtract with carry chains, schoolbook multiply on 64x64->128 products,
+ * Knuth division. Web3E's uint256_t nests two uint128_t halves and
+ * divides (and so prints) one bit per step.
+ *
+ * - Comparisons run a full borrow chain with no early exit
+ * - Decimal output peels 19 digits per pass: 10^19 is the largest power
+ *   of ten in a word and already has its top bit set, so each limb step
+ *   is one multiply by a fixed reciprocal (Moller-Granlund 2-by-1)
+ *   instead of a hardware or libgcc division
+ * - Converts implicitly to and from uint256_t, so it can hold what
+ *   getUint256() returns and be passed where uint256_t is expected
+ *
+ *   UInt256 balance = web3->getUint256(&response);
+ *   if (balance > 0) Serial.println(balance.str().c_str());
+ *
+ *   char dec[UINT256_DEC_CHARS];
+ *   balance.toDecimal(dec, sizeof(dec));            // No heap
+ *
+ * Header-only so the examples can share it with src/main.cpp.
+ */
+
+#ifndef UINT256_H
+#define UINT256_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+#include <string>
+#include <uint256/uint256_t.h>
+
+#include "hex.h"
+
+#define UINT256_DEC_CHARS 79                // 78 digits and the terminator
+#define UINT256_HEX_CHARS 65                // 64 digits and the terminator
+
+class UInt256 {
+public:
+    UInt256() : w{0, 0, 0, 0} {}
+    UInt256(uint64_t value) : w{value, 0, 0, 0} {}
+    // Most significant word first, as written
+    UInt256(uint64_t w3, uint64_t w2, uint64_t w1, uint64_t w0) : w{w0, w1, w2, w3} {}
+    UInt256(const uint256_t& v)
+        : w{v.lower().lower(), v.lower().upper(), v.upper().lower(), v.upper().upper()} {}
+
+    operator uint256_t() const { return uint256_t(uint128_t(w[3], w[2]), uint128_t(w[1], w[0])); }
+
+    // Limb i, least significant first
+    uint64_t word(int i) const { return w[i]; }
+    uint64_t low64() const { return w[0]; }
+    bool fits64() const { return (w[1] | w[2] | w[3]) == 0; }
+
+    int bits() const {
+        for (int i = 3; i >= 0; i--) {
+            if (w[i]) {
+                return 64 * i + 64 - clz(w[i]);
+            }
+        }
+        return 0;
+    }
+
+    explicit operator bool() const { return (w[0] | w[1] | w[2] | w[3]) != 0; }
+
+    // ===== COMPARISON =====
+    bool operator==(const UInt256& b) const {
+        return ((w[0] ^ b.w[0]) | (w[1] ^ b.w[1]) | (w[2] ^ b.w[2]) | (w[3] ^ b.w[3])) == 0;
+    }
+    bool operator!=(const UInt256& b) const { return !(*this == b); }
+    bool operator<(const UInt256& b) const { return borrowOut(*this, b); }
+    bool operator>(const UInt256& b) const { return borrowOut(b, *this); }
+    bool operator<=(const UInt256& b) const { return !borrowOut(b, *this); }
+    bool operator>=(const UInt256& b) const { return !borrowOut(*this, b); }
+
+    // -1, 0 or 1
+    static int compare(const UInt256& a, const UInt256& b) {
+        return (int)(a != b) - 2 * (int)borrowOut(a, b);
+    }
+
+    // ===== ARITHMETIC =====
+    // All wrap modulo 2^256 like the built-in unsigned types
+    UInt256& operator+=(const UInt256& b) {
+        // Written out: GCC keeps the four-step loop rolled at -O2
+        uint64_t carry = 0;
+        w[0] = addCarry(w[0], b.w[0], &carry);
+        w[1] = addCarry(w[1], b.w[1], &carry);
+        w[2] = addCarry(w[2], b.w[2], &carry);
+        w[3] = w[3] + b.w[3] + carry;
+        return *this;
+    }
+
+    UInt256& operator-=(const UInt256& b) {
+        uint64_t borrow = 0;
+        w[0] = subBorrow(w[0], b.w[0], &borrow);
+        w[1] = subBorrow(w[1], b.w[1], &borrow);
+        w[2] = subBorrow(w[2], b.w[2], &borrow);
+        w[3] = w[3] - b.w[3] - borrow;
+        return *this;
+    }
+
+    UInt256& operator*=(const UInt256& b) { return *this = *this * b; }
+    UInt256& operator/=(const UInt256& b) { return *this = *this / b; }
+    UInt256& operator%=(const UInt256& b) { return *this = *this % b; }
+
+    UInt256 operator+(const UInt256& b) const { return UInt256(*this) += b; }
+    UInt256 operator-(const UInt256& b) const { return UInt256(*this) -= b; }
+
+    UInt256 operator*(const UInt256& b) const {
+        UInt256 r;
+        for (int i = 0; i < 4; i++) {
+            uint64_t carry = 0;
+            for (int j = 0; i + j < 4; j++) {
+                uint64_t hi;
+                uint64_t lo = mul64(w[i], b.w[j], &hi);
+                lo += carry;
+                hi += lo < carry;
+                r.w[i + j] += lo;
+                hi += r.w[i + j] < lo;
+                carry = hi;
+            }
+        }
+        return r;
+    }
+
+    // Throws std::domain_error on a zero divisor, as uint256_t does
+    UInt256 operator/(const UInt256& b) const {
+        UInt256 q, r;
+        if (!divmod(*this, b, &q, &r)) {
+            throw std::domain_error("UInt256 division by zero");
+        }
+        return q;
+    }
+
+    UInt256 operator%(const UInt256& b) const {
+        UInt256 q, r;
+        if (!divmod(*this, b, &q, &r)) {
+            throw std::domain_error("UInt256 division by zero");
+        }
+        return r;
+    }
+
+    UInt256& operator++() { return *this += 1; }
+    UInt256& operator--() { return *this -= 1; }
+
+    // q = a / b, r = a % b; false when b is zero. q or r may be nullptr.
+    static bool divmod(const UInt256& a, const UInt256& b, UInt256* q, UInt256* r) {
+        UInt256 quotient, remainder;
+        if (b.fits64()) {
+            if (b.w[0] == 0) {
+                return false;
+            }
+            quotient = a;
+            remainder = divWord(&quotient, b.w[0]);
+        } else if (a < b) {
+            remainder = a;
+        } else {
+            divLong(a, b, &quotient, &remainder);
+        }
+        if (q) {
+            *q = quotient;
+        }
+        if (r) {
+            *r = remainder;
+        }
+        return true;
+    }
+
+    // ===== BITS =====
+    UInt256 operator&(const UInt256& b) const { return UInt256(w[3] & b.w[3], w[2] & b.w[2], w[1] & b.w[1], w[0] & b.w[0]); }
+    UInt256 operator|(const UInt256& b) const { return UInt256(w[3] | b.w[3], w[2] | b.w[2], w[1] | b.w[1], w[0] | b.w[0]); }
+    UInt256 operator^(const UInt256& b) const { return UInt256(w[3] ^ b.w[3], w[2] ^ b.w[2], w[1] ^ b.w[1], w[0] ^ b.w[0]); }
+    UInt256 operator~() const { return UInt256(~w[3], ~w[2], ~w[1], ~w[0]); }
+
+    UInt256 operator<<(unsigned n) const {
+        UInt256 r;
+        if (n >= 256) {
+            return r;
+        }
+        unsigned limbs = n / 64, shift = n % 64;
+        for (int i = 3; i >= (int)limbs; i--) {
+            r.w[i] = w[i - limbs] << shift;
+            if (shift && i - (int)limbs > 0) {
+                r.w[i] |= w[i - limbs - 1] >> (64 - shift);
+            }
+        }
+        return r;
+    }
+
+    UInt256 operator>>(unsigned n) const {
+        UInt256 r;
+        if (n >= 256) {
+            return r;
+        }
+        unsigned limbs = n / 64, shift = n % 64;
+        for (int i = 0; i + limbs < 4; i++) {
+            r.w[i] = w[i + limbs] >> shift;
+            if (shift && i + limbs < 3) {
+                r.w[i] |= w[i + limbs + 1] << (64 - shift);
+            }
+        }
+        return r;
+    }
+
+    // ===== TEXT =====
+    // Decimal digits without leading zeros; returns the length, or 0 if out
+    // is too small (UINT256_DEC_CHARS always fits)
+    size_t toDecimal(char* out, size_t len) const {
+        // 2^256 < 10^78, so at most five 19-digit chunks, least significant first
+        uint64_t chunks[5];
+        int count = 0;
+        UInt256 v = *this;
+        while (!v.fits64()) {
+            chunks[count++] = divWordNormalized(&v, DEC_CHUNK, DEC_CHUNK_RECIPROCAL);
+        }
+        chunks[count++] = v.w[0];
+
+        char top[20];
+        size_t topLen = putDigits(top + sizeof(top), chunks[count - 1], 0);
+        size_t needed = topLen + (count - 1) * 19;
+        if (needed + 1 > len) {
+            return 0;
+        }
+        memcpy(out, top + sizeof(top) - topLen, topLen);
+        char* p = out + topLen;
+        for (int i = count - 2; i >= 0; i--) {
+            p += 19;
+            putDigits(p, chunks[i], 19);
+        }
+        *p = '\0';
+        return needed;
+    }
+
+    // Lower-case hex digits without prefix or leading zeros; returns the
+    // length, or 0 if out is too small (UINT256_HEX_CHARS always fits)
+    size_t toHex(char* out, size_t len) const {
+        int n = bits();
+        size_t needed = n ? (n + 3) / 4 : 1;
+        if (needed + 1 > len) {
+            return 0;
+        }
+        // Leading word without its zero digits, then whole words
+        int top = (int)(needed - 1) / 16;
+        size_t lead = needed - 16 * top;
+        Hex::encodeWord(w[top], (int)lead, out);
+        for (int i = top - 1; i >= 0; i--) {
+            Hex::encodeWord(w[i], 16, out + lead + 16 * (top - 1 - i));
+        }
+        out[needed] = '\0';
+        return needed;
+    }
+
+    // uint256_t::str() compatible: base 2..16, zero-padded to at least len
+    std::string str(uint8_t base = 10, unsigned len = 0) const {
+        char buf[257];
+        size_t n;
+        if (base == 10) {
+            n = toDecimal(buf, sizeof(buf));
+        } else if (base == 16) {
+            n = toHex(buf, sizeof(buf));
+        } else if (base >= 2 && base <= 16) {
+            n = toBase(base, buf, sizeof(buf));
+        } else {
+            throw std::invalid_argument("UInt256 base must be 2 to 16");
+        }
+        std::string s;
+        if (len > n) {
+            s.assign(len - n, '0');
+        }
+        return s.append(buf, n);
+    }
+
+    // Optional 0x prefix, 1 to 64 hex digits, nothing else
+    static bool fromHex(const char* text, UInt256* out) {
+        return fromHex(text, strlen(text), out);
+    }
+
+    // Same for n characters of text that need not be terminated (a field
+    // inside a JSON reply)
+    static bool fromHex(const char* text, size_t n, UInt256* out) {
+        if (n >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+            text += 2;
+            n -= 2;
+        }
+        if (n == 0 || n > 64) {
+            return false;
+        }
+        // Whole words from the right, the leftover digits last
+        UInt256 v;
+        for (int i = 0; n > 0; i++) {
+            size_t take = n > 16 ? 16 : n;
+            n -= take;
+            if (!Hex::word(text + n, take, &v.w[i])) {
+                return false;
+            }
+        }
+        *out = v;
+        return true;
+    }
+
+    // Plain decimal digits; false on junk or overflow
+    static bool fromDecimal(const char* text, UInt256* out) {
+        size_t n = strlen(text);
+        if (n == 0) {
+            return false;
+        }
+        UInt256 v;
+        // Leading partial chunk, then whole 19-digit chunks
+        size_t take = n % 19 ? n % 19 : 19;
+        for (size_t at = 0; at < n; at += take, take = 19) {
+            uint64_t chunk = 0, scale = 1;
+            for (size_t i = at; i < at + take; i++) {
+                if (text[i] < '0' || text[i] > '9') {
+                    return false;
+                }
+                chunk = chunk * 10 + (text[i] - '0');
+                scale *= 10;
+            }
+            if (!mulAddWord(&v, scale, chunk)) {
+                return false;
+            }
+        }
+        *out = v;
+        return true;
+    }
+
+private:
+    uint64_t w[4];                          // Least significant first
+
+    static constexpr uint64_t DEC_CHUNK = 10000000000000000000ULL;            // 10^19
+    static constexpr uint64_t DEC_CHUNK_RECIPROCAL = 0xd83c94fb6d2ac34aULL;   // (2^128 - 1) / 10^19 - 2^64
+
+    static int clz(uint64_t x) {
+        return __builtin_clzll(x);
+    }
+
+    static uint64_t addCarry(uint64_t a, uint64_t b, uint64_t* carry) {
+        uint64_t s = a + b;
+        uint64_t c = s < a;
+        s += *carry;
+        *carry = c | (s < *carry);
+        return s;
+    }
+
+    static uint64_t subBorrow(uint64_t a, uint64_t b, uint64_t* borrow) {
+        uint64_t d = a - b;
+        uint64_t c = a < b;
+        uint64_t r = d - *borrow;
+        *borrow = c | (d < *borrow);
+        return r;
+    }
+
+    // Borrow out of a - b, i.e. a < b
+    static bool borrowOut(const UInt256& a, const UInt256& b) {
+        uint64_t borrow = 0;
+        subBorrow(a.w[0], b.w[0], &borrow);
+        subBorrow(a.w[1], b.w[1], &borrow);
+        subBorrow(a.w[2], b.w[2], &borrow);
+        subBorrow(a.w[3], b.w[3], &borrow);
+        return borrow != 0;
+    }
+
+    // Low word of a * b; high word to *hi. Four 32x32 products where the
+    // compiler has no 128-bit type (the ESP32).
+    static uint64_t mul64(uint64_t a, uint64_t b, uint64_t* hi) {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 p = (unsigned __int128)a * b;
+        *hi = (uint64_t)(p >> 64);
+        return (uint64_t)p;
+#else
+        uint64_t a0 = (uint32_t)a, a1 = a >> 32, b0 = (uint32_t)b, b1 = b >> 32;
+        uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+        *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+        return mid << 32 | (uint32_t)p00;
+#endif
+    }
+
+    // (u1:u0) / d for normalised d (top bit set) and u1 < d, using
+    // v = (2^128 - 1) / d - 2^64. Moller & Granlund, "Improved division by
+    // invariant integers", algorithm 4.
+    static uint64_t div2by1(uint64_t u1, uint64_t u0, uint64_t d, uint64_t v, uint64_t* r) {
+        uint64_t q1;
+        uint64_t q0 = mul64(v, u1, &q1);
+        q0 += u0;
+        q1 += u1 + (q0 < u0) + 1;
+        uint64_t rem = u0 - q1 * d;
+        if (rem > q0) {
+            q1--;
+            rem += d;
+        }
+        if (rem >= d) {
+            q1++;
+            rem -= d;
+        }
+        *r = rem;
+        return q1;
+    }
+
+    // Reciprocal for div2by1; runs once per division by a new divisor.
+    // Schoolbook (u1:u0) / d on 32-bit halves (Hacker's Delight divlu).
+    static uint64_t reciprocal(uint64_t d) {
+#ifdef __SIZEOF_INT128__
+        return (uint64_t)((((unsigned __int128)~d << 64) | ~(uint64_t)0) / d);
+#else
+        const uint64_t b = 1ULL << 32;
+        uint64_t u1 = ~d, u0 = ~(uint64_t)0;
+        uint64_t d1 = d >> 32, d0 = (uint32_t)d;
+        uint64_t q1 = u1 / d1, rhat = u1 - q1 * d1;
+        while (q1 >= b || q1 * d0 > (rhat << 32 | u0 >> 32)) {
+            q1--;
+            rhat += d1;
+            if (rhat >= b) {
+                break;
+            }
+        }
+        uint64_t u21 = (u1 << 32 | u0 >> 32) - q1 * d;
+        uint64_t q0 = u21 / d1;
+        rhat = u21 - q0 * d1;
+        while (q0 >= b || q0 * d0 > (rhat << 32 | (uint32_t)u0)) {
+            q0--;
+            rhat += d1;
+            if (rhat >= b) {
+                break;
+            }
+        }
+        return q1 << 32 | q0;
+#endif
+    }
+
+    // *v /= d for a normalised d with its reciprocal; returns the remainder
+    static uint64_t divWordNormalized(UInt256* v, uint64_t d, uint64_t recip) {
+        uint64_t r = 0;
+        for (int i = 3; i >= 0; i--) {
+            v->w[i] = div2by1(r, v->w[i], d, recip, &r);
+        }
+        return r;
+    }
+
+    // *v /= d for any nonzero word; returns the remainder
+    static uint64_t divWord(UInt256* v, uint64_t d) {
+        int s = clz(d);
+        if (s == 0) {
+            return divWordNormalized(v, d, reciprocal(d));
+        }
+        // Shift dividend and divisor left by s; the remainder comes back shifted
+        d <<= s;
+        uint64_t recip = reciprocal(d);
+        uint64_t r = v->w[3] >> (64 - s);
+        for (int i = 3; i >= 0; i--) {
+            uint64_t u0 = v->w[i] << s | (i ? v->w[i - 1] >> (64 - s) : 0);
+            v->w[i] = div2by1(r, u0, d, recip, &r);
+        }
+        return r >> s;
+    }
+
+    // Knuth, TAOCP vol. 2, 4.3.1 algorithm D, for divisors of two or more
+    // words and a >= b
+    static void divLong(const UInt256& a, const UInt256& b, UInt256* q, UInt256* r) {
+        int n = 4;
+        while (b.w[n - 1] == 0) {
+            n--;
+        }
+        int m = 4;
+        while (a.w[m - 1] == 0) {
+            m--;
+        }
+
+        int s = clz(b.w[n - 1]);
+        uint64_t vn[4], un[5];
+        for (int i = n - 1; i > 0; i--) {
+            vn[i] = b.w[i] << s | (s ? b.w[i - 1] >> (64 - s) : 0);
+        }
+        vn[0] = b.w[0] << s;
+        un[m] = s ? a.w[m - 1] >> (64 - s) : 0;
+        for (int i = m - 1; i > 0; i--) {
+            un[i] = a.w[i] << s | (s ? a.w[i - 1] >> (64 - s) : 0);
+        }
+        un[0] = a.w[0] << s;
+
+        uint64_t recip = reciprocal(vn[n - 1]);
+        *q = UInt256();
+        for (int j = m - n; j >= 0; j--) {
+            // Estimate from the top two words, off by at most two
+            uint64_t qhat, rhat;
+            bool rhatOverflow = false;
+            if (un[j + n] >= vn[n - 1]) {
+                qhat = ~(uint64_t)0;
+                rhat = un[j + n - 1] + vn[n - 1];
+                rhatOverflow = rhat < vn[n - 1];
+            } else {
+                qhat = div2by1(un[j + n], un[j + n - 1], vn[n - 1], recip, &rhat);
+            }
+            while (!rhatOverflow) {
+                uint64_t ph;
+                uint64_t pl = mul64(qhat, vn[n - 2], &ph);
+                if (ph < rhat || (ph == rhat && pl <= un[j + n - 2])) {
+                    break;
+                }
+                qhat--;
+                rhat += vn[n - 1];
+                rhatOverflow = rhat < vn[n - 1];
+            }
+
+            // un[j..j+n] -= qhat * vn
+            uint64_t carry = 0, borrow = 0;
+            for (int i = 0; i < n; i++) {
+                uint64_t hi;
+                uint64_t lo = mul64(qhat, vn[i], &hi);
+                lo += carry;
+                carry = hi + (lo < carry);
+                un[i + j] = subBorrow(un[i + j], lo, &borrow);
+            }
+            un[j + n] = subBorrow(un[j + n], carry, &borrow);
+
+            if (borrow) {
+                // Estimate was one too high; add the divisor back
+                qhat--;
+                uint64_t c = 0;
+                for (int i = 0; i < n; i++) {
+                    un[i + j] = addCarry(un[i + j], vn[i], &c);
+                }
+                un[j + n] += c;
+            }
+            q->w[j] = qhat;
+        }
+
+        *r = UInt256();
+        for (int i = 0; i < n; i++) {
+            r->w[i] = un[i] >> s | (s && i + 1 < n ? un[i + 1] << (64 - s) : 0);
+        }
+    }
+
+    // *v = *v * mul + add; false on overflow
+    static bool mulAddWord(UInt256* v, uint64_t mul, uint64_t add) {
+        uint64_t carry = add;
+        for (int i = 0; i < 4; i++) {
+            uint64_t hi;
+            uint64_t lo = mul64(v->w[i], mul, &hi);
+            lo += carry;
+            carry = hi + (lo < carry);
+            v->w[i] = lo;
+        }
+        return carry == 0;
+    }
+
+    // Digits of x ending just before end, zero-padded to width; returns the
+    // count written. Splits into 32-bit pieces of nine digits first so the
+    // per-digit divisions are native on 32-bit cores.
+    static size_t putDigits(char* end, uint64_t x, int width) {
+        char* p = end;
+        while (x >= 1000000000u || (width && end - p + 9 < width)) {
+            uint64_t q = x / 1000000000u;
+            uint32_t low = (uint32_t)(x - q * 1000000000u);
+            for (int i = 0; i < 9; i++) {
+                *--p = '0' + low % 10;
+                low /= 10;
+            }
+            x = q;
+        }
+        uint32_t low = (uint32_t)x;
+        do {
+            *--p = '0' + low % 10;
+            low /= 10;
+        } while (low);
+        while (end - p < width) {
+            *--p = '0';
+        }
+        return end - p;
+    }
+
+    size_t toBase(uint8_t base, char* out, size_t len) const {
+        static const char DIGITS[] = "0123456789abcdef";
+        char buf[257];
+        char* p = buf + sizeof(buf);
+        UInt256 v = *this;
+        do {
+            *--p = DIGITS[divWord(&v, base)];
+        } while (v);
+        size_t n = buf + sizeof(buf) - p;
+        if (n + 1 > len) {
+            return 0;
+        }
+        memcpy(out, p, n);
+        out[n] = '\0';
+        return n;
+    }
+};
+
+#endif // UINT256_H
@@ -0,0 +1,153 @@
+/*
+ * Payment Vouchers
+ *
+ * Off-chain payments for pay-per-use devices. The payer signs an EIP-712
+ * voucher for the running total it owes the device, one voucher per use.
+ * Each voucher supersedes the previous one, so the device only needs to
+ * keep the newest voucher per payer. It redeems that voucher with
+ * contracts/VoucherEscrow.sol whenever it likes: one transaction settles
+ * any number of uses.
+ *
+ *   static Eip712Domain VOUCHERS(VOUCHER_DOMAIN_NAME, "1", CHAIN_ID, VOUCHER_CONTRACT);
+ *   VoucherBook book(VOUCHERS, deviceAddress);
+ *   if (book.accept(voucher, signature, time(nullptr)) == VOUCHER_OK) {
+ *       // Serve the use
+ *   }
+ *
+ * The first voucher from a payer is checked by recovering the signer
+ * address. The book keeps the recovered public key, so later vouchers
+ * from that payer are checked with a plain verify, which is cheaper.
+ */
+
+#ifndef VOUCHER_H
+#define VOUCHER_H
+
+#include "eip712.h"
+#include "uint256.h"
+
+#define VOUCHER_TYPE "Voucher(address device,address payer,uint256 amount,uint64 nonce,uint64 expiry)"
+#define VOUCHER_DOMAIN_NAME "PolkaESP Voucher"
+
+#ifndef VOUCHER_MAX_PAYERS
+#define VOUCHER_MAX_PAYERS 8
+#endif
+
+struct Voucher {
+    uint8_t device[20];
+    uint8_t payer[20];
+    uint256_t amount;                 // Total owed to the device so far, in wei
+    uint64_t nonce;                   // Increases with every voucher from a payer
+    uint64_t expiry;                  // Unix seconds, 0 = never
+};
+
+enum VoucherStatus {
+    VOUCHER_OK,
+    VOUCHER_WRONG_DEVICE,
+    VOUCHER_EXPIRED,
+    VOUCHER_STALE,                    // Nonce or amount not above the last accepted one
+    VOUCHER_BAD_SIGNATURE,
+    VOUCHER_BOOK_FULL                 // New payer and no free slot
+};
+
+// EIP-712 digest the payer signs
+inline bool voucherDigest(Eip712Domain& domain, const Voucher& v, uint8_t out[32]) {
+    static Eip712Type type(VOUCHER_TYPE);
+    Eip712Struct s(type);
+    s.address(v.device).address(v.payer).uint(v.amount).uint(v.nonce).uint(v.expiry);
+    return domain.digest(s, out);
+}
+
+inline bool signVoucher(const Eip712Signer& signer, Eip712Domain& domain, const Voucher& v, uint8_t signature[65]) {
+    uint8_t digest[32];
+    return voucherDigest(domain, v, digest) && signer.sign(digest, signature);
+}
+
+class VoucherBook {
+public:
+    VoucherBook(Eip712Domain& domain, const uint8_t device[20]) : domain(domain), count(0) {
+        memcpy(self, device, 20);
+    }
+
+    // now is Unix seconds; pass 0 before the clock is set to skip the
+    // expiry check
+    VoucherStatus accept(const Voucher& v, const uint8_t signature[65], uint64_t now) {
+        if (memcmp(v.device, self, 20) != 0) {
+            return VOUCHER_WRONG_DEVICE;
+        }
+        if (v.expiry != 0 && now != 0 && now > v.expiry) {
+            return VOUCHER_EXPIRED;
+        }
+
+        Entry* e = find(v.payer);
+        if (e && (v.nonce <= e->voucher.nonce || less(v.amount, e->voucher.amount))) {
+            return VOUCHER_STALE;
+        }
+        if (!e && count == VOUCHER_MAX_PAYERS) {
+            return VOUCHER_BOOK_FULL;
+        }
+
+        uint8_t digest[32];
+        if (!voucherDigest(domain, v, digest)) {
+            return VOUCHER_BAD_SIGNATURE;
+        }
+        if (e) {
+            if (!Eip712Signer::verify(e->publicKey, digest, signature)) {
+                return VOUCHER_BAD_SIGNATURE;
+            }
+        } else {
+            uint8_t signer[20], publicKey[64];
+            if (!Eip712Signer::recover(digest, signature, signer, publicKey) || memcmp(signer, v.payer, 20) != 0) {
+                return VOUCHER_BAD_SIGNATURE;
+            }
+            e = &entries[count++];
+            memcpy(e->publicKey, publicKey, 64);
+        }
+        e->voucher = v;
+        memcpy(e->signature, signature, 65);
+        return VOUCHER_OK;
+    }
+
+    // Newest voucher per payer, ready for VoucherEscrow.redeem()
+    size_t size() const { return count; }
+    const Voucher& voucher(size_t i) const { return entries[i].voucher; }
+    const uint8_t* signature(size_t i) const { return entries[i].signature; }
+
+    static const char* statusName(VoucherStatus status) {
+        switch (status) {
+            case VOUCHER_OK: return "ok";
+            case VOUCHER_WRONG_DEVICE: return "wrong device";
+            case VOUCHER_EXPIRED: return "expired";
+            case VOUCHER_STALE: return "stale";
+            case VOUCHER_BAD_SIGNATURE: return "bad signature";
+            case VOUCHER_BOOK_FULL: return "book full";
+        }
+        return "?";
+    }
+
+private:
+    struct Entry {
+        Voucher voucher;
+        uint8_t signature[65];
+        uint8_t publicKey[64];
+    };
+
+    Eip712Domain& domain;
+    uint8_t self[20];
+    Entry entries[VOUCHER_MAX_PAYERS];
+    size_t count;
+
+    Entry* find(const uint8_t payer[20]) {
+        for (size_t i = 0; i < count; i++) {
+            if (memcmp(entries[i].voucher.payer, payer, 20) == 0) {
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    static bool less(const uint256_t& a, const uint256_t& b) {
+        return UInt256(a) < UInt256(b);
+    }
+};
+
+#endif // VOUCHER_H
@@ -0,0 +1,334 @@
+/*
+ * ABI Decoder Benchmark
+ *
+ * Decodes Polka32.get(address) replies (Device[]: string name, uint256
+ * time) of 1 to 1000 entries two ways and compares time and heap use:
+ *
+ *   lazy   AbiArray + decodeDevice() walking offsets over the reply text,
+ *          one element at a time into a fixed buffer (what firmware uses)
+ *   eager  whole payload converted to bytes, then every element copied
+ *          into a vector of structs (what decoding looked like before)
+ *
+ * First checks that string fields and arrays with hostile offsets or
+ * lengths (past the reply, or large enough to wrap the bounds arithmetic
+ * or a 32-bit size_t) are refused rather than read out of bounds, and
+ * that address words that are not zero-padded hex are refused. Exits
+ * non-zero on a failure.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src abi_bench.cpp -o abi_bench
+ *   ./abi_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "abi/polka32.h"
+
+// ===== ALLOCATION COUNTING =====
+static size_t allocCount = 0;
+static size_t allocBytes = 0;
+
+void* operator new(size_t size) {
+    allocCount++;
+    allocBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// ===== TEST DATA =====
+static void appendWord(std::string& out, uint64_t value) {
+    char word[65];
+    snprintf(word, sizeof(word), "%064llx", (unsigned long long)value);
+    out += word;
+}
+
+// ABI encoding of Device[] with n entries, wrapped in a JSON-RPC reply
+static std::string makeReply(size_t n) {
+    std::vector<std::string> names(n);
+    for (size_t i = 0; i < n; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "device-%04zu", i);
+        names[i] = name;
+    }
+
+    std::string hex;
+    appendWord(hex, 0x20);
+    appendWord(hex, n);
+
+    // Offset table, relative to the first offset word
+    size_t offset = n * 32;
+    for (size_t i = 0; i < n; i++) {
+        appendWord(hex, offset);
+        offset += 32 * 2 + 32 + (names[i].size() + 31) / 32 * 32;
+    }
+    for (size_t i = 0; i < n; i++) {
+        appendWord(hex, 0x40);                  // string offset inside the tuple
+        appendWord(hex, 1700000000 + i);        // time
+        appendWord(hex, names[i].size());
+        std::string data;
+        for (unsigned char c : names[i]) {
+            char b[3];
+            snprintf(b, sizeof(b), "%02x", c);
+            data += b;
+        }
+        data.resize((names[i].size() + 31) / 32 * 64, '0');
+        hex += data;
+    }
+    return "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"0x" + hex + "\"}";
+}
+
+// ===== DECODERS =====
+static uint64_t decodeLazy(const std::string& reply, size_t* count) {
+    uint64_t checksum = 0;
+    size_t n = 0;
+    for (AbiReader device : Polka32Abi::decodeGet(reply)) {
+        char name[33];
+        UInt256 time;
+        if (Polka32Abi::decodeDevice(device, name, sizeof(name), &time)) {
+            checksum += time.low64() + (uint8_t)name[7];
+            n++;
+        }
+    }
+    *count = n;
+    return checksum;
+}
+
+struct DeviceCopy {
+    std::string name;
+    uint64_t time;
+};
+
+static uint64_t readWord(const std::vector<uint8_t>& bytes, size_t at) {
+    uint64_t value = 0;
+    for (size_t i = at + 24; i < at + 32; i++) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+static uint64_t decodeEager(const std::string& reply, size_t* count) {
+    size_t at = reply.find("\"result\":\"0x") + 12;
+    size_t end = reply.find('"', at);
+
+    std::vector<uint8_t> bytes;
+    for (size_t i = at; i + 1 < end; i += 2) {
+        bytes.push_back((uint8_t)(Hex::nibble(reply[i]) << 4 | Hex::nibble(reply[i + 1])));
+    }
+
+    std::vector<DeviceCopy> devices;
+    size_t base = readWord(bytes, 0);
+    size_t n = readWord(bytes, base);
+    size_t table = base + 32;
+    for (size_t i = 0; i < n; i++) {
+        size_t element = table + readWord(bytes, table + i * 32);
+        size_t str = element + readWord(bytes, element);
+        size_t len = readWord(bytes, str);
+        devices.push_back({std::string((const char*)&bytes[str + 32], len), readWord(bytes, element + 32)});
+    }
+
+    uint64_t checksum = 0;
+    for (const DeviceCopy& d : devices) {
+        checksum += d.time + (uint8_t)d.name[7];
+    }
+    *count = devices.size();
+    return checksum;
+}
+
+// ===== HOSTILE REPLIES =====
+// A one-string reply: head word, length word, then dataWords of "ab..."
+static std::string stringReply(uint64_t offset, uint64_t length, size_t dataWords) {
+    std::string hex;
+    appendWord(hex, offset);
+    appendWord(hex, length);
+    for (size_t i = 0; i < dataWords; i++) {
+        hex += std::string(64, 'a');
+    }
+    return "{\"result\":\"0x" + hex + "\"}";
+}
+
+static bool readsString(const std::string& reply, const char* expected) {
+    char out[64];
+    size_t length;
+    bool ok = AbiReader(reply).string(0, out, sizeof(out), &length);
+    return expected ? ok && strcmp(out, expected) == 0 : !ok;
+}
+
+static int checkHostileStrings() {
+    struct Case {
+        const char* what;
+        std::string reply;
+        const char* expected;  // nullptr: must be refused
+    } cases[] = {
+        {"well-formed", stringReply(0x20, 2, 1), "\xaa\xaa"},
+        {"empty string", stringReply(0x20, 0, 0), ""},
+        {"length past the reply", stringReply(0x20, 33, 1), nullptr},
+        {"length that wraps (2^64 - 1)", stringReply(0x20, ~0ULL, 2), nullptr},
+        {"length that wraps (2^64 - 31)", stringReply(0x20, ~0ULL - 30, 2), nullptr},
+        {"length past 32 bits", stringReply(0x20, 0x100000001ULL, 1), nullptr},
+        {"offset past the reply", stringReply(0x40, 1, 1), nullptr},
+        {"offset past 32-bit words", stringReply(0x2000000020ULL, 1, 1), nullptr},
+        {"unaligned offset", stringReply(0x21, 1, 1), nullptr},
+    };
+    int failed = 0;
+    for (const Case& c : cases) {
+        if (!readsString(c.reply, c.expected)) {
+            printf("FAIL: %s\n", c.what);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+// A uint256[] reply: head word, length word, then the given words
+static std::string arrayReply(uint64_t offset, uint64_t length, const std::vector<uint64_t>& words) {
+    std::string hex;
+    appendWord(hex, offset);
+    appendWord(hex, length);
+    for (uint64_t w : words) {
+        appendWord(hex, w);
+    }
+    return "{\"result\":\"0x" + hex + "\"}";
+}
+
+// Number of elements a static (stride 1) and a dynamic (stride 0) reading
+// of the reply accept, and whether every dynamic element resolved
+static bool readsArray(const std::string& reply, size_t stride, size_t expected, bool elementsOk) {
+    AbiReader reader(reply);
+    AbiArray array(reader, 0, stride);
+    if (array.size() != expected) {
+        return false;
+    }
+    for (AbiReader element : array) {
+        if (element.ok() != elementsOk) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int checkHostileArrays() {
+    struct Case {
+        const char* what;
+        std::string reply;
+        size_t stride;
+        size_t expected;
+        bool elementsOk;
+    } cases[] = {
+        {"well-formed uint256[]", arrayReply(0x20, 2, {7, 8}), 1, 2, true},
+        {"well-formed dynamic array", arrayReply(0x20, 1, {0x20, 0}), 0, 1, true},
+        {"array offset past the reply", arrayReply(0x60, 1, {1}), 1, 0, true},
+        {"array offset past 32-bit words", arrayReply(0x2000000020ULL, 1, {1}), 1, 0, true},
+        {"array offset past 64-bit words", arrayReply(~0ULL - 31, 1, {1}), 1, 0, true},
+        {"array length past the reply", arrayReply(0x20, 3, {1, 2}), 1, 0, true},
+        {"element offset past the reply", arrayReply(0x20, 1, {0x40, 0}), 0, 1, false},
+        {"element offset past 32-bit words", arrayReply(0x20, 1, {0x2000000000ULL, 0}), 0, 1, false},
+        {"unaligned element offset", arrayReply(0x20, 1, {0x21, 0}), 0, 1, false},
+    };
+    int failed = 0;
+    for (const Case& c : cases) {
+        if (!readsArray(c.reply, c.stride, c.expected, c.elementsOk)) {
+            printf("FAIL: %s\n", c.what);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static bool readsAddress(const std::string& word, const char* expected) {
+    std::string reply = "{\"result\":\"0x" + word + "\"}";
+    char out[HEX_ADDRESS_CHARS];
+    bool ok = AbiReader(reply).address(0, out);
+    return expected ? ok && strcmp(out, expected) == 0 : !ok;
+}
+
+static int checkHostileAddresses() {
+    std::string pad(24, '0');
+    std::string digits = "00112233445566778899AaBbCcDdEeFf01234567";
+    struct Case {
+        const char* what;
+        std::string word;
+        const char* expected;  // nullptr: must be refused
+    } cases[] = {
+        {"mixed-case address", pad + digits, "0x00112233445566778899aabbccddeeff01234567"},
+        {"non-hex digit", pad + "g" + digits.substr(1), nullptr},
+        {"quote inside the address", pad + digits.substr(0, 39) + "\\", nullptr},
+        {"dirty high bytes", "1" + pad.substr(1) + digits, nullptr},
+        {"non-hex high bytes", "x" + pad.substr(1) + digits, nullptr},
+    };
+    int failed = 0;
+    for (const Case& c : cases) {
+        if (!readsAddress(c.word, c.expected)) {
+            printf("FAIL: %s\n", c.what);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+// ===== BENCHMARK =====
+template <typename Fn>
+static void measure(Fn fn, const std::string& reply, double* nsPerElement, size_t* allocs,
+                    size_t* bytes, uint64_t* checksum) {
+    size_t n = 0;
+    size_t before = allocCount, beforeBytes = allocBytes;
+    *checksum = fn(reply, &n);
+    *allocs = allocCount - before;
+    *bytes = allocBytes - beforeBytes;
+
+    // Repeat until the run is long enough to time reliably
+    size_t rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed{};
+    do {
+        fn(reply, &n);
+        rounds++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 50e6);
+    *nsPerElement = elapsed.count() / rounds / (n ? n : 1);
+}
+
+int main() {
+    if (checkHostileStrings() + checkHostileArrays() + checkHostileAddresses()) {
+        return 1;
+    }
+
+    const size_t sizes[] = {1, 10, 100, 1000};
+
+    printf("%8s %10s | %10s %8s | %10s %8s %10s\n", "devices", "reply B", "lazy ns/el", "allocs",
+           "eager ns/el", "allocs", "heap B");
+    for (size_t n : sizes) {
+        std::string reply = makeReply(n);
+
+        double lazyNs, eagerNs;
+        size_t lazyAllocs, lazyBytes, eagerAllocs, eagerBytes;
+        uint64_t lazySum, eagerSum;
+        measure(decodeLazy, reply, &lazyNs, &lazyAllocs, &lazyBytes, &lazySum);
+        measure(decodeEager, reply, &eagerNs, &eagerAllocs, &eagerBytes, &eagerSum);
+
+        printf("%8zu %10zu | %10.1f %8zu | %10.1f %8zu %10zu%s\n", n, reply.size(), lazyNs, lazyAllocs,
+               eagerNs, eagerAllocs, eagerBytes, lazySum == eagerSum ? "" : "  MISMATCH");
+        if (lazySum != eagerSum) {
+            return 1;
+        }
+    }
+    return 0;
+}
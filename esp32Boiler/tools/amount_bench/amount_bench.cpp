@@ -0,0 +1,305 @@
+/*
+ * Token Amount Benchmark
+ *
+ * Times src/amount.h against the Web3E helpers it replaced:
+ * Util::ConvertWeiToEthString() for balance prints (uint256_t::str()
+ * and std::string surgery to place the point and trim zeros) and
+ * Util::ConvertToWei(double, decimals) for amounts typed at the serial
+ * console (atof(), then the double written out to `decimals` places
+ * and read back as an integer). Heap allocations per call are counted
+ * alongside the time.
+ *
+ * Exactness checks run first:
+ *
+ * - format() agrees with the string-based helper for random values at
+ *   0, 6, 8, 18 and 77 decimals, and parse() reads its output back
+ * - parse() agrees with a reference built from the digit string by
+ *   uint256_t(text, 10) for random amounts with up to `decimals`
+ *   fraction digits
+ * - fractionDigits truncates, never rounds; short buffers return 0
+ * - junk, signs, exponents, a second point, too many fraction digits
+ *   and values past 2^256 - 1 are refused
+ *
+ * How many of the sample amounts the double path gets wrong is printed
+ * for information; it is not a failure. Exits non-zero if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src amount_bench.cpp -o amount_bench
+ *   ./amount_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "amount.h"
+
+// ===== ALLOCATION COUNTER =====
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ===== PREVIOUS CODE =====
+// Util::ConvertWeiToEthString: decimal string of the whole value, then
+// the point is inserted `decimals` from the right and zeros trimmed
+static std::string oldWeiToEthString(const uint256_t& wei, int decimals) {
+    std::string digits = wei.str(10);
+    if ((int)digits.size() <= decimals) {
+        digits = std::string(decimals + 1 - digits.size(), '0') + digits;
+    }
+    std::string out = digits.substr(0, digits.size() - decimals);
+    std::string fraction = digits.substr(digits.size() - decimals);
+    while (!fraction.empty() && fraction.back() == '0') {
+        fraction.pop_back();
+    }
+    if (!fraction.empty()) {
+        out += "." + fraction;
+    }
+    return out;
+}
+
+// Util::ConvertToWei(double, decimals), fed from atof() as the console was
+static uint256_t oldConvertToWei(const char* text, int decimals) {
+    double value = atof(text);
+    char buf[400];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    std::string digits;
+    for (const char* p = buf; *p; p++) {
+        if (*p != '.') {
+            digits += *p;
+        }
+    }
+    return uint256_t(digits, 10);
+}
+
+// ===== TEST DATA =====
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static UInt256 randomValue(int bits) {
+    UInt256 v(nextRandom(), nextRandom(), nextRandom(), nextRandom());
+    return bits >= 256 ? v : v >> (256 - bits);
+}
+
+// A decimal amount with at most `decimals` fraction digits, and the
+// same value in base units as an integer digit string
+static std::string randomAmount(int decimals, std::string* units) {
+    std::string whole = std::to_string(nextRandom() % (nextRandom() % 4 == 0 ? 1000000000ULL : 100));
+    int fractionDigits = decimals ? (int)(nextRandom() % (decimals + 1)) : 0;
+    std::string fraction;
+    for (int i = 0; i < fractionDigits; i++) {
+        fraction += (char)('0' + nextRandom() % 10);
+    }
+    *units = whole + fraction + std::string(decimals - fractionDigits, '0');
+    return fractionDigits ? whole + "." + fraction : whole;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok && failures++ < 10) {
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static bool formatsAs(const UInt256& value, int decimals, const char* expected, int fractionDigits = -1) {
+    char buf[AMOUNT_MAX_CHARS];
+    size_t n = Amount::format(value, decimals, buf, sizeof(buf), fractionDigits);
+    return n == strlen(expected) && strcmp(buf, expected) == 0;
+}
+
+static bool parsesAs(const char* text, int decimals, const UInt256& expected) {
+    UInt256 value;
+    return Amount::parse(text, decimals, &value) && value == expected;
+}
+
+static bool refused(const char* text, int decimals) {
+    UInt256 value;
+    return !Amount::parse(text, decimals, &value);
+}
+
+// ===== CHECKS =====
+static void checkAgainstOldFormat() {
+    const int decimalsList[] = {0, 6, 8, 18, 77};
+    for (int decimals : decimalsList) {
+        for (int i = 0; i < 2000; i++) {
+            UInt256 value = randomValue(i % 8 == 0 ? 256 : 1 + nextRandom() % 120);
+            char buf[AMOUNT_MAX_CHARS];
+            Amount::format(value, decimals, buf, sizeof(buf));
+            check(oldWeiToEthString(value, decimals) == buf, "format matches ConvertWeiToEthString");
+            UInt256 back;
+            check(Amount::parse(buf, decimals, &back) && back == value, "parse(format(v)) == v");
+        }
+    }
+}
+
+static void checkAgainstReferenceParse() {
+    const int decimalsList[] = {0, 6, 8, 18};
+    for (int decimals : decimalsList) {
+        for (int i = 0; i < 2000; i++) {
+            std::string units;
+            std::string text = randomAmount(decimals, &units);
+            check(parsesAs(text.c_str(), decimals, UInt256(uint256_t(units, 10))), "parse matches digit reference");
+        }
+    }
+}
+
+static void checkEdges() {
+    const UInt256 max = ~UInt256(0);
+    const char* maxText = "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+
+    check(formatsAs(0, 18, "0"), "zero");
+    check(formatsAs(1, 18, "0.000000000000000001"), "one wei");
+    check(formatsAs(UInt256(1000000000000000000ULL), 18, "1"), "one ether, no point");
+    check(formatsAs(UInt256(1500000000000000000ULL), 18, "1.5"), "trailing zeros trimmed");
+    check(formatsAs(1234567, 6, "1.23", 2), "fractionDigits truncates");
+    check(formatsAs(1239999, 6, "1.23", 2), "fractionDigits never rounds");
+    check(formatsAs(1200000, 6, "1.200000", 6), "fractionDigits keeps zeros");
+    check(formatsAs(1999999, 6, "1", 0), "fractionDigits 0");
+    check(formatsAs(max, 0, maxText), "2^256 - 1");
+    check(formatsAs(max, 77, "1.15792089237316195423570985008687907853269984665640564039457584007913129639935"),
+          "77 decimals");
+
+    char small[4];
+    check(Amount::format(12345, 0, small, sizeof(small)) == 0, "short buffer refused");
+    check(Amount::format(123, 0, small, sizeof(small)) == 3 && strcmp(small, "123") == 0, "exact fit");
+    check(Amount::format(1, 79, small, sizeof(small)) == 0, "decimals past 78 refused");
+
+    check(parsesAs("0.001", 18, UInt256(1000000000000000ULL)), "0.001 ether");
+    check(parsesAs(".5", 6, 500000), "leading point");
+    check(parsesAs("5.", 6, 5000000), "trailing point");
+    check(parsesAs("007", 0, 7), "leading zeros");
+    check(parsesAs("1.5000000", 6, 1500000), "extra zero fraction digits");
+    check(parsesAs(maxText, 0, max), "2^256 - 1 parses");
+    check(parsesAs("1", 77, UInt256(uint256_t("1" + std::string(77, '0'), 10))), "10^77");
+
+    check(refused("", 18), "empty");
+    check(refused(".", 18), "lone point");
+    check(refused("1.2.3", 18), "two points");
+    check(refused("-1", 18), "sign");
+    check(refused("+1", 18), "plus sign");
+    check(refused("1e18", 0), "exponent");
+    check(refused(" 1", 18), "leading space");
+    check(refused("1,5", 18), "comma");
+    check(refused("0.0000001", 6), "finer than the smallest unit");
+    check(refused("115792089237316195423570985008687907853269984665640564039457584007913129639936", 0),
+          "2^256 overflows");
+    check(refused("1", 78), "10^78 overflows");
+    check(refused("1", 79), "decimals past 78");
+    check(refused(nullptr, 18), "null");
+}
+
+// How many typed amounts the double path turns into a different integer
+static int doubleMismatches(const std::vector<std::string>& texts, const std::vector<UInt256>& exact, int decimals) {
+    int wrong = 0;
+    for (size_t i = 0; i < texts.size(); i++) {
+        wrong += !(UInt256(oldConvertToWei(texts[i].c_str(), decimals)) == exact[i]);
+    }
+    return wrong;
+}
+
+// ===== BENCHMARK =====
+static volatile uint64_t sink;
+
+struct Timing {
+    double ns;
+    double allocs;
+};
+
+template <typename Fn>
+static Timing measure(size_t n, Fn fn) {
+    size_t rounds = 0;
+    size_t allocated = allocations;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed{};
+    do {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        rounds++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 100e6);
+    return {elapsed.count() / (rounds * n), (double)(allocations - allocated) / (rounds * n)};
+}
+
+int main() {
+    checkAgainstOldFormat();
+    checkAgainstReferenceParse();
+    checkEdges();
+
+    const size_t N = 256;
+    std::vector<UInt256> balances, tokenBalances;
+    std::vector<uint256_t> oldBalances, oldTokenBalances;
+    std::vector<std::string> etherTexts, tokenTexts;
+    std::vector<UInt256> etherExact, tokenExact;
+    for (size_t i = 0; i < N; i++) {
+        balances.push_back(randomValue(40 + nextRandom() % 40));
+        tokenBalances.push_back(randomValue(10 + nextRandom() % 40));
+        oldBalances.push_back(balances.back());
+        oldTokenBalances.push_back(tokenBalances.back());
+        std::string units;
+        etherTexts.push_back(randomAmount(18, &units));
+        etherExact.push_back(uint256_t(units, 10));
+        tokenTexts.push_back(randomAmount(6, &units));
+        tokenExact.push_back(uint256_t(units, 10));
+    }
+
+    struct Row {
+        const char* op;
+        Timing old;
+        Timing now;
+    };
+    std::vector<Row> rows;
+    char buf[AMOUNT_MAX_CHARS];
+
+    rows.push_back({"format 18", measure(N, [&](size_t i) { sink += oldWeiToEthString(oldBalances[i], 18).size(); }),
+                    measure(N, [&](size_t i) { sink += Amount::format(balances[i], 18, buf, sizeof(buf)); })});
+    rows.push_back({"format 6", measure(N, [&](size_t i) { sink += oldWeiToEthString(oldTokenBalances[i], 6).size(); }),
+                    measure(N, [&](size_t i) { sink += Amount::format(tokenBalances[i], 6, buf, sizeof(buf)); })});
+    rows.push_back({"parse 18", measure(N, [&](size_t i) {
+                        sink += (uint64_t)oldConvertToWei(etherTexts[i].c_str(), 18);
+                    }),
+                    measure(N, [&](size_t i) {
+                        UInt256 v;
+                        sink += Amount::parse(etherTexts[i].c_str(), 18, &v);
+                    })});
+    rows.push_back({"parse 6", measure(N, [&](size_t i) {
+                        sink += (uint64_t)oldConvertToWei(tokenTexts[i].c_str(), 6);
+                    }),
+                    measure(N, [&](size_t i) {
+                        UInt256 v;
+                        sink += Amount::parse(tokenTexts[i].c_str(), 6, &v);
+                    })});
+
+    printf("%-10s %10s %8s %10s %8s %9s\n", "operation", "old ns", "allocs", "Amount ns", "allocs", "speedup");
+    for (const Row& r : rows) {
+        printf("%-10s %10.1f %8.1f %10.1f %8.1f %8.1fx\n", r.op, r.old.ns, r.old.allocs, r.now.ns, r.now.allocs,
+               r.old.ns / r.now.ns);
+    }
+    printf("\ndouble path wrong: %d / %zu amounts at 18 decimals, %d / %zu at 6\n",
+           doubleMismatches(etherTexts, etherExact, 18), N, doubleMismatches(tokenTexts, tokenExact, 6), N);
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+/*
+ * Access Log Anchor Check
+ *
+ * Runs the door's access log (examples/security_door/access_log.cpp) on
+ * the host over an in-memory LittleFS (host_shim/FS.h) and checks what it
+ * anchors against a plain level-by-level copy of the tree that
+ * contracts/AccessLogAnchor.sol verifies: leaf = keccak256 of the
+ * abi.encodePacked(uint64 period, uint32 index, uint32 time, bool granted,
+ * address user) bytes, inner node = keccak256 of the sorted pair, an odd
+ * last node carried up as is.
+ *
+ * Checks, for every period size from 1 to 70 entries and a spread up to
+ * ACCESS_LOG_MAX_ENTRIES:
+ * - the root the log closes a period with equals the reference root
+ * - every proof (a sample on large periods) has the reference siblings
+ *   and passes the contract's verify() loop
+ * - a proof stops verifying when the entry's time, verdict, user or index
+ *   is changed, or when it is checked against another period's root
+ * - a full period closes early and the next entry opens a new one
+ * - begin() resumes the open period and its entry count from flash
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src anchor_check.cpp \
+ *       ../../examples/security_door/access_log.cpp -o anchor_check
+ *   ./anchor_check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <Crypto.h>
+
+#include "../../examples/security_door/access_log.h"
+#include "hex.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 32);
+}
+
+typedef std::vector<uint8_t> Hash;
+
+// ===== CONTRACT SIDE =====
+// AccessLogAnchor.leaf(): abi.encodePacked packs each value big-endian at
+// its own width, so the preimage is 8 + 4 + 4 + 1 + 20 = 37 bytes
+static Hash contractLeaf(uint64_t period, uint32_t index, uint32_t time, bool granted, const uint8_t user[20]) {
+    uint8_t packed[37];
+    for (int i = 0; i < 8; i++) {
+        packed[i] = period >> (56 - 8 * i);
+    }
+    for (int i = 0; i < 4; i++) {
+        packed[8 + i] = index >> (24 - 8 * i);
+        packed[12 + i] = time >> (24 - 8 * i);
+    }
+    packed[16] = granted;
+    memcpy(packed + 17, user, 20);
+    Hash out(32);
+    Crypto::Keccak256(packed, sizeof(packed), out.data());
+    return out;
+}
+
+static Hash contractPair(const Hash& a, const Hash& b) {
+    uint8_t buf[64];
+    const Hash& lo = a < b ? a : b;    // bytes32 compares as a big-endian number
+    const Hash& hi = a < b ? b : a;
+    memcpy(buf, lo.data(), 32);
+    memcpy(buf + 32, hi.data(), 32);
+    Hash out(32);
+    Crypto::Keccak256(buf, sizeof(buf), out.data());
+    return out;
+}
+
+// AccessLogAnchor.verify() without the roots mapping
+static bool contractVerify(const Hash& root, Hash node, const std::vector<Hash>& proof) {
+    for (const Hash& sibling : proof) {
+        node = contractPair(node, sibling);
+    }
+    return node == root;
+}
+
+// The whole tree, one level at a time; levels[0] are the leaves
+static std::vector<std::vector<Hash>> referenceTree(const std::vector<Hash>& leaves) {
+    std::vector<std::vector<Hash>> levels = {leaves};
+    while (levels.back().size() > 1) {
+        const std::vector<Hash>& below = levels.back();
+        std::vector<Hash> up;
+        for (size_t i = 0; i < below.size(); i += 2) {
+            up.push_back(i + 1 < below.size() ? contractPair(below[i], below[i + 1]) : below[i]);
+        }
+        levels.push_back(up);
+    }
+    return levels;
+}
+
+static std::vector<Hash> referenceProof(const std::vector<std::vector<Hash>>& levels, uint32_t index) {
+    std::vector<Hash> proof;
+    for (size_t level = 0; level + 1 < levels.size(); level++, index >>= 1) {
+        if ((index ^ 1) < levels[level].size()) {
+            proof.push_back(levels[level][index ^ 1]);
+        }
+    }
+    return proof;
+}
+
+// ===== FIRMWARE SIDE =====
+struct Logged {
+    uint32_t time;
+    bool granted;
+    uint8_t user[20];
+};
+
+static Logged randomEntry() {
+    Logged e;
+    e.time = 1700000000 + rng() % 100000000;
+    e.granted = rng() & 1;
+    for (int i = 0; i < 20; i++) {
+        e.user[i] = rng();
+    }
+    return e;
+}
+
+static bool appendEntry(AccessLog& log, uint32_t now, const Logged& e) {
+    char text[43] = "0x";
+    Hex::encode(e.user, 20, text + 2);
+    text[42] = '\0';
+    return log.append(now, e.time, e.granted, text);
+}
+
+static std::vector<Hash> leavesOf(uint32_t period, const std::vector<Logged>& entries) {
+    std::vector<Hash> leaves;
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        leaves.push_back(contractLeaf(period, i, entries[i].time, entries[i].granted, entries[i].user));
+    }
+    return leaves;
+}
+
+// Checks the proof of one entry of a closed period against the reference tree
+static void checkProof(AccessLog& log, uint32_t period, uint32_t index, const std::vector<Logged>& entries,
+                       const std::vector<std::vector<Hash>>& levels, const Hash& otherRoot) {
+    AccessProof proof;
+    if (!log.proof(period, index, &proof)) {
+        check(false, "proof() for an entry of a closed period");
+        return;
+    }
+    const Logged& e = entries[index];
+    std::vector<Hash> siblings;
+    for (int i = 0; i < proof.depth; i++) {
+        siblings.push_back(Hash(proof.siblings[i], proof.siblings[i] + 32));
+    }
+    Hash root(proof.root, proof.root + 32);
+    Hash leaf = contractLeaf(period, index, e.time, e.granted, e.user);
+
+    check(proof.count == entries.size(), "proof carries the period's entry count");
+    check(proof.entry.time == e.time && proof.entry.granted == e.granted && memcmp(proof.entry.user, e.user, 20) == 0,
+          "proof carries the logged entry");
+    check(Hash(proof.leaf, proof.leaf + 32) == leaf, "firmware leaf matches AccessLogAnchor.leaf()");
+    check(siblings == referenceProof(levels, index), "proof siblings match the reference tree");
+    check(contractVerify(root, leaf, siblings), "proof passes AccessLogAnchor.verify()");
+
+    check(!contractVerify(root, contractLeaf(period, index, e.time + 1, e.granted, e.user), siblings),
+          "proof rejects a changed time");
+    check(!contractVerify(root, contractLeaf(period, index, e.time, !e.granted, e.user), siblings),
+          "proof rejects a flipped verdict");
+    uint8_t other[20];
+    memcpy(other, e.user, 20);
+    other[19] ^= 1;
+    check(!contractVerify(root, contractLeaf(period, index, e.time, e.granted, other), siblings),
+          "proof rejects another user");
+    if (entries.size() > 1) {
+        check(!contractVerify(root, contractLeaf(period, index ^ 1, e.time, e.granted, e.user), siblings),
+              "proof rejects another index");
+    }
+    if (!otherRoot.empty()) {
+        check(!contractVerify(otherRoot, leaf, siblings), "proof rejects another period's root");
+    }
+}
+
+// Logs one period of n entries, closes it and checks its root and proofs
+static void checkPeriod(uint32_t n, Hash* lastRoot) {
+    fs::FS flash;
+    AccessLog log(flash, 1000);
+    uint32_t now = 0;
+    check(log.begin(now), "begin() on an empty filesystem");
+
+    // Skip ahead so the leaf's period field is not always zero
+    uint32_t skip = n % 3;
+    for (uint32_t p = 0; p < skip; p++) {
+        appendEntry(log, now, randomEntry());
+        now += 1000;
+        log.roll(now);
+    }
+    uint32_t period = log.openPeriod();
+
+    std::vector<Logged> entries;
+    for (uint32_t i = 0; i < n; i++) {
+        entries.push_back(randomEntry());
+        if (!appendEntry(log, now, entries.back())) {
+            check(false, "append()");
+            return;
+        }
+    }
+    now += 1000;
+    check(log.roll(now), "roll() closes a due period");
+    check(log.openPeriod() == period + 1 && log.openEntries() == 0, "a new period opens after the close");
+
+    // The anchor queue hands out the oldest period first; mark the skipped ones
+    uint32_t anchored;
+    uint8_t root[32];
+    uint32_t count;
+    char txHash[67];
+    snprintf(txHash, sizeof(txHash), "0x%064x", 1);
+    while (log.pendingAnchor(&anchored, root, &count) && anchored < period) {
+        log.markAnchored(anchored, txHash);
+    }
+    check(anchored == period && count == n, "pendingAnchor() offers the closed period");
+
+    std::vector<std::vector<Hash>> levels = referenceTree(leavesOf(period, entries));
+    Hash rootHash(root, root + 32);
+    check(rootHash == levels.back()[0], "anchored root matches the reference tree");
+
+    if (n <= 70) {
+        for (uint32_t i = 0; i < n; i++) {
+            checkProof(log, period, i, entries, levels, *lastRoot);
+        }
+    } else {
+        checkProof(log, period, 0, entries, levels, *lastRoot);
+        checkProof(log, period, n - 1, entries, levels, *lastRoot);
+        for (int k = 0; k < 32; k++) {
+            checkProof(log, period, rng() % n, entries, levels, *lastRoot);
+        }
+    }
+
+    AccessProof none;
+    check(!log.proof(period, n, &none), "no proof past the last entry");
+    check(!log.proof(period + 1, 0, &none), "no proof in the open period");
+    *lastRoot = rootHash;
+}
+
+static void checkFullPeriod() {
+    fs::FS flash;
+    AccessLog log(flash, 3600000);
+    check(log.begin(0), "begin() on an empty filesystem");
+
+    std::vector<Logged> entries;
+    for (uint32_t i = 0; i < ACCESS_LOG_MAX_ENTRIES; i++) {
+        entries.push_back(randomEntry());
+        appendEntry(log, 0, entries.back());
+    }
+    check(log.openPeriod() == 0 && log.openEntries() == ACCESS_LOG_MAX_ENTRIES, "a full period stays open");
+    Logged extra = randomEntry();
+    check(appendEntry(log, 0, extra), "the entry after a full period is logged");
+    check(log.openPeriod() == 1 && log.openEntries() == 1, "a full period closes early");
+
+    uint32_t period;
+    uint8_t root[32];
+    uint32_t count;
+    check(log.pendingAnchor(&period, root, &count) && period == 0 && count == ACCESS_LOG_MAX_ENTRIES,
+          "the full period waits for its anchor");
+    std::vector<std::vector<Hash>> levels = referenceTree(leavesOf(0, entries));
+    check(Hash(root, root + 32) == levels.back()[0], "full period root matches the reference tree");
+    check(levels.size() - 1 == ACCESS_LOG_MAX_DEPTH, "a full period is ACCESS_LOG_MAX_DEPTH levels deep");
+    checkProof(log, 0, ACCESS_LOG_MAX_ENTRIES - 1, entries, levels, Hash());
+
+    // A reboot picks the open period back up where it was
+    AccessLog again(flash, 3600000);
+    check(again.begin(0), "begin() over an existing log");
+    check(again.openPeriod() == 1 && again.openEntries() == 1 && again.unanchored() == 1,
+          "begin() resumes the open period and the anchor queue");
+}
+
+int main() {
+    Hash lastRoot;
+    for (uint32_t n = 1; n <= 70; n++) {
+        checkPeriod(n, &lastRoot);
+    }
+    const uint32_t sizes[] = {127, 128, 129, 255, 256, 257, 511, 600, 1000, 1023, ACCESS_LOG_MAX_ENTRIES};
+    for (uint32_t n : sizes) {
+        checkPeriod(n, &lastRoot);
+    }
+    checkFullPeriod();
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,273 @@
+/*
+ * Challenge Table Load Test
+ *
+ * Drives examples/security_door/challenge_table.cpp the way the door's
+ * HTTP task does, from several threads behind one lock standing in for
+ * challengeLock. Each simulated user gets a challenge, holds it while it
+ * "signs", and hands it back; every login must succeed no matter how the
+ * others interleave. Then the same logins run while one client floods
+ * /api/getChallenge, and again with the table filled by many clients:
+ * real users' challenges must never be pushed out, and nobody gets a
+ * challenge twice. Reports logins per second.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -pthread -I../../examples/security_door challenge_load.cpp \
+ *       ../../examples/security_door/challenge_table.cpp -o challenge_load
+ *   ./challenge_load --threads 8 --logins 200000
+ *
+ * Options (defaults in brackets):
+ *   --threads N   concurrent users [8]
+ *   --logins N    logins per thread [100000]
+ *   --hold N      challenges each user holds before signing [2]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "challenge_table.h"
+
+static const uint32_t TIMEOUT_MS = 300000;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok && failures++ < 10) {
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// The door's table and lock; the clock is simulated and only moves when a
+// test moves it
+struct Door {
+    ChallengeTable table{TIMEOUT_MS};
+    std::mutex lock;
+    std::atomic<uint32_t> now{1000};
+
+    ChallengeIssue issue(uint64_t& rng, uint32_t client, uint32_t* id) {
+        ChallengeIssue result;
+        do {
+            *id = (uint32_t)nextRandom(rng);
+            std::lock_guard<std::mutex> guard(lock);
+            result = table.issue(*id, (uint32_t)(nextRandom(rng) >> 32), client, now);
+        } while (result == CHALLENGE_COLLISION);
+        return result;
+    }
+
+    bool consume(uint32_t id, char* text, size_t len) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.consume(id, now, text, len);
+    }
+};
+
+struct LoginStats {
+    std::atomic<uint64_t> ok{0};
+    std::atomic<uint64_t> lost{0};     // Issued, then gone before it was signed
+    std::atomic<uint64_t> refused{0};  // Turned away at getChallenge
+};
+
+// One user: get `hold` challenges (several tabs, a retry), sign, send back
+static void user(Door& door, LoginStats& stats, uint32_t client, uint32_t logins, uint32_t hold,
+                 uint64_t seed) {
+    uint64_t rng = seed | 1;
+    uint32_t ids[CHALLENGE_PER_CLIENT];
+    char text[CHALLENGE_TEXT_LEN];
+    for (uint32_t n = 0; n < logins; n++) {
+        uint32_t got = 0;
+        for (uint32_t h = 0; h < hold; h++) {
+            if (door.issue(rng, client, &ids[got]) == CHALLENGE_ISSUED) {
+                got++;
+            } else {
+                stats.refused++;
+            }
+        }
+        for (uint32_t h = 0; h < got; h++) {
+            if (door.consume(ids[h], text, sizeof(text))) {
+                stats.ok++;
+            } else {
+                stats.lost++;
+            }
+        }
+    }
+}
+
+static double runLogins(Door& door, LoginStats& stats, uint32_t threads, uint32_t logins, uint32_t hold) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> users;
+    for (uint32_t t = 0; t < threads; t++) {
+        uint32_t client = 0x0A000000 | (t + 1);  // 10.0.0.t
+        users.emplace_back(user, std::ref(door), std::ref(stats), client, logins, hold, 0x9E3779B97F4A7C15ULL * (t + 1));
+    }
+    for (auto& u : users) {
+        u.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void checkSingleUse() {
+    Door door;
+    uint64_t rng = 7;
+    char text[CHALLENGE_TEXT_LEN], again[CHALLENGE_TEXT_LEN];
+    uint32_t id;
+    check(door.issue(rng, 1, &id) == CHALLENGE_ISSUED, "issue");
+    const char* live = door.table.find(id, door.now);
+    check(live != nullptr && strlen(live) > 0, "find after issue");
+    check(door.consume(id, text, sizeof(text)), "first consume");
+    check(!door.consume(id, again, sizeof(again)), "second consume of the same challenge");
+    check(door.table.issue(0, 1, 1, door.now) == CHALLENGE_COLLISION, "id 0 accepted");
+
+    uint32_t dup;
+    check(door.issue(rng, 1, &dup) == CHALLENGE_ISSUED, "issue");
+    check(door.table.issue(dup, 2, 2, door.now) == CHALLENGE_COLLISION, "live id issued twice");
+
+    door.now += TIMEOUT_MS + 1;
+    check(!door.consume(dup, text, sizeof(text)), "expired challenge consumed");
+}
+
+static void checkQuota() {
+    Door door;
+    uint64_t rng = 11;
+    uint32_t first, id;
+    check(door.issue(rng, 42, &first) == CHALLENGE_ISSUED, "issue");
+    for (int i = 1; i < CHALLENGE_PER_CLIENT; i++) {
+        door.now++;
+        check(door.issue(rng, 42, &id) == CHALLENGE_ISSUED, "issue under quota");
+    }
+    check(door.table.evictedTotal() == 0, "eviction under quota");
+    check(door.issue(rng, 42, &id) == CHALLENGE_ISSUED, "issue over quota");
+    check(door.table.find(first, door.now) == nullptr, "client's oldest kept past its quota");
+    check(door.table.live() == CHALLENGE_PER_CLIENT, "client holds more than its quota");
+}
+
+static void checkFull() {
+    Door door;
+    uint64_t rng = 13;
+    uint32_t mine;
+    check(door.issue(rng, 1, &mine) == CHALLENGE_ISSUED, "issue");
+
+    // Many clients fill every other slot
+    uint32_t id;
+    for (uint32_t c = 2; c <= CHALLENGE_SLOTS; c++) {
+        check(door.issue(rng, 1000 + c, &id) == CHALLENGE_ISSUED, "fill");
+    }
+    check(door.table.live() == CHALLENGE_SLOTS, "table not full");
+    check(door.issue(rng, 99999, &id) == CHALLENGE_FULL, "new client admitted to a full table");
+    check(door.table.find(mine, door.now) != nullptr, "full table evicted another client's challenge");
+
+    // A client that already holds one may swap it for a new one
+    uint32_t swapped;
+    check(door.issue(rng, 1, &swapped) == CHALLENGE_ISSUED, "own slot not reused when full");
+    check(door.table.find(mine, door.now) == nullptr && door.table.find(swapped, door.now) != nullptr,
+          "swap when full");
+    char text[CHALLENGE_TEXT_LEN];
+    check(door.consume(swapped, text, sizeof(text)), "consume after swap");
+
+    // Expiry frees the table again
+    door.now += TIMEOUT_MS + 1;
+    check(door.issue(rng, 99999, &id) == CHALLENGE_ISSUED, "expired slots not reclaimed");
+}
+
+int main(int argc, char** argv) {
+    uint32_t threads = 8, logins = 100000, hold = 2;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--logins") == 0) logins = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--hold") == 0) hold = atoi(argv[i + 1]);
+    }
+    if (hold < 1 || hold > CHALLENGE_PER_CLIENT || threads * hold > CHALLENGE_SLOTS) {
+        printf("--hold must be 1..%d and threads * hold at most %d\n", CHALLENGE_PER_CLIENT, CHALLENGE_SLOTS);
+        return 2;
+    }
+
+    checkSingleUse();
+    checkQuota();
+    checkFull();
+
+    printf("Challenge table: %d slots, %d per client, %u users holding %u each\n\n", CHALLENGE_SLOTS,
+           CHALLENGE_PER_CLIENT, threads, hold);
+
+    // Parallel logins
+    {
+        Door door;
+        LoginStats stats;
+        double s = runLogins(door, stats, threads, logins, hold);
+        uint64_t want = (uint64_t)threads * logins * hold;
+        printf("parallel logins      %10.0f /s  (%llu ok, %llu lost, %llu refused)\n", stats.ok / s,
+               (unsigned long long)stats.ok.load(), (unsigned long long)stats.lost.load(),
+               (unsigned long long)stats.refused.load());
+        check(stats.ok == want, "parallel login failed");
+        check(door.table.live() == 0, "challenges left behind");
+    }
+
+    // The same with one client hammering getChallenge and never signing
+    {
+        Door door;
+        LoginStats stats;
+        std::atomic<bool> stop{false};
+        uint64_t flooded = 0;
+        std::thread flooder([&] {
+            uint64_t rng = 0xF100D;
+            uint32_t id;
+            while (!stop) {
+                door.issue(rng, 0xC0A80001, &id);
+                flooded++;
+            }
+        });
+        double s = runLogins(door, stats, threads, logins, hold);
+        stop = true;
+        flooder.join();
+        uint64_t want = (uint64_t)threads * logins * hold;
+        printf("with one flooder     %10.0f /s  (%llu ok, %llu lost, %llu refused; %llu flood requests)\n",
+               stats.ok / s, (unsigned long long)stats.ok.load(), (unsigned long long)stats.lost.load(),
+               (unsigned long long)stats.refused.load(), (unsigned long long)flooded);
+        check(stats.ok == want, "flooder pushed out a real user's challenge");
+        check(door.table.live() <= CHALLENGE_PER_CLIENT, "flooder holds more than its quota");
+    }
+
+    // Table filled by many clients that never sign: latecomers are turned
+    // away until the squatters expire, but nobody already holding a
+    // challenge loses it
+    {
+        Door door;
+        uint64_t rng = 0xB07;
+        std::vector<uint32_t> held(threads * hold);
+        for (uint32_t i = 0; i < held.size(); i++) {
+            door.issue(rng, 0x0A000000 | (i / hold + 1), &held[i]);
+        }
+        uint32_t flood, turnedAway = 0, floodRequests = 100000;
+        for (uint32_t c = 0; c < floodRequests; c++) {
+            if (door.issue(rng, 0xAC100000 | c, &flood) == CHALLENGE_FULL) {
+                turnedAway++;
+            }
+        }
+        uint32_t signedOk = 0;
+        char text[CHALLENGE_TEXT_LEN];
+        for (uint32_t id : held) {
+            signedOk += door.consume(id, text, sizeof(text));
+        }
+        printf("table full of others %u/%u held challenges signed; %u of %u flood requests turned away\n",
+               signedOk, (unsigned)held.size(), turnedAway, floodRequests);
+        check(signedOk == held.size(), "held challenge lost to a full table");
+        check(turnedAway == floodRequests - (CHALLENGE_SLOTS - held.size()), "full table admitted a newcomer");
+        door.now += TIMEOUT_MS + 1;
+        check(door.issue(rng, 0x0A000001, &flood) == CHALLENGE_ISSUED, "squatters never expired");
+    }
+
+    printf("\n");
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * EIP-712 Voucher Benchmark
+ *
+ * Checks src/eip712.h against the Mail example from the EIP-712 spec
+ * (type hash, domain separator, struct hash, digest and the published
+ * signature), then measures voucher throughput:
+ *
+ *   digest    voucherDigest() with cached type hash and domain separator
+ *   uncached  the same, rehashing the type string and domain every time
+ *   sign      digest + signature, as the payer does per use
+ *   recover   signer address from a signature (first voucher of a payer)
+ *   verify    signature against a known public key (every later one)
+ *   accept    VoucherBook::accept() over a stream from several payers
+ *
+ * Signing runs on OpenSSL here (host_signer.cpp); the firmware uses the
+ * secp256k1 code in Web3E, which the "voucher" serial command measures
+ * on the device. Exits non-zero if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src eip712_bench.cpp host_signer.cpp -lcrypto -o eip712_bench
+ *   ./eip712_bench --count 20000 --payers 4
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <new>
+
+#include "voucher.h"
+
+// ===== ALLOCATION COUNTING =====
+static size_t allocCount = 0;
+
+void* operator new(size_t size) {
+    allocCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// ===== HELPERS =====
+static uint32_t failedChecks = 0;
+
+static void unhex(const char* hex, uint8_t* out, size_t n) {
+    Hex::decode(hex + 2, out, n);
+}
+
+static void check(const char* what, const uint8_t* got, const char* expected) {
+    uint8_t want[32];
+    unhex(expected, want, 32);
+    bool ok = memcmp(got, want, 32) == 0;
+    printf("  %-18s %s\n", what, ok ? "ok" : "MISMATCH");
+    failedChecks += !ok;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* what, uint32_t n, double elapsed, const char* note) {
+    printf("  %-10s %12.0f /s  %8.2f us  %s\n", what, n / elapsed, 1e6 * elapsed / n, note);
+}
+
+// ===== SPEC VECTOR =====
+static void checkSpecExample() {
+    static Eip712Type person("Person(string name,address wallet)");
+    static Eip712Type mail("Mail(Person from,Person to,string contents)Person(string name,address wallet)");
+    Eip712Domain domain("Ether Mail", "1", 1, "0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC");
+
+    Eip712Struct from(person), to(person), message(mail);
+    from.text("Cow").address("0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826");
+    to.text("Bob").address("0xbBbBBBBbbBBBbbbBbbBbbbbBBbBbbbbBbBbbBBbB");
+    message.nested(from).nested(to).text("Hello, Bob!");
+
+    uint8_t structHash[32], digest[32];
+    printf("EIP-712 spec example (Mail):\n");
+    check("type hash", mail.typeHash(), "0xa0cedeb2dc280ba39b857546d74f5549c3a1d7bdc2dd96bf881f76108e23dac2");
+    check("domain separator", domain.separator(),
+          "0xf2cee375fa42b42143804025fc449deafd50cc031ca257e0b194a650a912090f");
+    bool hashed = message.hash(structHash) && domain.digest(message, digest);
+    failedChecks += !hashed;
+    check("struct hash", structHash, "0xc52c0ee5d84264471806290a3f2c4cecfc5490626bf912d01f240d7a274b371e");
+    check("digest", digest, "0xbe609aee343fb3c4b28e1df9e632fca64fcfaede20f02e86244efddf30957bd2");
+
+    // Published signature by keccak256("cow"), i.e. the "Cow" wallet
+    uint8_t signature[65], signer[20], cow[20];
+    unhex("0x4355c47d63924e8a72e509b65029052eb6c299d53a04e167c5775fd466751c9d", signature, 32);
+    unhex("0x07299936d304c153f6443dfa05f40ff007d72911b6f72307f996231605b91562", signature + 32, 32);
+    signature[64] = 28;
+    unhex("0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826", cow, 20);
+    bool recovered = Eip712Signer::recover(digest, signature, signer) && memcmp(signer, cow, 20) == 0;
+    printf("  %-18s %s\n\n", "spec signature", recovered ? "ok" : "MISMATCH");
+    failedChecks += !recovered;
+}
+
+// ===== BENCHMARK =====
+struct Options {
+    uint32_t count = 10000;
+    uint32_t payers = 4;
+};
+
+static bool parseArgs(int argc, char** argv, Options* opt) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        uint32_t value = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+        if (!strcmp(argv[i], "--count")) opt->count = value ? value : 1;
+        else if (!strcmp(argv[i], "--payers")) opt->payers = value ? value : 1;
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return false;
+        }
+    }
+    return (argc % 2) == 1 && opt->payers <= VOUCHER_MAX_PAYERS;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, &opt)) {
+        fprintf(stderr, "usage: see the header of eip712_bench.cpp (at most %d payers)\n", VOUCHER_MAX_PAYERS);
+        return 2;
+    }
+    checkSpecExample();
+
+    Eip712Domain domain(VOUCHER_DOMAIN_NAME, "1", 11155111, "0x1111111111111111111111111111111111111111");
+    Eip712Signer payers[VOUCHER_MAX_PAYERS];
+    for (uint32_t p = 0; p < opt.payers; p++) {
+        char key[65];
+        snprintf(key, sizeof(key), "%064x", p + 1);
+        payers[p].begin(key);
+    }
+
+    Voucher v = {};
+    unhex("0x2222222222222222222222222222222222222222", v.device, 20);
+    memcpy(v.payer, payers[0].address(), 20);
+    v.expiry = 2000000000;
+
+    uint8_t digest[32], signature[65], signer[20];
+    printf("Vouchers (%u iterations, %u payers):\n", opt.count, opt.payers);
+
+    size_t allocsBefore = allocCount;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < opt.count; i++) {
+        v.nonce = i;
+        voucherDigest(domain, v, digest);
+    }
+    report("digest", opt.count, seconds(start), "cached type hash and separator");
+    size_t digestAllocs = allocCount - allocsBefore;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < opt.count; i++) {
+        Eip712Type type(VOUCHER_TYPE);
+        Eip712Domain fresh(VOUCHER_DOMAIN_NAME, "1", 11155111, "0x1111111111111111111111111111111111111111");
+        Eip712Struct s(type);
+        v.nonce = i;
+        s.address(v.device).address(v.payer).uint(v.amount).uint(v.nonce).uint(v.expiry);
+        fresh.digest(s, digest);
+    }
+    report("uncached", opt.count, seconds(start), "type string and domain rehashed per voucher");
+
+    uint32_t crypto = opt.count / 10 ? opt.count / 10 : 1;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < crypto; i++) {
+        v.nonce = i;
+        signVoucher(payers[0], domain, v, signature);
+    }
+    report("sign", crypto, seconds(start), "digest + secp256k1 signature");
+
+    voucherDigest(domain, v, digest);
+    bool ok = true;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < crypto; i++) {
+        ok &= Eip712Signer::recover(digest, signature, signer) && memcmp(signer, payers[0].address(), 20) == 0;
+    }
+    report("recover", crypto, seconds(start), "address from signature");
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < crypto; i++) {
+        ok &= Eip712Signer::verify(payers[0].publicKey(), digest, signature);
+    }
+    report("verify", crypto, seconds(start), "known public key");
+    if (!ok) {
+        printf("FAIL signatures did not round-trip\n");
+        failedChecks++;
+    }
+
+    // Pay-per-use stream: each payer's running total grows by 1 gwei per use
+    static Voucher stream[4096];
+    static uint8_t sigs[4096][65];
+    uint32_t streamLen = crypto < 4096 ? crypto : 4096;
+    for (uint32_t i = 0; i < streamLen; i++) {
+        Voucher& u = stream[i];
+        u = v;
+        uint32_t p = i % opt.payers;
+        memcpy(u.payer, payers[p].address(), 20);
+        u.nonce = i / opt.payers + 1;
+        u.amount = uint256_t(u.nonce * 1000000000ULL);
+        signVoucher(payers[p], domain, u, sigs[i]);
+    }
+    VoucherBook book(domain, v.device);
+    uint32_t accepted = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < streamLen; i++) {
+        accepted += book.accept(stream[i], sigs[i], 1700000000) == VOUCHER_OK;
+    }
+    report("accept", streamLen, seconds(start), "recover once per payer, then verify");
+
+    // Replays and tampering must be refused
+    VoucherStatus replay = book.accept(stream[0], sigs[0], 1700000000);
+    Voucher forged = stream[streamLen - 1];
+    forged.nonce++;
+    forged.amount = uint256_t(1ULL << 60);
+    VoucherStatus tampered = book.accept(forged, sigs[streamLen - 1], 1700000000);
+    VoucherStatus expired = book.accept(forged, sigs[streamLen - 1], 2100000000);
+    if (accepted != streamLen || book.size() != opt.payers || replay != VOUCHER_STALE ||
+        tampered != VOUCHER_BAD_SIGNATURE || expired != VOUCHER_EXPIRED) {
+        printf("FAIL accepted %u/%u, replay %s, tampered %s, expired %s\n", accepted, streamLen,
+               VoucherBook::statusName(replay), VoucherBook::statusName(tampered), VoucherBook::statusName(expired));
+        failedChecks++;
+    }
+
+    printf("\n  heap allocations while hashing: %zu\n", digestAllocs);
+    failedChecks += digestAllocs != 0;
+    printf("\n%s\n", failedChecks ? "CHECKS FAILED" : "all checks passed");
+    return failedChecks ? 1 : 0;
+}
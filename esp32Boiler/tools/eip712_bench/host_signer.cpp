@@ -0,0 +1,187 @@
+/*
+ * Eip712Signer for the host
+ *
+ * The firmware signs with the secp256k1 code bundled in Web3E; on a PC the
+ * same interface is implemented on OpenSSL's EC arithmetic. Nonces are
+ * random rather than RFC 6979, so signatures differ from the device's
+ * but recover and verify identically.
+ */
+
+#include "eip712.h"
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+
+struct Curve {
+    EC_GROUP* group;
+    BIGNUM* order;
+    BIGNUM* half;
+    BN_CTX* ctx;
+};
+
+static Curve& curve() {
+    static Curve c = [] {
+        Curve k;
+        k.group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+        k.order = BN_new();
+        k.half = BN_new();
+        k.ctx = BN_CTX_new();
+        EC_GROUP_get_order(k.group, k.order, k.ctx);
+        BN_rshift1(k.half, k.order);
+        return k;
+    }();
+    return c;
+}
+
+// All BIGNUM/EC_POINT temporaries of one operation, freed together
+struct Scratch {
+    BIGNUM* bn[8];
+    EC_POINT* point[2];
+
+    Scratch() {
+        for (BIGNUM*& b : bn) b = BN_new();
+        for (EC_POINT*& p : point) p = EC_POINT_new(curve().group);
+    }
+    ~Scratch() {
+        for (BIGNUM* b : bn) BN_free(b);
+        for (EC_POINT* p : point) EC_POINT_free(p);
+    }
+};
+
+static void pointToBytes(const EC_POINT* p, uint8_t out[64]) {
+    uint8_t pub65[65];
+    EC_POINT_point2oct(curve().group, p, POINT_CONVERSION_UNCOMPRESSED, pub65, sizeof(pub65), curve().ctx);
+    memcpy(out, pub65 + 1, 64);
+}
+
+// r and s in range, s in the lower half, v 27 or 28
+static bool parseSignature(const uint8_t signature[65], BIGNUM* r, BIGNUM* s) {
+    Curve& c = curve();
+    BN_bin2bn(signature, 32, r);
+    BN_bin2bn(signature + 32, 32, s);
+    return (signature[64] == 27 || signature[64] == 28) && !BN_is_zero(r) && !BN_is_zero(s) &&
+           BN_cmp(r, c.order) < 0 && BN_cmp(s, c.half) <= 0;
+}
+
+Eip712Signer::Eip712Signer() : ready(false) {
+    memset(key, 0, sizeof(key));
+}
+
+bool Eip712Signer::begin(const char* privateKey) {
+    if (privateKey && privateKey[0] == '0' && (privateKey[1] == 'x' || privateKey[1] == 'X')) {
+        privateKey += 2;
+    }
+    if (!privateKey || strlen(privateKey) != 64 || !Hex::decode(privateKey, key, 32)) {
+        return ready = false;
+    }
+    Scratch t;
+    BN_bin2bn(key, 32, t.bn[0]);
+    EC_POINT_mul(curve().group, t.point[0], t.bn[0], nullptr, nullptr, curve().ctx);
+    pointToBytes(t.point[0], pub);
+    publicKeyToAddress(pub, addr);
+    return ready = true;
+}
+
+bool Eip712Signer::sign(const uint8_t digest[32], uint8_t signature[65]) const {
+    if (!ready) {
+        return false;
+    }
+    Curve& c = curve();
+    Scratch t;
+    BIGNUM *d = t.bn[0], *e = t.bn[1], *k = t.bn[2], *x = t.bn[3], *y = t.bn[4], *r = t.bn[5], *s = t.bn[6];
+    BN_bin2bn(key, 32, d);
+    BN_bin2bn(digest, 32, e);
+
+    for (;;) {
+        BN_rand_range(k, c.order);
+        if (BN_is_zero(k)) {
+            continue;
+        }
+        EC_POINT_mul(c.group, t.point[0], k, nullptr, nullptr, c.ctx);
+        EC_POINT_get_affine_coordinates(c.group, t.point[0], x, y, c.ctx);
+        if (BN_cmp(x, c.order) >= 0) {
+            continue;                       // recid would need the overflow bit
+        }
+        BN_copy(r, x);
+        uint8_t recid = BN_is_odd(y) ? 1 : 0;
+
+        // s = k^-1 (e + r d) mod n
+        BN_mod_mul(s, r, d, c.order, c.ctx);
+        BN_mod_add(s, s, e, c.order, c.ctx);
+        BN_mod_inverse(k, k, c.order, c.ctx);
+        BN_mod_mul(s, s, k, c.order, c.ctx);
+        if (BN_is_zero(r) || BN_is_zero(s)) {
+            continue;
+        }
+        if (BN_cmp(s, c.half) > 0) {
+            BN_sub(s, c.order, s);
+            recid ^= 1;
+        }
+        BN_bn2binpad(r, signature, 32);
+        BN_bn2binpad(s, signature + 32, 32);
+        signature[64] = 27 + recid;
+        return true;
+    }
+}
+
+bool Eip712Signer::recover(const uint8_t digest[32], const uint8_t signature[65], uint8_t address[20],
+                           uint8_t publicKey[64]) {
+    Curve& c = curve();
+    Scratch t;
+    BIGNUM *r = t.bn[0], *s = t.bn[1], *e = t.bn[2], *u1 = t.bn[3], *u2 = t.bn[4];
+    if (!parseSignature(signature, r, s) ||
+        !EC_POINT_set_compressed_coordinates(c.group, t.point[0], r, signature[64] - 27, c.ctx)) {
+        return false;
+    }
+
+    // Q = r^-1 (s R - e G)
+    BN_bin2bn(digest, 32, e);
+    BN_mod_inverse(r, r, c.order, c.ctx);
+    BN_mod_sub(u1, c.order, e, c.order, c.ctx);
+    BN_mod_mul(u1, u1, r, c.order, c.ctx);
+    BN_mod_mul(u2, s, r, c.order, c.ctx);
+    if (!EC_POINT_mul(c.group, t.point[1], u1, t.point[0], u2, c.ctx) ||
+        EC_POINT_is_at_infinity(c.group, t.point[1])) {
+        return false;
+    }
+
+    uint8_t pub[64];
+    pointToBytes(t.point[1], pub);
+    publicKeyToAddress(pub, address);
+    if (publicKey) {
+        memcpy(publicKey, pub, 64);
+    }
+    return true;
+}
+
+bool Eip712Signer::verify(const uint8_t publicKey[64], const uint8_t digest[32], const uint8_t signature[65]) {
+    Curve& c = curve();
+    Scratch t;
+    BIGNUM *r = t.bn[0], *s = t.bn[1], *e = t.bn[2], *u1 = t.bn[3], *u2 = t.bn[4], *x = t.bn[5];
+    uint8_t pub65[65] = {0x04};
+    memcpy(pub65 + 1, publicKey, 64);
+    if (!parseSignature(signature, r, s) ||
+        !EC_POINT_oct2point(c.group, t.point[0], pub65, sizeof(pub65), c.ctx)) {
+        return false;
+    }
+
+    // X = e s^-1 G + r s^-1 Q; valid if X.x = r (mod n)
+    BN_bin2bn(digest, 32, e);
+    BN_mod_inverse(s, s, c.order, c.ctx);
+    BN_mod_mul(u1, e, s, c.order, c.ctx);
+    BN_mod_mul(u2, r, s, c.order, c.ctx);
+    if (!EC_POINT_mul(c.group, t.point[1], u1, t.point[0], u2, c.ctx) ||
+        EC_POINT_is_at_infinity(c.group, t.point[1])) {
+        return false;
+    }
+    EC_POINT_get_affine_coordinates(c.group, t.point[1], x, nullptr, c.ctx);
+    BN_nnmod(x, x, c.order, c.ctx);
+    return BN_cmp(x, r) == 0;
+}
+
+void Eip712Signer::publicKeyToAddress(const uint8_t publicKey[64], uint8_t address[20]) {
+    uint8_t hash[32];
+    Crypto::Keccak256(publicKey, 64, hash);
+    memcpy(address, hash + 12, 20);
+}
@@ -0,0 +1,246 @@
+/*
+ * Fleet Simulator
+ *
+ * Runs hundreds or thousands of virtual devices against an in-process mock
+ * chain, each driven by the same RegistryAgent the firmware uses, and
+ * reports what the fleet does to the node: tx/s, RPC/s, latency
+ * percentiles and how much backing off the devices had to do.
+ *
+ * Devices are event-driven coroutines on a simulated clock, so an hour of
+ * a 5000-device fleet runs in seconds and the same seed gives the same run.
+ * Each call goes to the chain as the JSON-RPC request the firmware sends,
+ * and the reply comes back through RegistryAgent::interpret() as it does on
+ * the device. Transactions go as eth_sendTransaction, unsigned.
+ *
+ * Build and run on the host (no Arduino needed):
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src fleet_sim.cpp -o fleet_sim
+ *   ./fleet_sim --devices 2000 --seconds 1800 --rps 800
+ *
+ * Options (defaults in brackets):
+ *   --devices N        virtual devices [500]
+ *   --seconds S        simulated time [900]
+ *   --spread-ms MS     boot times spread over this window [0 = all at once]
+ *   --heartbeat-ms MS  ping() interval [60000]
+ *   --read-ms MS       get() interval [300000]
+ *   --block-ms MS      block interval [6000]
+ *   --tx-per-block N   block capacity [300]
+ *   --rps N            provider rate limit, 0 = none [1000]
+ *   --workers N        concurrent requests the node serves [32]
+ *   --rtt-ms MS        network round trip [60]
+ *   --seed N           [1]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+#include "mock_chain.h"
+#include "registry_agent.h"
+
+struct SimOptions {
+    uint32_t devices = 500;
+    uint32_t seconds = 900;
+    uint32_t spreadMs = 0;
+    uint32_t seed = 1;
+};
+
+struct Event {
+    uint64_t atUs;
+    uint32_t device;
+    bool reply;
+    RegistryStatus status;
+    uint64_t value;
+
+    bool operator>(const Event& other) const { return atUs > other.atUs; }
+};
+
+struct Device {
+    RegistryAgent* agent;
+    RegistryCall call;
+    uint64_t sentUs;
+    uint64_t wakeQueuedUs;       // Avoids queueing duplicate wake events
+};
+
+#define REGISTRY_ADDRESS "0x00000000000000000000000000000000000e5b01"
+
+static const char* CALL_NAMES[] = {"nonce", "add", "receipt", "ping", "get"};
+
+// The JSON-RPC body examples/device_registry sends for call
+static void buildRequest(const RegistryCall& call, const char* from, uint32_t id, std::string* body) {
+    char text[REGISTRY_CALLDATA_LEN + 256];
+    switch (call.type) {
+        case REGISTRY_NONCE:
+        case REGISTRY_RECEIPT:
+            snprintf(text, sizeof(text),
+                     "{\"jsonrpc\":\"2.0\",\"id\":%u,\"method\":\"eth_getTransactionCount\",\"params\":[\"%s\",\"%s\"]}",
+                     id, from, call.type == REGISTRY_NONCE ? "pending" : "latest");
+            break;
+        case REGISTRY_GET:
+            snprintf(text, sizeof(text),
+                     "{\"jsonrpc\":\"2.0\",\"id\":%u,\"method\":\"eth_call\",\"params\":[{\"to\":\"%s\",\"data\":\"%s\"},\"latest\"]}",
+                     id, REGISTRY_ADDRESS, call.data);
+            break;
+        case REGISTRY_ADD:
+        case REGISTRY_PING:
+            snprintf(text, sizeof(text),
+                     "{\"jsonrpc\":\"2.0\",\"id\":%u,\"method\":\"eth_sendTransaction\",\"params\":[{\"from\":\"%s\","
+                     "\"to\":\"%s\",\"nonce\":\"0x%x\",\"data\":\"%s\"}]}",
+                     id, from, REGISTRY_ADDRESS, call.nonce, call.data);
+            break;
+    }
+    body->assign(text);
+}
+
+static uint32_t percentile(std::vector<uint32_t>& v, int pct) {
+    if (v.empty()) {
+        return 0;
+    }
+    size_t k = (v.size() - 1) * pct / 100;
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static bool parseArgs(int argc, char** argv, SimOptions* opt, MockChainConfig* chain,
+                      RegistryAgentConfig* agent) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* name = argv[i];
+        uint32_t value = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+
+        if (!strcmp(name, "--devices")) opt->devices = value;
+        else if (!strcmp(name, "--seconds")) opt->seconds = value;
+        else if (!strcmp(name, "--spread-ms")) opt->spreadMs = value;
+        else if (!strcmp(name, "--seed")) opt->seed = value;
+        else if (!strcmp(name, "--heartbeat-ms")) agent->heartbeatMs = value;
+        else if (!strcmp(name, "--read-ms")) agent->readMs = value;
+        else if (!strcmp(name, "--block-ms")) chain->blockMs = value;
+        else if (!strcmp(name, "--tx-per-block")) chain->txPerBlock = value;
+        else if (!strcmp(name, "--rps")) chain->rpcPerSecond = value;
+        else if (!strcmp(name, "--workers")) chain->workers = value ? value : 1;
+        else if (!strcmp(name, "--rtt-ms")) chain->rttMs = value;
+        else {
+            fprintf(stderr, "unknown option %s\n", name);
+            return false;
+        }
+    }
+    return (argc % 2) == 1;
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    MockChainConfig chainConfig;
+    RegistryAgentConfig agentConfig = REGISTRY_DEFAULTS;
+    if (!parseArgs(argc, argv, &opt, &chainConfig, &agentConfig)) {
+        fprintf(stderr, "usage: see the header of fleet_sim.cpp\n");
+        return 2;
+    }
+
+    MockChain chain(chainConfig, opt.seed * 2654435761u);
+    std::vector<Device> devices(opt.devices);
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    uint32_t bootRng = opt.seed;
+
+    for (uint32_t i = 0; i < opt.devices; i++) {
+        char name[REGISTRY_NAME_MAX + 1];
+        char address[43];
+        snprintf(name, sizeof(name), "sim-%05u", i);
+        snprintf(address, sizeof(address), "0x%040x", i + 1);
+
+        devices[i].agent = new RegistryAgent(name, address, opt.seed * 7919 + i + 1, agentConfig);
+        bootRng = bootRng * 1103515245 + 12345;
+        uint64_t boot = opt.spreadMs ? (uint64_t)(bootRng >> 8) % opt.spreadMs * 1000 : 0;
+        devices[i].wakeQueuedUs = boot;
+        events.push({boot, i, false, REGISTRY_OK, 0});
+    }
+
+    std::vector<uint32_t> latencyMs[5];
+    std::string request;
+    uint32_t requestId = 0;
+    uint64_t calls[5] = {};
+    uint64_t endUs = (uint64_t)opt.seconds * 1000000;
+
+    while (!events.empty() && events.top().atUs <= endUs) {
+        Event ev = events.top();
+        events.pop();
+        Device& d = devices[ev.device];
+        uint32_t nowMs = (uint32_t)(ev.atUs / 1000);
+
+        if (ev.reply) {
+            latencyMs[d.call.type].push_back((uint32_t)((ev.atUs - d.sentUs) / 1000));
+            d.agent->complete(nowMs, ev.status, ev.value);
+        } else if (ev.atUs != d.wakeQueuedUs) {
+            continue;    // Superseded wake-up
+        } else if (d.agent->next(nowMs, &d.call)) {
+            calls[d.call.type]++;
+            d.sentUs = ev.atUs;
+            buildRequest(d.call, d.agent->address(), ++requestId, &request);
+            MockReply r = chain.handle(ev.atUs, request);
+            uint64_t value;
+            RegistryStatus status = RegistryAgent::interpret(d.call, r.response, &value);
+            events.push({r.arrivesUs, ev.device, true, status, value});
+            continue;
+        }
+
+        uint64_t wake = std::max<uint64_t>((uint64_t)d.agent->wakeAt() * 1000, ev.atUs);
+        d.wakeQueuedUs = wake;
+        events.push({wake, ev.device, false, REGISTRY_OK, 0});
+    }
+    chain.advance(endUs);
+
+    // ===== REPORT =====
+    double seconds = opt.seconds;
+    MockChainStats& s = chain.stats;
+    uint64_t backoffs = 0, backoffMs = 0, backedOff = 0, registered = 0;
+    uint32_t worstStreak = 0;
+    std::vector<uint32_t> registerMs;
+    for (Device& d : devices) {
+        backoffs += d.agent->backoffs();
+        backoffMs += d.agent->backoffMs();
+        backedOff += d.agent->backoffs() > 0;
+        worstStreak = std::max(worstStreak, d.agent->worstFailureStreak());
+        if (d.agent->registered()) {
+            registered++;
+            registerMs.push_back(d.agent->registeredTime());
+        }
+    }
+
+    printf("fleet: %u devices, %u s simulated, seed %u\n", opt.devices, opt.seconds, opt.seed);
+    printf("node:  %u ms blocks x %u tx, %u rpc/s limit, %u workers, %u ms rtt\n\n",
+           chainConfig.blockMs, chainConfig.txPerBlock, chainConfig.rpcPerSecond,
+           chainConfig.workers, chainConfig.rttMs);
+
+    printf("throughput\n");
+    printf("  rpc/s          %10.1f  (%llu requests)\n", s.requests / seconds, (unsigned long long)s.requests);
+    printf("  tx/s accepted  %10.1f\n", s.txAccepted / seconds);
+    printf("  tx/s mined     %10.1f  (%llu in %llu blocks, %llu reverted)\n", s.txMined / seconds,
+           (unsigned long long)s.txMined, (unsigned long long)s.blocks, (unsigned long long)s.reverts);
+    printf("  registry total %10llu\n\n", (unsigned long long)s.total);
+
+    printf("latency (ms)        calls      p50      p90      p99\n");
+    for (int t = 0; t < 5; t++) {
+        printf("  %-10s %12llu %8u %8u %8u\n", CALL_NAMES[t], (unsigned long long)calls[t],
+               percentile(latencyMs[t], 50), percentile(latencyMs[t], 90), percentile(latencyMs[t], 99));
+    }
+    printf("  %-10s %12zu %8u %8u %8u\n", "inclusion", s.inclusionMs.size(),
+           percentile(s.inclusionMs, 50), percentile(s.inclusionMs, 90), percentile(s.inclusionMs, 99));
+    printf("  %-10s %12zu %8u %8u %8u\n\n", "registered", registerMs.size(),
+           percentile(registerMs, 50), percentile(registerMs, 90), percentile(registerMs, 99));
+
+    printf("errors and backoff\n");
+    printf("  rate limited   %10llu\n", (unsigned long long)s.rateLimited);
+    printf("  mempool full   %10llu\n", (unsigned long long)s.mempoolFull);
+    printf("  nonce errors   %10llu\n", (unsigned long long)s.nonceErrors);
+    printf("  backoffs       %10llu  (%llu devices, %.1f s mean wait each, worst streak %u)\n",
+           (unsigned long long)backoffs, (unsigned long long)backedOff,
+           backoffs ? backoffMs / 1000.0 / backoffs : 0.0, worstStreak);
+    printf("  registered     %10llu / %u\n", (unsigned long long)registered, opt.devices);
+
+    for (Device& d : devices) {
+        delete d.agent;
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ * Mock Chain
+ *
+ * In-process stand-in for an EVM node running PolkaESPRegistry, modelled
+ * closely enough to load-test a fleet: per-sender nonces, a bounded
+ * mempool, blocks of limited size at a fixed interval, a provider rate
+ * limit, and RPC latency from network round trip plus queueing on a fixed
+ * number of server workers. Requests arrive as JSON-RPC bodies and calldata
+ * is decoded with the generated Polka32Abi bindings; replies are raw
+ * JSON-RPC, with the error codes and messages real providers use, so the
+ * agent's encoders and its reply classification are exercised too.
+ *
+ * Time is simulated (microseconds); nothing here sleeps.
+ */
+
+#ifndef MOCK_CHAIN_H
+#define MOCK_CHAIN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "abi/polka32.h"
+#include "registry_agent.h"
+
+struct MockChainConfig {
+    uint32_t blockMs = 6000;
+    uint32_t txPerBlock = 300;
+    uint32_t mempoolLimit = 4096;
+    uint32_t rpcPerSecond = 1000;     // Provider rate limit; 0 = unlimited
+    uint32_t rpcBurst = 200;
+    uint32_t workers = 32;            // Requests served concurrently
+    uint32_t serviceUs = 4000;        // Server time per request
+    uint32_t rttMs = 60;
+    uint32_t jitterMs = 40;
+};
+
+struct MockReply {
+    std::string response;            // Raw JSON-RPC reply
+    uint64_t arrivesUs;
+};
+
+struct MockChainStats {
+    uint64_t requests = 0;
+    uint64_t rateLimited = 0;
+    uint64_t nonceErrors = 0;
+    uint64_t mempoolFull = 0;
+    uint64_t txAccepted = 0;
+    uint64_t txMined = 0;
+    uint64_t reverts = 0;
+    uint64_t blocks = 0;
+    uint64_t total = 0;              // Registry.total()
+    std::vector<uint32_t> inclusionMs;
+};
+
+class MockChain {
+public:
+    MockChain(const MockChainConfig& config, uint32_t seed)
+        : cfg(config), rng(seed ? seed : 1), tokens(config.rpcBurst), refilledUs(0),
+          nextBlockUs((uint64_t)config.blockMs * 1000), busyUntil(config.workers, 0) {}
+
+    // Mine every block due up to now
+    void advance(uint64_t nowUs) {
+        while (nextBlockUs <= nowUs) {
+            mine(nextBlockUs);
+            nextBlockUs += (uint64_t)cfg.blockMs * 1000;
+        }
+    }
+
+    // request is a JSON-RPC body: eth_getTransactionCount, eth_call, or
+    // eth_sendTransaction with from, nonce and data (unsigned, since the
+    // mock has no keys to check)
+    MockReply handle(uint64_t nowUs, const std::string& request) {
+        advance(nowUs);
+        stats.requests++;
+
+        MockReply reply;
+        unsigned long id = strtoul(field(request, "\"id\":").c_str(), nullptr, 10);
+        uint64_t network = ((uint64_t)cfg.rttMs + random32() % (cfg.jitterMs + 1)) * 1000;
+
+        // Rejected at the edge: no server time, just the round trip. Providers
+        // differ in how they say so.
+        if (!takeToken(nowUs)) {
+            stats.rateLimited++;
+            reply.response = random32() & 1 ? error(id, -32005, "rate limit exceeded")
+                                            : error(id, -32029, "too many requests");
+            reply.arrivesUs = nowUs + network;
+            return reply;
+        }
+
+        // Earliest free worker serves the request
+        auto worker = std::min_element(busyUntil.begin(), busyUntil.end());
+        uint64_t start = std::max(*worker, nowUs + network / 2);
+        *worker = start + cfg.serviceUs;
+        reply.arrivesUs = *worker + network / 2;
+
+        std::string method = field(request, "\"method\":\"");
+        if (method == "eth_getTransactionCount") {
+            // ["0x<address>","pending"|"latest"]
+            std::string params = request.substr(request.find("\"params\":"));
+            Account& account = accounts[field(params, "[\"")];
+            bool pending = params.find("\"pending\"") != std::string::npos;
+            reply.response = quantity(id, pending ? account.pending : account.mined);
+        } else if (method == "eth_call") {
+            reply.response = call(id, field(request, "\"data\":\""));
+        } else if (method == "eth_sendTransaction") {
+            uint64_t nonce = UINT64_MAX;
+            std::string hex = field(request, "\"nonce\":\"0x");
+            Hex::word(hex.c_str(), hex.size(), &nonce);
+            reply.response = submit(id, nowUs, accounts[field(request, "\"from\":\"")], nonce,
+                                    field(request, "\"data\":\""));
+        } else {
+            reply.response = error(id, -32601, "method not found");
+        }
+        return reply;
+    }
+
+    MockChainStats stats;
+
+private:
+    struct Account {
+        uint32_t pending = 0;    // Next nonce the mempool accepts
+        uint32_t mined = 0;      // Transactions included so far
+        std::vector<std::string> devices;
+        uint32_t lastPing = 0;
+    };
+
+    struct Tx {
+        Account* account;
+        bool add;
+        std::string name;
+        uint64_t index;
+        uint64_t submittedUs;
+    };
+
+    MockChainConfig cfg;
+    uint32_t rng;
+    double tokens;
+    uint64_t refilledUs;
+    uint64_t nextBlockUs;
+    std::vector<uint64_t> busyUntil;
+    std::unordered_map<std::string, Account> accounts;
+    std::deque<Tx> mempool;
+
+    uint32_t random32() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    bool takeToken(uint64_t nowUs) {
+        if (cfg.rpcPerSecond == 0) {
+            return true;
+        }
+        tokens = std::min<double>(cfg.rpcBurst, tokens + (nowUs - refilledUs) * cfg.rpcPerSecond / 1e6);
+        refilledUs = nowUs;
+        if (tokens < 1) {
+            return false;
+        }
+        tokens -= 1;
+        return true;
+    }
+
+    // Text after key up to the next quote, comma or bracket
+    static std::string field(const std::string& json, const char* key) {
+        size_t at = json.find(key);
+        if (at == std::string::npos) {
+            return std::string();
+        }
+        at += strlen(key);
+        return json.substr(at, json.find_first_of("\",]}", at) - at);
+    }
+
+    static std::string error(unsigned long id, int code, const char* message) {
+        char out[160];
+        snprintf(out, sizeof(out), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"error\":{\"code\":%d,\"message\":\"%s\"}}",
+                 id, code, message);
+        return out;
+    }
+
+    static std::string quantity(unsigned long id, uint64_t value) {
+        char out[96];
+        snprintf(out, sizeof(out), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"result\":\"0x%llx\"}", id,
+                 (unsigned long long)value);
+        return out;
+    }
+
+    // Selector of 0x-prefixed calldata, and a reader over its arguments
+    static bool decodeCall(const std::string& data, uint32_t* selector, AbiReader* args) {
+        uint64_t sel;
+        if (data.size() < 10 || data.compare(0, 2, "0x") != 0 || !Hex::word(data.c_str() + 2, 8, &sel)) {
+            return false;
+        }
+        *selector = (uint32_t)sel;
+        *args = AbiReader(data.c_str() + 10, data.size() - 10);
+        return true;
+    }
+
+    // get(address): the account's Device[] as (string name, uint256 lastPing)
+    std::string call(unsigned long id, const std::string& data) {
+        uint32_t selector;
+        AbiReader args;
+        char owner[43];
+        if (!decodeCall(data, &selector, &args) || selector != Polka32Abi::GET || !args.address(0, owner)) {
+            return error(id, 3, "execution reverted");
+        }
+        const Account& account = accounts[owner];
+
+        size_t n = account.devices.size();
+        std::vector<char> out(96 + (3 + n * 5) * ABI_WORD_HEX);
+        int head = snprintf(out.data(), out.size(), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"result\":\"0x", id);
+        AbiWriter w(out.data() + head, out.size() - head - 3);
+        w.uint((uint64_t)0x20);
+        w.uint((uint64_t)n);
+        size_t tail = n * 32;
+        for (const std::string& name : account.devices) {
+            w.uint((uint64_t)tail);
+            tail += 64 + AbiWriter::dynamicSize(name.size());
+        }
+        for (const std::string& name : account.devices) {
+            w.uint((uint64_t)0x40);
+            w.uint((uint64_t)account.lastPing);
+            w.dynamic((const uint8_t*)name.data(), name.size());
+        }
+        size_t len = w.finish();
+        return std::string(out.data(), head + len) + "\"}";
+    }
+
+    std::string submit(unsigned long id, uint64_t nowUs, Account& account, uint64_t nonce, const std::string& data) {
+        if (nonce != account.pending) {
+            stats.nonceErrors++;
+            return error(id, -32000, nonce < account.pending ? "nonce too low" : "nonce too high");
+        }
+        if (mempool.size() >= cfg.mempoolLimit) {
+            stats.mempoolFull++;
+            return error(id, -32000, "txpool is full");
+        }
+
+        uint32_t selector;
+        AbiReader args;
+        Tx tx = {&account, false, std::string(), 0, nowUs};
+        if (!decodeCall(data, &selector, &args)) {
+            return error(id, -32602, "invalid calldata");
+        }
+        if (selector == Polka32Abi::ADD) {
+            char name[REGISTRY_NAME_MAX + 1];
+            size_t length;
+            if (!args.string(0, name, sizeof(name), &length) || length > REGISTRY_NAME_MAX) {
+                return error(id, -32602, "invalid calldata");
+            }
+            tx.add = true;
+            tx.name = name;
+        } else if (selector != Polka32Abi::PING || !args.uint(0, &tx.index)) {
+            return error(id, -32602, "invalid calldata");
+        }
+
+        account.pending++;
+        mempool.push_back(tx);
+        stats.txAccepted++;
+        char hash[140];
+        snprintf(hash, sizeof(hash), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"result\":\"0x%064llx\"}", id,
+                 (unsigned long long)stats.txAccepted);
+        return hash;
+    }
+
+    void mine(uint64_t blockUs) {
+        stats.blocks++;
+        for (uint32_t n = 0; n < cfg.txPerBlock && !mempool.empty(); n++) {
+            Tx tx = mempool.front();
+            mempool.pop_front();
+
+            Account& a = *tx.account;
+            a.mined++;
+            stats.txMined++;
+            stats.inclusionMs.push_back((uint32_t)((blockUs - tx.submittedUs) / 1000));
+
+            if (tx.add) {
+                a.devices.push_back(tx.name);
+                stats.total++;
+            } else if (tx.index < a.devices.size()) {
+                a.lastPing = (uint32_t)(blockUs / 1000000);
+            } else {
+                stats.reverts++;     // ping() past the end of devices[]
+            }
+        }
+    }
+};
+
+#endif // MOCK_CHAIN_H
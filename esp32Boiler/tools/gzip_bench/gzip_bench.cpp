@@ -0,0 +1,279 @@
+/*
+ * Compressed RPC Transport Test
+ *
+ * Runs src/gzip_inflate.cpp against a local stand-in for an RPC node that
+ * serves the replies the firmware fetches (eth_getLogs for the holder
+ * snapshot, Polka32 Device[] reads, receipts) either plain or gzipped, the
+ * way a node behind nginx or a provider CDN does. Bodies are delivered in
+ * TCP-sized pieces and in odd small ones, as HTTPClient hands them over.
+ *
+ * Per payload it reports bytes on the wire both ways, the transfer time
+ * that saves at a given link rate and the cost of inflating, and checks
+ * that every inflated reply matches the original byte for byte. Broken
+ * streams (truncated, corrupt, oversized, optional header fields) must be
+ * detected. Exits non-zero if a check fails.
+ *
+ * Build and run on the host (zlib stands in for the ROM decoder, so the
+ * inflate times only compare payloads with each other, not with the ESP32):
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src gzip_bench.cpp ../../src/gzip_inflate.cpp -lz -o gzip_bench
+ *   ./gzip_bench --level 6 --kbps 2000
+ *
+ * Options (defaults in brackets):
+ *   --level N     server gzip level, 1-9 [6]
+ *   --kbps N      link rate for the transfer time estimate [2000]
+ *   --seed N      [1]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gzip_inflate.h"
+
+#define RPC_INFLATE_MAX 65536           // As in src/rpc_client.h
+
+// ===== STAND-IN NODE =====
+static uint64_t rngState = 1;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static std::string randomHex(size_t digits) {
+    static const char HEX[] = "0123456789abcdef";
+    std::string s = "0x";
+    for (size_t i = 0; i < digits; i++) {
+        s += HEX[nextRandom() & 15];
+    }
+    return s;
+}
+
+static std::string quantity(uint64_t v) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "\"0x%llx\"", (unsigned long long)v);
+    return buf;
+}
+
+static std::string word(uint64_t v) {
+    char buf[72];
+    snprintf(buf, sizeof(buf), "0x%064llx", (unsigned long long)v);
+    return buf;
+}
+
+static std::string addressTopic() {
+    return "0x000000000000000000000000" + randomHex(40).substr(2);
+}
+
+// One ERC-721 Transfer log as eth_getLogs and receipts return it
+static std::string transferLog(const std::string& contract, uint64_t block, const std::string& blockHash,
+                               const std::string& txHash, size_t index) {
+    return "{\"address\":\"" + contract + "\",\"topics\":[\"" +
+           "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef\",\"" + addressTopic() + "\",\"" +
+           addressTopic() + "\",\"" + word(nextRandom() % 5000) + "\"],\"data\":\"0x\",\"blockNumber\":" +
+           quantity(block) + ",\"transactionHash\":\"" + txHash + "\",\"transactionIndex\":" +
+           quantity(nextRandom() % 200) + ",\"blockHash\":\"" + blockHash + "\",\"logIndex\":" + quantity(index) +
+           ",\"removed\":false}";
+}
+
+static std::string logsReply(size_t n) {
+    std::string contract = randomHex(40);
+    std::string reply = "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":[";
+    uint64_t block = 6000000;
+    std::string blockHash = randomHex(64);
+    for (size_t i = 0; i < n; i++) {
+        if (nextRandom() % 3 == 0) {
+            block += 1 + nextRandom() % 40;
+            blockHash = randomHex(64);
+        }
+        reply += (i ? "," : "") + transferLog(contract, block, blockHash, randomHex(64), i);
+    }
+    return reply + "]}";
+}
+
+static std::string receiptReply(size_t logs) {
+    std::string contract = randomHex(40);
+    std::string blockHash = randomHex(64);
+    std::string txHash = randomHex(64);
+    std::string reply = "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"blockHash\":\"" + blockHash +
+                        "\",\"blockNumber\":\"0x5b8d80\",\"contractAddress\":null,\"cumulativeGasUsed\":\"0x1c9c380\"," +
+                        "\"effectiveGasPrice\":\"0x3b9aca07\",\"from\":\"" + randomHex(40) +
+                        "\",\"gasUsed\":\"0x1d4c0\",\"logs\":[";
+    for (size_t i = 0; i < logs; i++) {
+        reply += (i ? "," : "") + transferLog(contract, 6000000, blockHash, txHash, i);
+    }
+    return reply + "],\"logsBloom\":\"" + randomHex(512) + "\",\"status\":\"0x1\",\"to\":\"" + contract +
+           "\",\"transactionHash\":\"" + txHash + "\",\"transactionIndex\":\"0x2a\",\"type\":\"0x2\"}}";
+}
+
+// Polka32.get(address): Device[] of (string name, uint256 time), ABI-encoded
+static std::string devicesReply(size_t n) {
+    std::string hex = word(0x20).substr(2) + word(n).substr(2);
+    size_t offset = n * 32;
+    for (size_t i = 0; i < n; i++) {
+        hex += word(offset).substr(2);
+        offset += 32 * 4;
+    }
+    for (size_t i = 0; i < n; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "device-%04zu", i);
+        std::string data;
+        for (const char* c = name; *c; c++) {
+            char b[3];
+            snprintf(b, sizeof(b), "%02x", (unsigned char)*c);
+            data += b;
+        }
+        data.resize(64, '0');
+        hex += word(0x40).substr(2) + word(1700000000 + nextRandom() % 1000000).substr(2) +
+               word(strlen(name)).substr(2) + data;
+    }
+    return "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"0x" + hex + "\"}";
+}
+
+// The stand-in's Content-Encoding: gzip body
+static std::string gzipBody(const std::string& body, int level) {
+    z_stream s = {};
+    deflateInit2(&s, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&s, body.size()), '\0');
+    s.next_in = (Bytef*)body.data();
+    s.avail_in = body.size();
+    s.next_out = (Bytef*)&out[0];
+    s.avail_out = out.size();
+    deflate(&s, Z_FINISH);
+    out.resize(s.total_out);
+    deflateEnd(&s);
+    return out;
+}
+
+// ===== CLIENT SIDE =====
+// Feeds a body the way the network delivers it; 0 = random 1..64 byte pieces
+static bool receive(const std::string& wire, size_t piece, std::string* out, size_t maxOutput = RPC_INFLATE_MAX) {
+    GzipInflater gz(out, maxOutput);
+    size_t at = 0;
+    while (at < wire.size()) {
+        size_t n = piece ? piece : 1 + nextRandom() % 64;
+        n = std::min(n, wire.size() - at);
+        if (!gz.feed((const uint8_t*)wire.data() + at, n)) {
+            return false;
+        }
+        at += n;
+    }
+    return gz.finished() && gz.consumed() == wire.size();
+}
+
+static double inflateUs(const std::string& wire) {
+    std::string out;
+    size_t rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::micro> elapsed{};
+    do {
+        receive(wire, 1436, &out);
+        rounds++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 50e3);
+    return elapsed.count() / rounds;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+int main(int argc, char** argv) {
+    int level = 6;
+    double kbps = 2000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--level")) {
+            level = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--kbps")) {
+            kbps = atof(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--seed")) {
+            rngState = strtoull(argv[i + 1], nullptr, 10) | 1;
+        }
+    }
+
+    struct Payload {
+        const char* name;
+        std::string body;
+    };
+    std::vector<Payload> payloads = {
+        {"getLogs x10", logsReply(10)},     {"getLogs x50", logsReply(50)},
+        {"getLogs x100", logsReply(100)},   {"receipt 1 log", receiptReply(1)},
+        {"receipt 8 logs", receiptReply(8)}, {"Device[] x10", devicesReply(10)},
+        {"Device[] x100", devicesReply(100)},
+    };
+
+    printf("gzip level %d, link %.0f kbit/s\n", level, kbps);
+    printf("%-15s %9s %9s %6s | %9s %9s | %10s %8s\n", "payload", "plain B", "gzip B", "ratio", "plain ms",
+           "gzip ms", "inflate us", "MB/s");
+    for (const Payload& p : payloads) {
+        std::string wire = gzipBody(p.body, level);
+
+        // The same body in MSS-sized segments, tiny pieces and all at once
+        const size_t pieces[] = {1436, 0, wire.size()};
+        for (size_t piece : pieces) {
+            std::string out = "stale reply";
+            check(receive(wire, piece, &out) && out == p.body, p.name);
+        }
+
+        double us = inflateUs(wire);
+        double plainMs = p.body.size() * 8 / kbps;
+        double gzipMs = wire.size() * 8 / kbps;
+        printf("%-15s %9zu %9zu %5.1fx | %9.1f %9.1f | %10.1f %8.1f\n", p.name, p.body.size(), wire.size(),
+               (double)p.body.size() / wire.size(), plainMs, gzipMs, us, p.body.size() / us);
+    }
+
+    // ===== BROKEN STREAMS =====
+    std::string body = logsReply(20);
+    std::string wire = gzipBody(body, level);
+    std::string out;
+
+    check(!receive(wire.substr(0, wire.size() - 5), 1436, &out), "truncated trailer accepted");
+    check(!receive(wire.substr(0, wire.size() / 2), 1436, &out) && out.size() < body.size(),
+          "truncated body accepted");
+
+    std::string corrupt = wire;
+    corrupt[corrupt.size() - 2] ^= 0x01;             // ISIZE
+    check(!receive(corrupt, 1436, &out) && out.empty(), "wrong length accepted");
+
+    corrupt = wire;
+    corrupt[0] = 0x1E;
+    check(!receive(corrupt, 1436, &out), "bad magic accepted");
+
+    corrupt = wire;
+    for (size_t i = 20; i < 40; i++) {
+        corrupt[i] = (char)0xFF;
+    }
+    check(!receive(corrupt, 1436, &out), "corrupt deflate data accepted");
+
+    // 4 MB of zeros gzips to a few KB; must stop at the output limit
+    std::string bomb = gzipBody(std::string(4 << 20, '0'), 9);
+    check(!receive(bomb, 1436, &out) && out.empty(), "decompression bomb not bounded");
+    check(receive(wire, 1436, &out, body.size()) && out == body, "reply exactly at the limit refused");
+
+    // FEXTRA, FNAME, FCOMMENT and FHCRC before the deflate data
+    std::string fields = wire.substr(0, 10);
+    fields[3] = 0x1E;
+    fields += std::string("\x04\x00" "abcd", 6) + std::string("reply.json\0", 11) + std::string("note\0", 5) +
+              std::string("\x12\x34", 2) + wire.substr(10);
+    check(receive(fields, 0, &out) && out == body, "optional header fields");
+
+    // Plain replies are not run through the inflater at all, but a server
+    // mislabelling one must not pass as gzip
+    check(!receive(body, 1436, &out), "plain body accepted as gzip");
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
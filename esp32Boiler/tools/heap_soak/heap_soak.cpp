@@ -0,0 +1,596 @@
+/*
+ * Heap Soak
+ *
+ * Runs the firmware's soak (runSoakTest() in src/main.cpp) and the door's
+ * request handlers (examples/security_door/blockchain_door.cpp) on the
+ * host, both compiled in unchanged, against a stand-in node on loopback.
+ * The firmware side repeats queryBalance(), eth_blockNumber,
+ * readStoredValue(), the ERC-20 name/decimals/balanceOf reads and the
+ * sign-and-recover check; the door side repeats GET /api/getChallenge,
+ * a personal_sign answer to it on /api/checkSignature, and /api/status
+ * over a real socket to the door's AsyncHttpServer, with the deferred
+ * handler run from this thread the way loop() would.
+ *
+ * malloc, calloc and realloc are replaced so that every allocation goes
+ * through heap_monitor.cpp's counting wrappers and the bytes in use feed
+ * host_shim/esp_heap_caps.h: HeapMonitor then reports allocations per
+ * run, peak use and leaks exactly as the esp32dev-soak build does. The
+ * stand-in node's threads and the test's own signing are not counted.
+ * Fragmentation is not modelled on the host and always reads 0%.
+ *
+ * Door decisions are dropped from the access queue instead of written to
+ * the flash log, which grows by design and would read as a leak.
+ *
+ * Exits non-zero if either monitor reports a failed run or a budget
+ * overrun.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -pthread -DHEAP_MONITOR_WRAP -I../host_shim -I../../src heap_soak.cpp \
+ *       ../../src/heap_monitor.cpp ../../src/rpc_client.cpp ../../src/gzip_inflate.cpp \
+ *       ../../src/serial_commands.cpp ../../src/signer_pool.cpp ../../src/meta_tx.cpp \
+ *       ../eip712_bench/host_signer.cpp \
+ *       ../../examples/security_door/access_log.cpp ../../examples/security_door/async_http_server.cpp \
+ *       ../../examples/security_door/challenge_table.cpp ../../examples/security_door/holder_snapshot.cpp \
+ *       ../../examples/security_door/sig_guard.cpp -lz -lcrypto -o heap_soak
+ *   ./heap_soak
+ *
+ * Add -DSOAK_ITERATIONS=N for a longer run (default 1000 per operation).
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <malloc.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <esp_heap_caps.h>
+
+// ===== COUNTING MALLOC =====
+// Threads that are the test rather than the code under test (the node,
+// the signing below) set this so their allocations stay out of the counts
+static thread_local bool untracked = false;
+
+struct Untracked {
+    bool was;
+    Untracked() : was(untracked) { untracked = true; }
+    ~Untracked() { untracked = was; }
+};
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* p);
+
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t n, size_t size);
+void* __wrap_realloc(void* p, size_t size);
+
+static void* taken(void* p) {
+    if (p != nullptr) {
+        hostHeapTake(malloc_usable_size(p));
+    }
+    return p;
+}
+
+void* __real_malloc(size_t size) { return taken(__libc_malloc(size)); }
+void* __real_calloc(size_t n, size_t size) { return taken(__libc_calloc(n, size)); }
+
+void* __real_realloc(void* p, size_t size) {
+    size_t before = p ? malloc_usable_size(p) : 0;
+    void* q = __libc_realloc(p, size);
+    if (q != nullptr || size == 0) {
+        hostHeapGive(before);
+        taken(q);
+    }
+    return q;
+}
+
+void* malloc(size_t size) { return untracked ? __libc_malloc(size) : __wrap_malloc(size); }
+void* calloc(size_t n, size_t size) { return untracked ? __libc_calloc(n, size) : __wrap_calloc(n, size); }
+void* realloc(void* p, size_t size) { return untracked ? __libc_realloc(p, size) : __wrap_realloc(p, size); }
+
+void free(void* p) {
+    if (p != nullptr && !untracked) {
+        hostHeapGive(malloc_usable_size(p));
+    }
+    __libc_free(p);
+}
+
+// Aligned allocations are rare (OpenSSL, libstdc++ over-aligned new); they
+// are counted in bytes but not as allocations
+void* memalign(size_t alignment, size_t size) {
+    void* p = __libc_memalign(alignment, size);
+    return untracked ? p : taken(p);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) { return memalign(alignment, size); }
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    void* p = memalign(alignment, size);
+    if (p == nullptr) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+void* valloc(size_t size) { return memalign(sysconf(_SC_PAGESIZE), size); }
+void* pvalloc(size_t size) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    return memalign(page, (size + page - 1) / page * page);
+}
+}
+
+// ===== FIRMWARE AND DOOR =====
+// Every header the two sketches include is pulled in here first, so inside
+// the namespaces below their include guards leave only the sketches' own
+// definitions. Both are compiled as they are; the defines replace their
+// placeholders with a test key pair and a loopback port.
+#include <Contract.h>
+#include <Crypto.h>
+#include <LittleFS.h>
+#include <Util.h>
+#include <WiFi.h>
+#include <Web3.h>
+
+#include "../../examples/security_door/access_log.h"
+#include "../../examples/security_door/async_http_server.h"
+#include "../../examples/security_door/challenge_table.h"
+#include "../../examples/security_door/door_page.h"
+#include "../../examples/security_door/holder_snapshot.h"
+#include "../../examples/security_door/sig_guard.h"
+#include "abi/access_log_anchor.h"
+#include "abi/erc20.h"
+#include "abi/erc721.h"
+#include "abi/simple_storage.h"
+#include "amount.h"
+#include "arena.h"
+#include "boot_profile.h"
+#include "eip712.h"
+#include "heap_monitor.h"
+#include "hex.h"
+#include "meta_tx.h"
+#include "read_cache.h"
+#include "rpc_client.h"
+#include "sensor_pipeline.h"
+#include "serial_commands.h"
+#include "signer_pool.h"
+#include "tls_resume.h"
+#include "tls_standin.h"
+#include "uint256.h"
+#include "voucher.h"
+
+#define MY_ADDRESS "0x2c7536e3605d9c16a7a3d7b1898e529396a65c23"
+#define PRIVATE_KEY "4c0883a69102937d6231471b5dbb6204fe5129617082792ae468d01a3f362318"
+#define SERVER_PORT 18081
+
+namespace firmware {
+#include "../../src/main.cpp"
+}
+
+// The door sketch relies on the prototypes the Arduino builder generates
+namespace door {
+void setupHardware();
+void setupWiFi();
+void setupWebServer();
+void handleRoot(const HttpRequest& request, HttpResponse& response);
+void handleGetChallenge(const HttpRequest& request, HttpResponse& response);
+void handleCheckSignature(const HttpRequest& request, HttpResponse& response);
+void handleProof(const HttpRequest& request, HttpResponse& response);
+void handleStatus(const HttpRequest& request, HttpResponse& response);
+bool checkAccessToken(const char* userAddress);
+bool queryTokenBalance(const char* userAddress, bool* hasToken);
+void queueAccess(bool granted, const char* userAddress);
+void processAccessEvents();
+void logAccess(bool granted, const char* userAddress);
+void anchorAccessLog();
+void publishChallenges();
+void grantAccess(const String& userAddress);
+void denyAccess(const String& userAddress);
+void openDoor();
+void closeDoor();
+void signalAccess(bool granted);
+
+#include "../../examples/security_door/blockchain_door.cpp"
+}
+
+// Door visitor: holds a token per the stand-in node
+#define VISITOR_KEY "8da4ef21b864d2cc526dbdb2a120bd2874c36c9d0a1fb7f8c63d7f7a8b41de8f"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// ===== CRYPTO =====
+// Web3E's personal_sign pair, on the host Eip712Signer
+static void personalHash(const std::string& message, uint8_t digest[32]) {
+    std::string prefixed = "\x19" "Ethereum Signed Message:\n" + std::to_string(message.size()) + message;
+    Crypto::Keccak256((const uint8_t*)prefixed.data(), prefixed.size(), digest);
+}
+
+std::string Crypto::Sign(std::string* privateKey, std::string* message) {
+    Eip712Signer signer;
+    uint8_t digest[32], sig[65];
+    personalHash(*message, digest);
+    if (!signer.begin(privateKey->c_str()) || !signer.sign(digest, sig)) {
+        throw std::runtime_error("signing failed");
+    }
+    char text[2 * 65 + 3];
+    return Hex::format(sig, 65, text, sizeof(text));
+}
+
+std::string Crypto::ECRecoverFromPersonalMessage(std::string* signature, std::string* message) {
+    uint8_t digest[32], sig[65], addr[20];
+    if (signature->size() != 2 * 65 + 2 || !Hex::decode(signature->c_str() + 2, sig, 65)) {
+        return "";
+    }
+    personalHash(*message, digest);
+    if (!Eip712Signer::recover(digest, sig, addr)) {
+        return "";
+    }
+    char text[HEX_ADDRESS_CHARS];
+    return Hex::format(addr, 20, text, sizeof(text));
+}
+
+// ===== NODE =====
+#define NODE_BLOCK 0x4b2a10
+
+// The ABI encoding of a string return value
+static std::string abiString(const char* s) {
+    char word[65];
+    std::string out = "0x";
+    snprintf(word, sizeof(word), "%064x", 32);
+    out += word;
+    snprintf(word, sizeof(word), "%064zx", strlen(s));
+    out += word;
+    char data[65] = {0};
+    Hex::encode((const uint8_t*)s, strlen(s), data);
+    out += data;
+    out.append(64 - strlen(data), '0');
+    return out;
+}
+
+static std::string nodeReply(const std::string& body) {
+    unsigned long id = strtoul(body.c_str() + body.find("\"id\":") + 5, nullptr, 10);
+    char prefix[48];
+    snprintf(prefix, sizeof(prefix), "{\"jsonrpc\":\"2.0\",\"id\":%lu,", id);
+
+    char word[67];
+    std::string result;
+    if (body.find("\"eth_blockNumber\"") != std::string::npos) {
+        snprintf(word, sizeof(word), "0x%x", NODE_BLOCK);
+        result = word;
+    } else if (body.find("\"eth_getBalance\"") != std::string::npos) {
+        result = "0xde0b6b3a7640000";                          // 1 ETH
+    } else if (body.find("\"eth_getTransactionCount\"") != std::string::npos) {
+        result = "0x7";
+    } else if (body.find("\"eth_call\"") != std::string::npos) {
+        size_t at = body.find("\"data\":\"0x");
+        uint32_t selector = at == std::string::npos ? 0 : strtoul(body.substr(at + 10, 8).c_str(), nullptr, 16);
+        if (selector == SimpleStorageAbi::RETRIEVE) {
+            snprintf(word, sizeof(word), "0x%064x", 42);
+            result = word;
+        } else if (selector == Erc20Abi::NAME) {
+            result = abiString("Soak Token");
+        } else if (selector == Erc20Abi::DECIMALS) {
+            snprintf(word, sizeof(word), "0x%064x", 18);
+            result = word;
+        } else if (selector == Erc20Abi::BALANCE_OF) {            // ERC-721 shares the selector
+            snprintf(word, sizeof(word), "0x%048x%016llx", 0, 1000000000000000000ULL);
+            result = word;
+        }
+    }
+    if (result.empty()) {
+        return prefix + std::string("\"error\":{\"code\":-32601,\"message\":\"method not found\"}}");
+    }
+    return prefix + std::string("\"result\":\"") + result + "\"}";
+}
+
+static void serve(int fd) {
+    untracked = true;
+    std::string in;
+    char buf[2048];
+    for (;;) {
+        size_t headEnd;
+        while ((headEnd = in.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                close(fd);
+                return;
+            }
+            in.append(buf, n);
+        }
+        size_t lengthAt = in.find("Content-Length: ");
+        size_t bodyLen = lengthAt < headEnd ? strtoul(in.c_str() + lengthAt + 16, nullptr, 10) : 0;
+        while (in.size() < headEnd + 4 + bodyLen) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                close(fd);
+                return;
+            }
+            in.append(buf, n);
+        }
+        std::string reply = nodeReply(in.substr(headEnd + 4, bodyLen));
+        in.erase(0, headEnd + 4 + bodyLen);
+
+        char head[128];
+        int headLen = snprintf(head, sizeof(head),
+                               "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n",
+                               reply.size());
+        std::string out = std::string(head, headLen) + reply;
+        if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) {
+            close(fd);
+            return;
+        }
+    }
+}
+
+static void startNode(char* url, size_t len) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+        perror("stand-in node");
+        exit(1);
+    }
+    socklen_t addrLen = sizeof(addr);
+    getsockname(listener, (sockaddr*)&addr, &addrLen);
+    snprintf(url, len, "http://127.0.0.1:%u/", ntohs(addr.sin_port));
+    Untracked scope;
+    std::thread([listener] {
+        untracked = true;
+        for (;;) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                std::thread(serve, fd).detach();
+            }
+        }
+    }).detach();
+}
+
+// ===== FIRMWARE SOAK =====
+// runSoakTest() prints every operation's output; only the progress lines,
+// the monitor's table and the first errors are shown
+static bool soakFirmware(const char* url) {
+    firmware::web3 = new Web3(SEPOLIA_ID);
+    firmware::rpc.addEndpoint(url);
+
+    fflush(stdout);
+    FILE* log = tmpfile();
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(log), STDOUT_FILENO);
+    bool pass = firmware::runSoakTest();
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    printf("Firmware reads:\n");
+    rewind(log);
+    char line[512];
+    bool table = false;
+    int errors = 0;
+    while (fgets(line, sizeof(line), log)) {
+        table = table || strncmp(line, "op ", 3) == 0;
+        bool error = strstr(line, "Error") != nullptr || strstr(line, "failed") != nullptr;
+        if (table || strncmp(line, "[soak]", 6) == 0 || strncmp(line, "Free heap", 9) == 0 ||
+            (error && errors++ < 5)) {
+            fputs(line, stdout);
+        }
+        table = table && strncmp(line, "SOAK ", 5) != 0;
+    }
+    fclose(log);
+    return pass;
+}
+
+// ===== DOOR SOAK =====
+// Allocations per request, the server's own included; challenge and status
+// are served from the stack and the HTTP arena, so none is allowed there
+#define DOOR_ALLOC_CHALLENGE 0
+#define DOOR_ALLOC_SIGNATURE 200    // Measured 147: the balanceOf read through Web3 and RpcClient
+#define DOOR_ALLOC_STATUS 0
+#define REPLY_WAIT_MS 5000
+
+static RpcClient nodeRpc;           // The door's Web3 reads go here
+
+static int doorFd = -1;
+static char replyBuf[4096];
+static int replyStatus;
+static const char* replyBody;
+
+static int openConnection() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(SERVER_PORT);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// One keep-alive GET; deferred handlers run here while the reply is
+// pending, as loop() runs them on the device. Allocates nothing itself.
+static bool sendRequest(const char* target) {
+    char request[512];
+    int len = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: door.local\r\n\r\n", target);
+    if (doorFd < 0) {
+        doorFd = openConnection();
+    }
+    if (doorFd < 0 || send(doorFd, request, len, MSG_NOSIGNAL) != len) {
+        return false;
+    }
+
+    size_t have = 0;
+    for (int waited = 0; waited < REPLY_WAIT_MS; waited++) {
+        door::server.handleDeferred();
+        pollfd p = {doorFd, POLLIN, 0};
+        if (poll(&p, 1, 1) <= 0) {
+            continue;
+        }
+        ssize_t n = recv(doorFd, replyBuf + have, sizeof(replyBuf) - 1 - have, 0);
+        if (n <= 0) {
+            return false;
+        }
+        have += n;
+        replyBuf[have] = '\0';
+        char* headEnd = strstr(replyBuf, "\r\n\r\n");
+        if (headEnd == nullptr) {
+            continue;
+        }
+        const char* length = strstr(replyBuf, "Content-Length: ");
+        size_t bodyLen = length && length < headEnd ? strtoul(length + 16, nullptr, 10) : 0;
+        if (have < (size_t)(headEnd + 4 - replyBuf) + bodyLen) {
+            continue;
+        }
+        replyStatus = atoi(replyBuf + 9);
+        replyBody = headEnd + 4;
+        const char* closing = strstr(replyBuf, "Connection: close");
+        if (closing && closing < headEnd) {
+            close(doorFd);
+            doorFd = -1;
+        }
+        return true;
+    }
+    return false;
+}
+
+// A connection the server dropped between requests is reopened once
+static bool get(const char* target) {
+    if (sendRequest(target)) {
+        return true;
+    }
+    if (doorFd >= 0) {
+        close(doorFd);
+        doorFd = -1;
+    }
+    return sendRequest(target);
+}
+
+static char challengeId[12];
+static char challengeText[CHALLENGE_TEXT_LEN];
+static char checkTarget[320];
+
+static bool askChallenge() {
+    if (!get("/api/getChallenge") || replyStatus != 200) {
+        return false;
+    }
+    return sscanf(replyBody, "{\"id\":\"%11[0-9a-f]\",\"challenge\":\"%47[^\"]\"}", challengeId, challengeText) == 2;
+}
+
+static bool checkSignature() {
+    if (!get(checkTarget)) {
+        return false;
+    }
+    bool pass = replyStatus == 200 && strcmp(replyBody, "pass") == 0;
+    door::accessHead = door::accessCount = 0;   // Decisions are not logged during the soak
+    return pass;
+}
+
+static bool askStatus() {
+    return get("/api/status") && replyStatus == 200 && strstr(replyBody, "Door Status") != nullptr;
+}
+
+// The visitor's personal_sign answer to the current challenge
+static void answerChallenge(const Eip712Signer& visitor) {
+    Untracked scope;
+    uint8_t digest[32], sig[65];
+    personalHash(challengeText, digest);
+    visitor.sign(digest, sig);
+    char sigText[2 * 65 + 3], addrText[HEX_ADDRESS_CHARS];
+    snprintf(checkTarget, sizeof(checkTarget), "/api/checkSignature?sig=%s&addr=%s&id=%s",
+             Hex::format(sig, 65, sigText, sizeof(sigText)),
+             Hex::format(visitor.address(), 20, addrText, sizeof(addrText)), challengeId);
+}
+
+static bool soakDoor(const char* url) {
+    fflush(stdout);
+    FILE* log = tmpfile();
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(log), STDOUT_FILENO);
+
+    door::setup();
+    nodeRpc.addEndpoint(url);
+    door::web3->call = [](const char* method, const std::string& params) {
+        std::string reply;
+        nodeRpc.read(method, params.c_str(), &reply);
+        return reply;
+    };
+
+    Eip712Signer visitor;
+    {
+        Untracked scope;
+        visitor.begin(VISITOR_KEY);
+    }
+
+    HeapMonitor monitor;
+    int challengeOp = monitor.add("challenge", DOOR_ALLOC_CHALLENGE);
+    int signatureOp = monitor.add("signature", DOOR_ALLOC_SIGNATURE);
+    int statusOp = monitor.add("status", DOOR_ALLOC_STATUS);
+
+    HeapSample start = HeapMonitor::sample();
+    for (int i = 0; i < SOAK_ITERATIONS; i++) {
+        hostAdvanceMillis(SIG_GUARD_REFILL_MS);     // Stay inside the visitor's recovery budget
+        monitor.run(challengeOp, askChallenge);
+        answerChallenge(visitor);
+        monitor.run(signatureOp, checkSignature);
+        monitor.run(statusOp, askStatus);
+    }
+    HeapSample end = HeapMonitor::sample();
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    fclose(log);
+
+    printf("Door handlers:\n");
+    printf("Free heap %lu -> %lu\n", (unsigned long)start.freeBytes, (unsigned long)end.freeBytes);
+    return monitor.check(Serial);
+}
+
+int main() {
+    // OpenSSL sets itself up on first use; like the runtime's own pools
+    // before main(), that is not heap the firmware could ever free
+    std::string key = PRIVATE_KEY, message = "warm-up";
+    std::string signature = Crypto::Sign(&key, &message);
+    Crypto::ECRecoverFromPersonalMessage(&signature, &message);
+    hostHeapStart();
+
+    char url[40];
+    startNode(url, sizeof(url));
+
+    bool firmwareOk = soakFirmware(url);
+    check(firmwareOk, "firmware soak within budgets");
+    bool doorOk = soakDoor(url);
+    check(doorOk, "door soak within budgets");
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    fflush(stdout);
+    _exit(failures ? 1 : 0);  // RpcClient's worker tasks and the server's never return
+}
@@ -0,0 +1,342 @@
+/*
+ * Hex Codec Benchmark
+ *
+ * Times src/hex.h against the per-character code it replaced on the RPC
+ * path: range-check nibble() branches for decoding (AbiReader, SigGuard,
+ * AccessLog), digit-string lookups and snprintf("%02x") for encoding
+ * (meta-tx and door replies, registry calldata), strtoull() for
+ * quantities and String::equalsIgnoreCase() for addresses. Workloads
+ * are the sizes the firmware handles: addresses, 32-byte words,
+ * signatures and a Device[] result.
+ *
+ * Before timing, the codec is checked on every byte value and every
+ * character, the in-place variants, odd word widths and address edge
+ * cases. Exits non-zero if a check fails or the two sides disagree.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../../src hex_bench.cpp -o hex_bench
+ *   ./hex_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "hex.h"
+
+// ===== PREVIOUS CODE =====
+static int oldNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool oldDecode(const char* p, uint8_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        int hi = oldNibble(p[2 * i]);
+        int lo = oldNibble(p[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = hi << 4 | lo;
+    }
+    return true;
+}
+
+static void oldEncode(const uint8_t* data, size_t n, char* out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; i++) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0x0F];
+    }
+}
+
+static void oldEncodePrintf(const uint8_t* data, size_t n, char* out) {
+    for (size_t i = 0; i < n; i++) {
+        snprintf(out + 2 * i, 3, "%02x", data[i]);
+    }
+}
+
+static bool oldWord(const char* p, uint64_t* out) {
+    uint64_t value = 0;
+    for (int k = 0; k < 16; k++) {
+        int v = oldNibble(p[k]);
+        if (v < 0) {
+            return false;
+        }
+        value = value << 4 | v;
+    }
+    *out = value;
+    return true;
+}
+
+// Arduino String::equalsIgnoreCase(), as the door compared addresses
+static bool oldAddressEquals(const char* a, const char* b) {
+    size_t len = strlen(a);
+    if (len != strlen(b)) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===== BENCHMARK =====
+static uint64_t rngState = 0x2545F4914F6CDD1DULL;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// Random digits in mixed case, as checksummed addresses arrive
+static std::string randomHex(size_t digits, bool mixedCase) {
+    static const char LOWER[] = "0123456789abcdef", UPPER[] = "0123456789ABCDEF";
+    std::string s;
+    for (size_t i = 0; i < digits; i++) {
+        uint64_t r = nextRandom();
+        s += (mixedCase && (r & 16) ? UPPER : LOWER)[r & 15];
+    }
+    return s;
+}
+
+static volatile uint64_t sink;
+
+template <typename Fn>
+static double nsPerOp(size_t n, Fn fn) {
+    size_t rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed{};
+    do {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        rounds++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 100e6);
+    return elapsed.count() / (rounds * n);
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok && failures++ < 10) {
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static void checkCodec() {
+    // Every byte both ways, every character alone
+    uint8_t all[256], back[256];
+    char text[513];
+    for (int i = 0; i < 256; i++) {
+        all[i] = (uint8_t)i;
+    }
+    Hex::encode(all, 256, text);
+    char ref[513];
+    oldEncode(all, 256, ref);
+    check(memcmp(text, ref, 512) == 0, "encode of every byte");
+    check(Hex::decode(text, back, 256) && memcmp(all, back, 256) == 0, "decode of every byte");
+    for (int c = 0; c < 256; c++) {
+        check(Hex::nibble((char)c) == oldNibble((char)c), "nibble of every character");
+        char pair[2] = {'a', (char)c};
+        uint8_t b;
+        check(Hex::decode(pair, &b, 1) == (oldNibble((char)c) >= 0), "decode validity of every character");
+        pair[0] = (char)c;
+        pair[1] = '0';
+        check(Hex::decode(pair, &b, 1) == (oldNibble((char)c) >= 0), "decode validity, high digit");
+    }
+    check(Hex::decode("", back, 0), "empty decode");
+
+    // In place, both directions
+    uint8_t buf[2 * 65];
+    for (int i = 0; i < 65; i++) {
+        buf[i] = (uint8_t)nextRandom();
+    }
+    memcpy(back, buf, 65);
+    Hex::encodeInPlace(buf, 65);
+    oldEncode(back, 65, ref);
+    check(memcmp(buf, ref, 130) == 0, "encodeInPlace");
+    char inplace[] = "0xDEADbeef00ff";
+    size_t n = 0;
+    check(Hex::decodeInPlace(inplace, &n) && n == 6 && memcmp(inplace, "\xde\xad\xbe\xef\x00\xff", 6) == 0,
+          "decodeInPlace");
+    char odd[] = "0xabc";
+    check(!Hex::decodeInPlace(odd, &n), "decodeInPlace accepted an odd length");
+    char junk[] = "abzz";
+    check(!Hex::decodeInPlace(junk, &n), "decodeInPlace accepted junk");
+
+    // Words of every width
+    for (int digits = 0; digits <= 16; digits++) {
+        uint64_t v = nextRandom();
+        uint64_t mask = digits == 16 ? ~0ULL : (1ULL << (4 * digits)) - 1;
+        char w[17] = {0}, want[20];
+        Hex::encodeWord(v, digits, w);
+        snprintf(want, sizeof(want), "%016llx", (unsigned long long)v);
+        check(strcmp(w, want + 16 - digits) == 0, "encodeWord width");
+        uint64_t parsed = 1;
+        check(Hex::word(w, digits, &parsed) && parsed == (v & mask), "word round trip");
+    }
+    uint64_t parsed;
+    check(!Hex::word("12345678901234567", 17, &parsed), "word accepted 17 digits");
+    check(!Hex::word("12g4", 4, &parsed), "word accepted junk");
+
+    char fixed[7];
+    check(strcmp(Hex::format(all + 0xab, 2, fixed, sizeof(fixed)), "0xabac") == 0, "format");
+    check(strcmp(Hex::format(all, 3, fixed, sizeof(fixed)), "") == 0, "format overflowed its buffer");
+
+    // Addresses
+    uint8_t a[20], b[20];
+    const char* checksummed = "0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed";
+    const char* lower = "0x5aaeb6053f3e94c9b9a09f33669435e7ef1beaed";
+    check(Hex::parseAddress(checksummed, a) && Hex::parseAddress(lower, b) && memcmp(a, b, 20) == 0 &&
+              a[0] == 0x5a && a[19] == 0xed,
+          "parseAddress");
+    check(Hex::addressEquals(checksummed, lower), "addressEquals across casing");
+    check(Hex::addressEquals("0X5AAEB6053F3E94C9B9A09F33669435E7EF1BEAED", lower), "addressEquals 0X prefix");
+    check(!Hex::addressEquals(lower, "0x5aaeb6053f3e94c9b9a09f33669435e7ef1beaee"), "addressEquals last byte");
+    check(!Hex::parseAddress("5aaeb6053f3e94c9b9a09f33669435e7ef1beaed00", a), "parseAddress without prefix");
+    check(!Hex::parseAddress("0x5aaeb6053f3e94c9b9a09f33669435e7ef1beae", a), "parseAddress 39 digits");
+    check(!Hex::parseAddress("0x5aaeb6053f3e94c9b9a09f33669435e7ef1beaed0", a), "parseAddress 41 digits");
+    check(!Hex::parseAddress("0x5aaeb6053f3e94c9b9a09f33669435e7ef1bea d", a), "parseAddress junk");
+    check(!Hex::parseAddress(nullptr, a), "parseAddress null");
+    check(!Hex::addressEquals("0xzz", "0xzz"), "addressEquals of two non-addresses");
+}
+
+int main() {
+    checkCodec();
+
+    const size_t N = 64;
+    std::vector<std::string> addresses, addressesLower, words, signatures;
+    std::vector<std::vector<uint8_t>> rawWords, rawSignatures;
+    for (size_t i = 0; i < N; i++) {
+        std::string hex = randomHex(40, true);
+        addresses.push_back("0x" + hex);
+        for (char& c : hex) {
+            c = (char)tolower(c);
+        }
+        addressesLower.push_back("0x" + hex);
+        words.push_back(randomHex(64, false));
+        signatures.push_back(randomHex(130, false));
+        rawWords.emplace_back(32);
+        rawSignatures.emplace_back(65);
+        Hex::decode(words.back().c_str(), rawWords.back().data(), 32);
+        Hex::decode(signatures.back().c_str(), rawSignatures.back().data(), 65);
+    }
+    // Polka32 Device[] x10 result: 2 + 10 + 10 * 4 words
+    std::string devices = randomHex(52 * 64, false);
+    std::vector<uint8_t> rawDevices(devices.size() / 2);
+
+    // Both sides agree on the workloads
+    for (size_t i = 0; i < N; i++) {
+        uint8_t x[65], y[65];
+        check(Hex::decode(addresses[i].c_str() + 2, x, 20) && oldDecode(addresses[i].c_str() + 2, y, 20) &&
+                  memcmp(x, y, 20) == 0,
+              "address decode");
+        char e[131], f[131];
+        Hex::encode(rawSignatures[i].data(), 65, e);
+        oldEncodePrintf(rawSignatures[i].data(), 65, f);
+        check(memcmp(e, f, 130) == 0, "signature encode");
+        uint64_t p, q;
+        check(Hex::word(words[i].c_str(), 16, &p) && oldWord(words[i].c_str(), &q) && p == q, "limb");
+        check(Hex::addressEquals(addresses[i].c_str(), addressesLower[i].c_str()) ==
+                  oldAddressEquals(addresses[i].c_str(), addressesLower[i].c_str()),
+              "address compare");
+    }
+
+    struct Row {
+        const char* op;
+        const char* was;
+        double before;
+        double after;
+    };
+    std::vector<Row> rows;
+    rows.push_back({"decode address", "nibble()", nsPerOp(N, [&](size_t i) {
+                        uint8_t out[20];
+                        sink += oldDecode(addresses[i].c_str() + 2, out, 20) + out[i % 20];
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        uint8_t out[20];
+                        sink += Hex::parseAddress(addresses[i].c_str(), out) + out[i % 20];
+                    })});
+    rows.push_back({"decode signature", "nibble()", nsPerOp(N, [&](size_t i) {
+                        uint8_t out[65];
+                        sink += oldDecode(signatures[i].c_str(), out, 65) + out[i % 65];
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        uint8_t out[65];
+                        sink += Hex::decode(signatures[i].c_str(), out, 65) + out[i % 65];
+                    })});
+    rows.push_back({"decode Device[]", "nibble()", nsPerOp(1, [&](size_t) {
+                        sink += oldDecode(devices.c_str(), rawDevices.data(), rawDevices.size());
+                    }),
+                    nsPerOp(1, [&](size_t) {
+                        sink += Hex::decode(devices.c_str(), rawDevices.data(), rawDevices.size());
+                    })});
+    rows.push_back({"uint256 limbs", "nibble()", nsPerOp(N, [&](size_t i) {
+                        uint64_t v = 0;
+                        for (int k = 0; k < 4; k++) {
+                            sink += oldWord(words[i].c_str() + 16 * k, &v) + v;
+                        }
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        uint64_t v = 0;
+                        for (int k = 0; k < 4; k++) {
+                            sink += Hex::word(words[i].c_str() + 16 * k, 16, &v) + v;
+                        }
+                    })});
+    rows.push_back({"quantity", "strtoull()", nsPerOp(N, [&](size_t i) {
+                        char* end;
+                        sink += strtoull(words[i].c_str() + 48, &end, 16);
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        uint64_t v = 0;
+                        sink += Hex::word(words[i].c_str() + 48, 16, &v) + v;
+                    })});
+    rows.push_back({"encode word", "digits[]", nsPerOp(N, [&](size_t i) {
+                        char out[64];
+                        oldEncode(rawWords[i].data(), 32, out);
+                        sink += out[i % 64];
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        char out[64];
+                        Hex::encode(rawWords[i].data(), 32, out);
+                        sink += out[i % 64];
+                    })});
+    rows.push_back({"encode signature", "snprintf()", nsPerOp(N, [&](size_t i) {
+                        char out[131];
+                        oldEncodePrintf(rawSignatures[i].data(), 65, out);
+                        sink += out[i % 130];
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        char out[133];
+                        sink += Hex::format(rawSignatures[i].data(), 65, out, sizeof(out))[i % 130];
+                    })});
+    rows.push_back({"address equals", "ignoreCase", nsPerOp(N, [&](size_t i) {
+                        sink += oldAddressEquals(addresses[i].c_str(), addressesLower[(i + (i & 1)) % N].c_str());
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        sink += Hex::addressEquals(addresses[i].c_str(), addressesLower[(i + (i & 1)) % N].c_str());
+                    })});
+
+    printf("%-17s %-13s %10s %10s %8s\n", "operation", "previous", "before ns", "Hex ns", "speedup");
+    for (const Row& r : rows) {
+        printf("%-17s %-13s %10.1f %10.1f %7.1fx\n", r.op, r.was, r.before, r.after, r.before / r.after);
+    }
+    printf("Device[] x10 result: %zu hex digits\n", devices.size());
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,400 @@
+/*
+ * Holder Snapshot Check
+ *
+ * Runs the door's holder snapshot (examples/security_door/holder_snapshot.cpp)
+ * on the host: src/rpc_client.cpp talks to a stand-in node on loopback
+ * that serves eth_blockNumber and eth_getLogs from a generated ERC-721
+ * transfer history, and the table lives in the in-memory LittleFS of
+ * host_shim/FS.h. Balances are replayed independently from the same
+ * history and compared with what the snapshot answers.
+ *
+ * Checks:
+ * - begin() refuses a start block of 0
+ * - a full sync from the deployment block, and incremental syncs after
+ *   it, agree with the replayed balances for every address seen, and
+ *   deny random addresses; a block with more new holders than one merge
+ *   takes, and providers capping eth_getLogs results, are both covered
+ * - after a reboot the table resumes at its block with the same holders
+ * - a merge that cannot open the table, or cannot create the new one,
+ *   loses no holder: the snapshot falls back to the table in flash and
+ *   the next syncs catch up to the same balances
+ *
+ * Exits non-zero if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -pthread -I../host_shim -I../../src holder_check.cpp \
+ *       ../../examples/security_door/holder_snapshot.cpp ../../src/rpc_client.cpp \
+ *       ../../src/gzip_inflate.cpp -lz -o holder_check
+ *   ./holder_check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <FS.h>
+
+#include "../../examples/security_door/holder_snapshot.h"
+#include "abi/erc721.h"
+#include "hex.h"
+#include "rpc_client.h"
+#include "tls_resume.h"
+#include "tls_standin.h"
+
+#define TOKEN "0x7000000000000000000000000000000000000007"
+#define DEPLOY_BLOCK 1000
+#define LOG_LIMIT 300                 // Results per eth_getLogs before the provider refuses
+#define ADDRESSES 400
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static uint64_t rngState = 0x2545F4914F6CDD1DULL;
+
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 32);
+}
+
+struct Address {
+    uint8_t bytes[20];
+    bool operator<(const Address& other) const { return memcmp(bytes, other.bytes, 20) < 0; }
+};
+
+static Address randomAddress() {
+    Address a;
+    for (int i = 0; i < 20; i++) {
+        a.bytes[i] = rng();
+    }
+    return a;
+}
+
+static const Address ZERO = {};
+
+// ===== CHAIN =====
+// Transfers in block order; token ownership is tracked so every transfer
+// and burn comes from the current owner
+struct Transfer {
+    uint64_t block;
+    Address from;
+    Address to;
+    uint32_t tokenId;
+};
+
+class Chain {
+public:
+    std::vector<Address> people;
+
+    Chain() : head(DEPLOY_BLOCK), nextToken(1) {
+        for (int i = 0; i < ADDRESSES; i++) {
+            people.push_back(randomAddress());
+        }
+    }
+
+    // Blocks of random activity up to the new head
+    void grow(uint64_t blocks, int perBlockMax) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (uint64_t b = 0; b < blocks; b++) {
+            head++;
+            int n = rng() % (perBlockMax + 1);
+            for (int i = 0; i < n; i++) {
+                uint32_t kind = rng() % 10;
+                if (kind < 4 || owners.empty()) {
+                    mint(people[rng() % people.size()]);
+                } else {
+                    auto it = owners.begin();
+                    std::advance(it, rng() % owners.size());
+                    Address to = kind == 9 ? ZERO : people[rng() % people.size()];
+                    transfers.push_back({head, it->second, to, it->first});
+                    if (kind == 9) {
+                        owners.erase(it);
+                    } else {
+                        it->second = to;
+                    }
+                }
+            }
+        }
+    }
+
+    // One block minting to more new addresses than a merge holds
+    void airdrop(int count) {
+        std::lock_guard<std::mutex> guard(lock);
+        head++;
+        for (int i = 0; i < count; i++) {
+            Address a = randomAddress();
+            people.push_back(a);
+            mint(a);
+        }
+    }
+
+    uint64_t confirmed() {
+        std::lock_guard<std::mutex> guard(lock);
+        return head - HOLDER_CONFIRMATIONS;
+    }
+
+    // Replayed balances up to and including a block
+    std::map<Address, int> balancesAt(uint64_t block) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::map<Address, int> balances;
+        for (const Transfer& t : transfers) {
+            if (t.block > block) {
+                break;
+            }
+            if (memcmp(t.from.bytes, ZERO.bytes, 20) != 0) {
+                balances[t.from]--;
+            }
+            if (memcmp(t.to.bytes, ZERO.bytes, 20) != 0) {
+                balances[t.to]++;
+            }
+        }
+        return balances;
+    }
+
+    std::string reply(const std::string& body) {
+        std::lock_guard<std::mutex> guard(lock);
+        unsigned long id = strtoul(body.c_str() + body.find("\"id\":") + 5, nullptr, 10);
+        char prefix[48];
+        snprintf(prefix, sizeof(prefix), "{\"jsonrpc\":\"2.0\",\"id\":%lu,", id);
+        if (body.find("\"eth_blockNumber\"") != std::string::npos) {
+            char result[40];
+            snprintf(result, sizeof(result), "\"result\":\"0x%llx\"}", (unsigned long long)head);
+            return prefix + std::string(result);
+        }
+        if (body.find("\"eth_getLogs\"") == std::string::npos) {
+            return prefix + std::string("\"error\":{\"code\":-32601,\"message\":\"method not found\"}}");
+        }
+
+        size_t fromAt = body.find("\"fromBlock\":\"0x");
+        size_t toAt = body.find("\"toBlock\":\"0x");
+        if (fromAt == std::string::npos || toAt == std::string::npos || body.find(TOKEN) == std::string::npos ||
+            body.find(Erc721Abi::TRANSFER_TOPIC) == std::string::npos) {
+            return prefix + std::string("\"error\":{\"code\":-32602,\"message\":\"invalid params\"}}");
+        }
+        uint64_t from = strtoull(body.c_str() + fromAt + 15, nullptr, 16);
+        uint64_t to = strtoull(body.c_str() + toAt + 13, nullptr, 16);
+        getLogs++;
+
+        std::string logs;
+        int count = 0;
+        for (const Transfer& t : transfers) {
+            if (t.block < from || t.block > to) {
+                continue;
+            }
+            if (++count > LOG_LIMIT) {
+                refused++;
+                return prefix + std::string("\"error\":{\"code\":-32602,\"message\":\"query returned more than ") +
+                       std::to_string(LOG_LIMIT) + " results\"}}";
+            }
+            char fromHex[41], toHex[41];
+            Hex::encode(t.from.bytes, 20, fromHex);
+            Hex::encode(t.to.bytes, 20, toHex);
+            fromHex[40] = toHex[40] = '\0';
+            char log[512];
+            snprintf(log, sizeof(log),
+                     "%s{\"address\":\"%s\",\"topics\":[\"%s\",\"0x%024d%s\",\"0x%024d%s\",\"0x%064x\"],"
+                     "\"data\":\"0x\",\"blockNumber\":\"0x%llx\",\"removed\":false}",
+                     logs.empty() ? "" : ",", TOKEN, Erc721Abi::TRANSFER_TOPIC, 0, fromHex, 0, toHex, t.tokenId,
+                     (unsigned long long)t.block);
+            logs += log;
+        }
+        return prefix + std::string("\"result\":[") + logs + "]}";
+    }
+
+    uint32_t getLogs = 0;
+    uint32_t refused = 0;
+
+private:
+    std::mutex lock;
+    std::vector<Transfer> transfers;
+    std::map<uint32_t, Address> owners;
+    uint64_t head;
+    uint32_t nextToken;
+
+    void mint(const Address& to) {
+        transfers.push_back({head, ZERO, to, nextToken});
+        owners[nextToken++] = to;
+    }
+};
+
+static Chain chain;
+
+// ===== NODE =====
+static void serve(int fd) {
+    std::string in;
+    char buf[2048];
+    for (;;) {
+        size_t headEnd;
+        while ((headEnd = in.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                close(fd);
+                return;
+            }
+            in.append(buf, n);
+        }
+        size_t lengthAt = in.find("Content-Length: ");
+        size_t bodyLen = lengthAt < headEnd ? strtoul(in.c_str() + lengthAt + 16, nullptr, 10) : 0;
+        while (in.size() < headEnd + 4 + bodyLen) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                close(fd);
+                return;
+            }
+            in.append(buf, n);
+        }
+        std::string reply = chain.reply(in.substr(headEnd + 4, bodyLen));
+        in.erase(0, headEnd + 4 + bodyLen);
+
+        char head[128];
+        int headLen = snprintf(head, sizeof(head),
+                               "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n",
+                               reply.size());
+        std::string out = std::string(head, headLen) + reply;
+        if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) {
+            close(fd);
+            return;
+        }
+    }
+}
+
+static void startNode(char* url, size_t len) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+        perror("stand-in node");
+        exit(1);
+    }
+    socklen_t addrLen = sizeof(addr);
+    getsockname(listener, (sockaddr*)&addr, &addrLen);
+    snprintf(url, len, "http://127.0.0.1:%u/", ntohs(addr.sin_port));
+    std::thread([listener] {
+        for (;;) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                std::thread(serve, fd).detach();
+            }
+        }
+    }).detach();
+}
+
+// ===== CHECKS =====
+static RpcClient* rpc;
+static uint32_t now = 0;
+
+// Syncs until the snapshot reaches the confirmed head; false if it stalls
+static bool catchUp(HolderSnapshot& snapshot) {
+    for (int i = 0; i < 5000; i++) {
+        now += HOLDER_POLL_MS;
+        snapshot.sync(*rpc, now);
+        if (snapshot.block() == chain.confirmed() && snapshot.current(now, HOLDER_POLL_MS)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every address of the history, and some never seen, against the replay
+static bool agrees(HolderSnapshot& snapshot) {
+    std::map<Address, int> balances = chain.balancesAt(snapshot.block());
+    uint32_t holding = 0;
+    bool same = true;
+    for (const auto& b : balances) {
+        holding += b.second > 0;
+        same &= snapshot.holds(b.first.bytes) == (b.second > 0);
+    }
+    for (int i = 0; i < 200; i++) {
+        same &= !snapshot.holds(randomAddress().bytes);
+    }
+    return same && snapshot.size() == holding;
+}
+
+static void checkStartBlock() {
+    fs::FS flash;
+    HolderSnapshot snapshot(flash, TOKEN, 0);
+    check(!snapshot.begin(), "begin() refuses start block 0");
+    HolderSnapshot other(flash, "0x1234", DEPLOY_BLOCK);
+    check(!other.begin(), "begin() refuses a malformed contract address");
+}
+
+static void checkSync(fs::FS& flash) {
+    chain.grow(3000, 4);
+    chain.airdrop(HOLDER_DELTA_MAX * 2);
+    chain.grow(2000, 4);
+
+    HolderSnapshot snapshot(flash, TOKEN, DEPLOY_BLOCK);
+    check(snapshot.begin() && snapshot.size() == 0 && snapshot.block() == DEPLOY_BLOCK - 1,
+          "begin() on an empty filesystem starts before the deployment block");
+    check(catchUp(snapshot), "full sync reaches the confirmed head");
+    check(agrees(snapshot), "full sync matches the replayed balances");
+    printf("full sync: %lu holders at block %llu, %lu eth_getLogs (%lu over the result cap)\n",
+           (unsigned long)snapshot.size(), (unsigned long long)snapshot.block(), (unsigned long)chain.getLogs,
+           (unsigned long)chain.refused);
+
+    chain.grow(700, 3);
+    check(catchUp(snapshot), "incremental sync reaches the confirmed head");
+    check(agrees(snapshot), "incremental sync matches the replayed balances");
+
+    HolderSnapshot rebooted(flash, TOKEN, DEPLOY_BLOCK);
+    check(rebooted.begin(), "begin() over an existing table");
+    check(rebooted.block() == snapshot.block() && rebooted.size() == snapshot.size(),
+          "a reboot resumes at the saved block with the same holders");
+    check(agrees(rebooted), "a resumed table matches the replayed balances");
+}
+
+// Fails one merge the given way and checks that nothing is lost
+static void checkFailedMerge(fs::FS& flash, const char* failing, const char* what) {
+    HolderSnapshot snapshot(flash, TOKEN, DEPLOY_BLOCK);
+    snapshot.begin();
+    check(catchUp(snapshot), "sync before the failed merge");
+    uint64_t before = snapshot.block();
+    uint32_t holders = snapshot.size();
+
+    chain.airdrop(3);               // At least one change to merge
+    chain.grow(20, 3);
+    flash.failNextOpens(failing, 1);
+    now += HOLDER_POLL_MS;
+    bool ok = snapshot.sync(*rpc, now);
+    char label[96];
+    snprintf(label, sizeof(label), "a merge that %s reports failure", what);
+    check(!ok, label);
+    snprintf(label, sizeof(label), "a merge that %s keeps the table and its block", what);
+    check(snapshot.block() == before && snapshot.size() == holders && agrees(snapshot), label);
+
+    snprintf(label, sizeof(label), "sync after a merge that %s catches up", what);
+    check(catchUp(snapshot) && agrees(snapshot), label);
+}
+
+int main() {
+    char url[40];
+    startNode(url, sizeof(url));
+    rpc = new RpcClient();
+    rpc->addEndpoint(url);
+
+    checkStartBlock();
+    fs::FS flash;
+    checkSync(flash);
+    checkFailedMerge(flash, HOLDER_SNAPSHOT_FILE, "cannot open the table");
+    checkFailedMerge(flash, "/holders.tmp", "cannot create the new table");
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    fflush(stdout);
+    _exit(failures ? 1 : 0);  // RpcClient's worker tasks never return
+}
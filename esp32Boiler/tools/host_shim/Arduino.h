@@ -0,0 +1,407 @@
+/*
+ * Host stand-in for the Arduino core and FreeRTOS
+ *
+ * The subset of Arduino.h (millis, String, Print, Serial, IPAddress, GPIO,
+ * ESP, configTime) and of the FreeRTOS API the ESP32 core pulls in with it
+ * (mutexes, critical sections, counting semaphores, queues, tasks with
+ * notifications) that src/ and the door use, mapped onto std::thread. One
+ * tick is one millisecond. Pins only remember what was written to them.
+ *
+ * millis() is the real clock plus whatever hostAdvanceMillis() added, so a
+ * test can skip minutes of polling intervals or timeouts without waiting.
+ */
+
+#ifndef HOST_SHIM_ARDUINO_H
+#define HOST_SHIM_ARDUINO_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+using std::max;
+using std::min;
+
+#define PROGMEM                           // Flash and RAM are one address space here
+
+// ===== TIME =====
+inline std::atomic<uint64_t>& hostSkippedUs() {
+    static std::atomic<uint64_t> skipped{0};
+    return skipped;
+}
+
+inline uint64_t hostMicros64() {
+    static const auto start = std::chrono::steady_clock::now();
+    auto real = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return (uint64_t)real.count() + hostSkippedUs();
+}
+
+inline void hostAdvanceMillis(uint32_t ms) { hostSkippedUs() += (uint64_t)ms * 1000; }
+
+inline uint32_t millis() { return (uint32_t)(hostMicros64() / 1000); }
+inline uint32_t micros() { return (uint32_t)hostMicros64(); }
+inline void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+inline void yield() { std::this_thread::yield(); }
+
+inline uint32_t esp_random() {
+    static std::mutex lock;
+    static uint64_t state = 0x2545F4914F6CDD1DULL;
+    std::lock_guard<std::mutex> guard(lock);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (uint32_t)(state >> 32);
+}
+
+// ===== GPIO AND SYSTEM =====
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define LOW 0
+#define HIGH 1
+
+inline std::atomic<uint8_t>* hostPins() {
+    static std::atomic<uint8_t> pins[40];
+    return pins;
+}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) { hostPins()[pin % 40] = value; }
+inline int digitalRead(uint8_t pin) { return hostPins()[pin % 40]; }
+inline uint32_t analogReadMilliVolts(uint8_t) { return 0; }
+
+// SNTP is not started; time() stays the host's clock
+inline void configTime(long, int, const char*, const char* = nullptr, const char* = nullptr) {}
+
+class EspClass {
+public:
+    void restart() {
+        fprintf(stderr, "ESP.restart()\n");
+        exit(1);
+    }
+};
+
+inline EspClass ESP;
+
+// ===== PRINT AND STRING =====
+class String {
+public:
+    String(const char* s = "") : s(s ? s : "") {}
+    String(const std::string& s) : s(s) {}
+    const char* c_str() const { return s.c_str(); }
+    unsigned length() const { return (unsigned)s.size(); }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(c_str(), other.c_str()) == 0; }
+    bool operator==(const char* other) const { return s == other; }
+    String& operator+=(const char* more) { s += more; return *this; }
+
+private:
+    std::string s;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) {
+        size_t n = 0;
+        while (n < size && write(buf[n])) {
+            n++;
+        }
+        return n;
+    }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(int v) { return print((long)v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(unsigned v) { return print((unsigned long)v); }
+    size_t print(long long v) { return printf("%lld", v); }
+    size_t print(unsigned long long v) { return printf("%llu", v); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+    template <typename T>
+    size_t println(T v) { return print(v) + println(); }
+    size_t println() { return write("\r\n"); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char small[256];
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(small, sizeof(small), format, args);
+        va_end(args);
+        if (n < 0) {
+            return 0;
+        }
+        if ((size_t)n < sizeof(small)) {
+            return write((const uint8_t*)small, n);
+        }
+        std::vector<char> big(n + 1);
+        va_start(args, format);
+        vsnprintf(big.data(), big.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*)big.data(), n);
+    }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+};
+
+// Output only; nothing is ever typed at the host's Serial
+class HostSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t b) override { return fwrite(&b, 1, 1, stdout); }
+    size_t write(const uint8_t* buf, size_t size) override { return fwrite(buf, 1, size, stdout); }
+    using Print::write;
+};
+
+inline HostSerial Serial;
+
+class IPAddress {
+public:
+    IPAddress(uint32_t address = 0) : address(address) {}
+    operator uint32_t() const { return address; }
+
+private:
+    uint32_t address;
+};
+
+// ===== FREERTOS =====
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Waits on cv until ready() or ticks pass; portMAX_DELAY waits forever
+template <typename Ready>
+inline bool hostWait(std::condition_variable& cv, std::unique_lock<std::mutex>& held, TickType_t ticks, Ready ready) {
+    if (ticks == portMAX_DELAY) {
+        cv.wait(held, ready);
+        return true;
+    }
+    return cv.wait_for(held, std::chrono::milliseconds(ticks), ready);
+}
+
+// portMUX spinlocks guard data shared between tasks; a mutex does here
+struct HostMux {
+    std::mutex m;
+};
+typedef HostMux portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED HostMux()
+
+inline void portENTER_CRITICAL(portMUX_TYPE* mux) { mux->m.lock(); }
+inline void portEXIT_CRITICAL(portMUX_TYPE* mux) { mux->m.unlock(); }
+
+// Mutexes, recursive mutexes and counting semaphores share one shape
+struct HostSemaphore {
+    std::mutex m;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t maxCount;
+    std::thread::id owner;
+    UBaseType_t depth;
+};
+typedef HostSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initial) {
+    SemaphoreHandle_t s = new HostSemaphore();
+    s->count = initial;
+    s->maxCount = maxCount;
+    s->depth = 0;
+    return s;
+}
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return xSemaphoreCreateCounting(1, 1); }
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return xSemaphoreCreateCounting(1, 0); }
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return xSemaphoreCreateMutex(); }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+    std::unique_lock<std::mutex> held(s->m);
+    if (!hostWait(s->cv, held, ticks, [s] { return s->count > 0; })) {
+        return pdFALSE;
+    }
+    s->count--;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    std::lock_guard<std::mutex> held(s->m);
+    if (s->count == s->maxCount) {
+        return pdFALSE;
+    }
+    s->count++;
+    s->cv.notify_one();
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ticks) {
+    std::unique_lock<std::mutex> held(s->m);
+    std::thread::id self = std::this_thread::get_id();
+    if (s->depth > 0 && s->owner == self) {
+        s->depth++;
+        return pdTRUE;
+    }
+    if (!hostWait(s->cv, held, ticks, [s] { return s->depth == 0; })) {
+        return pdFALSE;
+    }
+    s->owner = self;
+    s->depth = 1;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s) {
+    std::lock_guard<std::mutex> held(s->m);
+    if (s->depth == 0 || s->owner != std::this_thread::get_id()) {
+        return pdFALSE;
+    }
+    if (--s->depth == 0) {
+        s->cv.notify_one();
+    }
+    return pdTRUE;
+}
+
+struct HostQueue {
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    QueueHandle_t q = new HostQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> held(q->m);
+    if (!hostWait(q->cv, held, ticks, [q] { return q->items.size() < q->length; })) {
+        return pdFALSE;
+    }
+    const uint8_t* p = static_cast<const uint8_t*>(item);
+    q->items.emplace_back(p, p + q->itemSize);
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> held(q->m);
+    if (!hostWait(q->cv, held, ticks, [q] { return !q->items.empty(); })) {
+        return pdFALSE;
+    }
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> held(q->m);
+    return q->items.size();
+}
+
+typedef void (*TaskFunction_t)(void*);
+
+struct HostTask {
+    std::mutex m;
+    std::condition_variable cv;
+    uint32_t notified = 0;
+};
+typedef HostTask* TaskHandle_t;
+
+inline HostTask*& hostCurrentTask() {
+    thread_local HostTask* current = nullptr;
+    return current;
+}
+
+// Tasks run until the process exits
+inline BaseType_t xTaskCreate(TaskFunction_t code, const char*, uint32_t, void* arg, UBaseType_t,
+                              TaskHandle_t* handle) {
+    HostTask* task = new HostTask();
+    if (handle) {
+        *handle = task;
+    }
+    std::thread([=] {
+        hostCurrentTask() = task;
+        code(arg);
+    }).detach();
+    return pdPASS;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stack, void* arg,
+                                          UBaseType_t priority, TaskHandle_t* handle, BaseType_t) {
+    return xTaskCreate(code, name, stack, arg, priority, handle);
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> held(task->m);
+    task->notified++;
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask* task = hostCurrentTask();
+    std::unique_lock<std::mutex> held(task->m);
+    if (!hostWait(task->cv, held, ticks, [task] { return task->notified > 0; })) {
+        return 0;
+    }
+    uint32_t value = task->notified;
+    task->notified = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+inline TickType_t xTaskGetTickCount() { return millis(); }
+
+inline void vTaskDelayUntil(TickType_t* wake, TickType_t ticks) {
+    *wake += ticks;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(*wake - now) > 0) {
+        delay(*wake - now);
+    }
+}
+
+// Only a task deleting itself, as every caller in src/ does
+inline void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr) {
+        pthread_exit(nullptr);
+    }
+}
+
+#endif // HOST_SHIM_ARDUINO_H
@@ -0,0 +1,242 @@
+/*
+ * Host stand-in for AsyncTCP
+ *
+ * AsyncServer and AsyncClient on real sockets, so the door's HTTP server
+ * can be loaded from ordinary TCP clients. As on the ESP32, every callback
+ * (onClient, onData, onAck, onPoll, onDisconnect) runs on one event task,
+ * while add(), send(), space() and close() may be called from any task.
+ *
+ * - space() is a fixed send window (TCP_SND_BUF on the ESP32) minus bytes
+ *   not yet taken by the kernel; onAck fires as they are
+ * - onPoll every HOST_TCP_POLL_MS, like lwIP's slow timer
+ * - close() sends what is still queued, then disconnects; onDisconnect
+ *   runs on the event task and may delete the client
+ */
+
+#ifndef HOST_SHIM_ASYNCTCP_H
+#define HOST_SHIM_ASYNCTCP_H
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+
+#define ASYNC_WRITE_FLAG_COPY 0x01
+#define HOST_TCP_SND_BUF 5744
+#define HOST_TCP_POLL_MS 125
+
+class AsyncClient;
+
+typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
+typedef std::function<void(void*, AsyncClient*, void* data, size_t len)> AcDataHandler;
+typedef std::function<void(void*, AsyncClient*, size_t len, uint32_t time)> AcAckHandler;
+
+class AsyncClient {
+public:
+    AsyncClient(int fd, uint32_t ip) : fd(fd), ip(ip), closeRequested(false) {}
+    ~AsyncClient() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    IPAddress remoteIP() const { return IPAddress(ip); }
+    void setNoDelay(bool on) {
+        int flag = on;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+    void setRxTimeout(uint32_t) {}
+
+    void onData(AcDataHandler cb, void* arg = nullptr) { dataCb = cb; dataArg = arg; }
+    void onAck(AcAckHandler cb, void* arg = nullptr) { ackCb = cb; ackArg = arg; }
+    void onPoll(AcConnectHandler cb, void* arg = nullptr) { pollCb = cb; pollArg = arg; }
+    void onDisconnect(AcConnectHandler cb, void* arg = nullptr) { disconnectCb = cb; disconnectArg = arg; }
+
+    size_t space() {
+        std::lock_guard<std::mutex> guard(lock);
+        return closeRequested || tx.size() >= HOST_TCP_SND_BUF ? 0 : HOST_TCP_SND_BUF - tx.size();
+    }
+
+    // Data is always copied; the flag only matters on the device
+    size_t add(const char* data, size_t len, uint8_t = ASYNC_WRITE_FLAG_COPY) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (closeRequested) {
+            return 0;
+        }
+        size_t n = std::min(len, HOST_TCP_SND_BUF - std::min<size_t>(tx.size(), HOST_TCP_SND_BUF));
+        tx.insert(tx.end(), data, data + n);
+        return n;
+    }
+
+    bool send() { return true; }  // The event task writes whatever is queued
+
+    size_t write(const char* data, size_t len) { return add(data, len); }
+
+    void close(bool = false) {
+        std::lock_guard<std::mutex> guard(lock);
+        closeRequested = true;
+    }
+
+private:
+    friend class AsyncServer;
+
+    int fd;
+    uint32_t ip;
+    std::mutex lock;
+    std::vector<char> tx;
+    bool closeRequested;
+
+    AcDataHandler dataCb;
+    void* dataArg = nullptr;
+    AcAckHandler ackCb;
+    void* ackArg = nullptr;
+    AcConnectHandler pollCb;
+    void* pollArg = nullptr;
+    AcConnectHandler disconnectCb;
+    void* disconnectArg = nullptr;
+
+    bool pendingTx() {
+        std::lock_guard<std::mutex> guard(lock);
+        return !tx.empty();
+    }
+
+    bool closing() {
+        std::lock_guard<std::mutex> guard(lock);
+        return closeRequested;
+    }
+
+    // Hand queued bytes to the kernel; returns how many it took, -1 if the
+    // peer is gone
+    ssize_t flush() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tx.empty()) {
+            return 0;
+        }
+        ssize_t n = ::send(fd, tx.data(), tx.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+        tx.erase(tx.begin(), tx.begin() + n);
+        return n;
+    }
+};
+
+class AsyncServer {
+public:
+    explicit AsyncServer(uint16_t port) : port(port), listener(-1) {}
+
+    void onClient(AcConnectHandler cb, void* arg) { clientCb = cb; clientArg = arg; }
+    void setNoDelay(bool) {}
+
+    void begin() {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 64) != 0) {
+            perror("AsyncServer");
+            exit(1);
+        }
+        fcntl(listener, F_SETFL, O_NONBLOCK);
+        std::thread([this] { run(); }).detach();
+    }
+
+private:
+    uint16_t port;
+    int listener;
+    AcConnectHandler clientCb;
+    void* clientArg = nullptr;
+    std::vector<AsyncClient*> clients;
+
+    void disconnect(size_t i) {
+        AsyncClient* c = clients[i];
+        clients.erase(clients.begin() + i);
+        ::close(c->fd);
+        c->fd = -1;
+        if (c->disconnectCb) {
+            c->disconnectCb(c->disconnectArg, c);  // May delete c
+        }
+    }
+
+    void run() {
+        uint32_t polledAt = millis();
+        std::vector<pollfd> fds;
+        char rx[1460];
+        for (;;) {
+            fds.clear();
+            fds.push_back({listener, POLLIN, 0});
+            for (AsyncClient* c : clients) {
+                fds.push_back({c->fd, (short)(POLLIN | (c->pendingTx() ? POLLOUT : 0)), 0});
+            }
+            ::poll(fds.data(), fds.size(), 5);
+
+            if (fds[0].revents & POLLIN) {
+                sockaddr_in from = {};
+                socklen_t len = sizeof(from);
+                int fd;
+                while ((fd = accept(listener, (sockaddr*)&from, &len)) >= 0) {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    AsyncClient* c = new AsyncClient(fd, from.sin_addr.s_addr);
+                    clients.push_back(c);
+                    clientCb(clientArg, c);
+                }
+            }
+
+            // Clients accepted above have no pollfd yet; only walk the
+            // ones polled, newest first so removals keep indices valid
+            for (size_t i = fds.size() - 1; i >= 1; i--) {
+                AsyncClient* c = clients[i - 1];
+                short events = fds[i].revents;
+                bool gone = events & (POLLERR | POLLHUP | POLLNVAL);
+
+                if (!gone && (events & POLLIN)) {
+                    ssize_t n = recv(c->fd, rx, sizeof(rx), 0);
+                    if (n > 0) {
+                        if (!c->closing() && c->dataCb) {
+                            c->dataCb(c->dataArg, c, rx, n);
+                        }
+                    } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                        gone = true;
+                    }
+                }
+                if (!gone) {
+                    ssize_t sent = c->flush();
+                    if (sent < 0) {
+                        gone = true;
+                    } else if (sent > 0 && c->ackCb) {
+                        c->ackCb(c->ackArg, c, sent, 0);
+                    }
+                }
+                if (!gone && c->closing() && !c->pendingTx()) {
+                    shutdown(c->fd, SHUT_WR);
+                    gone = true;
+                }
+                if (gone) {
+                    disconnect(i - 1);
+                }
+            }
+
+            if (millis() - polledAt >= HOST_TCP_POLL_MS) {
+                polledAt = millis();
+                for (size_t i = clients.size(); i-- > 0;) {
+                    if (clients[i]->pollCb) {
+                        clients[i]->pollCb(clients[i]->pollArg, clients[i]);
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif // HOST_SHIM_ASYNCTCP_H
@@ -0,0 +1,38 @@
+/*
+ * Host stand-in for Web3E's Contract
+ *
+ * SendTransaction() and ViewCall() with the real signatures; the
+ * transaction goes to Web3::sendRaw instead of being signed and posted,
+ * the call to Web3::call as an eth_call at "latest".
+ */
+
+#ifndef HOST_SHIM_CONTRACT_H
+#define HOST_SHIM_CONTRACT_H
+
+#include <Web3.h>
+
+class Contract {
+public:
+    Contract(Web3* web3, const char* address) : web3(web3), address(address), key(nullptr) {}
+
+    void SetPrivateKey(const char* privateKey) { key = privateKey; }
+
+    std::string SendTransaction(uint32_t nonce, unsigned long long gasPrice, uint32_t gasLimit, std::string* to,
+                                uint256_t* value, std::string* data) {
+        if (!web3->sendRaw || key == nullptr) {
+            return "{\"jsonrpc\":\"2.0\",\"id\":1,\"error\":{\"code\":-32000,\"message\":\"no signer\"}}";
+        }
+        return web3->sendRaw({key, nonce, gasPrice, gasLimit, *to, *value, *data});
+    }
+
+    std::string ViewCall(const std::string* param) {
+        return web3->read("eth_call", "[{\"to\":\"" + address + "\",\"data\":\"" + *param + "\"},\"latest\"]");
+    }
+
+private:
+    Web3* web3;
+    std::string address;
+    const char* key;
+};
+
+#endif // HOST_SHIM_CONTRACT_H
@@ -0,0 +1,101 @@
+/*
+ * Host stand-in for Web3E's Crypto
+ *
+ * Crypto::Keccak256 over a buffer, enough for the src/ hashing code
+ * (eip712.h) to run in host tools. Plain reference Keccak-f[1600], not
+ * tuned for speed. Sign() and ECRecoverFromPersonalMessage() are only
+ * declared; a tool that runs code calling them links a definition
+ * (tools/heap_soak builds them on its host Eip712Signer).
+ */
+
+#ifndef HOST_SHIM_CRYPTO_H
+#define HOST_SHIM_CRYPTO_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+class Crypto {
+public:
+    static void Keccak256(const uint8_t* data, uint16_t length, uint8_t* result) {
+        uint64_t state[25] = {0};
+        uint8_t block[136];
+        size_t len = length;
+        while (len >= sizeof(block)) {
+            absorb(state, data);
+            data += sizeof(block);
+            len -= sizeof(block);
+        }
+        memset(block, 0, sizeof(block));
+        memcpy(block, data, len);
+        block[len] ^= 0x01;                 // Keccak padding, not SHA-3's 0x06
+        block[sizeof(block) - 1] ^= 0x80;
+        absorb(state, block);
+        memcpy(result, state, 32);          // Little-endian host
+    }
+
+    // EIP-191 personal_sign of message: "0x" + r, s, v in hex
+    static std::string Sign(std::string* privateKey, std::string* message);
+
+    // Address ("0x" + 40 digits) that produced a Sign() signature, or ""
+    static std::string ECRecoverFromPersonalMessage(std::string* signature, std::string* message);
+
+private:
+    static uint64_t rol(uint64_t x, int n) {
+        return x << n | x >> (64 - n);
+    }
+
+    static void absorb(uint64_t state[25], const uint8_t* block) {
+        for (int i = 0; i < 17; i++) {
+            uint64_t lane;
+            memcpy(&lane, block + 8 * i, 8);
+            state[i] ^= lane;
+        }
+        permute(state);
+    }
+
+    static void permute(uint64_t s[25]) {
+        static const uint64_t RC[24] = {
+            0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+            0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+            0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+            0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+            0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+            0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+        };
+        static const int ROT[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                                    27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+        static const int PI[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                                   15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+        for (int round = 0; round < 24; round++) {
+            uint64_t c[5];
+            for (int x = 0; x < 5; x++) {
+                c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+            }
+            for (int x = 0; x < 5; x++) {
+                uint64_t d = c[(x + 4) % 5] ^ rol(c[(x + 1) % 5], 1);
+                for (int y = 0; y < 25; y += 5) {
+                    s[y + x] ^= d;
+                }
+            }
+            uint64_t t = s[1];
+            for (int i = 0; i < 24; i++) {
+                uint64_t next = s[PI[i]];
+                s[PI[i]] = rol(t, ROT[i]);
+                t = next;
+            }
+            for (int y = 0; y < 25; y += 5) {
+                uint64_t row[5];
+                memcpy(row, s + y, sizeof(row));
+                for (int x = 0; x < 5; x++) {
+                    s[y + x] = row[x] ^ (~row[(x + 1) % 5] & row[(x + 2) % 5]);
+                }
+            }
+            s[0] ^= RC[round];
+        }
+    }
+};
+
+#endif // HOST_SHIM_CRYPTO_H
@@ -0,0 +1,173 @@
+/*
+ * Host stand-in for the Arduino-ESP32 FS (LittleFS)
+ *
+ * An in-memory filesystem with the calls the door's flash code makes:
+ * open() in FILE_READ/FILE_WRITE/FILE_APPEND and "r+", exists(), mkdir(),
+ * remove(), rename(), and on File read/write/seek/size plus directory
+ * listing with openNextFile(). Writes land immediately, so a File left
+ * open is not a torn record as it could be on flash. Tests can make the
+ * next opens of a path fail, as a worn or full flash does.
+ */
+
+#ifndef HOST_SHIM_FS_H
+#define HOST_SHIM_FS_H
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+class FS;
+
+class File {
+public:
+    File() : data(nullptr), pos(0), writable(false), directory(false), next(0) {}
+
+    explicit operator bool() const { return data != nullptr || directory; }
+    bool isDirectory() const { return directory; }
+    const char* name() const { return path.c_str(); }
+    size_t size() const { return data ? data->size() : 0; }
+
+    bool seek(uint32_t to) {
+        if (!data || to > data->size()) {
+            return false;
+        }
+        pos = to;
+        return true;
+    }
+
+    size_t read(uint8_t* buf, size_t size) {
+        if (!data || pos >= data->size()) {
+            return 0;
+        }
+        size_t n = std::min(size, data->size() - pos);
+        memcpy(buf, data->data() + pos, n);
+        pos += n;
+        return n;
+    }
+
+    size_t write(const uint8_t* buf, size_t size) {
+        if (!data || !writable) {
+            return 0;
+        }
+        if (data->size() < pos + size) {
+            data->resize(pos + size);
+        }
+        memcpy(data->data() + pos, buf, size);
+        pos += size;
+        return size;
+    }
+
+    File openNextFile() {
+        File f;
+        if (directory && next < entries.size()) {
+            f.path = entries[next].first;
+            f.data = entries[next].second;
+            f.writable = false;
+            next++;
+        }
+        return f;
+    }
+
+    void close() {
+        data = nullptr;
+        directory = false;
+    }
+
+private:
+    friend class FS;
+    std::string path;
+    std::shared_ptr<std::vector<uint8_t>> data;
+    size_t pos;
+    bool writable;
+    bool directory;
+    std::vector<std::pair<std::string, std::shared_ptr<std::vector<uint8_t>>>> entries;
+    size_t next;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = FILE_READ) {
+        File f;
+        f.path = path;
+        auto failing = failOpens.find(path);
+        if (failing != failOpens.end() && failing->second > 0) {
+            failing->second--;
+            return f;
+        }
+        if (dirs.count(path)) {
+            if (mode[0] == 'r') {
+                f.directory = true;
+                std::string prefix = std::string(path) + "/";
+                for (auto& e : files) {
+                    if (e.first.compare(0, prefix.size(), prefix) == 0) {
+                        f.entries.push_back(e);
+                    }
+                }
+            }
+            return f;
+        }
+        auto it = files.find(path);
+        if (mode[0] == 'r') {
+            if (it != files.end()) {
+                f.data = it->second;
+                f.writable = mode[1] == '+';
+            }
+            return f;
+        }
+        if (it == files.end() || mode[0] == 'w') {
+            files[path] = std::make_shared<std::vector<uint8_t>>();
+        }
+        f.data = files[path];
+        f.writable = true;
+        f.pos = mode[0] == 'a' ? f.data->size() : 0;
+        return f;
+    }
+
+    File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+
+    bool exists(const char* path) { return dirs.count(path) || files.count(path); }
+    bool mkdir(const char* path) {
+        dirs.insert(path);
+        return true;
+    }
+    bool remove(const char* path) { return files.erase(path) > 0; }
+
+    bool rename(const char* from, const char* to) {
+        auto it = files.find(from);
+        if (it == files.end() || files.count(to)) {
+            return false;
+        }
+        files[to] = it->second;
+        files.erase(it);
+        return true;
+    }
+
+    // Test hooks, not part of the device API
+    void failNextOpens(const char* path, int count) { failOpens[path] = count; }
+    std::vector<uint8_t>* raw(const char* path) {
+        auto it = files.find(path);
+        return it == files.end() ? nullptr : it->second.get();
+    }
+
+private:
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+    std::set<std::string> dirs;
+    std::map<std::string, int> failOpens;
+};
+
+}  // namespace fs
+
+using fs::File;
+
+#endif // HOST_SHIM_FS_H
@@ -0,0 +1,229 @@
+/*
+ * Host stand-in for the ESP32 HTTPClient
+ *
+ * HTTP/1.1 over a caller-supplied WiFiClient, with the calls RpcClient and
+ * MetaTxClient make: begin(client, url), request headers, GET() and POST(),
+ * collected reply headers, getString() and writeToStream(). Keep-alive follows
+ * setReuse(); bodies must carry a Content-Length (no chunked replies).
+ * Errors are the negative HTTPC_ERROR_* codes of the real client.
+ */
+
+#ifndef HOST_SHIM_HTTPCLIENT_H
+#define HOST_SHIM_HTTPCLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient {
+public:
+    HTTPClient()
+        : client(nullptr), port(0), reuse(true), connectTimeoutMs(5000), timeoutMs(5000), bodyLeft(0) {}
+
+    void setReuse(bool on) { reuse = on; }
+    void setAcceptEncoding(const String& encoding) { acceptEncoding = encoding.c_str(); }
+    void setConnectTimeout(int32_t ms) { connectTimeoutMs = ms; }
+    void setTimeout(uint16_t ms) { timeoutMs = ms; }
+
+    bool begin(WiFiClient& c, const String& url) {
+        client = &c;
+        requestHeaders.clear();
+        std::string u = url.c_str();
+        size_t scheme = u.find("://");
+        if (scheme == std::string::npos) {
+            return false;
+        }
+        port = u.compare(0, scheme, "https") == 0 ? 443 : 80;
+        size_t hostStart = scheme + 3;
+        size_t slash = u.find('/', hostStart);
+        std::string authority = u.substr(hostStart, slash == std::string::npos ? std::string::npos : slash - hostStart);
+        path = slash == std::string::npos ? "/" : u.substr(slash);
+        size_t colon = authority.find(':');
+        host = authority.substr(0, colon);
+        if (colon != std::string::npos) {
+            port = (uint16_t)atoi(authority.c_str() + colon + 1);
+        }
+        return !host.empty();
+    }
+
+    void addHeader(const String& name, const String& value) {
+        requestHeaders += std::string(name.c_str()) + ": " + value.c_str() + "\r\n";
+    }
+
+    void collectHeaders(const char* names[], size_t count) {
+        collected.clear();
+        for (size_t i = 0; i < count; i++) {
+            collected.push_back({names[i], ""});
+        }
+    }
+
+    String header(const char* name) {
+        for (auto& h : collected) {
+            if (strcasecmp(h.first.c_str(), name) == 0) {
+                return String(h.second);
+            }
+        }
+        return String();
+    }
+
+    int GET() { return sendRequest("GET", nullptr, 0); }
+    int POST(uint8_t* payload, size_t size) { return sendRequest("POST", payload, size); }
+
+    String getString() {
+        std::string body;
+        uint8_t buf[1024];
+        while (bodyLeft > 0) {
+            int n = readSome(buf, std::min(sizeof(buf), bodyLeft));
+            if (n <= 0) {
+                client->stop();
+                break;
+            }
+            body.append((const char*)buf, n);
+            bodyLeft -= n;
+        }
+        return String(body);
+    }
+
+    // Returns the bytes written, or a negative error
+    int writeToStream(Stream* stream) {
+        uint8_t buf[1460];
+        int total = 0;
+        while (bodyLeft > 0) {
+            int n = readSome(buf, std::min(sizeof(buf), bodyLeft));
+            if (n <= 0) {
+                client->stop();
+                return HTTPC_ERROR_READ_TIMEOUT;
+            }
+            bodyLeft -= n;
+            if (stream->write(buf, n) != (size_t)n) {
+                client->stop();
+                return HTTPC_ERROR_CONNECTION_LOST;
+            }
+            total += n;
+        }
+        return total;
+    }
+
+    void end() {
+        if (client && (!reuse || bodyLeft > 0)) {
+            client->stop();
+        }
+        bodyLeft = 0;
+    }
+
+private:
+    WiFiClient* client;
+    std::string host;
+    std::string path;
+    uint16_t port;
+    bool reuse;
+    int32_t connectTimeoutMs;
+    uint32_t timeoutMs;
+    std::string acceptEncoding;
+    std::string requestHeaders;
+    std::vector<std::pair<std::string, std::string>> collected;
+    size_t bodyLeft;
+
+    // A GET has no payload and sends no Content-Length
+    int sendRequest(const char* method, const uint8_t* payload, size_t size) {
+        if (client == nullptr) {
+            return HTTPC_ERROR_NOT_CONNECTED;
+        }
+        if (!client->connected() && !client->connect(host.c_str(), port, connectTimeoutMs)) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+
+        std::string head = std::string(method) + " " + path + " HTTP/1.1\r\nHost: " + host + "\r\n" + requestHeaders;
+        head += reuse ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+        if (!acceptEncoding.empty()) {
+            head += "Accept-Encoding: " + acceptEncoding + "\r\n";
+        }
+        if (payload != nullptr) {
+            head += "Content-Length: " + std::to_string(size) + "\r\n";
+        }
+        head += "\r\n";
+        if (client->write((const uint8_t*)head.data(), head.size()) != head.size() ||
+            (payload != nullptr && client->write(payload, size) != size)) {
+            client->stop();
+            return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+        }
+
+        for (auto& h : collected) {
+            h.second.clear();
+        }
+        std::string line;
+        int status = 0;
+        bodyLeft = 0;
+        for (bool first = true;; first = false) {
+            int error = readLine(&line);
+            if (error) {
+                client->stop();
+                return error;
+            }
+            if (first) {
+                status = line.size() > 9 ? atoi(line.c_str() + 9) : 0;
+                continue;
+            }
+            if (line.empty()) {
+                break;
+            }
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string name = line.substr(0, colon);
+            std::string value = line.substr(line.find_first_not_of(' ', colon + 1));
+            if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+                bodyLeft = strtoul(value.c_str(), nullptr, 10);
+            }
+            for (auto& h : collected) {
+                if (strcasecmp(h.first.c_str(), name.c_str()) == 0) {
+                    h.second = value;
+                }
+            }
+        }
+        return status > 0 ? status : HTTPC_ERROR_CONNECTION_LOST;
+    }
+
+    // Waits up to the timeout for data; 0 on timeout or a closed peer
+    int readSome(uint8_t* buf, size_t size) {
+        uint32_t start = millis();
+        for (;;) {
+            if (client->available()) {
+                return client->read(buf, size);
+            }
+            if (!client->connected() || millis() - start >= timeoutMs) {
+                return 0;
+            }
+            delay(1);
+        }
+    }
+
+    int readLine(std::string* line) {
+        line->clear();
+        uint8_t c;
+        for (;;) {
+            if (readSome(&c, 1) != 1) {
+                return client->connected() ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+            }
+            if (c == '\n') {
+                if (!line->empty() && line->back() == '\r') {
+                    line->pop_back();
+                }
+                return 0;
+            }
+            line->push_back((char)c);
+        }
+    }
+};
+
+#endif // HOST_SHIM_HTTPCLIENT_H
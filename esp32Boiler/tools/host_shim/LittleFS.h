@@ -0,0 +1,20 @@
+/*
+ * Host stand-in for the ESP32 LittleFS
+ *
+ * The in-memory filesystem of FS.h as the LittleFS global; begin() always
+ * mounts, as on a freshly formatted partition.
+ */
+
+#ifndef HOST_SHIM_LITTLEFS_H
+#define HOST_SHIM_LITTLEFS_H
+
+#include <FS.h>
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool = false) { return true; }
+};
+
+inline LittleFSFS LittleFS;
+
+#endif // HOST_SHIM_LITTLEFS_H
@@ -0,0 +1,12 @@
+/*
+ * Host stand-in for Web3E's Util
+ *
+ * Empty: src/main.cpp and the security door include it but call none of it.
+ */
+
+#ifndef HOST_SHIM_UTIL_H
+#define HOST_SHIM_UTIL_H
+
+#include <Web3.h>
+
+#endif // HOST_SHIM_UTIL_H
@@ -0,0 +1,78 @@
+/*
+ * Host stand-in for Web3E's Web3
+ *
+ * What src/ and the door pass around: a Web3 object that Contract sends
+ * through, and the string helpers around it. Signing and
+ * eth_sendRawTransaction are replaced by sendRaw, which a test points at
+ * its mock node; it receives the transaction fields and returns the
+ * node's raw JSON reply. Reads (eth_call, eth_getTransactionCount) go to
+ * call, which takes the method and its JSON params and returns the raw
+ * reply; left unset, every read fails.
+ */
+
+#ifndef HOST_SHIM_WEB3_H
+#define HOST_SHIM_WEB3_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <uint256/uint256_t.h>
+
+// Web3E's headers bring std::string in as string
+using std::string;
+
+#define MAINNET_ID 1
+#define SEPOLIA_ID 11155111
+
+struct Web3Transaction {
+    const char* privateKey;
+    uint32_t nonce;
+    unsigned long long gasPrice;
+    uint32_t gasLimit;
+    std::string to;
+    uint256_t value;
+    std::string data;
+};
+
+class Web3 {
+public:
+    explicit Web3(long long chainId = SEPOLIA_ID) : chainId(chainId) {}
+
+    long long chainId;
+    std::function<std::string(const Web3Transaction&)> sendRaw;
+    std::function<std::string(const char* method, const std::string& params)> call;
+
+    std::string read(const char* method, const std::string& params) {
+        if (!call) {
+            return "{\"jsonrpc\":\"2.0\",\"id\":1,\"error\":{\"code\":-32000,\"message\":\"no node\"}}";
+        }
+        return call(method, params);
+    }
+
+    int EthGetTransactionCount(const std::string* address) {
+        std::string reply = read("eth_getTransactionCount", "[\"" + *address + "\",\"pending\"]");
+        std::string result = getString(&reply);
+        if (result.size() < 3) {
+            throw std::runtime_error("eth_getTransactionCount failed");
+        }
+        return (int)strtol(result.c_str() + 2, nullptr, 16);
+    }
+
+    // The "result" string of a JSON-RPC reply, or "" if there is none
+    std::string getString(const std::string* json) {
+        size_t at = json->find("\"result\":\"");
+        if (at == std::string::npos) {
+            return "";
+        }
+        at += 10;
+        size_t end = json->find('"', at);
+        return end == std::string::npos ? "" : json->substr(at, end - at);
+    }
+
+    std::string getResult(const std::string* json) { return getString(json); }
+};
+
+#endif // HOST_SHIM_WEB3_H
@@ -0,0 +1,34 @@
+/*
+ * Host stand-in for the ESP32 WiFi library
+ *
+ * A station that is always associated: begin() and mode() do nothing,
+ * status() is WL_CONNECTED and localIP() is loopback, so sketches get
+ * past their WiFi setup and talk to stand-in nodes on 127.0.0.1.
+ */
+
+#ifndef HOST_SHIM_WIFI_H
+#define HOST_SHIM_WIFI_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define WIFI_STA 1
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+class WiFiClass {
+public:
+    void begin(const char*, const char* = nullptr) {}
+    bool mode(int) { return true; }
+    wl_status_t status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(htonl(INADDR_LOOPBACK)); }
+    int8_t RSSI() { return -50; }
+};
+
+inline WiFiClass WiFi;
+
+#endif // HOST_SHIM_WIFI_H
@@ -0,0 +1,166 @@
+/*
+ * Host stand-in for the ESP32 WiFiClient
+ *
+ * A TCP client on a non-blocking socket with the same virtual interface
+ * as ESPLwIPClient, so ResumableTlsClient and HTTPClient can sit on top
+ * of it. As on the device, read() and available() never wait; callers
+ * poll with their own timeout.
+ */
+
+#ifndef HOST_SHIM_WIFICLIENT_H
+#define HOST_SHIM_WIFICLIENT_H
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient() : fd(-1), peekedByte(-1) {}
+    virtual ~WiFiClient() { WiFiClient::stop(); }
+
+    virtual int connect(IPAddress ip, uint16_t port) { return connect(ip, port, 3000); }
+    virtual int connect(const char* host, uint16_t port) { return connect(host, port, 3000); }
+
+    virtual int connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = (uint32_t)ip;
+        addr.sin_port = htons(port);
+        return open(addr, timeoutMs);
+    }
+
+    virtual int connect(const char* host, uint16_t port, int32_t timeoutMs) {
+        addrinfo hints = {};
+        addrinfo* found = nullptr;
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host, nullptr, &hints, &found) != 0 || found == nullptr) {
+            return 0;
+        }
+        sockaddr_in addr = *(sockaddr_in*)found->ai_addr;
+        freeaddrinfo(found);
+        addr.sin_port = htons(port);
+        return open(addr, timeoutMs);
+    }
+
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size) override {
+        size_t sent = 0;
+        while (fd >= 0 && sent < size) {
+            ssize_t n = ::send(fd, buf + sent, size - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += n;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                pollfd p = {fd, POLLOUT, 0};
+                ::poll(&p, 1, 100);
+            } else {
+                break;
+            }
+        }
+        return sent;
+    }
+
+    int available() override {
+        if (fd < 0) {
+            return 0;
+        }
+        int n = 0;
+        ioctl(fd, FIONREAD, &n);
+        return n + (peekedByte >= 0);
+    }
+
+    int read() override {
+        uint8_t b;
+        return read(&b, 1) == 1 ? b : -1;
+    }
+
+    virtual int read(uint8_t* buf, size_t size) {
+        if (size == 0) {
+            return 0;
+        }
+        size_t got = 0;
+        if (peekedByte >= 0) {
+            buf[got++] = (uint8_t)peekedByte;
+            peekedByte = -1;
+        }
+        if (fd >= 0 && got < size) {
+            ssize_t n = ::recv(fd, buf + got, size - got, MSG_DONTWAIT);
+            if (n > 0) {
+                got += n;
+            } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                stop();
+            }
+        }
+        return got ? (int)got : -1;
+    }
+
+    int peek() override {
+        if (peekedByte < 0) {
+            uint8_t b;
+            if (read(&b, 1) == 1) {
+                peekedByte = b;
+            }
+        }
+        return peekedByte;
+    }
+
+    void flush() override {}
+
+    virtual void stop() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        peekedByte = -1;
+    }
+
+    // False once the peer has closed and nothing is left to read
+    virtual uint8_t connected() {
+        if (fd < 0) {
+            return peekedByte >= 0;
+        }
+        char b;
+        ssize_t n = ::recv(fd, &b, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            stop();
+            return 0;
+        }
+        return 1;
+    }
+
+private:
+    int fd;
+    int peekedByte;
+
+    int open(const sockaddr_in& addr, int32_t timeoutMs) {
+        stop();
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        if (::connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0 && errno != EINPROGRESS) {
+            stop();
+            return 0;
+        }
+        pollfd p = {fd, POLLOUT, 0};
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (::poll(&p, 1, timeoutMs) != 1 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error) {
+            stop();
+            return 0;
+        }
+        return 1;
+    }
+};
+
+#endif // HOST_SHIM_WIFICLIENT_H
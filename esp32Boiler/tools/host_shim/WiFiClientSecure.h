@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for the ESP32 WiFiClientSecure
+ *
+ * Plain TCP with the certificate setters accepted and ignored; host tools
+ * point HTTPS clients at stand-in services that speak plain HTTP.
+ */
+
+#ifndef HOST_SHIM_WIFICLIENTSECURE_H
+#define HOST_SHIM_WIFICLIENTSECURE_H
+
+#include <WiFiClient.h>
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setCACert(const char*) {}
+    void setInsecure() {}
+};
+
+#endif // HOST_SHIM_WIFICLIENTSECURE_H
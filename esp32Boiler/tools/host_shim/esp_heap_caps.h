@@ -0,0 +1,58 @@
+/*
+ * Host stand-in for ESP-IDF's esp_heap_caps.h
+ *
+ * The heap_caps_* queries HeapMonitor makes, answered from counters that
+ * a host tool keeps by replacing malloc (tools/heap_soak does): the heap
+ * is HOST_HEAP_BYTES, of which whatever was allocated since
+ * hostHeapStart() is in use. The largest free block is reported as all
+ * of the free heap, since the host allocator's layout says nothing about
+ * the ESP32's; fragmentation is only measured on the device. Without a
+ * counting malloc the heap always looks untouched.
+ */
+
+#ifndef HOST_SHIM_ESP_HEAP_CAPS_H
+#define HOST_SHIM_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+
+#ifndef HOST_HEAP_BYTES
+#define HOST_HEAP_BYTES (200 * 1024)      // Free DRAM heap of an ESP32 with WiFi up
+#endif
+
+// Bytes allocated, the most ever allocated at once, and the level
+// hostHeapStart() took as empty; constant-initialized, so a malloc that
+// runs before main() can already count
+inline std::atomic<int64_t> hostHeapUsed{0};
+inline std::atomic<int64_t> hostHeapPeak{0};
+inline std::atomic<int64_t> hostHeapBase{0};
+
+inline void hostHeapTake(size_t n) {
+    int64_t used = hostHeapUsed += (int64_t)n;
+    int64_t peak = hostHeapPeak;
+    while (used > peak && !hostHeapPeak.compare_exchange_weak(peak, used)) {
+    }
+}
+
+inline void hostHeapGive(size_t n) { hostHeapUsed -= (int64_t)n; }
+
+// Runtime pools allocated before main() do not count against the heap
+inline void hostHeapStart() {
+    hostHeapBase = hostHeapUsed.load();
+    hostHeapPeak = hostHeapBase.load();
+}
+
+inline size_t hostHeapFree(int64_t used) {
+    int64_t free = HOST_HEAP_BYTES - (used - hostHeapBase);
+    return free > 0 ? (size_t)free : 0;
+}
+
+inline size_t heap_caps_get_free_size(uint32_t) { return hostHeapFree(hostHeapUsed); }
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) { return heap_caps_get_free_size(caps); }
+inline size_t heap_caps_get_minimum_free_size(uint32_t) { return hostHeapFree(hostHeapPeak); }
+
+#endif // HOST_SHIM_ESP_HEAP_CAPS_H
@@ -0,0 +1,21 @@
+/*
+ * Host stand-in for the mbedtls types in src/tls_resume.h
+ *
+ * Types only, so the header compiles in host tools. The tools replace
+ * ResumableTlsClient with a plain TCP stand-in and never call mbedtls;
+ * ctr_drbg.h, entropy.h and x509_crt.h all resolve to this file.
+ */
+
+#ifndef HOST_SHIM_MBEDTLS_SSL_H
+#define HOST_SHIM_MBEDTLS_SSL_H
+
+#include <stddef.h>
+
+struct mbedtls_ssl_context {};
+struct mbedtls_ssl_config {};
+struct mbedtls_ssl_session {};
+struct mbedtls_x509_crt {};
+struct mbedtls_ctr_drbg_context {};
+struct mbedtls_entropy_context {};
+
+#endif // HOST_SHIM_MBEDTLS_SSL_H
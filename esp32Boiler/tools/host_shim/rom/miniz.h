@@ -0,0 +1,80 @@
+/*
+ * Host stand-in for the ESP32 ROM tinfl decoder
+ *
+ * Just the tinfl_decompress() subset src/gzip_inflate.cpp uses, mapped
+ * onto zlib's raw inflate (link with -lz). zlib keeps its own history, so
+ * the output base pointer is not needed here; status codes and input and
+ * output accounting follow tinfl. Decode times measured through this shim
+ * are zlib's, not the ROM decoder's.
+ */
+
+#ifndef HOST_SHIM_ROM_MINIZ_H
+#define HOST_SHIM_ROM_MINIZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+typedef uint8_t mz_uint8;
+typedef uint32_t mz_uint32;
+
+#define TINFL_FLAG_PARSE_ZLIB_HEADER 1
+#define TINFL_FLAG_HAS_MORE_INPUT 2
+#define TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF 4
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+struct tinfl_decompressor {
+    z_stream stream;
+    bool open;
+
+    tinfl_decompressor() : open(false) {}
+    ~tinfl_decompressor() {
+        if (open) {
+            inflateEnd(&stream);
+        }
+    }
+};
+
+inline void tinfl_init(tinfl_decompressor* r) {
+    if (r->open) {
+        inflateEnd(&r->stream);
+    }
+    memset(&r->stream, 0, sizeof(r->stream));
+    r->open = inflateInit2(&r->stream, -MAX_WBITS) == Z_OK;
+}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* in, size_t* inSize, mz_uint8* outStart,
+                                     mz_uint8* outNext, size_t* outSize, const mz_uint32 flags) {
+    (void)outStart;
+    (void)flags;
+    if (!r->open) {
+        return TINFL_STATUS_BAD_PARAM;
+    }
+    z_stream& s = r->stream;
+    s.next_in = const_cast<Bytef*>(in);
+    s.avail_in = (uInt)*inSize;
+    s.next_out = outNext;
+    s.avail_out = (uInt)*outSize;
+    int ret = inflate(&s, Z_NO_FLUSH);
+    *inSize -= s.avail_in;
+    *outSize -= s.avail_out;
+
+    if (ret == Z_STREAM_END) {
+        return TINFL_STATUS_DONE;
+    }
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        return TINFL_STATUS_FAILED;
+    }
+    return s.avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
+
+#endif // HOST_SHIM_ROM_MINIZ_H
@@ -0,0 +1,55 @@
+/*
+ * Plain-TCP stand-in for ResumableTlsClient
+ *
+ * Host tests run src/rpc_client.cpp against stand-in nodes that speak
+ * plain HTTP, so instead of src/tls_resume.cpp they include this file:
+ * the client is WiFiClient with the session bookkeeping left out, and
+ * every connect counts as a full handshake in stats().
+ *
+ * Defines the class's members; include it in exactly one translation
+ * unit, after tls_resume.h.
+ */
+
+#ifndef HOST_SHIM_TLS_STANDIN_H
+#define HOST_SHIM_TLS_STANDIN_H
+
+#include "tls_resume.h"
+
+static TlsResumeStats tlsStats;
+
+ResumableTlsClient::ResumableTlsClient()
+    : rootCA(nullptr), configured(false), established(false), lastResumed(false), peeked(-1),
+      handshakeTimeoutMs(TLS_HANDSHAKE_TIMEOUT_MS) {}
+ResumableTlsClient::~ResumableTlsClient() {}
+
+void ResumableTlsClient::setCACert(const char* root) { rootCA = root; }
+void ResumableTlsClient::setInsecure() { rootCA = nullptr; }
+
+int ResumableTlsClient::connect(IPAddress ip, uint16_t port) { return connect(ip, port, handshakeTimeoutMs); }
+int ResumableTlsClient::connect(const char* host, uint16_t port) { return connect(host, port, handshakeTimeoutMs); }
+
+int ResumableTlsClient::connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+    int ok = WiFiClient::connect(ip, port, timeoutMs);
+    ok ? tlsStats.full++ : tlsStats.failed++;
+    return ok;
+}
+
+int ResumableTlsClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    int ok = WiFiClient::connect(host, port, timeoutMs);
+    ok ? tlsStats.full++ : tlsStats.failed++;
+    return ok;
+}
+
+size_t ResumableTlsClient::write(const uint8_t* buf, size_t size) { return WiFiClient::write(buf, size); }
+int ResumableTlsClient::available() { return WiFiClient::available(); }
+int ResumableTlsClient::read() { return WiFiClient::read(); }
+int ResumableTlsClient::read(uint8_t* buf, size_t size) { return WiFiClient::read(buf, size); }
+int ResumableTlsClient::peek() { return WiFiClient::peek(); }
+void ResumableTlsClient::stop() { WiFiClient::stop(); }
+uint8_t ResumableTlsClient::connected() { return WiFiClient::connected(); }
+
+TlsResumeStats ResumableTlsClient::stats() { return tlsStats; }
+void ResumableTlsClient::forgetSessions() {}
+void ResumableTlsClient::report(Print&) {}
+
+#endif // HOST_SHIM_TLS_STANDIN_H
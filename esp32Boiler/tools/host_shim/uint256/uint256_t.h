@@ -0,0 +1,319 @@
+/*
+ * Host stand-in for Web3E's uint256_t
+ *
+ * Web3E's uint256_t is calccrypto's: a pair of uint128_t halves, each a
+ * pair of 64-bit words. This follows those algorithms so host benchmarks
+ * time the code the firmware used to run, not a faster substitute:
+ *
+ * - Multiply splits uint128_t operands into 32-bit pieces (16 products)
+ *   and uint256_t operands into 64-bit ones (16 uint128_t products)
+ * - divmod aligns the divisor and shifts and subtracts one bit per step
+ * - str() calls divmod once per digit; construction from text shifts in
+ *   one hex digit (or multiplies in one decimal digit) at a time
+ * - >= and <= evaluate both > (or <) and ==
+ *
+ * Only the interface the tree uses: integral and half-wise construction,
+ * upper()/lower(), arithmetic, bitwise and shift operators, comparisons,
+ * bits(), divmod() and str(). Not tuned, and not meant to be.
+ */
+
+#ifndef HOST_SHIM_UINT256_T_H
+#define HOST_SHIM_UINT256_T_H
+
+#include <stdint.h>
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+class uint128_t {
+public:
+    uint128_t() : hi(0), lo(0) {}
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    uint128_t(const T& value) : hi(0), lo((uint64_t)value) {}
+    uint128_t(uint64_t upper, uint64_t lower) : hi(upper), lo(lower) {}
+
+    const uint64_t& upper() const { return hi; }
+    const uint64_t& lower() const { return lo; }
+
+    explicit operator bool() const { return hi || lo; }
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    explicit operator T() const { return (T)lo; }
+
+    bool operator==(const uint128_t& b) const { return hi == b.hi && lo == b.lo; }
+    bool operator!=(const uint128_t& b) const { return !(*this == b); }
+    bool operator>(const uint128_t& b) const { return hi == b.hi ? lo > b.lo : hi > b.hi; }
+    bool operator<(const uint128_t& b) const { return hi == b.hi ? lo < b.lo : hi < b.hi; }
+    bool operator>=(const uint128_t& b) const { return (*this > b) | (*this == b); }
+    bool operator<=(const uint128_t& b) const { return (*this < b) | (*this == b); }
+
+    uint128_t operator&(const uint128_t& b) const { return uint128_t(hi & b.hi, lo & b.lo); }
+    uint128_t operator|(const uint128_t& b) const { return uint128_t(hi | b.hi, lo | b.lo); }
+    uint128_t operator^(const uint128_t& b) const { return uint128_t(hi ^ b.hi, lo ^ b.lo); }
+    uint128_t operator~() const { return uint128_t(~hi, ~lo); }
+
+    uint128_t operator<<(const uint128_t& b) const {
+        const uint64_t shift = b.lo;
+        if (b.hi || shift >= 128) return uint128_t();
+        if (shift == 64) return uint128_t(lo, 0);
+        if (shift == 0) return *this;
+        if (shift < 64) return uint128_t((hi << shift) + (lo >> (64 - shift)), lo << shift);
+        return uint128_t(lo << (shift - 64), 0);
+    }
+    uint128_t operator>>(const uint128_t& b) const {
+        const uint64_t shift = b.lo;
+        if (b.hi || shift >= 128) return uint128_t();
+        if (shift == 64) return uint128_t(0, hi);
+        if (shift == 0) return *this;
+        if (shift < 64) return uint128_t(hi >> shift, (hi << (64 - shift)) + (lo >> shift));
+        return uint128_t(0, hi >> (shift - 64));
+    }
+
+    uint128_t operator+(const uint128_t& b) const { return uint128_t(hi + b.hi + ((lo + b.lo) < lo), lo + b.lo); }
+    uint128_t operator-(const uint128_t& b) const { return uint128_t(hi - b.hi - ((lo - b.lo) > lo), lo - b.lo); }
+
+    uint128_t operator*(const uint128_t& b) const {
+        uint64_t top[4] = {hi >> 32, hi & 0xffffffff, lo >> 32, lo & 0xffffffff};
+        uint64_t bottom[4] = {b.hi >> 32, b.hi & 0xffffffff, b.lo >> 32, b.lo & 0xffffffff};
+        uint64_t products[4][4];
+        for (int y = 3; y > -1; y--) {
+            for (int x = 3; x > -1; x--) {
+                products[3 - x][y] = top[x] * bottom[y];
+            }
+        }
+        uint64_t fourth32 = products[0][3] & 0xffffffff;
+        uint64_t third32 = (products[0][2] & 0xffffffff) + (products[0][3] >> 32);
+        uint64_t second32 = (products[0][1] & 0xffffffff) + (products[0][2] >> 32);
+        uint64_t first32 = (products[0][0] & 0xffffffff) + (products[0][1] >> 32);
+        third32 += products[1][3] & 0xffffffff;
+        second32 += (products[1][2] & 0xffffffff) + (products[1][3] >> 32);
+        first32 += (products[1][1] & 0xffffffff) + (products[1][2] >> 32);
+        second32 += products[2][3] & 0xffffffff;
+        first32 += (products[2][2] & 0xffffffff) + (products[2][3] >> 32);
+        first32 += products[3][3] & 0xffffffff;
+        third32 += fourth32 >> 32;
+        second32 += third32 >> 32;
+        first32 += second32 >> 32;
+        fourth32 &= 0xffffffff;
+        third32 &= 0xffffffff;
+        second32 &= 0xffffffff;
+        first32 &= 0xffffffff;
+        return uint128_t((first32 << 32) | second32, (third32 << 32) | fourth32);
+    }
+
+    uint16_t bits() const {
+        uint16_t out = 0;
+        uint64_t v = hi ? hi : lo;
+        if (hi) {
+            out = 64;
+        }
+        while (v) {
+            v >>= 1;
+            out++;
+        }
+        return out;
+    }
+
+    static std::pair<uint128_t, uint128_t> divmod(const uint128_t& a, const uint128_t& b) {
+        if (b == uint128_t()) throw std::domain_error("Error: division or modulus by 0");
+        if (b == uint128_t(1)) return {a, uint128_t()};
+        if (a == b) return {uint128_t(1), uint128_t()};
+        if (a == uint128_t() || a < b) return {uint128_t(), a};
+
+        std::pair<uint128_t, uint128_t> qr(uint128_t(), a);
+        uint128_t copyd = b << uint128_t(a.bits() - b.bits());
+        uint128_t adder = uint128_t(1) << uint128_t(a.bits() - b.bits());
+        if (copyd > qr.second) {
+            copyd = copyd >> uint128_t(1);
+            adder = adder >> uint128_t(1);
+        }
+        while (qr.second >= b) {
+            if (qr.second >= copyd) {
+                qr.second = qr.second - copyd;
+                qr.first = qr.first | adder;
+            }
+            copyd = copyd >> uint128_t(1);
+            adder = adder >> uint128_t(1);
+        }
+        return qr;
+    }
+
+    uint128_t operator/(const uint128_t& b) const { return divmod(*this, b).first; }
+    uint128_t operator%(const uint128_t& b) const { return divmod(*this, b).second; }
+
+    uint128_t& operator+=(const uint128_t& b) { return *this = *this + b; }
+    uint128_t& operator-=(const uint128_t& b) { return *this = *this - b; }
+    uint128_t& operator*=(const uint128_t& b) { return *this = *this * b; }
+    uint128_t& operator|=(const uint128_t& b) { return *this = *this | b; }
+    uint128_t& operator<<=(const uint128_t& b) { return *this = *this << b; }
+    uint128_t& operator>>=(const uint128_t& b) { return *this = *this >> b; }
+
+private:
+    uint64_t hi;
+    uint64_t lo;
+};
+
+class uint256_t {
+public:
+    uint256_t() {}
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    uint256_t(const T& value) : hi(), lo(value) {}
+    uint256_t(const uint128_t& upper, const uint128_t& lower) : hi(upper), lo(lower) {}
+
+    // Digits in the given base (2-36), most significant first, no prefix
+    uint256_t(const std::string& text, uint8_t base) {
+        for (char c : text) {
+            uint8_t d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'z' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'Z' ? c - 'A' + 10 : 0;
+            if (base == 16) {
+                *this = (*this << uint256_t(4)) | uint256_t(d);
+            } else {
+                *this = *this * uint256_t(base) + uint256_t(d);
+            }
+        }
+    }
+
+    const uint128_t& upper() const { return hi; }
+    const uint128_t& lower() const { return lo; }
+
+    explicit operator bool() const { return (bool)hi || (bool)lo; }
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    explicit operator T() const { return (T)lo; }
+
+    bool operator==(const uint256_t& b) const { return hi == b.hi && lo == b.lo; }
+    bool operator!=(const uint256_t& b) const { return !(*this == b); }
+    bool operator>(const uint256_t& b) const { return hi == b.hi ? lo > b.lo : hi > b.hi; }
+    bool operator<(const uint256_t& b) const { return hi == b.hi ? lo < b.lo : hi < b.hi; }
+    bool operator>=(const uint256_t& b) const { return (*this > b) | (*this == b); }
+    bool operator<=(const uint256_t& b) const { return (*this < b) | (*this == b); }
+
+    uint256_t operator&(const uint256_t& b) const { return uint256_t(hi & b.hi, lo & b.lo); }
+    uint256_t operator|(const uint256_t& b) const { return uint256_t(hi | b.hi, lo | b.lo); }
+    uint256_t operator^(const uint256_t& b) const { return uint256_t(hi ^ b.hi, lo ^ b.lo); }
+    uint256_t operator~() const { return uint256_t(~hi, ~lo); }
+
+    uint256_t operator<<(const uint256_t& b) const {
+        const uint128_t shift = b.lo;
+        const uint128_t u128(128), u256(256);
+        if ((bool)b.hi || shift >= u256) return uint256_t();
+        if (shift == u128) return uint256_t(lo, uint128_t());
+        if (shift == uint128_t()) return *this;
+        if (shift < u128) return uint256_t((hi << shift) + (lo >> (u128 - shift)), lo << shift);
+        return uint256_t(lo << (shift - u128), uint128_t());
+    }
+    uint256_t operator>>(const uint256_t& b) const {
+        const uint128_t shift = b.lo;
+        const uint128_t u128(128), u256(256);
+        if ((bool)b.hi || shift >= u256) return uint256_t();
+        if (shift == u128) return uint256_t(uint128_t(), hi);
+        if (shift == uint128_t()) return *this;
+        if (shift < u128) return uint256_t(hi >> shift, (hi << (u128 - shift)) + (lo >> shift));
+        return uint256_t(uint128_t(), hi >> (shift - u128));
+    }
+
+    uint256_t operator+(const uint256_t& b) const {
+        return uint256_t(hi + b.hi + ((lo + b.lo) < lo ? uint128_t(1) : uint128_t()), lo + b.lo);
+    }
+    uint256_t operator-(const uint256_t& b) const {
+        return uint256_t(hi - b.hi - ((lo - b.lo) > lo ? uint128_t(1) : uint128_t()), lo - b.lo);
+    }
+
+    uint256_t operator*(const uint256_t& b) const {
+        uint128_t top[4] = {hi.upper(), hi.lower(), lo.upper(), lo.lower()};
+        uint128_t bottom[4] = {b.hi.upper(), b.hi.lower(), b.lo.upper(), b.lo.lower()};
+        uint128_t products[4][4];
+        for (int y = 3; y > -1; y--) {
+            for (int x = 3; x > -1; x--) {
+                products[3 - y][x] = top[x] * bottom[y];
+            }
+        }
+        uint128_t fourth64 = uint128_t(products[0][3].lower());
+        uint128_t third64 = uint128_t(products[0][2].lower()) + uint128_t(products[0][3].upper());
+        uint128_t second64 = uint128_t(products[0][1].lower()) + uint128_t(products[0][2].upper());
+        uint128_t first64 = uint128_t(products[0][0].lower()) + uint128_t(products[0][1].upper());
+        third64 += uint128_t(products[1][3].lower());
+        second64 += uint128_t(products[1][2].lower()) + uint128_t(products[1][3].upper());
+        first64 += uint128_t(products[1][1].lower()) + uint128_t(products[1][2].upper());
+        second64 += uint128_t(products[2][3].lower());
+        first64 += uint128_t(products[2][2].lower()) + uint128_t(products[2][3].upper());
+        first64 += uint128_t(products[3][3].lower());
+        const uint128_t u64(64);
+        return uint256_t(first64 << u64, uint128_t()) + uint256_t(third64.upper(), third64 << u64) +
+               uint256_t(second64, uint128_t()) + uint256_t(uint128_t(), fourth64);
+    }
+
+    uint16_t bits() const {
+        uint16_t out = 0;
+        uint128_t v = (bool)hi ? hi : lo;
+        if ((bool)hi) {
+            out = 128;
+        }
+        while ((bool)v) {
+            v >>= uint128_t(1);
+            out++;
+        }
+        return out;
+    }
+
+    static std::pair<uint256_t, uint256_t> divmod(const uint256_t& a, const uint256_t& b) {
+        if (b == uint256_t()) throw std::domain_error("Error: division or modulus by 0");
+        if (b == uint256_t(1)) return {a, uint256_t()};
+        if (a == b) return {uint256_t(1), uint256_t()};
+        if (a == uint256_t() || a < b) return {uint256_t(), a};
+
+        std::pair<uint256_t, uint256_t> qr(uint256_t(), a);
+        uint256_t copyd = b << uint256_t(a.bits() - b.bits());
+        uint256_t adder = uint256_t(1) << uint256_t(a.bits() - b.bits());
+        if (copyd > qr.second) {
+            copyd = copyd >> uint256_t(1);
+            adder = adder >> uint256_t(1);
+        }
+        while (qr.second >= b) {
+            if (qr.second >= copyd) {
+                qr.second = qr.second - copyd;
+                qr.first = qr.first | adder;
+            }
+            copyd = copyd >> uint256_t(1);
+            adder = adder >> uint256_t(1);
+        }
+        return qr;
+    }
+
+    uint256_t operator/(const uint256_t& b) const { return divmod(*this, b).first; }
+    uint256_t operator%(const uint256_t& b) const { return divmod(*this, b).second; }
+
+    uint256_t& operator+=(const uint256_t& b) { return *this = *this + b; }
+    uint256_t& operator-=(const uint256_t& b) { return *this = *this - b; }
+    uint256_t& operator*=(const uint256_t& b) { return *this = *this * b; }
+    uint256_t& operator/=(const uint256_t& b) { return *this = *this / b; }
+    uint256_t& operator%=(const uint256_t& b) { return *this = *this % b; }
+    uint256_t& operator|=(const uint256_t& b) { return *this = *this | b; }
+    uint256_t& operator<<=(const uint256_t& b) { return *this = *this << b; }
+    uint256_t& operator>>=(const uint256_t& b) { return *this = *this >> b; }
+
+    // One divmod per digit, zero-padded to at least len
+    std::string str(uint8_t base = 10, unsigned len = 0) const {
+        if (base < 2 || base > 36) throw std::invalid_argument("Base must be in the range 2-36");
+        std::string out;
+        if (!*this) {
+            out = "0";
+        } else {
+            std::pair<uint256_t, uint256_t> qr(*this, uint256_t());
+            do {
+                qr = divmod(qr.first, uint256_t(base));
+                out = "0123456789abcdefghijklmnopqrstuvwxyz"[(uint8_t)qr.second] + out;
+            } while ((bool)qr.first);
+        }
+        if (out.size() < len) {
+            out = std::string(len - out.size(), '0') + out;
+        }
+        return out;
+    }
+
+private:
+    uint128_t hi;
+    uint128_t lo;
+};
+
+#endif // HOST_SHIM_UINT256_T_H
@@ -0,0 +1,385 @@
+/*
+ * Door HTTP Server Load Test
+ *
+ * Runs examples/security_door/async_http_server.cpp on the host (AsyncTCP
+ * and FreeRTOS from tools/host_shim, on real loopback sockets) with the
+ * door's routes and limits: the gzipped page from flash, small inline JSON
+ * replies, a deferred handler that stands in for signature recovery on
+ * the loop() task, and an events stream fed by broadcast(). Concurrent
+ * keep-alive clients hammer it while one client dribbles half a request
+ * and stops, the way a stalled phone does.
+ *
+ * Reports requests per second and latency percentiles per route. A
+ * request's latency runs from its first attempt to its answer, so time
+ * spent waiting out a 503 at the connection limit counts. Checks that
+ * every answer is complete, the stalled client gets its 408 without
+ * holding anyone up, and the subscriber keeps receiving events. Exits
+ * non-zero if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -pthread -I../host_shim http_load.cpp \
+ *       ../../examples/security_door/async_http_server.cpp -o http_load
+ *   ./http_load --clients 20 --seconds 5
+ *
+ * Options (defaults in brackets):
+ *   --clients N      concurrent clients [20]
+ *   --seconds S      run time; over 4 s so the stalled client times out [5]
+ *   --handler-ms MS  time the deferred handler holds the loop task [5]
+ *   --port N         loopback port [18080]
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../../examples/security_door/async_http_server.h"
+#include "../../examples/security_door/door_page.h"
+
+static int failures = 0;
+static std::mutex failLock;
+
+static void check(bool ok, const char* what) {
+    std::lock_guard<std::mutex> guard(failLock);
+    if (!ok && failures++ < 10) {
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// ===== DOOR ROUTES =====
+static uint32_t handlerMs = 5;
+static AsyncHttpServer server(18080);
+
+static const char CHALLENGE_REPLY[] = "{\"id\":\"1a2b3c4d\",\"challenge\":\"falcon 48213 #1a2b3c4d\"}";
+static const char STATUS_REPLY[] = "{\"door\":\"LOCKED\",\"pending\":3,\"last\":null}";
+static const char VERDICT_REPLY[] = "pass";
+
+static void handlePage(const HttpRequest& request, HttpResponse& response) {
+    const char* etag = request.ifNoneMatch();
+    if (etag != nullptr && strcmp(etag, DOOR_PAGE_ETAG) == 0) {
+        response.send(304);
+        return;
+    }
+    response.header("Content-Encoding", "gzip");
+    response.header("ETag", DOOR_PAGE_ETAG);
+    response.sendStatic(200, "text/html", DOOR_PAGE_GZ, DOOR_PAGE_GZ_LEN);
+}
+
+static void handleChallenge(const HttpRequest&, HttpResponse& response) {
+    response.send(200, "application/json", CHALLENGE_REPLY);
+}
+
+static void handleStatus(const HttpRequest&, HttpResponse& response) {
+    response.send(200, "application/json", STATUS_REPLY);
+}
+
+// Deferred: recovery and the holder lookup keep loop() busy this long
+static void handleCheck(const HttpRequest& request, HttpResponse& response) {
+    char sig[140];
+    bool ok = request.arg("sig", sig, sizeof(sig)) && strlen(sig) == 132;
+    delay(handlerMs);
+    response.send(ok ? 200 : 400, "text/plain", ok ? VERDICT_REPLY : "fail: malformed signature");
+}
+
+// ===== CLIENTS =====
+struct Route {
+    const char* name;
+    const char* target;
+    size_t bodyLen;
+    int weight;
+};
+
+static const char CHECK_TARGET[] =
+    "/api/checkSignature?id=1a2b3c4d&addr=0x5aaeb6053f3e94c9b9a09f33669435e7ef1beaed&sig=0x"
+    "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+    "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb1b";
+
+static const Route ROUTES[] = {
+    {"/", "/", DOOR_PAGE_GZ_LEN, 10},
+    {"/api/getChallenge", "/api/getChallenge", sizeof(CHALLENGE_REPLY) - 1, 30},
+    {"/api/checkSignature", CHECK_TARGET, sizeof(VERDICT_REPLY) - 1, 20},
+    {"/api/status", "/api/status", sizeof(STATUS_REPLY) - 1, 40},
+};
+static const size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+
+struct ClientStats {
+    std::vector<uint32_t> latencyUs[ROUTE_COUNT];
+    uint32_t busy = 0;          // 503 at the connection limit
+    uint32_t reconnects = 0;
+    uint32_t bad = 0;
+};
+
+static uint16_t port = 18080;
+
+static int openConnection() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    timeval timeout = {10, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+struct Reply {
+    int status;
+    size_t bodyLen;
+    bool close;
+};
+
+// Reads one response; false if the connection went away first
+static bool readReply(int fd, std::string& buf, Reply* reply) {
+    size_t headEnd;
+    while ((headEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buf.append(chunk, n);
+    }
+    reply->status = atoi(buf.c_str() + 9);
+    size_t at = buf.find("Content-Length: ");
+    size_t length = at < headEnd ? strtoul(buf.c_str() + at + 16, nullptr, 10) : 0;
+    reply->close = buf.find("Connection: close") < headEnd;
+    size_t total = headEnd + 4 + length;
+    while (buf.size() < total) {
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buf.append(chunk, n);
+    }
+    reply->bodyLen = length;
+    buf.erase(0, total);
+    return true;
+}
+
+static void runClient(ClientStats& stats, std::atomic<bool>& stop, uint64_t seed) {
+    uint64_t rng = seed | 1;
+    int total = 0;
+    for (const Route& r : ROUTES) {
+        total += r.weight;
+    }
+
+    int fd = -1;
+    std::string buf;
+    while (!stop) {
+        int pick = nextRandom(rng) % total;
+        size_t route = 0;
+        while (pick >= ROUTES[route].weight) {
+            pick -= ROUTES[route++].weight;
+        }
+
+        char request[512];
+        int len = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: door.local\r\n\r\n",
+                           ROUTES[route].target);
+        uint32_t start = micros();
+        for (;;) {
+            if (fd < 0) {
+                fd = openConnection();
+                buf.clear();
+                stats.reconnects++;
+                if (fd < 0) {
+                    delay(1);
+                    continue;
+                }
+            }
+            Reply reply;
+            if (send(fd, request, len, MSG_NOSIGNAL) != len || !readReply(fd, buf, &reply)) {
+                close(fd);  // Closed after its request cap; ask again on a new one
+                fd = -1;
+                if (stop) {
+                    break;
+                }
+                continue;
+            }
+            if (reply.close) {
+                close(fd);
+                fd = -1;
+            }
+            if (reply.status == 503) {
+                stats.busy++;
+                delay(2);
+                continue;
+            }
+            if (reply.status != 200 || reply.bodyLen != ROUTES[route].bodyLen) {
+                stats.bad++;
+            }
+            stats.latencyUs[route].push_back(micros() - start);
+            break;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+// Sends the first line of a request and nothing more; the server must
+// answer 408 and drop it after HTTP_REQUEST_TIMEOUT_MS
+static void runStalled(int* status, uint32_t* heldMs) {
+    int fd = openConnection();
+    const char partial[] = "GET /api/status HTTP/1.1\r\nHost: door";
+    send(fd, partial, sizeof(partial) - 1, MSG_NOSIGNAL);
+    uint32_t start = millis();
+    std::string buf;
+    Reply reply;
+    *status = readReply(fd, buf, &reply) ? reply.status : -1;
+    *heldMs = millis() - start;
+    close(fd);
+}
+
+static void runSubscriber(std::atomic<bool>& stop, uint32_t* events) {
+    int fd = openConnection();
+    timeval timeout = {0, 200000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    const char request[] = "GET /api/events HTTP/1.1\r\nHost: door.local\r\n\r\n";
+    send(fd, request, sizeof(request) - 1, MSG_NOSIGNAL);
+    std::string seen;
+    while (!stop) {
+        char chunk[1024];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n == 0) {
+            break;
+        }
+        if (n > 0) {
+            seen.append(chunk, n);
+        }
+    }
+    for (size_t at = 0; (at = seen.find("event: door", at)) != std::string::npos; at++) {
+        (*events)++;
+    }
+    close(fd);
+}
+
+static uint32_t percentile(std::vector<uint32_t>& v, double pct) {
+    if (v.empty()) {
+        return 0;
+    }
+    std::sort(v.begin(), v.end());
+    return v[(size_t)((v.size() - 1) * pct / 100)];
+}
+
+int main(int argc, char** argv) {
+    uint32_t clients = 20, seconds = 5;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--clients") == 0) clients = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seconds") == 0) seconds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--handler-ms") == 0) handlerMs = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--port") == 0) port = atoi(argv[i + 1]);
+    }
+
+    server.~AsyncHttpServer();
+    new (&server) AsyncHttpServer(port);
+    server.on("/", handlePage);
+    server.on("/api/getChallenge", handleChallenge);
+    server.on("/api/checkSignature", handleCheck, true);
+    server.on("/api/status", handleStatus);
+    server.onEvents("/api/events");
+    server.begin();
+
+    // The loop() task: deferred handlers, and a state push now and then
+    std::atomic<bool> stop{false}, loopStop{false};
+    std::thread loopTask([&] {
+        uint32_t pushedAt = 0;
+        while (!loopStop) {
+            server.handleDeferred();
+            if (millis() - pushedAt >= 100) {
+                pushedAt = millis();
+                server.broadcast("door", STATUS_REPLY);
+            }
+            delay(1);
+        }
+    });
+    delay(50);
+
+    uint32_t events = 0;
+    std::thread subscriber(runSubscriber, std::ref(stop), &events);
+    int stalledStatus = 0;
+    uint32_t stalledMs = 0;
+    std::thread stalled(runStalled, &stalledStatus, &stalledMs);
+    delay(50);
+
+    printf("%u clients for %u s, %d connection slots, deferred handler %u ms\n\n", clients, seconds,
+           HTTP_MAX_CONNECTIONS, handlerMs);
+
+    std::vector<ClientStats> stats(clients);
+    std::vector<std::thread> threads;
+    uint32_t start = millis();
+    for (uint32_t c = 0; c < clients; c++) {
+        threads.emplace_back(runClient, std::ref(stats[c]), std::ref(stop), 0x9E3779B97F4A7C15ULL * (c + 1));
+    }
+    delay(seconds * 1000);
+    stop = true;
+    double elapsed = (millis() - start) / 1000.0;
+    for (auto& t : threads) {
+        t.join();  // Requests in flight still get their answers
+    }
+    stalled.join();
+    subscriber.join();
+    loopStop = true;
+    loopTask.join();
+
+    std::vector<uint32_t> all;
+    uint32_t busy = 0, reconnects = 0, bad = 0;
+    printf("%-22s %9s %9s %9s %9s %9s\n", "route", "requests", "req/s", "p50 ms", "p99 ms", "max ms");
+    for (size_t r = 0; r < ROUTE_COUNT; r++) {
+        std::vector<uint32_t> route;
+        for (ClientStats& s : stats) {
+            route.insert(route.end(), s.latencyUs[r].begin(), s.latencyUs[r].end());
+        }
+        all.insert(all.end(), route.begin(), route.end());
+        size_t n = route.size();
+        printf("%-22s %9zu %9.0f %9.2f %9.2f %9.2f\n", ROUTES[r].name, n, n / elapsed, percentile(route, 50) / 1000.0,
+               percentile(route, 99) / 1000.0, percentile(route, 100) / 1000.0);
+    }
+    for (ClientStats& s : stats) {
+        busy += s.busy;
+        reconnects += s.reconnects;
+        bad += s.bad;
+    }
+    size_t n = all.size();
+    printf("%-22s %9zu %9.0f %9.2f %9.2f %9.2f\n", "all", n, n / elapsed, percentile(all, 50) / 1000.0,
+           percentile(all, 99) / 1000.0, percentile(all, 100) / 1000.0);
+
+    HttpServerStats s = server.stats();
+    printf("\n%u turned away at the connection limit, %u connections opened, %u events to the subscriber\n", busy,
+           reconnects, events);
+    printf("stalled client: %d after %u ms; server counted %u requests, %u deferred, %u timeouts\n\n",
+           stalledStatus, stalledMs, s.requests, s.deferred, s.timeouts);
+
+    check(n > 0, "no requests answered");
+    check(bad == 0, "incomplete or failed answer");
+    check(seconds * 1000 < HTTP_REQUEST_TIMEOUT_MS + 500 ||
+              (stalledStatus == 408 && stalledMs < HTTP_REQUEST_TIMEOUT_MS + 1000),
+          "stalled client not timed out");
+    check(events >= seconds * 5, "subscriber starved of events");
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,390 @@
+"""
+Reference ERC-2771 relayer
+
+Accepts ForwardRequests signed by devices (src/meta_tx.h), checks them the
+way contracts/BatchForwarder.sol will (EIP-712 signature, nonce, deadline),
+queues them and submits many per transaction with executeBatch(). Devices
+then need no gas token and make no node RPCs of their own.
+
+Meant for local testing against a development node whose accounts are
+unlocked (anvil, hardhat node, geth --dev): batches go out with
+eth_sendTransaction from --account. With --dry-run there is no node at all:
+nonces are tracked in memory and each batch is logged with its calldata
+size instead of being sent.
+
+Usage:
+    python tools/relayer/relayer.py --forwarder 0x... --chain-id 31337 \\
+        --rpc http://127.0.0.1:8545 --account 0x... [--port 8088]
+        [--batch-size 32] [--batch-ms 2000] [--max-gas 500000] [--dry-run]
+
+Endpoints:
+    GET  /nonce/<address>  {"nonce":N}, counting requests still queued
+    POST /relay            ForwardRequest JSON -> {"queued":true,"id":"..."}
+                           or HTTP 400 {"error":"...","nonce":N}
+    GET  /stats            counters and the transaction saving so far
+
+Only the Python standard library is needed; Keccak comes from
+scripts/abi_codegen.py.
+"""
+
+import argparse
+import json
+import os
+import sys
+import threading
+import time
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "scripts"))
+from abi_codegen import keccak256  # noqa: E402
+
+# ===== SECP256K1 =====
+# Affine arithmetic with modular inverses: slow, but a relayer for a test
+# bench checks a few hundred signatures a second at most.
+
+P = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F
+N = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141
+G = (0x79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798,
+     0x483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8)
+
+
+def _add(a, b):
+    if a is None:
+        return b
+    if b is None:
+        return a
+    if a[0] == b[0] and (a[1] + b[1]) % P == 0:
+        return None
+    if a == b:
+        m = 3 * a[0] * a[0] * pow(2 * a[1], -1, P) % P
+    else:
+        m = (b[1] - a[1]) * pow(b[0] - a[0], -1, P) % P
+    x = (m * m - a[0] - b[0]) % P
+    return x, (m * (a[0] - x) - a[1]) % P
+
+
+def _mul(k, point):
+    result = None
+    while k:
+        if k & 1:
+            result = _add(result, point)
+        point = _add(point, point)
+        k >>= 1
+    return result
+
+
+def recover(digest, signature):
+    """Signer address (20 bytes) of a 65-byte r || s || v signature, or None."""
+    if len(signature) != 65 or signature[64] not in (27, 28):
+        return None
+    r = int.from_bytes(signature[:32], "big")
+    s = int.from_bytes(signature[32:64], "big")
+    if not (0 < r < N and 0 < s <= N // 2):
+        return None
+    y2 = (pow(r, 3, P) + 7) % P
+    y = pow(y2, (P + 1) // 4, P)
+    if y * y % P != y2:
+        return None
+    if y % 2 != signature[64] - 27:
+        y = P - y
+    e = int.from_bytes(digest, "big")
+    r_inv = pow(r, -1, N)
+    q = _add(_mul(s * r_inv % N, (r, y)), _mul((-e * r_inv) % N, G))
+    if q is None:
+        return None
+    return keccak256(q[0].to_bytes(32, "big") + q[1].to_bytes(32, "big"))[12:]
+
+
+# ===== EIP-712 =====
+DOMAIN_TYPE = b"EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)"
+REQUEST_TYPE = (b"ForwardRequest(address from,address to,uint256 value,uint256 gas,uint256 nonce,"
+                b"uint48 deadline,bytes data)")
+
+
+def word(value):
+    return value.to_bytes(32, "big")
+
+
+def address_word(addr):
+    return bytes(12) + addr
+
+
+def domain_separator(chain_id, forwarder):
+    return keccak256(keccak256(DOMAIN_TYPE) + keccak256(b"PolkaESP Forwarder") + keccak256(b"1") +
+                     word(chain_id) + address_word(forwarder))
+
+
+def request_digest(separator, req):
+    struct_hash = keccak256(keccak256(REQUEST_TYPE) + address_word(req["from"]) + address_word(req["to"]) +
+                            word(req["value"]) + word(req["gas"]) + word(req["nonce"]) +
+                            word(req["deadline"]) + keccak256(req["data"]))
+    return keccak256(b"\x19\x01" + separator + struct_hash)
+
+
+# ===== ABI =====
+def selector(sig):
+    return keccak256(sig.encode())[:4]
+
+
+EXECUTE_BATCH = selector("executeBatch((address,address,uint256,uint256,uint256,uint48,bytes,bytes)[])")
+NONCES = selector("nonces(address)")
+# Requests skipped on chain (state changed since queueing, or too little gas left in the batch)
+REJECTED_TOPIC = "0x" + keccak256(b"RejectedForwardRequest(address,uint256,string)").hex()
+
+
+def _dynamic(data):
+    return word(len(data)) + data + bytes(-len(data) % 32)
+
+
+def encode_execute_batch(requests):
+    """executeBatch(ForwardRequestData[]) calldata."""
+    elements = []
+    for req in requests:
+        head_size = 8 * 32
+        data = _dynamic(req["data"])
+        element = (address_word(req["from"]) + address_word(req["to"]) + word(req["value"]) +
+                   word(req["gas"]) + word(req["nonce"]) + word(req["deadline"]) +
+                   word(head_size) + word(head_size + len(data)) + data + _dynamic(req["signature"]))
+        elements.append(element)
+    offsets, at = b"", 32 * len(elements)
+    for element in elements:
+        offsets += word(at)
+        at += len(element)
+    return EXECUTE_BATCH + word(32) + word(len(elements)) + offsets + b"".join(elements)
+
+
+# ===== NODE =====
+class Node:
+    def __init__(self, url):
+        self.url = url
+        self.next_id = 0
+
+    def call(self, method, params):
+        self.next_id += 1
+        body = json.dumps({"jsonrpc": "2.0", "id": self.next_id, "method": method, "params": params}).encode()
+        request = urllib.request.Request(self.url, body, {"Content-Type": "application/json"})
+        with urllib.request.urlopen(request, timeout=10) as reply:
+            response = json.load(reply)
+        if "error" in response:
+            raise RuntimeError("%s: %s" % (method, response["error"].get("message", response["error"])))
+        return response["result"]
+
+
+# ===== RELAYER =====
+def parse_request(body):
+    """Decoded ForwardRequest dict; raises ValueError on malformed input."""
+    def hexbytes(name, size=None):
+        text = body[name]
+        if not isinstance(text, str) or not text.startswith("0x"):
+            raise ValueError("%s must be 0x-hex" % name)
+        value = bytes.fromhex(text[2:])
+        if size is not None and len(value) != size:
+            raise ValueError("%s must be %d bytes" % (name, size))
+        return value
+
+    def number(name):
+        return int(str(body[name]), 0)
+
+    try:
+        return {
+            "from": hexbytes("from", 20), "to": hexbytes("to", 20), "value": number("value"),
+            "gas": number("gas"), "nonce": number("nonce"), "deadline": number("deadline"),
+            "data": hexbytes("data"), "signature": hexbytes("signature", 65),
+        }
+    except KeyError as e:
+        raise ValueError("missing field %s" % e)
+
+
+class Relayer:
+    def __init__(self, args):
+        self.args = args
+        self.forwarder = bytes.fromhex(args.forwarder[2:])
+        self.separator = domain_separator(args.chain_id, self.forwarder)
+        self.node = None if args.dry_run else Node(args.rpc)
+        self.lock = threading.Condition()
+        self.queue = []
+        self.pending = {}           # from -> requests queued or in flight
+        self.nonces = {}            # from -> next nonce on chain (cached)
+        self.stats = {"queued": 0, "rejected": 0, "batches": 0, "executed": 0, "failed_batches": 0,
+                      "rejected_on_chain": 0, "gas_used": 0}
+        self.sequence = 0
+
+    def chain_nonce(self, sender):
+        if sender not in self.nonces:
+            if self.node is None:
+                self.nonces[sender] = 0
+            else:
+                result = self.node.call("eth_call", [{"to": "0x" + self.forwarder.hex(),
+                                                      "data": "0x" + (NONCES + address_word(sender)).hex()},
+                                                     "latest"])
+                self.nonces[sender] = int(result, 16)
+        return self.nonces[sender]
+
+    def next_nonce(self, sender):
+        with self.lock:
+            return self.chain_nonce(sender) + self.pending.get(sender, 0)
+
+    def submit(self, req):
+        """(queued id, None) or (None, error)."""
+        if req["value"] != 0:
+            return None, "value transfers are not relayed"
+        if req["gas"] > self.args.max_gas:
+            return None, "gas above %d" % self.args.max_gas
+        if req["deadline"] and req["deadline"] < time.time() + 10:
+            return None, "expired"
+        if recover(request_digest(self.separator, req), req["signature"]) != req["from"]:
+            return None, "bad signature"
+        with self.lock:
+            expected = self.chain_nonce(req["from"]) + self.pending.get(req["from"], 0)
+            if req["nonce"] != expected:
+                return None, "bad nonce"
+            self.pending[req["from"]] = self.pending.get(req["from"], 0) + 1
+            self.sequence += 1
+            req["id"] = "r%d" % self.sequence
+            self.queue.append(req)
+            self.stats["queued"] += 1
+            if len(self.queue) >= self.args.batch_size:
+                self.lock.notify()
+            return req["id"], None
+
+    def run(self):
+        """Batch loop: flush when the batch is full or batch-ms has passed."""
+        while True:
+            with self.lock:
+                self.lock.wait(self.args.batch_ms / 1000.0)
+                batch, self.queue = self.queue[:self.args.batch_size], self.queue[self.args.batch_size:]
+            if batch:
+                self.flush(batch)
+
+    def flush(self, batch):
+        calldata = encode_execute_batch(batch)
+        gas = sum(req["gas"] + req["gas"] // 63 + 40000 for req in batch) + 60000
+        ok = True
+        skipped = 0
+        if self.node is None:
+            print("batch of %d: %d bytes of calldata, gas limit %d (dry run)" % (len(batch), len(calldata), gas))
+        else:
+            try:
+                tx = self.node.call("eth_sendTransaction", [{"from": self.args.account,
+                                                             "to": "0x" + self.forwarder.hex(),
+                                                             "gas": hex(gas), "data": "0x" + calldata.hex()}])
+                receipt = None
+                while receipt is None:
+                    time.sleep(0.5)
+                    receipt = self.node.call("eth_getTransactionReceipt", [tx])
+                ok = receipt["status"] == "0x1"
+                skipped = sum(1 for log in receipt.get("logs", []) if log["topics"][:1] == [REJECTED_TOPIC])
+                self.stats["gas_used"] += int(receipt["gasUsed"], 16)
+                print("batch of %d: %s %s, %d skipped, gas used %d" % (len(batch), tx, "ok" if ok else "REVERTED",
+                                                                      skipped, int(receipt["gasUsed"], 16)))
+            except (OSError, RuntimeError) as e:
+                print("batch of %d failed: %s" % (len(batch), e))
+                ok = False
+
+        with self.lock:
+            for req in batch:
+                self.pending[req["from"]] -= 1
+                if ok and self.node is None:
+                    self.nonces[req["from"]] += 1
+            if ok and self.node is not None:
+                for req in batch:
+                    self.nonces.pop(req["from"], None)    # Re-read: a request may have been rejected on chain
+            self.stats["batches"] += 1
+            self.stats["executed"] += len(batch) - skipped if ok else 0
+            self.stats["rejected_on_chain"] += skipped if ok else 0
+            self.stats["failed_batches"] += 0 if ok else 1
+            if not ok:
+                # Later requests of these senders carry nonces that can no longer execute
+                senders = {req["from"] for req in batch}
+                dropped = [req for req in self.queue if req["from"] in senders]
+                self.queue = [req for req in self.queue if req["from"] not in senders]
+                for req in dropped:
+                    self.pending[req["from"]] -= 1
+                for sender in senders:
+                    self.nonces.pop(sender, None)
+
+    def report(self):
+        with self.lock:
+            s = dict(self.stats)
+            s["queue"] = len(self.queue)
+            s["transactions_saved"] = max(0, s["executed"] - s["batches"])
+            return s
+
+
+def make_handler(relayer):
+    class Handler(BaseHTTPRequestHandler):
+        def reply(self, status, payload):
+            body = json.dumps(payload, separators=(",", ":")).encode()    # Compact: devices match "queued":true
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_GET(self):
+            if self.path.startswith("/nonce/0x") and len(self.path) == 49:
+                try:
+                    sender = bytes.fromhex(self.path[9:])
+                    self.reply(200, {"nonce": relayer.next_nonce(sender)})
+                except (ValueError, OSError, RuntimeError) as e:
+                    self.reply(502 if not isinstance(e, ValueError) else 400, {"error": str(e)})
+            elif self.path == "/stats":
+                self.reply(200, relayer.report())
+            else:
+                self.reply(404, {"error": "not found"})
+
+        def do_POST(self):
+            if self.path != "/relay":
+                self.reply(404, {"error": "not found"})
+                return
+            try:
+                length = int(self.headers.get("Content-Length", "0"))
+                req = parse_request(json.loads(self.rfile.read(length)))
+                queued, error = relayer.submit(req)
+            except (ValueError, TypeError) as e:
+                self.reply(400, {"error": str(e)})
+                return
+            except (OSError, RuntimeError) as e:
+                self.reply(502, {"error": "node: %s" % e})
+                return
+            if error:
+                with relayer.lock:
+                    relayer.stats["rejected"] += 1
+                self.reply(400, {"error": error, "nonce": relayer.next_nonce(req["from"])})
+            else:
+                self.reply(200, {"queued": True, "id": queued})
+
+        def log_message(self, fmt, *args):
+            pass
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Reference ERC-2771 batch relayer for local testing")
+    parser.add_argument("--forwarder", required=True, help="BatchForwarder address")
+    parser.add_argument("--chain-id", type=int, required=True)
+    parser.add_argument("--rpc", default="http://127.0.0.1:8545", help="development node")
+    parser.add_argument("--account", help="unlocked account that pays for batches")
+    parser.add_argument("--port", type=int, default=8088)
+    parser.add_argument("--batch-size", type=int, default=32)
+    parser.add_argument("--batch-ms", type=int, default=2000)
+    parser.add_argument("--max-gas", type=int, default=500000, help="per request")
+    parser.add_argument("--dry-run", action="store_true", help="no node; log batches instead of sending")
+    args = parser.parse_args()
+    if not args.dry_run and not args.account:
+        parser.error("--account is required unless --dry-run")
+
+    relayer = Relayer(args)
+    threading.Thread(target=relayer.run, daemon=True).start()
+    server = ThreadingHTTPServer(("0.0.0.0", args.port), make_handler(relayer))
+    print("relaying to %s on port %d (%s)" % (args.forwarder, args.port, "dry run" if args.dry_run else args.rpc))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print(json.dumps(relayer.report()))
+
+
+if __name__ == "__main__":
+    main()
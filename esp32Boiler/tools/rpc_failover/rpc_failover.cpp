@@ -0,0 +1,420 @@
+/*
+ * RPC Failover and Hedging Test
+ *
+ * Runs src/rpc_client.cpp on the host against in-process stand-in nodes
+ * on loopback, each with injected latency, periodic stalls and failure
+ * modes: HTTP 503, provider rate limits on HTTP 200 (-32005, -32029), a
+ * captive-portal page, connections dropped without a reply and ports
+ * nobody listens on. HTTPClient and WiFiClient come from tools/host_shim;
+ * ResumableTlsClient is replaced by plain TCP (host_shim/tls_standin.h),
+ * since the nodes do not speak TLS.
+ *
+ * Checks:
+ * - requests go to the fastest measured endpoint and leave it when it
+ *   gets slow
+ * - every failure mode fails over to the next endpoint within the same
+ *   call, and the reply handed back is the good one
+ * - an endpoint failing RPC_COOLDOWN_FAILURES times in a row cools down
+ *   and gets no traffic, then wins it back after the cooldown
+ * - a call fails only when every endpoint does
+ * - with one endpoint stalling on every Nth request, hedged reads cut the
+ *   tail latency that plain reads suffer, including reads that start
+ *   while an earlier stalled request still holds a hedging worker
+ * - the block-scoped read cache (read_cache.h) never hands out a reply
+ *   from one endpoint under the block number another endpoint reported
+ *
+ * Reports latency percentiles with and without hedging. Exits non-zero
+ * if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -pthread -I../host_shim -I../../src rpc_failover.cpp \
+ *       ../../src/rpc_client.cpp ../../src/gzip_inflate.cpp -lz -o rpc_failover
+ *   ./rpc_failover --reads 200 --stall-every 10 --stall-ms 500
+ *
+ * Options (defaults in brackets):
+ *   --reads N        reads per hedging run [200]
+ *   --stall-every N  the primary stalls on every Nth request [10]
+ *   --stall-ms MS    length of a stall [500]
+ *   --gap-ms MS      pause between reads, as between loop() passes [20]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "read_cache.h"
+#include "rpc_client.h"
+#include "tls_resume.h"
+#include "tls_standin.h"
+
+// ===== STAND-IN NODES =====
+enum NodeMode { NODE_OK, NODE_HTTP_503, NODE_RATE_LIMITED, NODE_OVER_QUOTA, NODE_PORTAL, NODE_DROP };
+
+// A JSON-RPC node on a loopback port, one thread per connection. Every
+// reply's result is the node's number (index + 1), so the test can tell
+// who answered.
+class StandInNode {
+public:
+    std::atomic<int> mode{NODE_OK};
+    std::atomic<uint32_t> latencyMs{0};
+    std::atomic<uint32_t> stallEvery{0};  // 0: never stall
+    std::atomic<uint32_t> stallMs{0};
+    std::atomic<uint32_t> served{0};
+
+    void start(int number) {
+        this->number = number;
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+            perror("stand-in node");
+            exit(1);
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listener, (sockaddr*)&addr, &len);
+        snprintf(url, sizeof(url), "http://127.0.0.1:%u/", ntohs(addr.sin_port));
+        std::thread([this] { acceptLoop(); }).detach();
+    }
+
+    void reset(uint32_t latency) {
+        mode = NODE_OK;
+        latencyMs = latency;
+        stallEvery = 0;
+        stallMs = 0;
+        served = 0;
+    }
+
+    const char* endpoint() const { return url; }
+
+private:
+    int number = 0;
+    int listener = -1;
+    char url[40] = "";
+
+    void acceptLoop() {
+        for (;;) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                std::thread([this, fd] { serve(fd); }).detach();
+            }
+        }
+    }
+
+    void serve(int fd) {
+        std::string in;
+        char buf[2048];
+        for (;;) {
+            size_t headEnd;
+            while ((headEnd = in.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, buf, sizeof(buf), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                in.append(buf, n);
+            }
+            size_t lengthAt = in.find("Content-Length: ");
+            size_t bodyLen = lengthAt < headEnd ? strtoul(in.c_str() + lengthAt + 16, nullptr, 10) : 0;
+            while (in.size() < headEnd + 4 + bodyLen) {
+                ssize_t n = recv(fd, buf, sizeof(buf), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                in.append(buf, n);
+            }
+            std::string body = in.substr(headEnd + 4, bodyLen);
+            in.erase(0, headEnd + 4 + bodyLen);
+
+            uint32_t count = ++served;
+            uint32_t every = stallEvery;
+            uint32_t wait = latencyMs + (every && count % every == 0 ? stallMs.load() : 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+
+            int current = mode;
+            if (current == NODE_DROP) {
+                close(fd);
+                return;
+            }
+            size_t idAt = body.find("\"id\":");
+            unsigned long id = idAt == std::string::npos ? 0 : strtoul(body.c_str() + idAt + 5, nullptr, 10);
+            char reply[256];
+            int status = 200;
+            const char* type = "application/json";
+            if (current == NODE_HTTP_503) {
+                status = 503;
+                snprintf(reply, sizeof(reply), "Service Unavailable");
+                type = "text/plain";
+            } else if (current == NODE_RATE_LIMITED) {
+                snprintf(reply, sizeof(reply),
+                         "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"error\":{\"code\":-32005,\"message\":\"rate limit exceeded\"}}", id);
+            } else if (current == NODE_OVER_QUOTA) {
+                snprintf(reply, sizeof(reply),
+                         "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"error\":{\"code\":-32029,\"message\":\"too many requests\"}}", id);
+            } else if (current == NODE_PORTAL) {
+                snprintf(reply, sizeof(reply), "<html><body>Please sign in to the guest network</body></html>");
+                type = "text/html";
+            } else {
+                snprintf(reply, sizeof(reply), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"result\":\"0x%x\"}", id, number);
+            }
+            char head[160];
+            int headLen = snprintf(head, sizeof(head), "HTTP/1.1 %d X\r\nContent-Type: %s\r\nContent-Length: %zu\r\n\r\n",
+                                   status, type, strlen(reply));
+            std::string out = std::string(head, headLen) + reply;
+            if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) {
+                close(fd);
+                return;
+            }
+        }
+    }
+};
+
+// ===== TEST HELPERS =====
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok && failures++ < 10) {
+        printf("FAIL: %s\n", what);
+    }
+}
+
+#define NODES 3
+static StandInNode nodes[NODES];
+
+// Clients are never freed: hedging workers keep a pointer to theirs
+static RpcClient& freshClient(size_t endpoints, bool hedged) {
+    RpcClient* rpc = new RpcClient();
+    for (size_t i = 0; i < endpoints; i++) {
+        rpc->addEndpoint(nodes[i].endpoint());
+    }
+    rpc->setHedging(hedged);
+    return *rpc;
+}
+
+// Index of the node that answered, or -1 if the call failed
+static int ask(RpcClient& rpc, bool hedged = false, uint32_t* elapsedMs = nullptr) {
+    std::string response;
+    uint32_t start = millis();
+    bool ok = hedged ? rpc.read("eth_blockNumber", "[]", &response) : rpc.call("eth_blockNumber", "[]", &response);
+    if (elapsedMs) {
+        *elapsedMs = millis() - start;
+    }
+    uint64_t number;
+    return ok && RpcClient::resultQuantity(response, &number) ? (int)number - 1 : -1;
+}
+
+static void resetNodes(uint32_t latency0, uint32_t latency1, uint32_t latency2) {
+    nodes[0].reset(latency0);
+    nodes[1].reset(latency1);
+    nodes[2].reset(latency2);
+}
+
+static uint32_t percentile(std::vector<uint32_t> v, double pct) {
+    if (v.empty()) {
+        return 0;
+    }
+    std::sort(v.begin(), v.end());
+    return v[(size_t)((v.size() - 1) * pct / 100)];
+}
+
+// ===== SCENARIOS =====
+// Endpoints nobody has measured yet score as if they took 300 ms, so
+// traffic stays on a measured favourite until it gets slower than that
+static void slowFavouriteLosesTraffic() {
+    resetNodes(5, 30, 60);
+    RpcClient& rpc = freshClient(NODES, false);
+    for (int i = 0; i < 10; i++) {
+        check(ask(rpc) == 0, "measured favourite gets the traffic");
+    }
+    nodes[0].latencyMs = 400;
+    int moved = -1;
+    for (int i = 0; i < 20 && moved < 0; i++) {
+        if (ask(rpc) != 0) {
+            moved = i;
+        }
+    }
+    int stayed = 0;
+    for (int i = 0; i < 20; i++) {
+        stayed += ask(rpc) == 1;
+    }
+    printf("ranking: favourite slowed to 400 ms, traffic moved after %d calls, %d of the next 20 on the runner-up\n",
+           moved + 1, stayed);
+    check(moved >= 0, "traffic leaves an endpoint that got slow");
+    check(stayed == 20, "and settles on the next fastest");
+}
+
+static void failsOverOn(NodeMode mode, const char* what) {
+    resetNodes(5, 20, 40);
+    RpcClient& rpc = freshClient(NODES, false);
+    for (int i = 0; i < 5; i++) {
+        ask(rpc);  // Node 0 becomes the measured favourite
+    }
+    nodes[0].mode = mode;
+    int who = ask(rpc);
+    char label[96];
+    snprintf(label, sizeof(label), "%s fails over to another node in the same call", what);
+    check(who == 1 || who == 2, label);
+}
+
+static void coolsDownAndRecovers() {
+    resetNodes(5, 20, 40);
+    RpcClient& rpc = freshClient(NODES, false);
+    for (int i = 0; i < 5; i++) {
+        ask(rpc);
+    }
+    nodes[0].mode = NODE_HTTP_503;
+    for (int i = 0; i < RPC_COOLDOWN_FAILURES; i++) {
+        check(ask(rpc) == 1, "503s are absorbed by the runner-up");
+    }
+    check(rpc.stats(0).coolingDown, "node cools down after consecutive failures");
+
+    uint32_t before = nodes[0].served;
+    uint32_t worst = 0;
+    for (int i = 0; i < 20; i++) {
+        uint32_t ms;
+        check(ask(rpc, false, &ms) == 1, "cooling node is skipped");
+        worst = std::max(worst, ms);
+    }
+    check(nodes[0].served == before, "cooling node gets no requests");
+    printf("cooldown: node 0 skipped for 20 calls, worst call %u ms (runner-up takes 20)\n", worst);
+
+    nodes[0].mode = NODE_OK;
+    hostAdvanceMillis(RPC_COOLDOWN_MS + 1);
+    int back = -1;
+    for (int i = 0; i < 20 && back < 0; i++) {
+        if (ask(rpc) == 0) {
+            back = i;
+        }
+    }
+    check(back >= 0, "recovered node wins its traffic back after the cooldown");
+}
+
+static void failsOnlyWhenAllFail() {
+    resetNodes(5, 5, 5);
+    RpcClient& rpc = freshClient(NODES, false);
+    nodes[0].mode = NODE_HTTP_503;
+    nodes[1].mode = NODE_RATE_LIMITED;
+    check(ask(rpc) == 2, "last healthy node answers");
+    nodes[2].mode = NODE_PORTAL;
+    check(ask(rpc) == -1, "call fails when every node fails");
+}
+
+static void deadEndpoint() {
+    resetNodes(5, 5, 5);
+    RpcClient* rpc = new RpcClient();
+    rpc->addEndpoint("http://127.0.0.1:1/");  // Nothing listens there
+    rpc->addEndpoint(nodes[1].endpoint());
+    check(ask(*rpc) == 1, "refused connection fails over");
+}
+
+// Every node reports its own number as the block, so a head polled from
+// one node and a reply from another show up as different blocks
+static void readCacheFollowsEndpoint() {
+    resetNodes(5, 20, 40);
+    RpcClient& rpc = freshClient(NODES, false);
+    for (int i = 0; i < 5; i++) {
+        ask(rpc);
+    }
+    ReadCache cache(rpc, 60000);
+    std::string response;
+    uint64_t who = 0;
+
+    cache.read("eth_call", "[1]", &response);
+    uint32_t before = nodes[0].served;
+    cache.read("eth_call", "[1]", &response);
+    check(nodes[0].served == before && cache.hits() == 1, "repeat read within a block is a hit");
+
+    // Head still from node 0, but node 0 now fails and node 1 answers
+    nodes[0].mode = NODE_HTTP_503;
+    cache.read("eth_call", "[2]", &response);
+    before = nodes[1].served;
+    cache.read("eth_call", "[2]", &response);
+    check(nodes[1].served == before + 1, "reply from another endpoint than the head's is not cached");
+
+    // Next poll lands on node 1: node 0's entries must not be served
+    hostAdvanceMillis(60001);
+    bool ok = cache.read("eth_call", "[1]", &response) && RpcClient::resultQuantity(response, &who);
+    check(ok && who == 2, "entries from the old endpoint stop matching after a switch");
+    check(cache.endpointSwitches() == 1 && cache.block() == 2, "switch is counted and head follows the new endpoint");
+    printf("read cache: %lu hits, %lu misses, %lu endpoint switches\n", (unsigned long)cache.hits(),
+           (unsigned long)cache.misses(), (unsigned long)cache.endpointSwitches());
+}
+
+// Plain and hedged reads against a primary that stalls every Nth request
+static void hedging(int reads, uint32_t every, uint32_t stall, uint32_t gap) {
+    printf("\nprimary 5 ms, stalls %u ms on every %uth request; runner-up 30 ms; %u ms between reads\n", stall,
+           every, gap);
+    printf("%-8s %7s %7s %7s %7s %9s %9s\n", "reads", "p50 ms", "p90 ms", "p99 ms", "max ms", "hedges", "hedge won");
+
+    uint32_t p99[2] = {0, 0};
+    for (int hedged = 0; hedged < 2; hedged++) {
+        resetNodes(5, 30, 30);
+        RpcClient& rpc = freshClient(2, hedged);
+        for (int i = 0; i < 5; i++) {
+            ask(rpc);  // Measure both before stalls start
+        }
+        nodes[0].stallEvery = every;
+        nodes[0].stallMs = stall;
+
+        std::vector<uint32_t> times;
+        int answered = 0;
+        for (int i = 0; i < reads; i++) {
+            uint32_t ms;
+            answered += ask(rpc, true, &ms) >= 0;
+            times.push_back(ms);
+            delay(gap);
+        }
+        check(answered == reads, "every read is answered");
+        p99[hedged] = percentile(times, 99);
+        printf("%-8s %7u %7u %7u %7u %9u %9u\n", hedged ? "hedged" : "plain", percentile(times, 50),
+               percentile(times, 90), p99[hedged], percentile(times, 100), rpc.hedgesSent(), rpc.hedgesWon());
+    }
+    check(p99[0] >= stall, "plain reads wait out the stalls");
+    check(p99[1] < stall / 2, "hedged reads do not");
+}
+
+int main(int argc, char** argv) {
+    int reads = 200;
+    uint32_t every = 10, stall = 500, gap = 20;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--reads")) {
+            reads = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--stall-every")) {
+            every = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--stall-ms")) {
+            stall = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--gap-ms")) {
+            gap = atoi(argv[i + 1]);
+        }
+    }
+
+    for (int i = 0; i < NODES; i++) {
+        nodes[i].start(i + 1);
+    }
+
+    slowFavouriteLosesTraffic();
+    failsOverOn(NODE_HTTP_503, "HTTP 503");
+    failsOverOn(NODE_RATE_LIMITED, "rate limit (-32005)");
+    failsOverOn(NODE_OVER_QUOTA, "rate limit (-32029)");
+    failsOverOn(NODE_PORTAL, "captive portal page");
+    failsOverOn(NODE_DROP, "dropped connection");
+    coolsDownAndRecovers();
+    failsOnlyWhenAllFail();
+    deadEndpoint();
+    readCacheFollowsEndpoint();
+    hedging(reads, every, stall, gap);
+
+    printf("%lu connections opened\n", (unsigned long)ResumableTlsClient::stats().full);
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    fflush(stdout);
+    _exit(failures ? 1 : 0);  // Worker tasks never return
+}
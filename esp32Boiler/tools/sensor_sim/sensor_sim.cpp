@@ -0,0 +1,262 @@
+/*
+ * Sensor Pipeline Simulator
+ *
+ * Feeds src/sensor_pipeline.h from a simulated temperature sensor (slow
+ * hourly swing, noise and occasional heat spikes) on a simulated clock.
+ * Commits go through a send that blocks the loop and fails now and then,
+ * the way a real transaction does. The sensor is switched off for a while
+ * mid-run and for good at the end, with loop() flushing like the firmware
+ * does and no time-skipping drain afterwards. Reports how many
+ * transactions the samples turned into, and checks the committed windows
+ * against the raw stream: every sample accounted for, extremes preserved,
+ * means exact to rounding, pack()/unpack() lossless, no window spanning a
+ * pause, and the last partial window committed soon after the stop.
+ * Exits non-zero if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src sensor_sim.cpp -o sensor_sim
+ *   ./sensor_sim --hz 200 --seconds 7200 --window-ms 60000 --fail-pct 20
+ *
+ * Options (defaults in brackets):
+ *   --hz N             samples per second [100]
+ *   --seconds S        simulated time [3600]
+ *   --window-ms MS     commit window [60000]
+ *   --min-window-ms MS shortest window an alert may close [5000]
+ *   --alert MILLI      alert threshold in milli-degrees, 0 = off [30000]
+ *   --send-ms MS       time one send blocks the loop [1500]
+ *   --fail-pct N       share of sends that fail [10]
+ *   --pause-at S       switch the sensor off at S seconds [2/5 of --seconds]
+ *   --pause-s S        and back on S seconds later, 0 = no pause [120]
+ *   --seed N           [1]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sensor_pipeline.h"
+
+struct SimOptions {
+    uint32_t hz = 100;
+    uint32_t seconds = 3600;
+    uint32_t sendMs = 1500;
+    uint32_t failPct = 10;
+    uint32_t seed = 1;
+    uint32_t pauseAt = UINT32_MAX;    // Default: 2/5 of seconds
+    uint32_t pauseSeconds = 120;
+};
+
+static uint32_t rng = 1;
+
+static uint32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// Milli-degrees: 22 C +- 3 C over an hour, +-0.2 C noise, and a 2-minute
+// spike to ~35 C every 20 minutes, off the minute so windows do not line
+// up with the stops
+static int32_t readSensor(uint32_t ms) {
+    double base = 22000 + 3000 * sin(2 * M_PI * ms / 3600000.0);
+    double noise = (int32_t)(nextRandom() % 401) - 200;
+    double spike = (ms % 1200000) > 610000 && (ms % 1200000) < 730000 ? 13000 : 0;
+    return (int32_t)(base + noise + spike);
+}
+
+static bool parseArgs(int argc, char** argv, SimOptions* opt, SensorPipelineConfig* cfg) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* name = argv[i];
+        uint32_t value = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+
+        if (!strcmp(name, "--hz")) opt->hz = value ? value : 1;
+        else if (!strcmp(name, "--seconds")) opt->seconds = value;
+        else if (!strcmp(name, "--send-ms")) opt->sendMs = value;
+        else if (!strcmp(name, "--fail-pct")) opt->failPct = value;
+        else if (!strcmp(name, "--seed")) opt->seed = value;
+        else if (!strcmp(name, "--pause-at")) opt->pauseAt = value;
+        else if (!strcmp(name, "--pause-s")) opt->pauseSeconds = value;
+        else if (!strcmp(name, "--window-ms")) cfg->windowMs = value;
+        else if (!strcmp(name, "--min-window-ms")) cfg->minWindowMs = value;
+        else if (!strcmp(name, "--alert")) {
+            cfg->alerts = value != 0;
+            cfg->alertHigh = (int32_t)value;
+        } else {
+            fprintf(stderr, "unknown option %s\n", name);
+            return false;
+        }
+    }
+    return (argc % 2) == 1;
+}
+
+struct Totals {
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+};
+
+static bool sameWindow(const SensorWindow& a, const SensorWindow& b) {
+    return a.sequence == (b.sequence & 0xFFFFFF) && a.flags == b.flags && a.startMs == b.startMs &&
+           a.durationMs == b.durationMs && a.count == b.count && a.min == b.min && a.max == b.max &&
+           a.mean == b.mean && a.last == b.last;
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    SensorPipelineConfig cfg = SENSOR_DEFAULTS;
+    cfg.windowMs = 60000;
+    cfg.minWindowMs = 5000;
+    cfg.alerts = true;
+    cfg.alertHigh = 30000;
+    cfg.alertHysteresis = 1000;
+    if (!parseArgs(argc, argv, &opt, &cfg)) {
+        fprintf(stderr, "usage: see the header of sensor_sim.cpp\n");
+        return 2;
+    }
+    rng = opt.seed ? opt.seed : 1;
+
+    SensorPipeline pipeline(cfg);
+    Totals raw, committed;
+    uint64_t meanSlack = 0;
+    uint32_t sends = 0, failures = 0, alertWindows = 0, failedChecks = 0;
+    uint32_t sampleEveryUs = 1000000 / opt.hz;
+    uint64_t nextSampleUs = 0;
+    uint32_t loopFreeMs = 0;
+    uint32_t endMs = opt.seconds * 1000;
+    uint32_t pauseMs = (opt.pauseAt == UINT32_MAX ? opt.seconds * 2 / 5 : opt.pauseAt) * 1000;
+    uint32_t resumeMs = pauseMs + opt.pauseSeconds * 1000;
+    uint32_t stoppedWindows = 0;
+    uint32_t openAtStop = 0;          // Stops that found a window open
+    bool wasSampling = true;
+    uint32_t lastCommitMs = 0;
+    uint32_t now = 0;
+    auto sampling = [&](uint32_t ms) { return ms < endMs && !(opt.pauseSeconds && ms >= pauseMs && ms < resumeMs); };
+
+    auto commit = [&](const SensorWindow& w) {
+        SensorWindow back = SensorPipeline::unpack(SensorPipeline::pack(w));
+        if (!sameWindow(back, w)) {
+            printf("FAIL window %u does not survive pack/unpack\n", w.sequence);
+            failedChecks++;
+        }
+        if (w.count == 0 || w.min > w.mean || w.mean > w.max) {
+            printf("FAIL window %u: count %u min %d mean %d max %d\n", w.sequence, w.count, w.min, w.mean, w.max);
+            failedChecks++;
+        }
+        committed.count += w.count;
+        committed.sum += (int64_t)w.mean * w.count;
+        committed.min = w.min < committed.min ? w.min : committed.min;
+        committed.max = w.max > committed.max ? w.max : committed.max;
+        meanSlack += w.count / 2 + 1;
+        alertWindows += (w.flags & SENSOR_FLAG_ALERT) != 0;
+        stoppedWindows += (w.flags & SENSOR_FLAG_STOPPED) != 0;
+        lastCommitMs = now;
+
+        // Only a merge under backlog may fold samples from both sides of a pause
+        uint32_t lastSample = w.startMs + w.durationMs;
+        if (opt.pauseSeconds && !(w.flags & SENSOR_FLAG_MERGED) && w.startMs < pauseMs && lastSample >= resumeMs) {
+            printf("FAIL window %u spans the pause (%u..%u ms)\n", w.sequence, w.startMs, lastSample);
+            failedChecks++;
+        }
+    };
+
+    // After the final stop, loop() keeps going until the outbox is empty;
+    // an hour is far more than the retries need
+    uint32_t limitMs = endMs + 3600000;
+    for (; now < limitMs; now++) {
+        if (now >= endMs && !pipeline.pending() && pipeline.backlog() == 0) {
+            break;
+        }
+
+        // Sampler task: runs on time whatever the loop is doing, and
+        // pushes nothing while the sensor is off
+        while (sampling(now) && nextSampleUs <= (uint64_t)now * 1000) {
+            int32_t v = readSensor(now);
+            if (pipeline.push(now, v)) {
+                raw.count++;
+                raw.sum += v;
+                raw.min = v < raw.min ? v : raw.min;
+                raw.max = v > raw.max ? v : raw.max;
+            }
+            nextSampleUs += sampleEveryUs;
+        }
+        if (!sampling(now) && nextSampleUs <= (uint64_t)now * 1000) {
+            nextSampleUs = (uint64_t)(now + 1) * 1000;
+        }
+        if (wasSampling && !sampling(now)) {
+            openAtStop += pipeline.pending();
+        }
+        wasSampling = sampling(now);
+
+        // loop(): drains every 10 ms unless a send is blocking it; once the
+        // sensor is off it flushes instead, as serviceSensorPipeline() does
+        if (now < loopFreeMs) {
+            continue;
+        }
+        if (sampling(now)) {
+            pipeline.drain(now);
+        } else {
+            pipeline.flush(now);
+        }
+        SensorWindow w;
+        if (pipeline.peek(&w)) {
+            sends++;
+            loopFreeMs = now + opt.sendMs;
+            if (nextRandom() % 100 < opt.failPct) {
+                failures++;
+            } else {
+                commit(w);
+                pipeline.pop();
+            }
+        } else {
+            loopFreeMs = now + 10;
+        }
+    }
+
+    SensorPipelineStats s = pipeline.snapshot();
+    if (pipeline.pending() || pipeline.backlog() > 0) {
+        printf("FAIL %u window(s) still queued an hour after the sensor stopped\n", (unsigned)pipeline.backlog());
+        failedChecks++;
+    }
+    // Merges fold flags together, so under backlog a stop may not show
+    if (s.merged ? stoppedWindows == 0 && openAtStop > 0 : stoppedWindows != openAtStop) {
+        printf("FAIL %u window(s) closed by a stop, %u stop(s) found one open\n", stoppedWindows, openAtStop);
+        failedChecks++;
+    }
+    if (committed.count != raw.count) {
+        printf("FAIL %llu samples committed, %llu accepted\n", (unsigned long long)committed.count,
+               (unsigned long long)raw.count);
+        failedChecks++;
+    }
+    if (committed.min != raw.min || committed.max != raw.max) {
+        printf("FAIL extremes %d..%d committed, %d..%d sampled\n", committed.min, committed.max, raw.min, raw.max);
+        failedChecks++;
+    }
+    uint64_t meanError = (uint64_t)llabs(committed.sum - raw.sum);
+    if (meanError > meanSlack) {
+        printf("FAIL mean drift %llu exceeds rounding slack %llu\n", (unsigned long long)meanError,
+               (unsigned long long)meanSlack);
+        failedChecks++;
+    }
+
+    printf("sensor: %u Hz for %u s, %u ms windows, alert %s %d\n", opt.hz, opt.seconds, cfg.windowMs,
+           cfg.alerts ? "at" : "off", cfg.alertHigh);
+    printf("send:   %u ms blocking, %u%% failing\n", opt.sendMs, opt.failPct);
+    printf("stops:  off at %u s for %u s, and for good at %u s\n\n", pauseMs / 1000, opt.pauseSeconds, opt.seconds);
+    printf("  samples        %10u  (%u dropped from the ring)\n", s.samples, s.dropped);
+    printf("  windows        %10u  (%u closed by alerts, %u merged under backlog)\n", s.windows,
+           alertWindows, s.merged);
+    printf("  transactions   %10u  (%u sends, %u failed and retried)\n", s.committed, sends, failures);
+    printf("  after stop     %10u ms until the last window was committed (%u cut short by %u stops)\n",
+           lastCommitMs - endMs, stoppedWindows, opt.pauseSeconds ? 2 : 1);
+    printf("  samples/tx     %10.1f\n", s.committed ? (double)s.samples / s.committed : 0.0);
+    printf("  tx saved       %10.2f%%  vs one store() per sample\n",
+           s.samples ? 100.0 * (s.samples - s.committed) / s.samples : 0.0);
+    printf("  sampled range  %10d .. %d, mean %lld\n", raw.min, raw.max,
+           raw.count ? (long long)(raw.sum / (int64_t)raw.count) : 0LL);
+    printf("\n%s\n", failedChecks ? "CHECKS FAILED" : "all checks passed");
+    return failedChecks ? 1 : 0;
+}
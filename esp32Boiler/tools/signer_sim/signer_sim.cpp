@@ -0,0 +1,432 @@
+/*
+ * Signer Pool Throughput Simulator
+ *
+ * Runs src/signer_pool.cpp and src/rpc_client.cpp on the host against a
+ * mock node: JSON-RPC over loopback for eth_getTransactionCount, and a
+ * mempool fed through Web3::sendRaw (host_shim/Web3.h) in place of
+ * signing. The node mines a block every --block-ms of simulated time,
+ * taking each sender's transactions in nonce order, and caps every
+ * sender's queued transactions like a real txpool does. A gateway posts
+ * --rate readings per second, each one a transaction.
+ *
+ * Checks:
+ * - committed tx/s grows with the number of lanes (4 keys at least 3x
+ *   one key, while the producer outpaces them)
+ * - an underpriced transaction that never mines holds up only its own
+ *   lane: the lane is reported stuck and the others keep committing
+ * - when the node drops the stuck transactions, the lane resyncs its
+ *   nonce and commits again
+ * - every nonce a lane hands out is mined exactly once
+ *
+ * Exits non-zero if a check fails.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -pthread -I../host_shim -I../../src signer_sim.cpp \
+ *       ../../src/signer_pool.cpp ../../src/rpc_client.cpp ../../src/gzip_inflate.cpp -lz -o signer_sim
+ *   ./signer_sim --rate 4 --seconds 600 --block-ms 12000
+ *
+ * Options (defaults in brackets):
+ *   --rate N       readings per second from the gateway [4]
+ *   --seconds S    simulated time per run [600]
+ *   --block-ms MS  block interval [12000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Contract.h>
+
+#include "rpc_client.h"
+#include "signer_pool.h"
+#include "tls_resume.h"
+#include "tls_standin.h"
+
+#define SENDER_QUEUE_LIMIT 16         // Queued transactions per sender, as in geth's txpool
+#define STEP_MS 250
+
+static const char* KEYS[] = {
+    "1111111111111111111111111111111111111111111111111111111111111111",
+    "2222222222222222222222222222222222222222222222222222222222222222",
+    "3333333333333333333333333333333333333333333333333333333333333333",
+    "4444444444444444444444444444444444444444444444444444444444444444",
+};
+static const char* ADDRESSES[] = {
+    "0x1000000000000000000000000000000000000001",
+    "0x2000000000000000000000000000000000000002",
+    "0x3000000000000000000000000000000000000003",
+    "0x4000000000000000000000000000000000000004",
+};
+
+// ===== MOCK NODE =====
+// Accounts are the four signers above. Transaction counts are served over
+// HTTP from the node's threads; submissions and mining come from the
+// simulation loop, so the state sits behind a mutex.
+class MockNode {
+public:
+    struct Account {
+        uint32_t mined;
+        std::map<uint32_t, bool> pool;  // Nonce -> underpriced (never mined)
+        uint32_t submitted;
+        uint32_t underpriceAt;          // Submission that goes in underpriced, 0 = none
+        std::vector<uint32_t> minedNonces;
+    };
+
+    void start() {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+            perror("mock node");
+            exit(1);
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listener, (sockaddr*)&addr, &len);
+        snprintf(url, sizeof(url), "http://127.0.0.1:%u/", ntohs(addr.sin_port));
+        std::thread([this] { acceptLoop(); }).detach();
+    }
+
+    const char* endpoint() const { return url; }
+
+    void reset() {
+        std::lock_guard<std::mutex> guard(lock);
+        for (Account& a : accounts) {
+            a = Account();
+        }
+        minedTotal = 0;
+    }
+
+    void underprice(int account, uint32_t submission) {
+        std::lock_guard<std::mutex> guard(lock);
+        accounts[account].underpriceAt = submission;
+    }
+
+    // The txpool evicts everything the account has queued
+    void drop(int account) {
+        std::lock_guard<std::mutex> guard(lock);
+        accounts[account].pool.clear();
+    }
+
+    std::string submit(const Web3Transaction& tx) {
+        std::lock_guard<std::mutex> guard(lock);
+        int index = accountOf(tx.privateKey);
+        if (index < 0) {
+            return error("invalid sender");
+        }
+        Account& a = accounts[index];
+        if (tx.nonce < a.mined || a.pool.count(tx.nonce)) {
+            return error("nonce too low");
+        }
+        if (a.pool.size() >= SENDER_QUEUE_LIMIT) {
+            return error("txpool is full");
+        }
+        a.submitted++;
+        a.pool[tx.nonce] = a.submitted == a.underpriceAt;
+        char reply[160];
+        snprintf(reply, sizeof(reply), "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"0x%056x%08x\"}", index + 1,
+                 (unsigned)tx.nonce);
+        return reply;
+    }
+
+    // One block: each sender's transactions in nonce order, up to the first
+    // gap or underpriced one
+    void mine() {
+        std::lock_guard<std::mutex> guard(lock);
+        for (Account& a : accounts) {
+            for (auto it = a.pool.find(a.mined); it != a.pool.end() && it->first == a.mined && !it->second;
+                 it = a.pool.find(a.mined)) {
+                a.minedNonces.push_back(a.mined);
+                a.pool.erase(it);
+                a.mined++;
+                minedTotal++;
+            }
+        }
+    }
+
+    uint32_t mined() {
+        std::lock_guard<std::mutex> guard(lock);
+        return minedTotal;
+    }
+
+    uint32_t mined(int account) {
+        std::lock_guard<std::mutex> guard(lock);
+        return accounts[account].mined;
+    }
+
+    // Nonces 0..mined-1, each exactly once
+    bool minedInOrder(int account) {
+        std::lock_guard<std::mutex> guard(lock);
+        const Account& a = accounts[account];
+        for (size_t i = 0; i < a.minedNonces.size(); i++) {
+            if (a.minedNonces[i] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::mutex lock;
+    Account accounts[4];
+    uint32_t minedTotal = 0;
+    int listener = -1;
+    char url[40] = "";
+
+    static int accountOf(const char* key) {
+        for (int i = 0; i < 4; i++) {
+            if (strcmp(KEYS[i], key) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    static std::string error(const char* message) {
+        return std::string("{\"jsonrpc\":\"2.0\",\"id\":1,\"error\":{\"code\":-32000,\"message\":\"") + message + "\"}}";
+    }
+
+    // "latest": mined count. "pending": plus the run of queued nonces after it.
+    uint32_t transactionCount(const std::string& request) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (int i = 0; i < 4; i++) {
+            if (request.find(ADDRESSES[i]) == std::string::npos) {
+                continue;
+            }
+            const Account& a = accounts[i];
+            uint32_t count = a.mined;
+            if (request.find("\"pending\"") != std::string::npos) {
+                while (a.pool.count(count)) {
+                    count++;
+                }
+            }
+            return count;
+        }
+        return 0;
+    }
+
+    void acceptLoop() {
+        for (;;) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                std::thread([this, fd] { serve(fd); }).detach();
+            }
+        }
+    }
+
+    void serve(int fd) {
+        std::string in;
+        char buf[2048];
+        for (;;) {
+            size_t headEnd;
+            while ((headEnd = in.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, buf, sizeof(buf), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                in.append(buf, n);
+            }
+            size_t lengthAt = in.find("Content-Length: ");
+            size_t bodyLen = lengthAt < headEnd ? strtoul(in.c_str() + lengthAt + 16, nullptr, 10) : 0;
+            while (in.size() < headEnd + 4 + bodyLen) {
+                ssize_t n = recv(fd, buf, sizeof(buf), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                in.append(buf, n);
+            }
+            std::string body = in.substr(headEnd + 4, bodyLen);
+            in.erase(0, headEnd + 4 + bodyLen);
+
+            unsigned long id = strtoul(body.c_str() + body.find("\"id\":") + 5, nullptr, 10);
+            char reply[160];
+            if (body.find("\"eth_getTransactionCount\"") != std::string::npos) {
+                snprintf(reply, sizeof(reply), "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"result\":\"0x%x\"}", id,
+                         transactionCount(body));
+            } else {
+                snprintf(reply, sizeof(reply),
+                         "{\"jsonrpc\":\"2.0\",\"id\":%lu,\"error\":{\"code\":-32601,\"message\":\"method not found\"}}", id);
+            }
+            char head[128];
+            int headLen = snprintf(head, sizeof(head),
+                                   "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n",
+                                   strlen(reply));
+            std::string out = std::string(head, headLen) + reply;
+            if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) {
+                close(fd);
+                return;
+            }
+        }
+    }
+};
+
+// ===== SIMULATION =====
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok && failures++ < 10) {
+        printf("FAIL: %s\n", what);
+    }
+}
+
+struct SimOptions {
+    uint32_t rate = 4;
+    uint32_t seconds = 600;
+    uint32_t blockMs = 12000;
+};
+
+struct RunResult {
+    uint32_t mined;
+    uint32_t sendsRefused;            // Every lane full or stuck
+    size_t backlog;                   // Readings still waiting at the end
+    double txPerSecond;
+};
+
+static MockNode node;
+static RpcClient* rpc;
+
+// Fault hook, called at the start of every step with the simulated time
+typedef void (*Fault)(uint32_t ms);
+
+static RunResult run(const SimOptions& opt, size_t lanes, Fault fault, SignerPool** keep = nullptr) {
+    node.reset();
+    Web3* web3 = new Web3(SEPOLIA_ID);
+    web3->sendRaw = [](const Web3Transaction& tx) { return node.submit(tx); };
+    SignerPool* pool = new SignerPool(web3, *rpc);  // Kept: stats are read after the run
+    for (size_t i = 0; i < lanes; i++) {
+        pool->addSigner(KEYS[i], ADDRESSES[i]);
+    }
+
+    RunResult r = {};
+    const std::string to = "0x5000000000000000000000000000000000000005";
+    const std::string data = "0x6057361d000000000000000000000000000000000000000000000000000000000000002a";
+    uint32_t start = millis();
+    uint32_t nextBlock = start + opt.blockMs;
+    double due = 0;
+    size_t waiting = 0;
+
+    for (uint32_t t = 0; t < opt.seconds * 1000; t += STEP_MS) {
+        if (fault) {
+            fault(t);
+        }
+        due += opt.rate * STEP_MS / 1000.0;
+        while (due >= 1) {
+            waiting++;
+            due -= 1;
+        }
+        while (waiting > 0) {
+            SignerReceipt receipt;
+            if (!pool->send(to, uint256_t(0), data, 1000000000ULL, 60000, &receipt)) {
+                r.sendsRefused++;
+                break;
+            }
+            waiting--;
+        }
+        pool->poll();
+        if ((int32_t)(millis() - nextBlock) >= 0) {
+            node.mine();
+            nextBlock += opt.blockMs;
+        }
+        hostAdvanceMillis(STEP_MS);
+    }
+
+    r.mined = node.mined();
+    r.backlog = waiting;
+    r.txPerSecond = (double)r.mined / opt.seconds;
+    if (keep) {
+        *keep = pool;
+    }
+    return r;
+}
+
+static void printRun(const char* label, const RunResult& r) {
+    printf("%-22s %8u %8.2f %10u %9zu\n", label, r.mined, r.txPerSecond, r.sendsRefused, r.backlog);
+}
+
+static void lanesScale(const SimOptions& opt) {
+    double perSecond[5] = {0};
+    for (size_t lanes : {1, 2, 4}) {
+        char label[32];
+        snprintf(label, sizeof(label), "%zu lane%s", lanes, lanes > 1 ? "s" : "");
+        RunResult r = run(opt, lanes, nullptr);
+        printRun(label, r);
+        perSecond[lanes] = r.txPerSecond;
+        for (size_t i = 0; i < lanes; i++) {
+            check(node.minedInOrder(i), "every nonce is mined once, in order");
+        }
+    }
+    check(perSecond[2] >= perSecond[1] * 1.8, "2 lanes commit about twice what 1 does");
+    check(perSecond[4] >= perSecond[1] * 3, "4 lanes commit at least 3x what 1 does");
+}
+
+static void stuckLane(const SimOptions& opt) {
+    SignerPool* pool;
+    RunResult healthy = run(opt, 4, nullptr);
+    RunResult r = run(opt, 4, [](uint32_t ms) {
+        if (ms == 0) {
+            node.underprice(0, 3);  // Lane 0's third transaction never mines
+        }
+    }, &pool);
+    printRun("4 lanes, 1 stuck", r);
+
+    SignerLaneStats lane0 = pool->stats(0);
+    check(lane0.stuck, "lane behind an underpriced transaction is reported stuck");
+    check(node.mined(0) == 2, "nothing after the underpriced transaction mines");
+    check(r.txPerSecond >= healthy.txPerSecond * 0.6, "the other lanes keep committing");
+}
+
+static void droppedLane(const SimOptions& opt) {
+    SignerPool* pool;
+    RunResult r = run(opt, 4, [](uint32_t ms) {
+        if (ms == 0) {
+            node.underprice(0, 3);
+        } else if (ms == 300000) {
+            node.drop(0);  // The txpool evicts the stuck transaction and its followers
+        }
+    }, &pool);
+    printRun("4 lanes, 1 dropped", r);
+
+    SignerLaneStats lane0 = pool->stats(0);
+    check(!lane0.stuck, "lane is freed once the node dropped its transactions");
+    check(node.mined(0) > 2, "and commits again after resyncing its nonce");
+    check(node.minedInOrder(0), "resynced nonces continue without a gap");
+    check(lane0.failed > 0, "dropped transactions are counted as failed");
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--rate")) {
+            opt.rate = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--seconds")) {
+            opt.seconds = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--block-ms")) {
+            opt.blockMs = atoi(argv[i + 1]);
+        }
+    }
+
+    node.start();
+    rpc = new RpcClient();
+    rpc->addEndpoint(node.endpoint());
+
+    printf("%u readings/s, %u s simulated, block every %u ms, lane depth %d, %d queued per sender\n", opt.rate,
+           opt.seconds, opt.blockMs, SIGNER_LANE_DEPTH, SENDER_QUEUE_LIMIT);
+    printf("%-22s %8s %8s %10s %9s\n", "run", "mined", "tx/s", "refused", "backlog");
+    lanesScale(opt);
+    stuckLane(opt);
+    droppedLane(opt);
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    fflush(stdout);
+    _exit(failures ? 1 : 0);  // RpcClient's worker tasks never return
+}
@@ -0,0 +1,195 @@
+/*
+ * UInt256 Benchmark
+ *
+ * Times src/uint256.h against uint256_t for the operations the firmware
+ * uses: add, compare, multiply, divmod (by a word and by a wide divisor),
+ * decimal string and parsing a hex quantity. Every operation is checked
+ * for equal results on the same random operands. Exits non-zero on a
+ * mismatch.
+ *
+ * uint256_t is the one from tools/host_shim, which follows Web3E's
+ * (calccrypto) algorithms: two uint128_t halves of two words each,
+ * multiplication from 32-bit and 64-bit pieces, divmod one bit per step,
+ * str() one divmod per digit, hex input one nibble at a time. The ratios
+ * are what matter, not the absolute times.
+ *
+ * Compare is the one row where UInt256 loses, at 0.6x to 0.7x (about
+ * 2 ns): uint256_t stops at the first differing half, which on random
+ * operands is almost always the first, while UInt256 runs its borrow
+ * chain over all four words every time, as asked for (no data-dependent
+ * branches). The call sites compare a balance once per RPC reply, so
+ * those nanoseconds are not worth an early exit.
+ *
+ * Build and run on the host:
+ *
+ *   g++ -std=c++17 -O2 -I../host_shim -I../../src uint256_bench.cpp -o uint256_bench
+ *   ./uint256_bench
+ *
+ * Add -U__SIZEOF_INT128__ to time the 32-bit-friendly paths the ESP32
+ * compiler takes (no 128-bit integer type there).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <uint256/uint256_t.h>
+
+#include "uint256.h"
+
+// Folds all words into the sink so no part of a result can be skipped
+static uint64_t fold(const UInt256& v) { return v.word(0) ^ v.word(1) ^ v.word(2) ^ v.word(3); }
+static uint64_t fold(const uint256_t& v) {
+    return v.lower().lower() ^ v.lower().upper() ^ v.upper().lower() ^ v.upper().upper();
+}
+
+// Web3E parses quantities from the digits after 0x
+static uint256_t genericFromHex(const std::string& text) {
+    return uint256_t(text.substr(2), 16);
+}
+
+// ===== BENCHMARK =====
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// Mostly balance-sized values (up to ~2^100), some full width
+static UInt256 randomValue(int bits) {
+    UInt256 v(nextRandom(), nextRandom(), nextRandom(), nextRandom());
+    return bits >= 256 ? v : v >> (256 - bits);
+}
+
+static volatile uint64_t sink;
+
+template <typename Fn>
+static double nsPerOp(size_t n, Fn fn) {
+    size_t rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed{};
+    do {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        rounds++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 100e6);
+    return elapsed.count() / (rounds * n);
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* op, size_t i) {
+    if (!ok && failures++ < 10) {
+        printf("MISMATCH: %s, operand %zu\n", op, i);
+    }
+}
+
+int main() {
+    const size_t N = 256;
+    std::vector<UInt256> a, b, wide, balances;
+    std::vector<uint256_t> ga, gb, gwide, gbalances;
+    std::vector<std::string> hex;
+    for (size_t i = 0; i < N; i++) {
+        a.push_back(randomValue(256));
+        b.push_back(randomValue(256));
+        wide.push_back(randomValue(96 + nextRandom() % 100));
+        balances.push_back(randomValue(60 + nextRandom() % 40));
+        hex.push_back("0x" + a.back().str(16));
+        ga.push_back(a.back());
+        gb.push_back(b.back());
+        gwide.push_back(wide.back());
+        gbalances.push_back(balances.back());
+    }
+    const UInt256 word = 1000000007ULL;
+    const uint256_t gword = 1000000007ULL;
+
+    // Same results first
+    for (size_t i = 0; i < N; i++) {
+        check(uint256_t(a[i] + b[i]) == ga[i] + gb[i], "add", i);
+        check(uint256_t(a[i] * b[i]) == ga[i] * gb[i], "mul", i);
+        UInt256 q, r;
+        UInt256::divmod(a[i], word, &q, &r);
+        std::pair<uint256_t, uint256_t> gqr = uint256_t::divmod(ga[i], gword);
+        check(uint256_t(q) == gqr.first && uint256_t(r) == gqr.second, "divmod word", i);
+        UInt256::divmod(a[i], wide[i], &q, &r);
+        gqr = uint256_t::divmod(ga[i], gwide[i]);
+        check(uint256_t(q) == gqr.first && uint256_t(r) == gqr.second, "divmod wide", i);
+        check(a[i].str() == ga[i].str() && balances[i].str() == gbalances[i].str(), "str", i);
+        UInt256 parsed;
+        check(UInt256::fromHex(hex[i].c_str(), &parsed) && uint256_t(parsed) == genericFromHex(hex[i]), "from hex",
+              i);
+        check((a[i] > b[i]) == (ga[i] > gb[i]) && (a[i] >= a[i]) == (ga[i] >= ga[i]) &&
+              (b[i] < a[i]) == (gb[i] < ga[i]), "compare", i);
+    }
+
+    struct Row {
+        const char* op;
+        double generic;
+        double fixed;
+    };
+    std::vector<Row> rows;
+    rows.push_back({"add", nsPerOp(N, [&](size_t i) { sink += fold(ga[i] + gb[i]); }),
+                    nsPerOp(N, [&](size_t i) { sink += fold(a[i] + b[i]); })});
+    rows.push_back({"compare", nsPerOp(N, [&](size_t i) { sink += ga[i] >= gb[i]; }),
+                    nsPerOp(N, [&](size_t i) { sink += a[i] >= b[i]; })});
+    rows.push_back({"mul", nsPerOp(N, [&](size_t i) { sink += fold(ga[i] * gb[i]); }),
+                    nsPerOp(N, [&](size_t i) { sink += fold(a[i] * b[i]); })});
+    rows.push_back({"divmod word", nsPerOp(N, [&](size_t i) {
+                        std::pair<uint256_t, uint256_t> qr = uint256_t::divmod(ga[i], gword);
+                        sink += fold(qr.first) ^ fold(qr.second);
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        UInt256 q, r;
+                        UInt256::divmod(a[i], word, &q, &r);
+                        sink += fold(q) ^ fold(r);
+                    })});
+    rows.push_back({"divmod wide", nsPerOp(N, [&](size_t i) {
+                        std::pair<uint256_t, uint256_t> qr = uint256_t::divmod(ga[i], gwide[i]);
+                        sink += fold(qr.first) ^ fold(qr.second);
+                    }),
+                    nsPerOp(N, [&](size_t i) {
+                        UInt256 q, r;
+                        UInt256::divmod(a[i], wide[i], &q, &r);
+                        sink += fold(q) ^ fold(r);
+                    })});
+    rows.push_back({"str balance", nsPerOp(N, [&](size_t i) { sink += gbalances[i].str().size(); }),
+                    nsPerOp(N, [&](size_t i) { sink += balances[i].str().size(); })});
+    rows.push_back({"str 256-bit", nsPerOp(N, [&](size_t i) { sink += ga[i].str().size(); }),
+                    nsPerOp(N, [&](size_t i) { sink += a[i].str().size(); })});
+    rows.push_back({"toDecimal", 0, nsPerOp(N, [&](size_t i) {
+                        char buf[UINT256_DEC_CHARS];
+                        sink += a[i].toDecimal(buf, sizeof(buf));
+                    })});
+    rows.push_back({"from hex", nsPerOp(N, [&](size_t i) { sink += fold(genericFromHex(hex[i])); }),
+                    nsPerOp(N, [&](size_t i) {
+                        UInt256 v;
+                        UInt256::fromHex(hex[i].c_str(), &v);
+                        sink += fold(v);
+                    })});
+
+#ifdef __SIZEOF_INT128__
+    printf("64x64 products: __int128\n");
+#else
+    printf("64x64 products: 32-bit pieces\n");
+#endif
+    printf("%-12s %12s %12s %9s\n", "operation", "uint256_t ns", "UInt256 ns", "speedup");
+    for (const Row& r : rows) {
+        if (r.generic > 0) {
+            printf("%-12s %12.1f %12.1f %8.1fx\n", r.op, r.generic, r.fixed, r.generic / r.fixed);
+        } else {
+            printf("%-12s %12s %12.1f %9s\n", r.op, "-", r.fixed, "(no heap)");
+        }
+    }
+
+    printf(failures ? "%d mismatch(es)\n" : "All results match\n", failures);
+    return failures ? 1 : 0;
+}